@@ -0,0 +1,417 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+#include "swfp.h"
+#include "swint.h"
+#include "swunpacked.h"
+#include "swbatch.h"
+#include "swexec.h"
+
+//
+// Exact long accumulator
+//
+// long_accumulator<format> is a two's-complement fixed-point number wide enough
+// to hold any sum of products of `format` values without rounding: the least
+// significant bit is worth the smallest product of two subnormals and the top
+// limb leaves 64 bits of headroom for carries. That is 3 limbs for binary16,
+// 10 for binary32 and 67 for binary64.
+//
+// Addends and products go in exactly, so the state does not depend on the
+// order they arrive in, and round() rounds to nearest-even once. Accumulators
+// filled on different threads merge exactly, which makes batch::accumulate and
+// batch::dot bit-reproducible for any thread count or chunking.
+//
+
+namespace details
+{
+    // integer significand of a finite non-zero value, worth
+    // 2^(exponent - significand_bitsize) per unit; subnormals are denormalized
+    // again so that exponent >= emin
+    template<fp_format format>
+    constexpr uint64_t integer_significand(const unpacked_t<format> &u, int32_t &exponent)
+    {
+        constexpr int32_t emin = 1 - fp_traits<format>::bias;
+
+        uint64_t significand = static_cast<uint64_t>(u.significand >> unpacked_t<format>::guard_bits);
+        exponent = u.exponent;
+        if (exponent < emin) {
+            significand >>= emin - exponent;
+            exponent = emin;
+        }
+        return significand;
+    }
+
+    // exact product of the integer significands of finite non-zero values,
+    // worth 2^exponent per unit
+    template<fp_format format>
+    constexpr void integer_product(const unpacked_t<format> &a, const unpacked_t<format> &b, uint64_t &hi, uint64_t &lo, int32_t &exponent)
+    {
+        constexpr int significand_bitsize = unpacked_t<format>::precision - 1;
+
+        int32_t ea = 0, eb = 0;
+        const uint64_t sa = integer_significand(a, ea);
+        const uint64_t sb = integer_significand(b, eb);
+
+        hi = 0;
+        if constexpr (sizeof(typename fp_traits<format>::uint_t) <= sizeof(uint32_t)) {
+            lo = sa * sb;
+        }
+        else {
+            lo = mul_extended(sa, sb, hi);
+        }
+        exponent = ea + eb - 2 * significand_bitsize;
+    }
+
+    // NaN, infinity and signed-zero bookkeeping of an accumulator: the result
+    // of a sum with special terms does not depend on their order
+    template<fp_format format>
+    struct accumulator_terms
+    {
+        using packed_t = floatbase_t<format>;
+
+        // record a term, returns true for finite non-zero values
+        constexpr bool track(const unpacked_t<format> &u, packed_t x)
+        {
+            switch (u.class_)
+            {
+            case unpacked_class::nan:
+                record_nan(x);
+                return false;
+            case unpacked_class::infinity:
+                record_infinity(u.sign);
+                return false;
+            case unpacked_class::zero:
+                record_zero(u.sign);
+                return false;
+            default:
+                record_zero(0);
+                return true;
+            }
+        }
+
+        // record a product term, returns true for finite non-zero products
+        constexpr bool track_product(const unpacked_t<format> &ua, const unpacked_t<format> &ub, packed_t a, packed_t b)
+        {
+            const uint8_t sign = ua.sign ^ ub.sign;
+
+            if (ua.class_ == unpacked_class::nan || ub.class_ == unpacked_class::nan) {
+                record_nan(ua.class_ == unpacked_class::nan ? a : b);
+                return false;
+            }
+            if (ua.class_ == unpacked_class::infinity || ub.class_ == unpacked_class::infinity) {
+                if (ua.class_ == unpacked_class::zero || ub.class_ == unpacked_class::zero) {
+                    record_nan(packed_t::indeterminate_nan());
+                }
+                else {
+                    record_infinity(sign);
+                }
+                return false;
+            }
+            if (ua.class_ == unpacked_class::zero || ub.class_ == unpacked_class::zero) {
+                record_zero(sign);
+                return false;
+            }
+
+            record_zero(0);
+            return true;
+        }
+
+        constexpr void merge(const accumulator_terms &other)
+        {
+            if (other.has_nan) {
+                record_nan(other.nan_value);
+            }
+            positive_infinity |= other.positive_infinity;
+            negative_infinity |= other.negative_infinity;
+            has_terms |= other.has_terms;
+            all_negative_zero &= other.all_negative_zero;
+        }
+
+        // the result if it is NaN or infinite
+        template<fp_format out>
+        constexpr bool special_result(floatbase_t<out> &result) const
+        {
+            if (has_nan) {
+                result = static_cast<floatbase_t<out>>(nan_value);
+            }
+            else if (positive_infinity && negative_infinity) {
+                result = floatbase_t<out>::indeterminate_nan();
+            }
+            else if (positive_infinity || negative_infinity) {
+                result = floatbase_t<out>::infinity(negative_infinity ? 1 : 0);
+            }
+            else {
+                return false;
+            }
+            return true;
+        }
+
+        // an exact zero sum is +0 unless every term was -0
+        constexpr uint8_t zero_sign() const { return has_terms && all_negative_zero ? 1 : 0; }
+
+        // keep the NaN with the smallest encoding so the result does not depend
+        // on the order the terms arrive in
+        constexpr void record_nan(packed_t x)
+        {
+            if (!has_nan || x.to_bitstring() < nan_value.to_bitstring()) {
+                nan_value = x;
+            }
+            has_nan = true;
+            has_terms = true;
+        }
+
+        constexpr void record_infinity(uint8_t sign)
+        {
+            (sign ? negative_infinity : positive_infinity) = true;
+            has_terms = true;
+        }
+
+        // a zero term of the given sign, or a non-zero term (sign 0)
+        constexpr void record_zero(uint8_t sign)
+        {
+            all_negative_zero &= sign != 0;
+            has_terms = true;
+        }
+
+        packed_t nan_value = packed_t::zero();
+        bool has_nan = false;
+        bool positive_infinity = false;
+        bool negative_infinity = false;
+        bool has_terms = false;
+        bool all_negative_zero = true;
+    };
+
+    // add or subtract the 128-bit value hi:lo shifted left by `offset` bits to
+    // little-endian two's-complement limbs
+    template<int limb_count>
+    constexpr void add_limbs_at(uint64_t (&limbs)[limb_count], int32_t offset, uint64_t hi, uint64_t lo, bool negative)
+    {
+        const int index = offset / 64;
+        const int shift = offset % 64;
+
+        uint64_t parts[3] = { lo << shift, hi << shift, 0 };
+        if (shift) {
+            parts[1] |= lo >> (64 - shift);
+            parts[2] = hi >> (64 - shift);
+        }
+
+        uint8_t carry = 0;
+        int i = index;
+        for (int k = 0; k < 3 && i < limb_count; ++k, ++i) {
+            limbs[i] = negative ? sub_borrow(limbs[i], parts[k], carry) : add_carry(limbs[i], parts[k], carry);
+        }
+        for (; carry && i < limb_count; ++i) {
+            limbs[i] = negative ? sub_borrow(limbs[i], uint64_t(0), carry) : add_carry(limbs[i], uint64_t(0), carry);
+        }
+    }
+
+    // magnitude of two's-complement limbs, returns true if the value is negative
+    template<int limb_count>
+    constexpr bool limbs_magnitude(const uint64_t (&limbs)[limb_count], uint64_t (&magnitude)[limb_count])
+    {
+        const bool negative = (limbs[limb_count - 1] >> 63) != 0;
+        uint8_t borrow = 0;
+        for (int i = 0; i < limb_count; ++i) {
+            magnitude[i] = negative ? sub_borrow(uint64_t(0), limbs[i], borrow) : limbs[i];
+        }
+        return negative;
+    }
+
+    // left-aligned 64 bits of a non-zero magnitude starting at its leading bit,
+    // lower bits ORed into the last bit; returns the index of the leading bit
+    template<int limb_count>
+    constexpr int limbs_window(const uint64_t (&magnitude)[limb_count], uint64_t &window)
+    {
+        int top = limb_count - 1;
+        while (magnitude[top] == 0) {
+            --top;
+        }
+
+        unsigned long index = 0;
+        reverse_bit_scan(&index, magnitude[top]);
+
+        window = magnitude[top];
+        uint64_t rest = 0;
+        if (index != 63) {
+            window <<= 63 - index;
+            if (top > 0) {
+                window |= magnitude[top - 1] >> (index + 1);
+                rest = magnitude[top - 1] << (63 - index);
+            }
+        }
+        else if (top > 0) {
+            rest = magnitude[top - 1];
+        }
+
+        bool sticky = rest != 0;
+        for (int i = top - 2; i >= 0 && !sticky; --i) {
+            sticky = magnitude[i] != 0;
+        }
+        window |= sticky ? 1 : 0;
+
+        return top * 64 + static_cast<int>(index);
+    }
+
+    template<int limb_count>
+    constexpr bool limbs_zero(const uint64_t (&limbs)[limb_count])
+    {
+        for (int i = 0; i < limb_count; ++i) {
+            if (limbs[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // round the two's-complement value limbs * 2^lsb_exponent into `out`
+    template<fp_format out, int limb_count>
+    constexpr floatbase_t<out> round_limbs(const uint64_t (&limbs)[limb_count], int32_t lsb_exponent, uint8_t zero_sign)
+    {
+        uint64_t magnitude[limb_count] = {};
+        const bool negative = limbs_magnitude(limbs, magnitude);
+        if (limbs_zero(magnitude)) {
+            return floatbase_t<out>::zero(zero_sign);
+        }
+
+        uint64_t window = 0;
+        const int lead = limbs_window(magnitude, window);
+        return round_window<out>(negative ? 1 : 0, lead + lsb_exponent, window);
+    }
+}
+
+template<fp_format format>
+class long_accumulator
+{
+public:
+
+    using packed_t = floatbase_t<format>;
+    using uint_t = typename fp_traits<format>::uint_t;
+
+    static_assert(sizeof(uint_t) <= sizeof(uint64_t), "long_accumulator supports formats up to binary64");
+
+    static constexpr int significand_bitsize = unpacked_t<format>::precision - 1;
+    static constexpr int32_t emin = 1 - fp_traits<format>::bias;
+    static constexpr int32_t emax = fp_traits<format>::bias;
+
+    // weight of bit 0: the product of two minimum subnormals
+    static constexpr int32_t lsb_exponent = 2 * (emin - significand_bitsize);
+
+    // products stay below 2^(2 * (emax + 1)), plus carry headroom and a sign bit
+    static constexpr int value_bits = 2 * (emax + 1) - lsb_exponent;
+    static constexpr int limb_count = (value_bits + 64 + 1 + 63) / 64;
+
+    constexpr long_accumulator() = default;
+
+    constexpr void clear() { *this = long_accumulator(); }
+
+    // acc += x
+    constexpr void add(packed_t x)
+    {
+        unpacked_t<format> u(x);
+        if (!terms.track(u, x)) {
+            return;
+        }
+
+        int32_t exponent = 0;
+        uint64_t significand = details::integer_significand(u, exponent);
+        details::add_limbs_at(limbs, exponent - significand_bitsize - lsb_exponent, 0, significand, u.sign != 0);
+    }
+
+    // acc += a * b, the product is not rounded
+    constexpr void add_product(packed_t a, packed_t b)
+    {
+        unpacked_t<format> ua(a), ub(b);
+        if (!terms.track_product(ua, ub, a, b)) {
+            return;
+        }
+
+        uint64_t hi = 0, lo = 0;
+        int32_t exponent = 0;
+        details::integer_product(ua, ub, hi, lo, exponent);
+        details::add_limbs_at(limbs, exponent - lsb_exponent, hi, lo, (ua.sign ^ ub.sign) != 0);
+    }
+
+    // acc += other, exact
+    constexpr void merge(const long_accumulator &other)
+    {
+        uint8_t carry = 0;
+        for (int i = 0; i < limb_count; ++i) {
+            limbs[i] = details::add_carry(limbs[i], other.limbs[i], carry);
+        }
+        terms.merge(other.terms);
+    }
+
+    // the accumulated value rounded to nearest-even
+    template<fp_format out = format>
+    constexpr floatbase_t<out> round() const
+    {
+        floatbase_t<out> special;
+        if (terms.special_result(special)) {
+            return special;
+        }
+        return details::round_limbs<out>(limbs, lsb_exponent, terms.zero_sign());
+    }
+
+private:
+
+    uint64_t limbs[limb_count] = {};         // little-endian two's complement
+    details::accumulator_terms<format> terms;
+};
+
+namespace batch
+{
+    // acc += sum of x[i], exact
+    template<fp_format format>
+    void accumulate(const floatbase_t<format> *x, size_t count, long_accumulator<format> &acc, thread_pool &pool = default_thread_pool())
+    {
+        std::vector<long_accumulator<format>> partial(pool.size());
+        pool.parallel_for(0, count, details::batch_grain<format>(), [&](size_t begin, size_t end, unsigned worker) {
+            for (size_t i = begin; i < end; ++i) {
+                partial[worker].add(x[i]);
+            }
+        });
+
+        for (auto &p : partial) {
+            acc.merge(p);
+        }
+    }
+
+    // acc += sum of x[i] * y[i], exact
+    template<fp_format format>
+    void accumulate_products(const floatbase_t<format> *x, const floatbase_t<format> *y, size_t count, long_accumulator<format> &acc, thread_pool &pool = default_thread_pool())
+    {
+        std::vector<long_accumulator<format>> partial(pool.size());
+        pool.parallel_for(0, count, details::batch_grain<format>(), [&](size_t begin, size_t end, unsigned worker) {
+            for (size_t i = begin; i < end; ++i) {
+                partial[worker].add_product(x[i], y[i]);
+            }
+        });
+
+        for (auto &p : partial) {
+            acc.merge(p);
+        }
+    }
+
+    // sum of x[i] rounded once
+    template<fp_format format>
+    floatbase_t<format> accumulate(const floatbase_t<format> *x, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        long_accumulator<format> acc;
+        accumulate(x, count, acc, pool);
+        return acc.round();
+    }
+
+    // sum of x[i] * y[i] rounded once
+    template<fp_format format>
+    floatbase_t<format> dot(const floatbase_t<format> *x, const floatbase_t<format> *y, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        long_accumulator<format> acc;
+        accumulate_products(x, y, count, acc, pool);
+        return acc.round();
+    }
+}
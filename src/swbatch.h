@@ -0,0 +1,473 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+#include "swfp.h"
+#include "swexec.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+//
+// Batch kernels over arrays of floatbase_t values
+//
+// Predicates produce packed bitmasks: bit (i % 64) of mask[i / 64] holds the
+// result for element i. Unused bits of the last word are written as 0.
+//
+// All kernels run in chunks on a thread_pool (the default pool unless one is
+// passed in). Arithmetic and conversion kernels return the exception flags
+// raised by any element.
+//
+
+// IEEE754 exception flags reported by the batch kernels
+enum class fp_flags : uint8_t
+{
+    none = 0,
+    invalid = 1,
+    divide_by_zero = 2,
+    overflow = 4,
+    underflow = 8
+};
+
+constexpr fp_flags operator|(fp_flags a, fp_flags b) { return static_cast<fp_flags>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b)); }
+inline fp_flags &operator|=(fp_flags &a, fp_flags b) { a = a | b; return a; }
+constexpr bool has_flag(fp_flags flags, fp_flags flag) { return (static_cast<uint8_t>(flags) & static_cast<uint8_t>(flag)) != 0; }
+
+namespace details
+{
+    // Integer key transform of IEEE754 bit patterns
+    //
+    // Converting the sign-magnitude encoding to two's-complement makes the order
+    // of the keys match the order of the (non-NaN) floating-point values and maps
+    // -0 and +0 to the same key, so plain integer compares implement the
+    // floating-point relational operators once NaNs are masked out.
+    template<fp_format format>
+    struct fp_key_traits
+    {
+        using uint_t = typename fp_traits<format>::uint_t;
+        using int_t = std::make_signed_t<uint_t>;
+
+        static constexpr int bitsize = sizeof(uint_t) * 8;
+        static constexpr int exponent_bitsize = fp_traits<format>::exponent_bitsize;
+        static constexpr int significand_bitsize = bitsize - exponent_bitsize - 1;
+        static constexpr uint_t sign_mask = static_cast<uint_t>(uint_t(1) << (bitsize - 1));
+        static constexpr uint_t magnitude_mask = static_cast<uint_t>(~sign_mask);
+        static constexpr uint_t infinity_bits = static_cast<uint_t>(((uint_t(1) << exponent_bitsize) - 1) << significand_bitsize);
+        static constexpr uint_t min_normal_bits = static_cast<uint_t>(uint_t(1) << significand_bitsize);
+
+        static constexpr int_t key(uint_t x) {
+            int_t magnitude = static_cast<int_t>(x & magnitude_mask);
+            return static_cast<int_t>((x & sign_mask) ? -magnitude : magnitude);
+        }
+
+        // unsigned key whose order is the IEEE754 totalOrder predicate:
+        // -NaN < -inf < ... < -0 < +0 < ... < +inf < +NaN
+        static constexpr uint_t ordered_key(uint_t x) {
+            return static_cast<uint_t>((x & sign_mask) ? ~x : (x ^ sign_mask));
+        }
+        static constexpr uint_t from_ordered_key(uint_t k) {
+            return static_cast<uint_t>((k & sign_mask) ? (k ^ sign_mask) : ~k);
+        }
+
+        static constexpr bool is_nan(uint_t x) { return static_cast<uint_t>(x & magnitude_mask) > infinity_bits; }
+        static constexpr bool is_inf(uint_t x) { return static_cast<uint_t>(x & magnitude_mask) == infinity_bits; }
+        static constexpr bool is_subnormal(uint_t x) {
+            uint_t magnitude = static_cast<uint_t>(x & magnitude_mask);
+            return magnitude != 0 && magnitude < min_normal_bits;
+        }
+    };
+
+    enum class cmp_op { lt, le, eq, ne, gt, ge };
+    enum class class_op { nan, inf, subnormal };
+
+    template<cmp_op op, typename int_t>
+    constexpr bool compare_keys(int_t a, int_t b, bool unordered)
+    {
+        // NaN's compare false for everything but '!='
+        if constexpr (op == cmp_op::lt) { return !unordered && a < b; }
+        else if constexpr (op == cmp_op::le) { return !unordered && a <= b; }
+        else if constexpr (op == cmp_op::eq) { return !unordered && a == b; }
+        else if constexpr (op == cmp_op::ne) { return unordered || a != b; }
+        else if constexpr (op == cmp_op::gt) { return !unordered && a > b; }
+        else { return !unordered && a >= b; }
+    }
+
+    template<class_op op, fp_format format>
+    constexpr bool classify_bits(typename fp_key_traits<format>::uint_t x)
+    {
+        if constexpr (op == class_op::nan) { return fp_key_traits<format>::is_nan(x); }
+        else if constexpr (op == class_op::inf) { return fp_key_traits<format>::is_inf(x); }
+        else { return fp_key_traits<format>::is_subnormal(x); }
+    }
+
+#if USE_SSE2
+    // SSE2 has signed 16-bit and 32-bit integer compares, wider lanes use the scalar loop
+    template<size_t lane_size> struct sse2_lanes { static constexpr int count = 0; };
+
+    template<> struct sse2_lanes<2>
+    {
+        static constexpr int count = 8;
+        static __m128i set1(uint16_t x) { return _mm_set1_epi16(static_cast<short>(x)); }
+        static __m128i sign(__m128i x) { return _mm_srai_epi16(x, 15); }
+        static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi16(a, b); }
+        static __m128i cmpeq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+        static __m128i cmpgt(__m128i a, __m128i b) { return _mm_cmpgt_epi16(a, b); }
+        static uint32_t movemask(__m128i m) { return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(m, _mm_setzero_si128()))); }
+    };
+
+    template<> struct sse2_lanes<4>
+    {
+        static constexpr int count = 4;
+        static __m128i set1(uint32_t x) { return _mm_set1_epi32(static_cast<int>(x)); }
+        static __m128i sign(__m128i x) { return _mm_srai_epi32(x, 31); }
+        static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }
+        static __m128i cmpeq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+        static __m128i cmpgt(__m128i a, __m128i b) { return _mm_cmpgt_epi32(a, b); }
+        static uint32_t movemask(__m128i m) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(m))); }
+    };
+
+    template<typename lanes, fp_format format>
+    struct sse2_keys
+    {
+        using key_traits = fp_key_traits<format>;
+
+        // two's-complement key: (magnitude ^ sign) - sign
+        static __m128i key(__m128i x) {
+            __m128i sign = lanes::sign(x);
+            __m128i magnitude = _mm_and_si128(x, lanes::set1(key_traits::magnitude_mask));
+            return lanes::sub(_mm_xor_si128(magnitude, sign), sign);
+        }
+
+        static __m128i magnitude(__m128i x) { return _mm_and_si128(x, lanes::set1(key_traits::magnitude_mask)); }
+        static __m128i is_nan(__m128i x) { return lanes::cmpgt(magnitude(x), lanes::set1(key_traits::infinity_bits)); }
+
+        template<cmp_op op>
+        static __m128i compare(__m128i a, __m128i b, __m128i unordered)
+        {
+            const __m128i allones = _mm_set1_epi32(-1);
+            if constexpr (op == cmp_op::lt) { return _mm_andnot_si128(unordered, lanes::cmpgt(b, a)); }
+            else if constexpr (op == cmp_op::le) { return _mm_andnot_si128(_mm_or_si128(unordered, lanes::cmpgt(a, b)), allones); }
+            else if constexpr (op == cmp_op::eq) { return _mm_andnot_si128(unordered, lanes::cmpeq(a, b)); }
+            else if constexpr (op == cmp_op::ne) { return _mm_or_si128(unordered, _mm_andnot_si128(lanes::cmpeq(a, b), allones)); }
+            else if constexpr (op == cmp_op::gt) { return _mm_andnot_si128(unordered, lanes::cmpgt(a, b)); }
+            else { return _mm_andnot_si128(_mm_or_si128(unordered, lanes::cmpgt(b, a)), allones); }
+        }
+
+        template<class_op op>
+        static __m128i classify(__m128i x)
+        {
+            __m128i m = magnitude(x);
+            if constexpr (op == class_op::nan) { return lanes::cmpgt(m, lanes::set1(key_traits::infinity_bits)); }
+            else if constexpr (op == class_op::inf) { return lanes::cmpeq(m, lanes::set1(key_traits::infinity_bits)); }
+            else {
+                return _mm_and_si128(lanes::cmpgt(m, _mm_setzero_si128()), lanes::cmpgt(lanes::set1(key_traits::min_normal_bits), m));
+            }
+        }
+    };
+#endif
+
+    template<cmp_op op, fp_format format, bool scalar_rhs>
+    void compare_kernel(const floatbase_t<format> *a, const floatbase_t<format> *b, size_t count, uint64_t *mask)
+    {
+        using key_traits = fp_key_traits<format>;
+        using uint_t = typename key_traits::uint_t;
+
+        size_t i = 0;
+
+#if USE_SSE2
+        using lanes = sse2_lanes<sizeof(uint_t)>;
+        if constexpr (lanes::count != 0)
+        {
+            using keys = sse2_keys<lanes, format>;
+
+            __m128i kb = _mm_setzero_si128(), nb = _mm_setzero_si128();
+            if constexpr (scalar_rhs) {
+                __m128i y = lanes::set1(b->to_bitstring());
+                kb = keys::key(y);
+                nb = keys::is_nan(y);
+            }
+
+            for (; i + 64 <= count; i += 64)
+            {
+                uint64_t word = 0;
+                for (int j = 0; j < 64; j += lanes::count)
+                {
+                    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i + j));
+                    if constexpr (!scalar_rhs) {
+                        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i + j));
+                        kb = keys::key(y);
+                        nb = keys::is_nan(y);
+                    }
+
+                    __m128i result = keys::template compare<op>(keys::key(x), kb, _mm_or_si128(keys::is_nan(x), nb));
+                    word |= static_cast<uint64_t>(lanes::movemask(result)) << j;
+                }
+                mask[i / 64] = word;
+            }
+        }
+#endif
+
+        // remaining elements (and formats without a vector path)
+        for (; i < count; i += 64)
+        {
+            uint64_t word = 0;
+            size_t block = std::min<size_t>(64, count - i);
+            for (size_t j = 0; j < block; ++j)
+            {
+                uint_t x = a[i + j].to_bitstring();
+                uint_t y = scalar_rhs ? b->to_bitstring() : b[i + j].to_bitstring();
+                bool unordered = key_traits::is_nan(x) || key_traits::is_nan(y);
+                word |= static_cast<uint64_t>(compare_keys<op>(key_traits::key(x), key_traits::key(y), unordered)) << j;
+            }
+            mask[i / 64] = word;
+        }
+    }
+
+    template<class_op op, fp_format format>
+    void classify_kernel(const floatbase_t<format> *a, size_t count, uint64_t *mask)
+    {
+        using uint_t = typename fp_key_traits<format>::uint_t;
+
+        size_t i = 0;
+
+#if USE_SSE2
+        using lanes = sse2_lanes<sizeof(uint_t)>;
+        if constexpr (lanes::count != 0)
+        {
+            using keys = sse2_keys<lanes, format>;
+
+            for (; i + 64 <= count; i += 64)
+            {
+                uint64_t word = 0;
+                for (int j = 0; j < 64; j += lanes::count)
+                {
+                    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i + j));
+                    word |= static_cast<uint64_t>(lanes::movemask(keys::template classify<op>(x))) << j;
+                }
+                mask[i / 64] = word;
+            }
+        }
+#endif
+
+        for (; i < count; i += 64)
+        {
+            uint64_t word = 0;
+            size_t block = std::min<size_t>(64, count - i);
+            for (size_t j = 0; j < block; ++j) {
+                word |= static_cast<uint64_t>(classify_bits<op, format>(a[i + j].to_bitstring())) << j;
+            }
+            mask[i / 64] = word;
+        }
+    }
+
+    // elements per parallel_for chunk: a whole number of cache lines and of 64-bit
+    // mask words, sized so a chunk is a few tens of microseconds of soft-float work
+    template<fp_format format>
+    constexpr size_t batch_grain()
+    {
+        using uint_t = typename fp_traits<format>::uint_t;
+        if constexpr (sizeof(uint_t) <= 2) { return 8192; }
+        else if constexpr (sizeof(uint_t) == 4) { return 4096; }
+        else if constexpr (sizeof(uint_t) == 8) { return 2048; }
+        else { return 512; }
+    }
+
+    // run fn(begin, end) -> fp_flags over grain-sized chunks, merging the flags
+    // raised on each worker in worker order once all chunks are done
+    template<fp_format format, typename fn_t>
+    fp_flags run_batch(thread_pool &pool, size_t count, fn_t fn)
+    {
+        struct alignas(64) worker_flags_t { fp_flags flags = fp_flags::none; };
+        std::vector<worker_flags_t> worker_flags(pool.size());
+
+        pool.parallel_for(0, count, batch_grain<format>(), [&](size_t begin, size_t end, unsigned worker) {
+            worker_flags[worker].flags |= fn(begin, end);
+        });
+
+        fp_flags flags = fp_flags::none;
+        for (auto &f : worker_flags) {
+            flags |= f.flags;
+        }
+        return flags;
+    }
+
+    enum class arith_op { add, sub, mul, div };
+
+    // Exception flags are derived from the classes of the operands and the result,
+    // the scalar operators do not report them. Underflow is raised on tininess
+    // alone since exactness of the rounded result is not tracked.
+    template<arith_op op, fp_format format>
+    fp_flags arith_flags(typename fp_key_traits<format>::uint_t a, typename fp_key_traits<format>::uint_t b, typename fp_key_traits<format>::uint_t r)
+    {
+        using key_traits = fp_key_traits<format>;
+
+        auto finite = [](auto x) { return static_cast<decltype(x)>(x & key_traits::magnitude_mask) < key_traits::infinity_bits; };
+        auto zero = [](auto x) { return static_cast<decltype(x)>(x & key_traits::magnitude_mask) == 0; };
+        auto tiny = [](auto x) { return static_cast<decltype(x)>(x & key_traits::magnitude_mask) < key_traits::min_normal_bits; };
+
+        fp_flags flags = fp_flags::none;
+
+        if (key_traits::is_nan(r) && !key_traits::is_nan(a) && !key_traits::is_nan(b)) {
+            flags |= fp_flags::invalid;
+        }
+
+        if constexpr (op == arith_op::div) {
+            if (zero(b) && finite(a) && !zero(a)) {
+                return flags | fp_flags::divide_by_zero;
+            }
+        }
+
+        if (finite(a) && finite(b))
+        {
+            if (key_traits::is_inf(r)) {
+                flags |= fp_flags::overflow;
+            }
+            else if constexpr (op == arith_op::mul || op == arith_op::div) {
+                // sums of representable values that land below the normal range are exact
+                if (tiny(r) && !zero(a) && !zero(b)) {
+                    flags |= fp_flags::underflow;
+                }
+            }
+        }
+
+        return flags;
+    }
+
+    template<arith_op op, fp_format format>
+    fp_flags arith_kernel(const floatbase_t<format> *a, const floatbase_t<format> *b, floatbase_t<format> *out, size_t count)
+    {
+        fp_flags flags = fp_flags::none;
+        for (size_t i = 0; i < count; ++i)
+        {
+            floatbase_t<format> x = a[i], y = b[i], r;
+            if constexpr (op == arith_op::add) { r = x + y; }
+            else if constexpr (op == arith_op::sub) { r = x - y; }
+            else if constexpr (op == arith_op::mul) { r = x * y; }
+            else { r = x / y; }
+
+            flags |= arith_flags<op, format>(x.to_bitstring(), y.to_bitstring(), r.to_bitstring());
+            out[i] = r;
+        }
+        return flags;
+    }
+
+    template<fp_format from, fp_format to>
+    fp_flags convert_kernel(const floatbase_t<from> *src, floatbase_t<to> *dst, size_t count)
+    {
+        using src_traits = fp_key_traits<from>;
+        using dst_traits = fp_key_traits<to>;
+
+        fp_flags flags = fp_flags::none;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto x = src[i].to_bitstring();
+            floatbase_t<to> r = static_cast<floatbase_t<to>>(src[i]);
+
+            auto magnitude = static_cast<typename src_traits::uint_t>(x & src_traits::magnitude_mask);
+            if (magnitude != 0 && magnitude < src_traits::infinity_bits)
+            {
+                auto result = static_cast<typename dst_traits::uint_t>(r.to_bitstring() & dst_traits::magnitude_mask);
+                if (result == dst_traits::infinity_bits) {
+                    flags |= fp_flags::overflow;
+                }
+                else if (result < dst_traits::min_normal_bits) {
+                    flags |= fp_flags::underflow;
+                }
+            }
+
+            dst[i] = r;
+        }
+        return flags;
+    }
+}
+
+namespace batch
+{
+    // number of 64-bit words needed to hold the bitmask for `count` elements
+    constexpr size_t mask_words(size_t count) { return (count + 63) / 64; }
+
+    //
+    // relational predicates: column-column and column-scalar
+    //
+
+#define MAKE_BATCH_COMPARE(name)                                                                                    \
+    template<fp_format format>                                                                                      \
+    void name(const floatbase_t<format> *a, const floatbase_t<format> *b, size_t count, uint64_t *mask,             \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        pool.parallel_for(0, count, details::batch_grain<format>(), [=](size_t begin, size_t end, unsigned) {       \
+            details::compare_kernel<details::cmp_op::name, format, false>(a + begin, b + begin, end - begin, mask + begin / 64); \
+        });                                                                                                         \
+    }                                                                                                               \
+    template<fp_format format>                                                                                      \
+    void name(const floatbase_t<format> *a, floatbase_t<format> b, size_t count, uint64_t *mask,                    \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        pool.parallel_for(0, count, details::batch_grain<format>(), [=](size_t begin, size_t end, unsigned) {       \
+            details::compare_kernel<details::cmp_op::name, format, true>(a + begin, &b, end - begin, mask + begin / 64); \
+        });                                                                                                         \
+    }                                                                                                               \
+
+    MAKE_BATCH_COMPARE(lt)
+    MAKE_BATCH_COMPARE(le)
+    MAKE_BATCH_COMPARE(eq)
+    MAKE_BATCH_COMPARE(ne)
+    MAKE_BATCH_COMPARE(gt)
+    MAKE_BATCH_COMPARE(ge)
+
+#undef MAKE_BATCH_COMPARE
+
+    //
+    // classification
+    //
+
+#define MAKE_BATCH_CLASSIFY(name, op)                                                                               \
+    template<fp_format format>                                                                                      \
+    void name(const floatbase_t<format> *a, size_t count, uint64_t *mask, thread_pool &pool = default_thread_pool()) { \
+        pool.parallel_for(0, count, details::batch_grain<format>(), [=](size_t begin, size_t end, unsigned) {       \
+            details::classify_kernel<details::class_op::op, format>(a + begin, end - begin, mask + begin / 64);      \
+        });                                                                                                         \
+    }                                                                                                               \
+
+    MAKE_BATCH_CLASSIFY(isnan, nan)
+    MAKE_BATCH_CLASSIFY(isinf, inf)
+    MAKE_BATCH_CLASSIFY(issubnormal, subnormal)
+
+#undef MAKE_BATCH_CLASSIFY
+
+    //
+    // arithmetic: out[i] = a[i] op b[i], returns the merged exception flags
+    //
+
+#define MAKE_BATCH_ARITH(name)                                                                                      \
+    template<fp_format format>                                                                                      \
+    fp_flags name(const floatbase_t<format> *a, const floatbase_t<format> *b, floatbase_t<format> *out, size_t count, \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        return details::run_batch<format>(pool, count, [=](size_t begin, size_t end) {                              \
+            return details::arith_kernel<details::arith_op::name, format>(a + begin, b + begin, out + begin, end - begin); \
+        });                                                                                                         \
+    }                                                                                                               \
+
+    MAKE_BATCH_ARITH(add)
+    MAKE_BATCH_ARITH(sub)
+    MAKE_BATCH_ARITH(mul)
+    MAKE_BATCH_ARITH(div)
+
+#undef MAKE_BATCH_ARITH
+
+    //
+    // conversion: dst[i] = (to)src[i], returns the merged exception flags
+    //
+
+    template<fp_format from, fp_format to>
+    fp_flags convert(const floatbase_t<from> *src, floatbase_t<to> *dst, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        return details::run_batch<from>(pool, count, [=](size_t begin, size_t end) {
+            return details::convert_kernel<from, to>(src + begin, dst + begin, end - begin);
+        });
+    }
+}
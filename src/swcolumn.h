@@ -0,0 +1,472 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <array>
+#include <vector>
+
+#include "swint.h"
+#include "swexec.h"
+#include "swbatch.h"
+
+//
+// Structure-of-arrays columns of 128-bit integers
+//
+// int128_column keeps the lower and upper 64-bit halves of its values in two
+// separate arrays, so the batch kernels load whole vectors of lower halves and
+// of upper halves instead of unpacking {lower, upper} pairs:
+//
+//      int128_column<true> a(values, count), b(count), total(count);
+//      batch::add(a, b, total);
+//      int128sw_t s = batch::sum(total);
+//
+// Arithmetic wraps modulo 2^128 like intbase_t. Additions and subtractions
+// take the carry of the lower halves from a per-lane compare mask, products
+// are 64x64->128 multiplies of the lower halves plus the two cross products.
+// Predicates produce the packed bitmasks of swbatch.h.
+//
+
+template<bool is_signed>
+class int128_column
+{
+public:
+
+    using value_type = intbase_t<16, is_signed>;
+
+    explicit int128_column(size_t count = 0) : lo(count), hi(count) {}
+
+    int128_column(const value_type *values, size_t count) : lo(count), hi(count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            set(i, values[i]);
+        }
+    }
+
+    size_t size() const { return lo.size(); }
+
+    void resize(size_t count)
+    {
+        lo.resize(count);
+        hi.resize(count);
+    }
+
+    value_type operator[](size_t i) const { return details::bit_cast<value_type>(std::array<uint64_t, 2>{ lo[i], hi[i] }); }
+
+    void set(size_t i, value_type x)
+    {
+        const auto halves = details::bit_cast<std::array<uint64_t, 2>>(x);
+        lo[i] = halves[0];
+        hi[i] = halves[1];
+    }
+
+    void copy_to(value_type *values) const
+    {
+        for (size_t i = 0; i < size(); ++i) {
+            values[i] = (*this)[i];
+        }
+    }
+
+    std::vector<uint64_t> lo;
+    std::vector<uint64_t> hi;
+};
+
+namespace details
+{
+    // elements per parallel_for chunk, a whole number of 64-bit mask words
+    constexpr size_t column_grain = 16384;
+
+    // a + b and a - b of the halves
+    inline void add128(uint64_t alo, uint64_t ahi, uint64_t blo, uint64_t bhi, uint64_t &lo, uint64_t &hi)
+    {
+        lo = alo + blo;
+        hi = ahi + bhi + (lo < alo);
+    }
+
+    inline void sub128(uint64_t alo, uint64_t ahi, uint64_t blo, uint64_t bhi, uint64_t &lo, uint64_t &hi)
+    {
+        lo = alo - blo;
+        hi = ahi - bhi - (alo < blo);
+    }
+
+    // a < b, signed values compare with the sign bits of the upper halves flipped
+    template<bool is_signed>
+    inline bool less128(uint64_t alo, uint64_t ahi, uint64_t blo, uint64_t bhi)
+    {
+        if constexpr (is_signed) {
+            ahi ^= uint64_t(1) << 63;
+            bhi ^= uint64_t(1) << 63;
+        }
+        return ahi < bhi || (ahi == bhi && alo < blo);
+    }
+
+#if USE_SSE2
+    // SSE2 has 64-bit adds but no 64-bit compares: an unsigned a < b is the
+    // borrow out of a - b, which is the top bit of (~a & b) | (~(a ^ b) & (a - b)).
+    // The mask helpers leave their result in the top bit of each lane, which
+    // _mm_movemask_pd reads directly and _mm_srli_epi64 turns into a 0/1 carry
+    struct sse2_int128
+    {
+        static __m128i borrow(__m128i a, __m128i b, __m128i d)
+        {
+            return _mm_or_si128(_mm_andnot_si128(a, b), _mm_andnot_si128(_mm_xor_si128(a, b), d));
+        }
+
+        // carry out of a + b = s: (a & b) | ((a | b) & ~s)
+        static __m128i carry(__m128i a, __m128i b, __m128i s)
+        {
+            return _mm_or_si128(_mm_and_si128(a, b), _mm_andnot_si128(s, _mm_or_si128(a, b)));
+        }
+
+        // top bit set where a < b as 128-bit values: the borrow out of the full subtraction
+        template<bool is_signed>
+        static __m128i less(__m128i alo, __m128i ahi, __m128i blo, __m128i bhi)
+        {
+            if constexpr (is_signed) {
+                const __m128i sign = _mm_set1_epi64x(static_cast<long long>(uint64_t(1) << 63));
+                ahi = _mm_xor_si128(ahi, sign);
+                bhi = _mm_xor_si128(bhi, sign);
+            }
+            const __m128i low_borrow = _mm_srli_epi64(borrow(alo, blo, _mm_sub_epi64(alo, blo)), 63);
+            return borrow(ahi, bhi, _mm_sub_epi64(_mm_sub_epi64(ahi, bhi), low_borrow));
+        }
+
+        // all-ones lanes where a == b
+        static __m128i equal(__m128i alo, __m128i ahi, __m128i blo, __m128i bhi)
+        {
+            const __m128i e = _mm_and_si128(_mm_cmpeq_epi32(alo, blo), _mm_cmpeq_epi32(ahi, bhi));
+            return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+
+        // x where the top bit of m is set, else y
+        static __m128i select(__m128i m, __m128i x, __m128i y)
+        {
+            m = _mm_shuffle_epi32(_mm_srai_epi32(m, 31), _MM_SHUFFLE(3, 3, 1, 1));
+            return _mm_or_si128(_mm_and_si128(m, x), _mm_andnot_si128(m, y));
+        }
+
+        static __m128i load(const uint64_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+        static void store(uint64_t *p, __m128i x) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), x); }
+        static uint32_t movemask(__m128i m) { return static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(m))); }
+    };
+#endif
+
+    enum class column_op { add, sub };
+
+    template<column_op op>
+    void column_arith_kernel(const uint64_t *alo, const uint64_t *ahi, const uint64_t *blo, const uint64_t *bhi,
+        uint64_t *lo, uint64_t *hi, size_t count)
+    {
+        size_t i = 0;
+
+#if USE_SSE2
+        using v = sse2_int128;
+        for (; i + 2 <= count; i += 2)
+        {
+            const __m128i xl = v::load(alo + i), xh = v::load(ahi + i), yl = v::load(blo + i), yh = v::load(bhi + i);
+            if constexpr (op == column_op::add) {
+                const __m128i rl = _mm_add_epi64(xl, yl);
+                const __m128i c = _mm_srli_epi64(v::carry(xl, yl, rl), 63);
+                v::store(lo + i, rl);
+                v::store(hi + i, _mm_add_epi64(_mm_add_epi64(xh, yh), c));
+            }
+            else {
+                const __m128i rl = _mm_sub_epi64(xl, yl);
+                const __m128i b = _mm_srli_epi64(v::borrow(xl, yl, rl), 63);
+                v::store(lo + i, rl);
+                v::store(hi + i, _mm_sub_epi64(_mm_sub_epi64(xh, yh), b));
+            }
+        }
+#endif
+
+        for (; i < count; ++i) {
+            if constexpr (op == column_op::add) { add128(alo[i], ahi[i], blo[i], bhi[i], lo[i], hi[i]); }
+            else { sub128(alo[i], ahi[i], blo[i], bhi[i], lo[i], hi[i]); }
+        }
+    }
+
+    // the low 128 bits of the product: one 64x64->128 multiply of the lower
+    // halves and the low halves of the two cross products. SSE2 only has
+    // 32x32->64 multiplies, so this stays on the scalar multiplier
+    inline void column_mul_kernel(const uint64_t *alo, const uint64_t *ahi, const uint64_t *blo, const uint64_t *bhi,
+        uint64_t *lo, uint64_t *hi, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t upper = 0;
+            const uint64_t lower = mul_extended(alo[i], blo[i], upper);
+            hi[i] = upper + alo[i] * bhi[i] + ahi[i] * blo[i];
+            lo[i] = lower;
+        }
+    }
+
+    template<cmp_op op, bool is_signed, bool scalar_rhs>
+    void column_compare_kernel(const uint64_t *alo, const uint64_t *ahi, const uint64_t *blo, const uint64_t *bhi,
+        size_t count, uint64_t *mask)
+    {
+        // gt, ge and le are lt and its negation with the operands swapped
+        auto scalar = [](uint64_t xl, uint64_t xh, uint64_t yl, uint64_t yh) {
+            if constexpr (op == cmp_op::lt) { return less128<is_signed>(xl, xh, yl, yh); }
+            else if constexpr (op == cmp_op::le) { return !less128<is_signed>(yl, yh, xl, xh); }
+            else if constexpr (op == cmp_op::eq) { return xl == yl && xh == yh; }
+            else if constexpr (op == cmp_op::ne) { return xl != yl || xh != yh; }
+            else if constexpr (op == cmp_op::gt) { return less128<is_signed>(yl, yh, xl, xh); }
+            else { return !less128<is_signed>(xl, xh, yl, yh); }
+        };
+
+        size_t i = 0;
+
+#if USE_SSE2
+        using v = sse2_int128;
+        __m128i yl = _mm_setzero_si128(), yh = _mm_setzero_si128();
+        if constexpr (scalar_rhs) {
+            yl = _mm_set1_epi64x(static_cast<long long>(*blo));
+            yh = _mm_set1_epi64x(static_cast<long long>(*bhi));
+        }
+
+        for (; i + 64 <= count; i += 64)
+        {
+            uint64_t word = 0;
+            for (int j = 0; j < 64; j += 2)
+            {
+                const __m128i xl = v::load(alo + i + j), xh = v::load(ahi + i + j);
+                if constexpr (!scalar_rhs) {
+                    yl = v::load(blo + i + j);
+                    yh = v::load(bhi + i + j);
+                }
+
+                uint32_t bits;
+                if constexpr (op == cmp_op::lt || op == cmp_op::ge) { bits = v::movemask(v::less<is_signed>(xl, xh, yl, yh)); }
+                else if constexpr (op == cmp_op::gt || op == cmp_op::le) { bits = v::movemask(v::less<is_signed>(yl, yh, xl, xh)); }
+                else { bits = v::movemask(v::equal(xl, xh, yl, yh)); }
+
+                if constexpr (op == cmp_op::ge || op == cmp_op::le || op == cmp_op::ne) {
+                    bits ^= 3;
+                }
+                word |= static_cast<uint64_t>(bits) << j;
+            }
+            mask[i / 64] = word;
+        }
+#endif
+
+        for (; i < count; i += 64)
+        {
+            uint64_t word = 0;
+            size_t block = std::min<size_t>(64, count - i);
+            for (size_t j = 0; j < block; ++j) {
+                const size_t k = scalar_rhs ? 0 : i + j;
+                word |= static_cast<uint64_t>(scalar(alo[i + j], ahi[i + j], blo[k], bhi[k])) << j;
+            }
+            mask[i / 64] = word;
+        }
+    }
+
+    // sum of the values modulo 2^128
+    inline void column_sum_kernel(const uint64_t *alo, const uint64_t *ahi, size_t count, uint64_t &lo, uint64_t &hi)
+    {
+        size_t i = 0;
+        uint64_t sl = 0, sh = 0;
+
+#if USE_SSE2
+        using v = sse2_int128;
+        if (count >= 2)
+        {
+            __m128i vl = _mm_setzero_si128(), vh = _mm_setzero_si128();
+            for (; i + 2 <= count; i += 2) {
+                const __m128i xl = v::load(alo + i);
+                const __m128i rl = _mm_add_epi64(vl, xl);
+                vh = _mm_add_epi64(_mm_add_epi64(vh, v::load(ahi + i)), _mm_srli_epi64(v::carry(vl, xl, rl), 63));
+                vl = rl;
+            }
+
+            uint64_t l[2], h[2];
+            v::store(l, vl);
+            v::store(h, vh);
+            add128(l[0], h[0], l[1], h[1], sl, sh);
+        }
+#endif
+
+        for (; i < count; ++i) {
+            add128(sl, sh, alo[i], ahi[i], sl, sh);
+        }
+        lo = sl;
+        hi = sh;
+    }
+
+    // index-free minimum or maximum of count > 0 values
+    template<bool is_signed, bool is_max>
+    void column_minmax_kernel(const uint64_t *alo, const uint64_t *ahi, size_t count, uint64_t &lo, uint64_t &hi)
+    {
+        size_t i = 0;
+        uint64_t bl = alo[0], bh = ahi[0];
+
+#if USE_SSE2
+        using v = sse2_int128;
+        if (count >= 2)
+        {
+            __m128i vl = v::load(alo), vh = v::load(ahi);
+            for (i = 2; i + 2 <= count; i += 2) {
+                const __m128i xl = v::load(alo + i), xh = v::load(ahi + i);
+                const __m128i take = is_max ? v::less<is_signed>(vl, vh, xl, xh) : v::less<is_signed>(xl, xh, vl, vh);
+                vl = v::select(take, xl, vl);
+                vh = v::select(take, xh, vh);
+            }
+
+            uint64_t l[2], h[2];
+            v::store(l, vl);
+            v::store(h, vh);
+            const bool second = is_max ? less128<is_signed>(l[0], h[0], l[1], h[1]) : less128<is_signed>(l[1], h[1], l[0], h[0]);
+            bl = second ? l[1] : l[0];
+            bh = second ? h[1] : h[0];
+        }
+#endif
+
+        for (; i < count; ++i) {
+            const bool take = is_max ? less128<is_signed>(bl, bh, alo[i], ahi[i]) : less128<is_signed>(alo[i], ahi[i], bl, bh);
+            if (take) {
+                bl = alo[i];
+                bh = ahi[i];
+            }
+        }
+        lo = bl;
+        hi = bh;
+    }
+
+    template<bool is_signed, bool is_max>
+    intbase_t<16, is_signed> column_minmax(const int128_column<is_signed> &a, thread_pool &pool)
+    {
+        if (a.size() == 0) {
+            throw std::exception("min/max of an empty column");
+        }
+
+        struct alignas(64) worker_value_t { uint64_t lo = 0, hi = 0; bool valid = false; };
+        std::vector<worker_value_t> worker_values(pool.size());
+
+        const uint64_t *alo = a.lo.data(), *ahi = a.hi.data();
+        pool.parallel_for(0, a.size(), column_grain, [&](size_t begin, size_t end, unsigned worker) {
+            uint64_t lo, hi;
+            column_minmax_kernel<is_signed, is_max>(alo + begin, ahi + begin, end - begin, lo, hi);
+
+            worker_value_t &w = worker_values[worker];
+            const bool take = !w.valid || (is_max ? less128<is_signed>(w.lo, w.hi, lo, hi) : less128<is_signed>(lo, hi, w.lo, w.hi));
+            if (take) {
+                w.lo = lo;
+                w.hi = hi;
+                w.valid = true;
+            }
+        });
+
+        worker_value_t r;
+        for (auto &w : worker_values) {
+            if (w.valid && (!r.valid || (is_max ? less128<is_signed>(r.lo, r.hi, w.lo, w.hi) : less128<is_signed>(w.lo, w.hi, r.lo, r.hi)))) {
+                r = w;
+            }
+        }
+        return details::bit_cast<intbase_t<16, is_signed>>(std::array<uint64_t, 2>{ r.lo, r.hi });
+    }
+}
+
+namespace batch
+{
+    //
+    // arithmetic on int128 columns: out[i] = a[i] op b[i], wrapping modulo 2^128.
+    // out is resized to the length of a and may be a or b
+    //
+
+#define MAKE_COLUMN_ARITH(name, kernel)                                                                             \
+    template<bool is_signed>                                                                                        \
+    void name(const int128_column<is_signed> &a, const int128_column<is_signed> &b, int128_column<is_signed> &out,  \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        if (b.size() != a.size()) {                                                                                 \
+            throw std::exception("column lengths differ");                                                          \
+        }                                                                                                           \
+        out.resize(a.size());                                                                                       \
+        const uint64_t *alo = a.lo.data(), *ahi = a.hi.data(), *blo = b.lo.data(), *bhi = b.hi.data();              \
+        uint64_t *lo = out.lo.data(), *hi = out.hi.data();                                                          \
+        pool.parallel_for(0, a.size(), details::column_grain, [=](size_t begin, size_t end, unsigned) {             \
+            details::kernel(alo + begin, ahi + begin, blo + begin, bhi + begin, lo + begin, hi + begin, end - begin); \
+        });                                                                                                         \
+    }                                                                                                               \
+
+    MAKE_COLUMN_ARITH(add, column_arith_kernel<details::column_op::add>)
+    MAKE_COLUMN_ARITH(sub, column_arith_kernel<details::column_op::sub>)
+    MAKE_COLUMN_ARITH(mul, column_mul_kernel)
+
+#undef MAKE_COLUMN_ARITH
+
+    //
+    // relational predicates on int128 columns: column-column and column-scalar,
+    // mask holds mask_words(a.size()) words
+    //
+
+#define MAKE_COLUMN_COMPARE(name)                                                                                   \
+    template<bool is_signed>                                                                                        \
+    void name(const int128_column<is_signed> &a, const int128_column<is_signed> &b, uint64_t *mask,                 \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        if (b.size() != a.size()) {                                                                                 \
+            throw std::exception("column lengths differ");                                                          \
+        }                                                                                                           \
+        const uint64_t *alo = a.lo.data(), *ahi = a.hi.data(), *blo = b.lo.data(), *bhi = b.hi.data();              \
+        pool.parallel_for(0, a.size(), details::column_grain, [=](size_t begin, size_t end, unsigned) {             \
+            details::column_compare_kernel<details::cmp_op::name, is_signed, false>(alo + begin, ahi + begin,       \
+                blo + begin, bhi + begin, end - begin, mask + begin / 64);                                          \
+        });                                                                                                         \
+    }                                                                                                               \
+    template<bool is_signed>                                                                                        \
+    void name(const int128_column<is_signed> &a, intbase_t<16, is_signed> b, uint64_t *mask,                        \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        const auto halves = details::bit_cast<std::array<uint64_t, 2>>(b);                                          \
+        const uint64_t *alo = a.lo.data(), *ahi = a.hi.data();                                                      \
+        pool.parallel_for(0, a.size(), details::column_grain, [=](size_t begin, size_t end, unsigned) {             \
+            details::column_compare_kernel<details::cmp_op::name, is_signed, true>(alo + begin, ahi + begin,        \
+                &halves[0], &halves[1], end - begin, mask + begin / 64);                                            \
+        });                                                                                                         \
+    }                                                                                                               \
+
+    MAKE_COLUMN_COMPARE(lt)
+    MAKE_COLUMN_COMPARE(le)
+    MAKE_COLUMN_COMPARE(eq)
+    MAKE_COLUMN_COMPARE(ne)
+    MAKE_COLUMN_COMPARE(gt)
+    MAKE_COLUMN_COMPARE(ge)
+
+#undef MAKE_COLUMN_COMPARE
+
+    //
+    // reductions
+    //
+
+    // sum modulo 2^128; the partial sums of each worker are merged once all
+    // chunks are done, so the result does not depend on the thread count
+    template<bool is_signed>
+    intbase_t<16, is_signed> sum(const int128_column<is_signed> &a, thread_pool &pool = default_thread_pool())
+    {
+        struct alignas(64) worker_sum_t { uint64_t lo = 0, hi = 0; };
+        std::vector<worker_sum_t> worker_sums(pool.size());
+
+        const uint64_t *alo = a.lo.data(), *ahi = a.hi.data();
+        pool.parallel_for(0, a.size(), details::column_grain, [&](size_t begin, size_t end, unsigned worker) {
+            uint64_t lo, hi;
+            details::column_sum_kernel(alo + begin, ahi + begin, end - begin, lo, hi);
+            details::add128(worker_sums[worker].lo, worker_sums[worker].hi, lo, hi, worker_sums[worker].lo, worker_sums[worker].hi);
+        });
+
+        uint64_t lo = 0, hi = 0;
+        for (auto &s : worker_sums) {
+            details::add128(lo, hi, s.lo, s.hi, lo, hi);
+        }
+        return details::bit_cast<intbase_t<16, is_signed>>(std::array<uint64_t, 2>{ lo, hi });
+    }
+
+    // smallest and largest value of a non-empty column
+    template<bool is_signed>
+    intbase_t<16, is_signed> min(const int128_column<is_signed> &a, thread_pool &pool = default_thread_pool())
+    {
+        return details::column_minmax<is_signed, false>(a, pool);
+    }
+
+    template<bool is_signed>
+    intbase_t<16, is_signed> max(const int128_column<is_signed> &a, thread_pool &pool = default_thread_pool())
+    {
+        return details::column_minmax<is_signed, true>(a, pool);
+    }
+}
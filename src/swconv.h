@@ -0,0 +1,194 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "swfp.h"
+#include "swbatch.h"
+#include "swexec.h"
+#include "swfile.h"
+
+//
+// Streaming conversion of raw floating-point files
+//
+// The source is memory mapped and converted in windows of a few tens of
+// megabytes. Each window is split into batch-sized chunks on the thread pool;
+// a chunk is converted into a per-worker staging buffer and copied to the
+// mapped destination with non-temporal stores, so the output does not evict
+// the input from the caches. Once a window is done its destination pages are
+// flushed and both ranges are released, which keeps the working set bounded
+// and lets files larger than physical memory stream through.
+//
+// Files hold packed values in native byte order with no header.
+//
+
+// bytes of source data converted between flush/release steps
+constexpr size_t convert_window_bytes = size_t(64) << 20;
+
+struct convert_stats
+{
+    uint64_t count = 0;             // values converted
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    double seconds = 0;
+    fp_flags flags = fp_flags::none;
+
+    // bytes read plus bytes written per second, in units of 10^9 bytes
+    double gigabytes_per_second() const
+    {
+        return seconds > 0 ? static_cast<double>(bytes_read + bytes_written) / seconds / 1e9 : 0;
+    }
+};
+
+namespace details
+{
+    // copy to memory that will not be read again soon, bypassing the caches
+    inline void stream_copy(void *dst, const void *src, size_t bytes)
+    {
+        uint8_t *d = static_cast<uint8_t *>(dst);
+        const uint8_t *s = static_cast<const uint8_t *>(src);
+
+#if USE_SSE2
+        size_t head = std::min(bytes, (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15);
+        memcpy(d, s, head);
+        d += head;
+        s += head;
+        bytes -= head;
+
+        for (; bytes >= 16; bytes -= 16, d += 16, s += 16) {
+            _mm_stream_si128(reinterpret_cast<__m128i *>(d), _mm_loadu_si128(reinterpret_cast<const __m128i *>(s)));
+        }
+        _mm_sfence();
+#endif
+
+        memcpy(d, s, bytes);
+    }
+}
+
+// convert the file at `src_path` holding values of format `from` into a new
+// file at `dst_path` holding values of format `to`
+template<fp_format from, fp_format to>
+convert_stats convert_file(const std::string &src_path, const std::string &dst_path, thread_pool &pool = default_thread_pool())
+{
+    using src_t = floatbase_t<from>;
+    using dst_t = floatbase_t<to>;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    mapped_file src = mapped_file::open(src_path);
+    if (src.size() % sizeof(src_t) != 0) {
+        throw std::exception("input size is not a multiple of the value size");
+    }
+
+    const uint64_t count = src.size() / sizeof(src_t);
+    mapped_file dst = mapped_file::create(dst_path, count * sizeof(dst_t));
+
+    const src_t *in = reinterpret_cast<const src_t *>(src.data());
+    dst_t *out = reinterpret_cast<dst_t *>(dst.data());
+
+    // grain-sized chunks keep the destination of each chunk 16-byte aligned
+    const size_t grain = details::batch_grain<from>();
+    const size_t window = std::max<size_t>(1, convert_window_bytes / sizeof(src_t) / grain) * grain;
+
+    struct alignas(64) worker_state_t
+    {
+        fp_flags flags = fp_flags::none;
+        std::vector<dst_t> staging;
+    };
+    std::vector<worker_state_t> workers(pool.size());
+    for (auto &w : workers) {
+        w.staging.resize(grain);
+    }
+
+    for (uint64_t window_begin = 0; window_begin < count; window_begin += window)
+    {
+        const size_t window_end = static_cast<size_t>(std::min<uint64_t>(count, window_begin + window));
+
+        pool.parallel_for(static_cast<size_t>(window_begin), window_end, grain, [&](size_t begin, size_t end, unsigned worker) {
+            if constexpr (from == to) {
+                (worker); // copies need no per-worker state
+                details::stream_copy(out + begin, in + begin, (end - begin) * sizeof(dst_t));
+            }
+            else {
+                worker_state_t &state = workers[worker];
+                state.flags |= details::convert_kernel<from, to>(in + begin, state.staging.data(), end - begin);
+                details::stream_copy(out + begin, state.staging.data(), (end - begin) * sizeof(dst_t));
+            }
+        });
+
+        const uint64_t window_count = window_end - window_begin;
+        dst.flush(window_begin * sizeof(dst_t), window_count * sizeof(dst_t));
+        dst.release(window_begin * sizeof(dst_t), window_count * sizeof(dst_t));
+        src.release(window_begin * sizeof(src_t), window_count * sizeof(src_t));
+    }
+
+    convert_stats stats;
+    for (auto &w : workers) {
+        stats.flags |= w.flags;
+    }
+
+    stats.count = count;
+    stats.bytes_read = src.size();
+    stats.bytes_written = dst.size();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+namespace details
+{
+    template<fp_format from>
+    convert_stats convert_file_from(const std::string &src_path, const std::string &dst_path, fp_format to, thread_pool &pool)
+    {
+        switch (to)
+        {
+        case fp_format::float8_e5m2: return convert_file<from, fp_format::float8_e5m2>(src_path, dst_path, pool);
+        case fp_format::bfloat16: return convert_file<from, fp_format::bfloat16>(src_path, dst_path, pool);
+        case fp_format::binary16: return convert_file<from, fp_format::binary16>(src_path, dst_path, pool);
+        case fp_format::binary32: return convert_file<from, fp_format::binary32>(src_path, dst_path, pool);
+        case fp_format::binary64: return convert_file<from, fp_format::binary64>(src_path, dst_path, pool);
+        default: throw std::exception("unsupported destination format");
+        }
+    }
+}
+
+// convert_file with the formats chosen at runtime
+inline convert_stats convert_file(const std::string &src_path, fp_format from, const std::string &dst_path, fp_format to, thread_pool &pool = default_thread_pool())
+{
+    switch (from)
+    {
+    case fp_format::float8_e5m2: return details::convert_file_from<fp_format::float8_e5m2>(src_path, dst_path, to, pool);
+    case fp_format::bfloat16: return details::convert_file_from<fp_format::bfloat16>(src_path, dst_path, to, pool);
+    case fp_format::binary16: return details::convert_file_from<fp_format::binary16>(src_path, dst_path, to, pool);
+    case fp_format::binary32: return details::convert_file_from<fp_format::binary32>(src_path, dst_path, to, pool);
+    case fp_format::binary64: return details::convert_file_from<fp_format::binary64>(src_path, dst_path, to, pool);
+    default: throw std::exception("unsupported source format");
+    }
+}
+
+// parse the short format names used by the conversion tool:
+// fp8 (e5m2), bf16, fp16, fp32, fp64
+inline bool parse_fp_format(const std::string &name, fp_format &format)
+{
+    static const struct { const char *name; fp_format format; } names[] = {
+        { "fp8", fp_format::float8_e5m2 },
+        { "e5m2", fp_format::float8_e5m2 },
+        { "bf16", fp_format::bfloat16 },
+        { "fp16", fp_format::binary16 },
+        { "fp32", fp_format::binary32 },
+        { "fp64", fp_format::binary64 },
+    };
+
+    for (auto &n : names) {
+        if (name == n.name) {
+            format = n.format;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,414 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "swfp.h"
+#include "swunpacked.h"
+#include "swbatch.h"
+#include "swexec.h"
+
+//
+// Double-double and quad-double arithmetic
+//
+// two_sum, fast_two_sum and two_product are the error-free transformations:
+// each returns the rounded result of an operation and the exact rounding error
+// through `error`, so that result + error is the exact value. Products use the
+// single-rounding fma of unpacked_t and are exact unless the error underflows.
+//
+// dd_real<format> is an unevaluated sum hi + lo of two `format` values with
+// |lo| <= ulp(hi) / 2, about 2 * precision bits: 106 bits for binary64 at a
+// fraction of the cost of a soft binary128. qd_real<format> has four
+// components and about 4 * precision bits. Both follow the algorithms of the QD
+// library by Hida, Li and Bailey; the exponent range is the one of `format`,
+// and infinities and NaNs are carried in the leading component only.
+//
+// Defining SWFP_DD_FLOAT128 makes float128_t a double-double, for code that
+// needs the precision of binary128 more than its range.
+//
+
+namespace details
+{
+    template<fp_format format>
+    constexpr bool is_finite(floatbase_t<format> x)
+    {
+        const auto exponent_bits = floatbase_t<format>::infinity().to_bitstring();
+        return (x.to_bitstring() & exponent_bits) != exponent_bits;
+    }
+}
+
+//
+// error-free transformations
+//
+
+// a + b, exact error
+template<fp_format format>
+constexpr floatbase_t<format> two_sum(floatbase_t<format> a, floatbase_t<format> b, floatbase_t<format> &error)
+{
+    const auto sum = a + b;
+    const auto bb = sum - a;
+    error = (a - (sum - bb)) + (b - bb);
+    return sum;
+}
+
+// a + b, exact error if |a| >= |b| or a is zero
+template<fp_format format>
+constexpr floatbase_t<format> fast_two_sum(floatbase_t<format> a, floatbase_t<format> b, floatbase_t<format> &error)
+{
+    const auto sum = a + b;
+    error = b - (sum - a);
+    return sum;
+}
+
+// a * b, exact error unless it underflows
+template<fp_format format>
+constexpr floatbase_t<format> two_product(floatbase_t<format> a, floatbase_t<format> b, floatbase_t<format> &error)
+{
+    const auto product = a * b;
+    error = fma(unpacked_t<format>(a), unpacked_t<format>(b), unpacked_t<format>(-product)).pack();
+    return product;
+}
+
+//
+// double-double
+//
+
+template<fp_format format>
+class dd_real
+{
+public:
+    using packed_t = floatbase_t<format>;
+
+    dd_real() = default;
+    constexpr dd_real(packed_t x) : hi(x), lo(packed_t::zero()) { }
+
+    // hi + lo with |lo| <= ulp(hi) / 2
+    constexpr dd_real(packed_t hi, packed_t lo) : hi(hi), lo(lo) { }
+
+    explicit constexpr dd_real(double x) : dd_real(packed_t(x)) { }
+
+    // the nearest `format` value
+    explicit constexpr operator packed_t() const { return hi; }
+    explicit constexpr operator double() const { return static_cast<double>(hi) + static_cast<double>(lo); }
+
+    constexpr dd_real operator-() const { return { -hi, -lo }; }
+
+    constexpr dd_real operator+(const dd_real &b) const
+    {
+        packed_t e1, e2;
+        auto s = two_sum(hi, b.hi, e1);
+        if (!details::is_finite(s)) {
+            return s;
+        }
+        auto t = two_sum(lo, b.lo, e2);
+        e1 = e1 + t;
+        s = fast_two_sum(s, e1, e1);
+        e1 = e1 + e2;
+        s = fast_two_sum(s, e1, e1);
+        return { s, e1 };
+    }
+
+    constexpr dd_real operator-(const dd_real &b) const { return *this + (-b); }
+
+    constexpr dd_real operator*(const dd_real &b) const
+    {
+        packed_t e;
+        auto p = two_product(hi, b.hi, e);
+        if (!details::is_finite(p)) {
+            return p;
+        }
+        e = e + (hi * b.lo + lo * b.hi);
+        p = fast_two_sum(p, e, e);
+        return { p, e };
+    }
+
+    constexpr dd_real operator/(const dd_real &b) const
+    {
+        // long division, a quotient digit per step
+        auto q1 = hi / b.hi;
+        if (!details::is_finite(q1)) {
+            return q1;
+        }
+        auto r = *this - b * dd_real(q1);
+        auto q2 = r.hi / b.hi;
+        r = r - b * dd_real(q2);
+        auto q3 = r.hi / b.hi;
+
+        packed_t e;
+        q1 = fast_two_sum(q1, q2, e);
+        return dd_real(q1, e) + dd_real(q3);
+    }
+
+    constexpr dd_real &operator+=(const dd_real &b) { return *this = *this + b; }
+    constexpr dd_real &operator-=(const dd_real &b) { return *this = *this - b; }
+    constexpr dd_real &operator*=(const dd_real &b) { return *this = *this * b; }
+    constexpr dd_real &operator/=(const dd_real &b) { return *this = *this / b; }
+
+    bool operator==(const dd_real &b) const { return hi == b.hi && lo == b.lo; }
+    bool operator!=(const dd_real &b) const { return !operator==(b); }
+    bool operator<(const dd_real &b) const { return hi < b.hi || (hi == b.hi && lo < b.lo); }
+    bool operator<=(const dd_real &b) const { return hi < b.hi || (hi == b.hi && lo <= b.lo); }
+    bool operator>(const dd_real &b) const { return b < *this; }
+    bool operator>=(const dd_real &b) const { return b <= *this; }
+
+    packed_t hi;
+    packed_t lo;
+};
+
+template<fp_format format>
+constexpr dd_real<format> sqrt(const dd_real<format> &a)
+{
+    using packed_t = floatbase_t<format>;
+
+    if (a.hi == packed_t::zero() || !details::is_finite(a.hi)) {
+        return a.hi < packed_t::zero() ? packed_t::indeterminate_nan() : a.hi;
+    }
+    if (a.hi < packed_t::zero()) {
+        return packed_t::indeterminate_nan();
+    }
+
+    // one Newton step from s: s + (a - s^2) / 2s, with s^2 exact
+    const auto s = sqrt(a.hi);
+    packed_t e;
+    const auto square = two_product(s, s, e);
+    return dd_real<format>(s) + dd_real<format>((a - dd_real<format>(square, e)).hi / (s + s));
+}
+
+//
+// quad-double
+//
+
+template<fp_format format>
+class qd_real
+{
+public:
+    using packed_t = floatbase_t<format>;
+
+    qd_real() = default;
+    constexpr qd_real(packed_t x) : x{ x, packed_t::zero(), packed_t::zero(), packed_t::zero() } { }
+    constexpr qd_real(const dd_real<format> &d) : x{ d.hi, d.lo, packed_t::zero(), packed_t::zero() } { }
+
+    // x0 + x1 + x2 + x3, each component at most half an ulp of the previous
+    constexpr qd_real(packed_t x0, packed_t x1, packed_t x2, packed_t x3) : x{ x0, x1, x2, x3 } { }
+
+    explicit constexpr qd_real(double x) : qd_real(packed_t(x)) { }
+
+    explicit constexpr operator packed_t() const { return x[0]; }
+    explicit constexpr operator dd_real<format>() const { return { x[0], x[1] }; }
+    explicit constexpr operator double() const { return static_cast<double>(x[0]) + static_cast<double>(x[1]); }
+
+    constexpr qd_real operator-() const { return { -x[0], -x[1], -x[2], -x[3] }; }
+
+    // the components of b go in one at a time, each addition is error-free up
+    // to the final renormalization
+    constexpr qd_real operator+(const qd_real &b) const
+    {
+        qd_real r = *this;
+        for (int i = 0; i < 4; ++i) {
+            r = add_component(r, b.x[i]);
+        }
+        return r;
+    }
+
+    constexpr qd_real operator-(const qd_real &b) const { return *this + (-b); }
+
+    // the products x[i] * b.x[j] with i + j <= 3 and the rounding errors of
+    // those with i + j <= 2, smallest terms last
+    constexpr qd_real operator*(const qd_real &b) const
+    {
+        const packed_t leading = x[0] * b.x[0];
+        if (!details::is_finite(leading)) {
+            return leading;
+        }
+
+        qd_real r(packed_t::zero());
+        packed_t errors[3];
+        int error_count = 0;
+
+        for (int level = 0; level < 4; ++level) {
+            packed_t next_errors[3];
+            int next_count = 0;
+            for (int i = 0; i <= level; ++i) {
+                packed_t e;
+                r = add_component(r, two_product(x[i], b.x[level - i], e));
+                if (level < 3 && next_count < 3) {
+                    next_errors[next_count++] = e;
+                }
+            }
+            for (int k = 0; k < error_count; ++k) {
+                r = add_component(r, errors[k]);
+            }
+            for (int k = 0; k < next_count; ++k) {
+                errors[k] = next_errors[k];
+            }
+            error_count = next_count;
+        }
+        return r;
+    }
+
+    constexpr qd_real operator/(const qd_real &b) const
+    {
+        // long division, a quotient digit per step
+        packed_t q[5];
+        q[0] = x[0] / b.x[0];
+        if (!details::is_finite(q[0])) {
+            return q[0];
+        }
+
+        qd_real r = *this - b * qd_real(q[0]);
+        for (int i = 1; i < 5; ++i) {
+            q[i] = r.x[0] / b.x[0];
+            if (i < 4) {
+                r = r - b * qd_real(q[i]);
+            }
+        }
+        return renormalize(q[0], q[1], q[2], q[3], q[4]);
+    }
+
+    constexpr qd_real &operator+=(const qd_real &b) { return *this = *this + b; }
+    constexpr qd_real &operator-=(const qd_real &b) { return *this = *this - b; }
+    constexpr qd_real &operator*=(const qd_real &b) { return *this = *this * b; }
+    constexpr qd_real &operator/=(const qd_real &b) { return *this = *this / b; }
+
+    bool operator==(const qd_real &b) const { return x[0] == b.x[0] && x[1] == b.x[1] && x[2] == b.x[2] && x[3] == b.x[3]; }
+    bool operator!=(const qd_real &b) const { return !operator==(b); }
+    bool operator<(const qd_real &b) const
+    {
+        for (int i = 0; i < 3; ++i) {
+            if (x[i] != b.x[i]) {
+                return x[i] < b.x[i];
+            }
+        }
+        return x[3] < b.x[3];
+    }
+    bool operator<=(const qd_real &b) const { return !(b < *this); }
+    bool operator>(const qd_real &b) const { return b < *this; }
+    bool operator>=(const qd_real &b) const { return !(*this < b); }
+
+    // five overlapping components to four non-overlapping ones
+    static constexpr qd_real renormalize(packed_t c0, packed_t c1, packed_t c2, packed_t c3, packed_t c4)
+    {
+        if (!details::is_finite(c0)) {
+            return c0;
+        }
+
+        packed_t s = fast_two_sum(c3, c4, c4);
+        s = fast_two_sum(c2, s, c3);
+        s = fast_two_sum(c1, s, c2);
+        c0 = fast_two_sum(c0, s, c1);
+
+        // compress from the top, skipping components that became zero
+        packed_t in[4] = { c1, c2, c3, c4 };
+        packed_t out[4] = { c0, packed_t::zero(), packed_t::zero(), packed_t::zero() };
+        int k = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (k == 3) {
+                out[3] = out[3] + in[i];
+                continue;
+            }
+
+            packed_t e;
+            out[k] = fast_two_sum(out[k], in[i], e);
+            if (e != packed_t::zero()) {
+                out[++k] = e;
+            }
+        }
+        return { out[0], out[1], out[2], out[3] };
+    }
+
+    packed_t x[4];
+
+private:
+
+    // a + b, the errors of the component sums carried down
+    static constexpr qd_real add_component(const qd_real &a, packed_t b)
+    {
+        packed_t e;
+        const packed_t c0 = two_sum(a.x[0], b, e);
+        if (!details::is_finite(c0)) {
+            return c0;
+        }
+        const packed_t c1 = two_sum(a.x[1], e, e);
+        const packed_t c2 = two_sum(a.x[2], e, e);
+        const packed_t c3 = two_sum(a.x[3], e, e);
+        return renormalize(c0, c1, c2, c3, e);
+    }
+};
+
+template<fp_format format>
+constexpr qd_real<format> sqrt(const qd_real<format> &a)
+{
+    using packed_t = floatbase_t<format>;
+
+    if (a.x[0] == packed_t::zero() || !details::is_finite(a.x[0])) {
+        return a.x[0] < packed_t::zero() ? packed_t::indeterminate_nan() : a.x[0];
+    }
+    if (a.x[0] < packed_t::zero()) {
+        return packed_t::indeterminate_nan();
+    }
+
+    // Newton iterations for 1 / sqrt(a), each doubles the correct bits:
+    // y += y * (1/2 - a/2 * y^2)
+    const qd_real<format> half(packed_t(0.5));
+    const qd_real<format> h = a * half;
+    qd_real<format> y(packed_t(1.0) / sqrt(a.x[0]));
+    for (int i = 0; i < 3; ++i) {
+        y = y + y * (half - h * y * y);
+    }
+    return a * y;
+}
+
+//
+// element-wise kernels: out[i] = a[i] op b[i], out[i] = sqrt(a[i])
+//
+
+namespace batch
+{
+#define MAKE_BATCH_MULTI_ARITH(name, op)                                                                            \
+    template<fp_format format>                                                                                      \
+    void name(const dd_real<format> *a, const dd_real<format> *b, dd_real<format> *out, size_t count,               \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        pool.parallel_for(0, count, details::batch_grain<format>(), [=](size_t begin, size_t end, unsigned) {       \
+            for (size_t i = begin; i < end; ++i) { out[i] = a[i] op b[i]; }                                         \
+        });                                                                                                         \
+    }                                                                                                               \
+    template<fp_format format>                                                                                      \
+    void name(const qd_real<format> *a, const qd_real<format> *b, qd_real<format> *out, size_t count,               \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        pool.parallel_for(0, count, details::batch_grain<format>(), [=](size_t begin, size_t end, unsigned) {       \
+            for (size_t i = begin; i < end; ++i) { out[i] = a[i] op b[i]; }                                         \
+        });                                                                                                         \
+    }                                                                                                               \
+
+    MAKE_BATCH_MULTI_ARITH(add, +)
+    MAKE_BATCH_MULTI_ARITH(sub, -)
+    MAKE_BATCH_MULTI_ARITH(mul, *)
+    MAKE_BATCH_MULTI_ARITH(div, /)
+
+#undef MAKE_BATCH_MULTI_ARITH
+
+    template<fp_format format>
+    void sqrt(const dd_real<format> *a, dd_real<format> *out, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        pool.parallel_for(0, count, details::batch_grain<format>(), [=](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) { out[i] = ::sqrt(a[i]); }
+        });
+    }
+
+    template<fp_format format>
+    void sqrt(const qd_real<format> *a, qd_real<format> *out, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        pool.parallel_for(0, count, details::batch_grain<format>(), [=](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) { out[i] = ::sqrt(a[i]); }
+        });
+    }
+}
+
+using dd32_t = dd_real<fp_format::binary32>;
+using dd64_t = dd_real<fp_format::binary64>;
+using qd64_t = qd_real<fp_format::binary64>;
+
+#if defined(SWFP_DD_FLOAT128)
+using float128_t = dd64_t;
+#endif
@@ -0,0 +1,194 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "swint.h"
+
+//
+// Division by invariant integers
+//
+// divider<T> precomputes a magic multiplier and shifts for one divisor
+// (Granlund and Montgomery, "Division by invariant integers using
+// multiplication"), after which a quotient is the high half of a
+// multiply_extended, an add and two shifts:
+//
+//      unsigned:  t = mulhi(magic, n)
+//                 q = (t + ((n - t) >> 1)) >> (l - 1)        l = ceil(log2 d)
+//
+//      signed:    q = ((n + mulsh(magic, n)) >> (l - 1)) - (n < 0 ? -1 : 0)
+//                 negated when d < 0                          l = ceil(log2 |d|)
+//
+// The magic numbers fit the width of T for every divisor, so there is no
+// special case for powers of 2 or for 1. Quotients truncate and remainders
+// have the sign of the dividend as for the built-in operators:
+//
+//      divider<uint128sw_t> by_ten(uint128sw_t(10));
+//      q = n / by_ten;  r = n % by_ten;
+//
+// T is any built-in integer or intbase_t. The magic number is found with one
+// double-width division when the divider is made.
+//
+
+namespace details
+{
+    template<typename int_t, typename = void> struct divider_traits;
+
+    template<typename int_t>
+    struct divider_traits<int_t, std::enable_if_t<std::is_integral_v<int_t>>>
+    {
+        static constexpr bool is_signed = std::is_signed_v<int_t>;
+        using uint_t = std::make_unsigned_t<int_t>;
+        using sint_t = std::make_signed_t<int_t>;
+        using wide_t = selector_t<(sizeof(int_t) < sizeof(uint64_t)), make_integral_t<2 * sizeof(int_t), false>, intbase_t<16, false>>;
+
+        static uint_t mulhi(uint_t a, uint_t b)
+        {
+            uint_t hi = 0;
+            mul_extended(a, b, hi);
+            return hi;
+        }
+
+        static bool highest_bit(unsigned long *index, uint_t x) { return reverse_bit_scan(index, x); }
+        static uint_t as_unsigned(sint_t x) { return static_cast<uint_t>(x); }
+        static sint_t as_signed(uint_t x) { return static_cast<sint_t>(x); }
+    };
+
+    template<size_t byte_size, bool is_signed_, typename layout>
+    struct divider_traits<intbase_t<byte_size, is_signed_, layout>>
+    {
+        static constexpr bool is_signed = is_signed_;
+        using uint_t = intbase_t<byte_size, false, layout>;
+        using sint_t = intbase_t<byte_size, true, layout>;
+        using wide_t = intbase_t<2 * byte_size, false>;
+
+        static uint_t mulhi(uint_t a, uint_t b)
+        {
+            uint_t hi;
+            uint_t::multiply_extended(a, b, hi);
+            return hi;
+        }
+
+        static bool highest_bit(unsigned long *index, uint_t x) { return uint_t::reverse_bit_scan(index, x); }
+        static uint_t as_unsigned(sint_t x) { return bit_cast<uint_t>(x); }
+        static sint_t as_signed(uint_t x) { return bit_cast<sint_t>(x); }
+    };
+}
+
+template<typename int_t>
+class divider
+{
+    using traits = details::divider_traits<int_t>;
+    using uint_t = typename traits::uint_t;
+    using sint_t = typename traits::sint_t;
+    using wide_t = typename traits::wide_t;
+
+    static constexpr int bitsize = sizeof(int_t) * 8;
+
+public:
+
+    explicit divider(int_t divisor) : d(divisor)
+    {
+        if (!divisor) {
+            // handle divide-by-zero
+            details::divide_by_zero();
+        }
+
+        if constexpr (traits::is_signed) {
+            // l = max(ceil(log2 |d|), 1), magic = 2^(N + l - 1) / |d| + 1 - 2^N
+            const uint_t magnitude = divisor < int_t(0) ? uint_t(0) - traits::as_unsigned(divisor) : traits::as_unsigned(divisor);
+            const int l = ceil_log2(magnitude) > 1 ? ceil_log2(magnitude) : 1;
+            magic = narrow((wide_t(1) << (bitsize + l - 1)) / widen(magnitude) + wide_t(1));
+            shift = l - 1;
+            negative = divisor < int_t(0);
+        }
+        else {
+            // l = ceil(log2 d), magic = 2^N (2^l - d) / d + 1
+            const int l = ceil_log2(divisor);
+            magic = narrow((((wide_t(1) << l) - widen(divisor)) << bitsize) / widen(divisor) + wide_t(1));
+            shift = l;
+        }
+    }
+
+    int_t divisor() const { return d; }
+
+    int_t divide(int_t n) const
+    {
+        if constexpr (traits::is_signed) {
+            // mulsh(m, n) from the unsigned high product
+            const uint_t un = traits::as_unsigned(n);
+            uint_t high = traits::mulhi(magic, un);
+            if (traits::as_signed(magic) < sint_t(0)) {
+                high = static_cast<uint_t>(high - un);
+            }
+            if (n < int_t(0)) {
+                high = static_cast<uint_t>(high - magic);
+            }
+
+            const sint_t q0 = traits::as_signed(static_cast<uint_t>(un + high)) >> shift;
+            uint_t q = traits::as_unsigned(q0);
+            if (n < int_t(0)) {
+                q = static_cast<uint_t>(q + uint_t(1));
+            }
+            if (negative) {
+                q = static_cast<uint_t>(uint_t(0) - q);
+            }
+            return traits::as_signed(q);
+        }
+        else {
+            const uint_t t = traits::mulhi(magic, n);
+            if (shift == 0) {
+                return static_cast<uint_t>(t + n);
+            }
+            return static_cast<uint_t>(static_cast<uint_t>(t + static_cast<uint_t>(static_cast<uint_t>(n - t) >> 1)) >> (shift - 1));
+        }
+    }
+
+    int_t remainder(int_t n) const
+    {
+        return static_cast<int_t>(n - static_cast<int_t>(divide(n) * d));
+    }
+
+    friend int_t operator/(int_t n, const divider &d) { return d.divide(n); }
+    friend int_t operator%(int_t n, const divider &d) { return d.remainder(n); }
+
+private:
+
+    // ceil(log2 x) for x > 0
+    static int ceil_log2(uint_t x)
+    {
+        unsigned long index = 0;
+        if (!traits::highest_bit(&index, static_cast<uint_t>(x - uint_t(1)))) {
+            return 0;
+        }
+        return static_cast<int>(index) + 1;
+    }
+
+    // x zero-extended to the double width, and the low half of a double-width value
+    static wide_t widen(uint_t x)
+    {
+        if constexpr (std::is_integral_v<wide_t>) {
+            return static_cast<wide_t>(x);
+        }
+        else {
+            uint8_t bytes[sizeof(wide_t)] = {};
+            memcpy(bytes, &x, sizeof(x));
+            return details::bit_cast<wide_t>(bytes);
+        }
+    }
+
+    static uint_t narrow(wide_t x)
+    {
+        uint_t r;
+        memcpy(&r, &x, sizeof(r));
+        return r;
+    }
+
+    int_t d;
+    uint_t magic;
+    int shift = 0;
+    bool negative = false;
+};
@@ -0,0 +1,294 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+//
+// Work-stealing thread pool for batch kernels
+//
+// parallel_for splits [begin, end) into grain-sized chunks and deals contiguous
+// runs of chunks to per-worker deques. Workers take chunks from the front of
+// their own deque and steal from the back of the others once theirs is empty.
+// The calling thread takes part as the last worker. If a chunk throws, the
+// chunks not yet started are skipped and the first exception is rethrown on
+// the calling thread once every worker is done with the job.
+//
+
+class thread_pool
+{
+public:
+
+    // threads == 0 uses one worker per hardware thread
+    explicit thread_pool(unsigned threads = 0, bool pin_threads = false)
+    {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        worker_count = threads;
+        queues.reset(new work_queue[worker_count]);
+
+        // the calling thread is the last worker, spawn the rest
+        for (unsigned i = 0; i + 1 < worker_count; ++i) {
+            workers.emplace_back([this, i] { worker_loop(i); });
+            if (pin_threads) {
+                pin_thread(workers.back(), i);
+            }
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(state_lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    // number of workers, including the calling thread
+    unsigned size() const { return worker_count; }
+
+    // call fn(chunk_begin, chunk_end, worker) for every chunk of [begin, end).
+    // `worker` is in [0, size()) and no two concurrent calls share a worker index,
+    // so it can select per-worker state without locking
+    template<typename fn_t>
+    void parallel_for(size_t begin, size_t end, size_t grain, fn_t &&fn)
+    {
+        if (end <= begin) {
+            return;
+        }
+
+        grain = std::max<size_t>(grain, 1);
+        const size_t chunks = (end - begin + grain - 1) / grain;
+
+        // calls nested inside one of our own chunks run inline on that worker
+        worker_info *caller = current_worker();
+        if (caller && caller->pool == this) {
+            for (size_t b = begin; b < end; b += grain) {
+                fn(b, std::min(b + grain, end), caller->index);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> job_guard(job_lock);
+
+        // the calling thread is the last worker while the job runs
+        worker_info self{ this, worker_count - 1 };
+        worker_scope scope(&self);
+
+        if (chunks == 1 || worker_count == 1)
+        {
+            for (size_t b = begin; b < end; b += grain) {
+                fn(b, std::min(b + grain, end), self.index);
+            }
+        }
+        else
+        {
+            std::function<void(size_t, size_t, unsigned)> body = std::ref(fn);
+            job = &body;
+            failed.store(false);
+            pending.store(chunks);
+
+            // deal contiguous runs of chunks so each worker starts with neighbouring memory
+            for (unsigned w = 0; w < worker_count; ++w) {
+                std::lock_guard<std::mutex> guard(queues[w].lock);
+                for (size_t c = chunks * w / worker_count; c < chunks * (w + 1) / worker_count; ++c) {
+                    size_t b = begin + c * grain;
+                    queues[w].ranges.push_back({ b, std::min(b + grain, end) });
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(state_lock);
+                ++generation;
+            }
+            wake.notify_all();
+
+            // work through our own chunks, then wait for stolen chunks to finish
+            run_chunks(self.index);
+
+            std::exception_ptr error;
+            {
+                std::unique_lock<std::mutex> guard(state_lock);
+                done.wait(guard, [this] { return pending.load() == 0; });
+                job = nullptr;
+                std::swap(error, failure);
+            }
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+private:
+
+    struct range_t { size_t begin, end; };
+
+    struct alignas(64) work_queue
+    {
+        std::mutex lock;
+        std::deque<range_t> ranges;
+    };
+
+    struct worker_info { thread_pool *pool; unsigned index; };
+
+    static worker_info *&current_worker()
+    {
+        static thread_local worker_info *info = nullptr;
+        return info;
+    }
+
+    // makes `info` the current worker until the scope is left, normally or by an exception
+    struct worker_scope
+    {
+        explicit worker_scope(worker_info *info) : previous(current_worker()) { current_worker() = info; }
+        ~worker_scope() { current_worker() = previous; }
+
+        worker_scope(const worker_scope &) = delete;
+        worker_scope &operator=(const worker_scope &) = delete;
+
+        worker_info *previous;
+    };
+
+    static void pin_thread(std::thread &thread, unsigned index)
+    {
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+#if defined(_WIN32)
+        SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << (index % cores));
+#else
+        (thread); (index); (cores);
+#endif
+    }
+
+    bool pop(unsigned worker, range_t &range)
+    {
+        std::lock_guard<std::mutex> guard(queues[worker].lock);
+        if (queues[worker].ranges.empty()) {
+            return false;
+        }
+        range = queues[worker].ranges.front();
+        queues[worker].ranges.pop_front();
+        return true;
+    }
+
+    bool steal(unsigned thief, range_t &range)
+    {
+        for (unsigned i = 1; i < worker_count; ++i) {
+            unsigned victim = (thief + i) % worker_count;
+            std::lock_guard<std::mutex> guard(queues[victim].lock);
+            if (!queues[victim].ranges.empty()) {
+                range = queues[victim].ranges.back();
+                queues[victim].ranges.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run_chunks(unsigned worker)
+    {
+        range_t range;
+        while (pop(worker, range) || steal(worker, range))
+        {
+            // once a chunk has failed the remaining ones are only counted off
+            if (!failed.load()) {
+                try {
+                    (*job)(range.begin, range.end, worker);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> guard(state_lock);
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                    failed.store(true);
+                }
+            }
+
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> guard(state_lock);
+                done.notify_all();
+            }
+        }
+    }
+
+    void worker_loop(unsigned index)
+    {
+        worker_info self{ this, index };
+        worker_scope scope(&self);
+
+        uint64_t seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> guard(state_lock);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+
+            run_chunks(index);
+        }
+    }
+
+    unsigned worker_count = 1;
+    std::vector<std::thread> workers;
+    std::unique_ptr<work_queue[]> queues;
+
+    std::mutex job_lock;        // serializes parallel_for callers
+    std::mutex state_lock;      // protects generation/stopping and the condition variables
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    std::atomic<size_t> pending{ 0 };
+    const std::function<void(size_t, size_t, unsigned)> *job = nullptr;
+
+    std::atomic<bool> failed{ false };
+    std::exception_ptr failure;     // first exception thrown by a chunk, protected by state_lock
+};
+
+// process-wide pool used by the batch kernels
+inline thread_pool &default_thread_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+// parallel_for on the default pool
+template<typename fn_t>
+void parallel_for(size_t begin, size_t end, size_t grain, fn_t &&fn)
+{
+    default_thread_pool().parallel_for(begin, end, grain, std::forward<fn_t>(fn));
+}
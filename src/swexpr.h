@@ -0,0 +1,288 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "swfp.h"
+#include "swunpacked.h"
+#include "swaccum.h"
+
+//
+// Fused expressions
+//
+// fused_t<format> is a floatbase_t whose products are evaluated lazily. The
+// product a * b of fused values is an expression; adding it to a value or to
+// another product builds a larger expression, and converting the expression
+// back to a value evaluates it with a single rounding:
+//
+//      fused16_t a, b, c, d;
+//      float16_t x = a * b + c;        // fused_fma
+//      float16_t y = a * b - c * d;    // fused_product_sum
+//      float16_t z = sum(fused(p, n) * fused(q, n));   // fused_dot
+//
+// Everything else evaluates eagerly with the floatbase_t operators, so code
+// changes only in the declared types. Operands are unpacked once and products
+// are kept exact; see swunpacked.h.
+//
+
+template<fp_format format> class fused_t;
+template<fp_format format> class fp_product;
+template<fp_format format> class fp_fma_expr;
+template<fp_format format> class fp_product_sum;
+
+namespace details
+{
+    template<fp_format format>
+    using fused_wide_t = fp_wide<typename fp_traits<format>::uint_t, 2>;
+
+    template<fp_format format>
+    constexpr fp_wide<typename fp_traits<format>::uint_t, 1> unpack_wide(floatbase_t<format> x)
+    {
+        return unpacked_t<format>(x).to_wide();
+    }
+
+    // exact a * b, negated if `negate`
+    template<fp_format format>
+    constexpr fused_wide_t<format> exact_product(floatbase_t<format> a, floatbase_t<format> b, bool negate = false)
+    {
+        auto product = multiply_exact(unpack_wide(a), unpack_wide(b));
+        return negate ? details::negate(product) : product;
+    }
+
+    // operand categories of the fused operators
+    template<typename T> struct fused_operand { static constexpr bool is_value = false; static constexpr bool is_fused = false; };
+    template<fp_format f> struct fused_operand<floatbase_t<f>> { static constexpr bool is_value = true; static constexpr bool is_fused = false; static constexpr fp_format format = f; };
+    template<fp_format f> struct fused_operand<fused_t<f>> { static constexpr bool is_value = true; static constexpr bool is_fused = true; static constexpr fp_format format = f; };
+    template<fp_format f> struct fused_operand<fp_product<f>> { static constexpr bool is_value = false; static constexpr bool is_fused = true; static constexpr fp_format format = f; };
+    template<fp_format f> struct fused_operand<fp_fma_expr<f>> { static constexpr bool is_value = false; static constexpr bool is_fused = true; static constexpr fp_format format = f; };
+    template<fp_format f> struct fused_operand<fp_product_sum<f>> { static constexpr bool is_value = false; static constexpr bool is_fused = true; static constexpr fp_format format = f; };
+
+    template<typename T> constexpr bool is_fused_operand_v = fused_operand<T>::is_value || fused_operand<T>::is_fused;
+
+    // both operands of the same format, at least one of them fused
+    template<typename L, typename R, typename = void>
+    struct fused_pair : std::false_type { };
+    template<typename L, typename R>
+    struct fused_pair<L, R, std::enable_if_t<is_fused_operand_v<L> && is_fused_operand_v<R>>>
+        : std::bool_constant<fused_operand<L>::format == fused_operand<R>::format && (fused_operand<L>::is_fused || fused_operand<R>::is_fused)> { };
+
+    template<typename L, typename R> constexpr bool is_fused_pair_v = fused_pair<L, R>::value;
+    template<typename L, typename R> constexpr bool is_value_pair_v = fused_operand<L>::is_value && fused_operand<R>::is_value;
+
+    template<typename T> constexpr bool is_product_v = false;
+    template<fp_format f> constexpr bool is_product_v<fp_product<f>> = true;
+
+    // sums and differences that have their own fused operator
+    template<typename L, typename R> constexpr bool is_fusable_sum_v =
+        (is_product_v<L> && (is_product_v<R> || fused_operand<R>::is_value)) || (fused_operand<L>::is_value && is_product_v<R>);
+}
+
+//
+// kernels
+//
+
+// a * b + c rounded once
+template<fp_format format>
+constexpr floatbase_t<format> fused_fma(floatbase_t<format> a, floatbase_t<format> b, floatbase_t<format> c)
+{
+    return fma(unpacked_t<format>(a), unpacked_t<format>(b), unpacked_t<format>(c)).pack();
+}
+
+// a * b + c * d, or a * b - c * d if `subtract`, rounded once
+template<fp_format format>
+constexpr floatbase_t<format> fused_product_sum(floatbase_t<format> a, floatbase_t<format> b, floatbase_t<format> c, floatbase_t<format> d, bool subtract = false)
+{
+    auto sum = details::add(details::exact_product(a, b), details::exact_product(c, d, subtract));
+    return unpacked_t<format>::pack(sum);
+}
+
+// sum of x[i] * y[i], rounded once at the end
+template<fp_format format>
+floatbase_t<format> fused_dot(const floatbase_t<format> *x, const floatbase_t<format> *y, size_t count)
+{
+    long_accumulator<format> acc;
+    for (size_t i = 0; i < count; ++i) {
+        acc.add_product(x[i], y[i]);
+    }
+    return acc.round();
+}
+
+// sum of x[i], rounded once at the end
+template<fp_format format>
+floatbase_t<format> fused_sum(const floatbase_t<format> *x, size_t count)
+{
+    long_accumulator<format> acc;
+    for (size_t i = 0; i < count; ++i) {
+        acc.add(x[i]);
+    }
+    return acc.round();
+}
+
+//
+// values and expressions
+//
+
+template<fp_format format>
+class fused_t : public floatbase_t<format>
+{
+public:
+    using floatbase_t<format>::floatbase_t;
+
+    fused_t() = default;
+    constexpr fused_t(floatbase_t<format> x) : floatbase_t<format>(x) { }
+};
+
+// a * b
+template<fp_format format>
+class fp_product
+{
+public:
+    constexpr fp_product(floatbase_t<format> a, floatbase_t<format> b, bool negated = false) : a(a), b(b), negated(negated) { }
+
+    constexpr fused_t<format> evaluate() const { return negated ? -(a * b) : a * b; }
+    constexpr operator fused_t<format>() const { return evaluate(); }
+
+    constexpr fp_product negated_product() const { return fp_product(a, b, !negated); }
+
+    floatbase_t<format> a, b;
+    bool negated;
+};
+
+// a * b + c
+template<fp_format format>
+class fp_fma_expr
+{
+public:
+    constexpr fp_fma_expr(fp_product<format> product, floatbase_t<format> c, bool subtract) : product(product), c(c), subtract(subtract) { }
+
+    constexpr fused_t<format> evaluate() const
+    {
+        auto addend = details::unpack_wide(c).template resize<2>();
+        auto sum = details::add(details::exact_product(product.a, product.b, product.negated), subtract ? details::negate(addend) : addend);
+        return unpacked_t<format>::pack(sum);
+    }
+    constexpr operator fused_t<format>() const { return evaluate(); }
+
+    fp_product<format> product;
+    floatbase_t<format> c;
+    bool subtract;
+};
+
+// a * b + c * d
+template<fp_format format>
+class fp_product_sum
+{
+public:
+    constexpr fp_product_sum(fp_product<format> l, fp_product<format> r, bool subtract) : l(l), r(r), subtract(subtract) { }
+
+    constexpr fused_t<format> evaluate() const
+    {
+        auto sum = details::add(details::exact_product(l.a, l.b, l.negated), details::exact_product(r.a, r.b, r.negated != subtract));
+        return unpacked_t<format>::pack(sum);
+    }
+    constexpr operator fused_t<format>() const { return evaluate(); }
+
+    fp_product<format> l, r;
+    bool subtract;
+};
+
+namespace details
+{
+    template<typename T>
+    constexpr auto evaluate(const T &x)
+    {
+        if constexpr (fused_operand<T>::is_value) {
+            return fused_t<fused_operand<T>::format>(x);
+        }
+        else {
+            return x.evaluate();
+        }
+    }
+}
+
+// products of values build expressions
+template<typename L, typename R, std::enable_if_t<details::is_fused_pair_v<L, R> && details::is_value_pair_v<L, R>, int> = 0>
+constexpr fp_product<details::fused_operand<L>::format> operator*(const L &a, const R &b) { return { a, b }; }
+
+template<fp_format format>
+constexpr fp_product<format> operator-(const fp_product<format> &p) { return p.negated_product(); }
+
+template<fp_format format>
+constexpr fp_fma_expr<format> operator+(const fp_product<format> &p, const floatbase_t<format> &c) { return { p, c, false }; }
+template<fp_format format>
+constexpr fp_fma_expr<format> operator+(const floatbase_t<format> &c, const fp_product<format> &p) { return { p, c, false }; }
+template<fp_format format>
+constexpr fp_fma_expr<format> operator-(const fp_product<format> &p, const floatbase_t<format> &c) { return { p, c, true }; }
+template<fp_format format>
+constexpr fp_fma_expr<format> operator-(const floatbase_t<format> &c, const fp_product<format> &p) { return { -p, c, false }; }
+
+template<fp_format format>
+constexpr fp_product_sum<format> operator+(const fp_product<format> &l, const fp_product<format> &r) { return { l, r, false }; }
+template<fp_format format>
+constexpr fp_product_sum<format> operator-(const fp_product<format> &l, const fp_product<format> &r) { return { l, r, true }; }
+
+// everything else evaluates the operands and applies the floatbase_t operator
+template<typename L, typename R, std::enable_if_t<details::is_fused_pair_v<L, R> && !details::is_fusable_sum_v<L, R>, int> = 0>
+constexpr auto operator+(const L &l, const R &r) { return fused_t<details::fused_operand<L>::format>(details::evaluate(l).operator+(details::evaluate(r))); }
+template<typename L, typename R, std::enable_if_t<details::is_fused_pair_v<L, R> && !details::is_fusable_sum_v<L, R>, int> = 0>
+constexpr auto operator-(const L &l, const R &r) { return fused_t<details::fused_operand<L>::format>(details::evaluate(l).operator-(details::evaluate(r))); }
+template<typename L, typename R, std::enable_if_t<details::is_fused_pair_v<L, R> && !details::is_value_pair_v<L, R>, int> = 0>
+constexpr auto operator*(const L &l, const R &r) { return fused_t<details::fused_operand<L>::format>(details::evaluate(l).operator*(details::evaluate(r))); }
+template<typename L, typename R, std::enable_if_t<details::is_fused_pair_v<L, R>, int> = 0>
+constexpr auto operator/(const L &l, const R &r) { return fused_t<details::fused_operand<L>::format>(details::evaluate(l).operator/(details::evaluate(r))); }
+
+template<fp_format format>
+constexpr fused_t<format> operator-(const fused_t<format> &x) { return x.operator-(); }
+
+//
+// ranges
+//
+
+// contiguous values whose sums and dot products are fused
+template<fp_format format>
+class fused_range
+{
+public:
+    constexpr fused_range(const floatbase_t<format> *data, size_t count) : data(data), count(count) { }
+
+    const floatbase_t<format> *data;
+    size_t count;
+};
+
+// x[i] * y[i]
+template<fp_format format>
+class fp_range_product
+{
+public:
+    fused_range<format> x, y;
+};
+
+template<fp_format format>
+constexpr fused_range<format> fused(const floatbase_t<format> *data, size_t count) { return { data, count }; }
+
+template<fp_format format>
+fused_range<format> fused(const std::vector<floatbase_t<format>> &values) { return { values.data(), values.size() }; }
+
+template<fp_format format>
+fp_range_product<format> operator*(const fused_range<format> &x, const fused_range<format> &y)
+{
+    if (x.count != y.count) {
+        throw std::exception("ranges have different lengths");
+    }
+    return { x, y };
+}
+
+template<fp_format format>
+fused_t<format> sum(const fp_range_product<format> &products) { return fused_dot(products.x.data, products.y.data, products.x.count); }
+
+template<fp_format format>
+fused_t<format> sum(const fused_range<format> &values) { return fused_sum(values.data, values.count); }
+
+using fused8_e5m2_t = fused_t<fp_format::float8_e5m2>;
+using fusedbf16_t = fused_t<fp_format::bfloat16>;
+using fused16_t = fused_t<fp_format::binary16>;
+using fused32_t = fused_t<fp_format::binary32>;
+using fused64_t = fused_t<fp_format::binary64>;
@@ -0,0 +1,185 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <utility>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+//
+// Memory-mapped files
+//
+// Files are mapped whole. On 64-bit targets the address space is not the limit,
+// physical memory is: callers walking files larger than RAM flush and release
+// the ranges they are done with so the OS can reclaim those pages early.
+//
+
+class mapped_file
+{
+public:
+
+    mapped_file() = default;
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    mapped_file(mapped_file &&other) noexcept { swap(other); }
+    mapped_file &operator=(mapped_file &&other) noexcept
+    {
+        mapped_file tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    ~mapped_file() { close(); }
+
+    // map an existing file read-only
+    static mapped_file open(const std::string &path)
+    {
+        mapped_file file;
+        file.open_file(path, false, 0);
+        return file;
+    }
+
+    // create (or truncate) a file of `size` bytes and map it read-write
+    static mapped_file create(const std::string &path, uint64_t size)
+    {
+        mapped_file file;
+        file.open_file(path, true, size);
+        return file;
+    }
+
+    const uint8_t *data() const { return view; }
+    uint8_t *data() { return view; }
+    uint64_t size() const { return length; }
+    bool writable() const { return is_writable; }
+
+    // start writing back modified pages in [offset, offset + count)
+    void flush(uint64_t offset, uint64_t count)
+    {
+        if (!is_writable || !page_range(offset, count)) {
+            return;
+        }
+        FlushViewOfFile(view + offset, static_cast<SIZE_T>(count));
+    }
+
+    // drop the pages of [offset, offset + count) from the working set, they
+    // are read back from the file (or page cache) if touched again
+    void release(uint64_t offset, uint64_t count)
+    {
+        if (!page_range(offset, count)) {
+            return;
+        }
+        // unlocking pages that are not locked removes them from the working set
+        VirtualUnlock(view + offset, static_cast<SIZE_T>(count));
+    }
+
+private:
+
+    static uint64_t page_size()
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+    }
+
+    // shrink [offset, offset + count) to whole pages inside the mapping
+    bool page_range(uint64_t &offset, uint64_t &count) const
+    {
+        if (!view || offset >= length) {
+            return false;
+        }
+
+        const uint64_t page = page_size();
+        uint64_t end = std::min(offset + count, length);
+        offset = (offset + page - 1) / page * page;
+        if (end != length) {
+            end = end / page * page;
+        }
+        if (end <= offset) {
+            return false;
+        }
+        count = end - offset;
+        return true;
+    }
+
+    void open_file(const std::string &path, bool write, uint64_t size)
+    {
+        is_writable = write;
+
+        handle = CreateFileA(path.c_str(), write ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+            FILE_SHARE_READ, nullptr, write ? CREATE_ALWAYS : OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            throw std::exception("cannot open file");
+        }
+
+        if (write) {
+            length = size;
+        }
+        else {
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(handle, &file_size)) {
+                throw std::exception("cannot get file size");
+            }
+            length = static_cast<uint64_t>(file_size.QuadPart);
+        }
+
+        // empty files cannot be mapped
+        if (length == 0) {
+            return;
+        }
+
+        mapping = CreateFileMappingA(handle, nullptr, write ? PAGE_READWRITE : PAGE_READONLY,
+            static_cast<DWORD>(length >> 32), static_cast<DWORD>(length), nullptr);
+        if (!mapping) {
+            throw std::exception("cannot map file");
+        }
+
+        view = static_cast<uint8_t *>(MapViewOfFile(mapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+        if (!view) {
+            throw std::exception("cannot map file");
+        }
+    }
+
+    void close()
+    {
+        if (view) {
+            UnmapViewOfFile(view);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(handle);
+        }
+        mapping = nullptr;
+        handle = INVALID_HANDLE_VALUE;
+        view = nullptr;
+        length = 0;
+    }
+
+    void swap(mapped_file &other) noexcept
+    {
+        std::swap(handle, other.handle);
+        std::swap(mapping, other.mapping);
+        std::swap(view, other.view);
+        std::swap(length, other.length);
+        std::swap(is_writable, other.is_writable);
+    }
+
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+    uint8_t *view = nullptr;
+    uint64_t length = 0;
+    bool is_writable = false;
+};
@@ -0,0 +1,558 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "swfp.h"
+#include "swint.h"
+#include "swunpacked.h"
+#include "swexec.h"
+
+//
+// Fixed-point numbers
+//
+// fixed_t<int_bits, frac_bits> is a signed Qm.n number: a two's-complement
+// integer with m = int_bits integer bits and n = frac_bits fractional bits
+// above a sign bit, worth raw * 2^-n. The range is [-2^m, 2^m - 2^-n].
+//
+// The storage is the smallest built-in integer that holds the m + n + 1 bits,
+// or a signed intbase_t above 64 bits; any wider signed type can be passed in.
+// Sums are formed in the storage type when it has a spare bit. Products and
+// quotients go through the double-width type: multiply_extended gives the
+// whole product and the intbase_t division the quotient of (a << n) / b.
+//
+// The policies are part of the type, as they are for fixed-point hardware:
+//
+//      rounding   how products, quotients and conversions from floatbase_t
+//                 drop bits below 2^-n: toward_zero, down (toward -inf, an
+//                 arithmetic shift), nearest_up (ties toward +inf) or
+//                 nearest_even
+//      overflow   results out of range wrap modulo 2^(m + n + 1) or saturate
+//
+//      using q15_t = fixed_t<0, 15>;       // int16_t, nearest-even, saturating
+//      q15_t y = q15_t(float16_t(0.5f)) * q15_t::from_raw(int16_t(-32768));
+//      float32_t f = static_cast<float32_t>(y);
+//
+// Conversions to floatbase_t formats up to binary64 round to nearest-even like
+// every floatbase_t conversion. From floatbase_t, NaN converts to 0 and infinities to the
+// limits of the type under either overflow policy. Division by zero is
+// handled like intbase_t division.
+//
+
+enum class fixed_rounding { toward_zero, down, nearest_up, nearest_even };
+enum class fixed_overflow { wrap, saturate };
+
+namespace details
+{
+    template<size_t bits>
+    struct fixed_storage
+    {
+        using type = selector_t<(bits > 64), intbase_t<(bits + 63) / 64 * 8, true>, make_integral_t<(bits <= 8 ? 1 : bits <= 16 ? 2 : bits <= 32 ? 4 : 8), true>>;
+    };
+
+    template<size_t bits> using fixed_storage_t = typename fixed_storage<bits>::type;
+
+    // the double-width type of a signed storage type and the conversions to and from it
+    template<typename int_t, typename = void> struct fixed_int_traits;
+
+    template<typename int_t>
+    struct fixed_int_traits<int_t, std::enable_if_t<std::is_integral_v<int_t>>>
+    {
+        static_assert(std::is_signed_v<int_t>, "fixed_t needs signed storage");
+
+        using wide_t = selector_t<(sizeof(int_t) < sizeof(int64_t)), make_integral_t<2 * sizeof(int_t), true>, intbase_t<16, true>>;
+
+        static constexpr wide_t widen(int_t x) { return static_cast<wide_t>(x); }
+
+        static wide_t multiply(int_t a, int_t b) { return widen(a) * widen(b); }
+
+        static int_t narrow(wide_t x)
+        {
+            if constexpr (std::is_integral_v<wide_t>) {
+                return static_cast<int_t>(x);
+            }
+            else {
+                int_t r;
+                memcpy(&r, &x, sizeof(r));
+                return r;
+            }
+        }
+    };
+
+    template<size_t byte_size, typename layout>
+    struct fixed_int_traits<intbase_t<byte_size, true, layout>>
+    {
+        using int_t = intbase_t<byte_size, true, layout>;
+        using wide_t = intbase_t<2 * byte_size, true>;
+
+        static wide_t widen(int_t x)
+        {
+            uint8_t bytes[sizeof(wide_t)];
+            memset(bytes, x < int_t(0) ? 0xff : 0, sizeof(bytes));
+            memcpy(bytes, &x, sizeof(x));
+            return bit_cast<wide_t>(bytes);
+        }
+
+        // the high half of multiply_extended is the sign-extended top of the product
+        static wide_t multiply(int_t a, int_t b)
+        {
+            int_t hi;
+            const int_t lo = int_t::multiply_extended(a, b, hi);
+            uint8_t bytes[sizeof(wide_t)];
+            memcpy(bytes, &lo, sizeof(lo));
+            memcpy(bytes + sizeof(lo), &hi, sizeof(hi));
+            return bit_cast<wide_t>(bytes);
+        }
+
+        static int_t narrow(wide_t x)
+        {
+            int_t r;
+            memcpy(&r, &x, sizeof(r));
+            return r;
+        }
+    };
+
+    // x with bits above `bits` replaced by copies of bit (bits - 1)
+    template<typename int_t>
+    constexpr int_t sign_extend_from(int_t x, int bits)
+    {
+        constexpr int bitsize = static_cast<int>(sizeof(int_t) * 8);
+        if (bits >= bitsize) {
+            return x;
+        }
+        if constexpr (std::is_integral_v<int_t>) {
+            using uint_t = std::make_unsigned_t<int_t>;
+            return static_cast<int_t>(static_cast<int_t>(static_cast<uint_t>(static_cast<uint_t>(x) << (bitsize - bits))) >> (bitsize - bits));
+        }
+        else {
+            return (x << (bitsize - bits)) >> (bitsize - bits);
+        }
+    }
+
+    // 2^(bits - 1) - 1, the largest value of a signed `bits`-wide field. Built-in types
+    // form it unsigned, shifting a negative value is undefined there
+    template<typename int_t>
+    constexpr int_t max_of_width(int bits)
+    {
+        if constexpr (std::is_integral_v<int_t>) {
+            using uint_t = std::make_unsigned_t<int_t>;
+            return static_cast<int_t>(static_cast<uint_t>((uint_t(1) << (bits - 1)) - uint_t(1)));
+        }
+        else {
+            return (int_t(1) << (bits - 1)) - int_t(1);
+        }
+    }
+
+    // x * 2^shift, formed unsigned for built-in types like max_of_width
+    template<typename int_t>
+    constexpr int_t shift_left(int_t x, int shift)
+    {
+        if constexpr (std::is_integral_v<int_t>) {
+            using uint_t = std::make_unsigned_t<int_t>;
+            return static_cast<int_t>(static_cast<uint_t>(static_cast<uint_t>(x) << shift));
+        }
+        else {
+            return x << shift;
+        }
+    }
+
+    // the non-negative value x in a signed type wide enough to hold it
+    template<typename int_t>
+    int_t from_word(uint64_t x)
+    {
+        if constexpr (std::is_integral_v<int_t>) {
+            return static_cast<int_t>(x);
+        }
+        else {
+            uint8_t bytes[sizeof(int_t)] = {};
+            memcpy(bytes, &x, sizeof(int_t) < sizeof(x) ? sizeof(int_t) : sizeof(x));
+            return bit_cast<int_t>(bytes);
+        }
+    }
+
+    // x / 2^shift rounded
+    template<fixed_rounding rounding, typename int_t>
+    constexpr int_t round_shift(int_t x, int shift)
+    {
+        if (shift == 0) {
+            return x;
+        }
+
+        const int_t floor = x >> shift;
+        const int_t remainder = x - shift_left(floor, shift);
+        const int_t half = int_t(1) << (shift - 1);
+
+        bool increment = false;
+        if constexpr (rounding == fixed_rounding::toward_zero) { increment = x < int_t(0) && remainder != int_t(0); }
+        else if constexpr (rounding == fixed_rounding::nearest_up) { increment = !(remainder < half); }
+        else if constexpr (rounding == fixed_rounding::nearest_even) { increment = half < remainder || (remainder == half && !!(floor & int_t(1))); }
+        return increment ? floor + int_t(1) : floor;
+    }
+
+    // n / d rounded, for d != 0
+    template<fixed_rounding rounding, typename int_t>
+    constexpr int_t round_divide(int_t n, int_t d)
+    {
+        const int_t q = n / d;
+        const int_t r = n - q * d;
+        if (r == int_t(0) || rounding == fixed_rounding::toward_zero) {
+            return q;
+        }
+
+        // one step away from zero when the quotient rounds up in magnitude
+        const bool negative = (n < int_t(0)) != (d < int_t(0));
+        const int_t twice_r = r < int_t(0) ? int_t(0) - (r + r) : r + r;
+        const int_t magnitude_d = d < int_t(0) ? int_t(0) - d : d;
+
+        bool away = false;
+        if constexpr (rounding == fixed_rounding::down) { away = negative; }
+        else if constexpr (rounding == fixed_rounding::nearest_up) { away = magnitude_d < twice_r || (twice_r == magnitude_d && !negative); }
+        else { away = magnitude_d < twice_r || (twice_r == magnitude_d && !!(q & int_t(1))); }
+
+        if (!away) {
+            return q;
+        }
+        return negative ? q - int_t(1) : q + int_t(1);
+    }
+
+    // bits [position - 63, position] of little-endian limbs, bits below 0 read as 0
+    template<int limb_count>
+    constexpr uint64_t limbs_bits_at(const uint64_t (&limbs)[limb_count], int position)
+    {
+        const int low = position - 63;
+        auto limb = [&](int i) { return i >= 0 && i < limb_count ? limbs[i] : uint64_t(0); };
+        const int index = low >= 0 ? low / 64 : -((-low + 63) / 64);
+        const int shift = low - index * 64;
+        return shift ? (limb(index) >> shift) | (limb(index + 1) << (64 - shift)) : limb(index);
+    }
+
+    // true if any of bits [0, count) is set
+    template<int limb_count>
+    constexpr bool limbs_any_below(const uint64_t (&limbs)[limb_count], int count)
+    {
+        for (int i = 0; i < limb_count && count > 0; ++i, count -= 64) {
+            const uint64_t mask = count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+            if (limbs[i] & mask) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // round sign * magnitude * 2^lsb_exponent to nearest-even in `out`, from a
+    // 64-bit window below the leading bit with the rest ORed into a sticky bit
+    template<fp_format out, int limb_count>
+    constexpr floatbase_t<out> round_limbs_magnitude(uint8_t sign, const uint64_t (&magnitude)[limb_count], int32_t lsb_exponent)
+    {
+        int top = limb_count - 1;
+        while (top >= 0 && magnitude[top] == 0) {
+            --top;
+        }
+        if (top < 0) {
+            return floatbase_t<out>::zero(sign);
+        }
+
+        unsigned long index = 0;
+        reverse_bit_scan(&index, magnitude[top]);
+        const int lead = top * 64 + static_cast<int>(index);
+
+        const uint64_t window = limbs_bits_at(magnitude, lead);
+        const bool sticky = limbs_any_below(magnitude, lead - 63);
+        return round_window<out>(sign, lead + lsb_exponent, window | (sticky ? 1 : 0));
+    }
+}
+
+template<int int_bits, int frac_bits,
+    typename storage_t = details::fixed_storage_t<int_bits + frac_bits + 1>,
+    fixed_rounding rounding = fixed_rounding::nearest_even,
+    fixed_overflow overflow = fixed_overflow::saturate>
+class fixed_t
+{
+    using traits = details::fixed_int_traits<storage_t>;
+    using wide_t = typename traits::wide_t;
+
+    static constexpr int value_bits = int_bits + frac_bits + 1;
+    static constexpr int storage_bits = static_cast<int>(sizeof(storage_t) * 8);
+
+    static_assert(int_bits >= 0 && frac_bits >= 0, "expecting non-negative integer and fraction bits");
+    static_assert(value_bits <= storage_bits, "storage type too narrow for the integer and fraction bits");
+
+public:
+
+    using storage_type = storage_t;
+
+    static constexpr int integer_bits = int_bits;
+    static constexpr int fraction_bits = frac_bits;
+    static constexpr fixed_rounding rounding_mode = rounding;
+    static constexpr fixed_overflow overflow_mode = overflow;
+
+    // default is uninit, like the built-in types
+    fixed_t() = default;
+
+    static constexpr fixed_t from_raw(storage_t raw)
+    {
+        fixed_t r;
+        r.value = raw;
+        return r;
+    }
+
+    constexpr storage_t raw() const { return value; }
+
+    // largest, smallest and smallest positive values
+    static constexpr fixed_t max() { return from_raw(details::max_of_width<storage_t>(value_bits)); }
+    static constexpr fixed_t min() { return from_raw(storage_t(~max().value)); }
+    static constexpr fixed_t epsilon() { return from_raw(storage_t(1)); }
+
+    // integral values, out-of-range values follow the overflow policy
+    template<typename integral_t, typename = std::enable_if_t<std::is_integral_v<integral_t>>>
+    explicit fixed_t(integral_t x)
+    {
+        if constexpr (overflow == fixed_overflow::saturate && int_bits < 64) {
+            if (x >= integral_t(0) && static_cast<uint64_t>(x) > (uint64_t(1) << int_bits) - 1) {
+                *this = max();
+                return;
+            }
+            if constexpr (std::is_signed_v<integral_t> && int_bits < 63) {
+                if (x < integral_t(0) && static_cast<int64_t>(x) < -static_cast<int64_t>(uint64_t(1) << int_bits)) {
+                    *this = min();
+                    return;
+                }
+            }
+        }
+
+        // only the low bits of x can reach the value when it wraps
+        *this = from_wide(details::shift_left(traits::widen(static_cast<storage_t>(x)), frac_bits));
+    }
+
+    // x rounded by the rounding policy
+    template<fp_format format>
+    explicit fixed_t(floatbase_t<format> x)
+    {
+        using uint_t = typename unpacked_t<format>::uint_t;
+        constexpr int bitsize = unpacked_t<format>::bitsize;
+        static_assert(sizeof(uint_t) <= sizeof(uint64_t), "fixed_t converts formats up to binary64");
+
+        const unpacked_t<format> u(x);
+        switch (u.class_)
+        {
+        case unpacked_class::nan:
+        case unpacked_class::zero:
+            value = storage_t(0);
+            return;
+        case unpacked_class::infinity:
+            *this = u.sign ? min() : max();
+            return;
+        default:
+            break;
+        }
+
+        // |x| * 2^n = significand * 2^-shift
+        const int64_t shift = int64_t(bitsize - 1) - u.exponent - frac_bits;
+
+        uint_t q = u.significand;
+        bool round_bit = false, sticky = false;
+        int left = 0;
+        if (shift > bitsize) {
+            q = uint_t(0);
+            sticky = true;
+        }
+        else if (shift > 0) {
+            const int s = static_cast<int>(shift);
+            round_bit = !!((u.significand >> (s - 1)) & uint_t(1));
+            sticky = s > 1 && !!(static_cast<uint_t>(u.significand << (bitsize - s + 1)));
+            q = s == bitsize ? uint_t(0) : static_cast<uint_t>(u.significand >> s);
+        }
+        else {
+            left = shift < -2 * int64_t(storage_bits) ? 2 * storage_bits : static_cast<int>(-shift);
+        }
+
+        bool increment = false;
+        if constexpr (rounding == fixed_rounding::down) { increment = u.sign && (round_bit || sticky); }
+        else if constexpr (rounding == fixed_rounding::nearest_up) { increment = round_bit && (!u.sign || sticky); }
+        else if constexpr (rounding == fixed_rounding::nearest_even) { increment = round_bit && (sticky || !!(q & uint_t(1))); }
+        if (increment) {
+            q = static_cast<uint_t>(q + uint_t(1));
+        }
+
+        uint64_t magnitude = q;
+
+        // magnitudes of 2^(m + n + 1) and above are out of range for either sign
+        unsigned long lead = 0;
+        if (!details::reverse_bit_scan(&lead, magnitude)) {
+            value = storage_t(0);
+            return;
+        }
+        if (static_cast<int>(lead) + left >= value_bits) {
+            if constexpr (overflow == fixed_overflow::saturate) {
+                *this = u.sign ? min() : max();
+                return;
+            }
+            else {
+                // keep the bits that land below 2^(m + n + 1)
+                const int keep = value_bits - left;
+                if (keep <= 0) {
+                    value = storage_t(0);
+                    return;
+                }
+                if (keep < 64) {
+                    magnitude &= (uint64_t(1) << keep) - 1;
+                }
+            }
+        }
+
+        const wide_t shifted = details::from_word<wide_t>(magnitude) << left;
+        *this = from_wide(u.sign ? wide_t(0) - shifted : shifted);
+    }
+
+    // rounded to nearest-even
+    template<fp_format format>
+    explicit operator floatbase_t<format>() const
+    {
+        static_assert(sizeof(typename fp_traits<format>::uint_t) <= sizeof(uint64_t), "fixed_t converts formats up to binary64");
+
+        const wide_t wide = traits::widen(value);
+        const wide_t magnitude = wide < wide_t(0) ? wide_t(0) - wide : wide;
+
+        uint64_t limbs[(sizeof(wide_t) + 7) / 8] = {};
+        memcpy(limbs, &magnitude, sizeof(magnitude));
+        return details::round_limbs_magnitude<format>(wide < wide_t(0) ? 1 : 0, limbs, -frac_bits);
+    }
+
+    //
+    // arithmetic
+    //
+
+    fixed_t operator+(fixed_t other) const
+    {
+        if constexpr (value_bits < storage_bits) {
+            return from_wide(traits::widen(static_cast<storage_t>(value + other.value)));
+        }
+        else {
+            return from_wide(traits::widen(value) + traits::widen(other.value));
+        }
+    }
+
+    fixed_t operator-(fixed_t other) const
+    {
+        if constexpr (value_bits < storage_bits) {
+            return from_wide(traits::widen(static_cast<storage_t>(value - other.value)));
+        }
+        else {
+            return from_wide(traits::widen(value) - traits::widen(other.value));
+        }
+    }
+
+    fixed_t operator-() const
+    {
+        return from_wide(wide_t(0) - traits::widen(value));
+    }
+
+    // the double-width product has 2n fraction bits, n of them are rounded off
+    fixed_t operator*(fixed_t other) const
+    {
+        return from_wide(details::round_shift<rounding>(traits::multiply(value, other.value), frac_bits));
+    }
+
+    fixed_t operator/(fixed_t other) const
+    {
+        if (other.value == storage_t(0)) {
+            // handle divide-by-zero
+            details::divide_by_zero();
+        }
+        return from_wide(details::round_divide<rounding>(details::shift_left(traits::widen(value), frac_bits), traits::widen(other.value)));
+    }
+
+    fixed_t &operator+=(fixed_t other) { return *this = *this + other; }
+    fixed_t &operator-=(fixed_t other) { return *this = *this - other; }
+    fixed_t &operator*=(fixed_t other) { return *this = *this * other; }
+    fixed_t &operator/=(fixed_t other) { return *this = *this / other; }
+
+    //
+    // comparison
+    //
+
+    constexpr bool operator==(fixed_t other) const { return value == other.value; }
+    constexpr bool operator!=(fixed_t other) const { return value != other.value; }
+    constexpr bool operator<(fixed_t other) const { return value < other.value; }
+    constexpr bool operator<=(fixed_t other) const { return !(other.value < value); }
+    constexpr bool operator>(fixed_t other) const { return other.value < value; }
+    constexpr bool operator>=(fixed_t other) const { return !(value < other.value); }
+
+private:
+
+    // apply the overflow policy to a raw value in the double-width type
+    static fixed_t from_wide(wide_t x)
+    {
+        if constexpr (overflow == fixed_overflow::saturate) {
+            if (traits::widen(max().value) < x) {
+                return max();
+            }
+            if (x < traits::widen(min().value)) {
+                return min();
+            }
+        }
+        else {
+            x = details::sign_extend_from(x, value_bits);
+        }
+        return from_raw(traits::narrow(x));
+    }
+
+    storage_t value;
+};
+
+namespace batch
+{
+    //
+    // fixed-point arithmetic: out[i] = a[i] op b[i]
+    //
+
+#define MAKE_FIXED_ARITH(name, op)                                                                                  \
+    template<int int_bits, int frac_bits, typename storage_t, fixed_rounding rounding, fixed_overflow overflow>      \
+    void name(const fixed_t<int_bits, frac_bits, storage_t, rounding, overflow> *a,                                 \
+        const fixed_t<int_bits, frac_bits, storage_t, rounding, overflow> *b,                                       \
+        fixed_t<int_bits, frac_bits, storage_t, rounding, overflow> *out, size_t count,                             \
+        thread_pool &pool = default_thread_pool()) {                                                                \
+        pool.parallel_for(0, count, 4096, [=](size_t begin, size_t end, unsigned) {                                 \
+            for (size_t i = begin; i < end; ++i) {                                                                  \
+                out[i] = a[i] op b[i];                                                                              \
+            }                                                                                                       \
+        });                                                                                                         \
+    }                                                                                                               \
+
+    MAKE_FIXED_ARITH(add, +)
+    MAKE_FIXED_ARITH(sub, -)
+    MAKE_FIXED_ARITH(mul, *)
+    MAKE_FIXED_ARITH(div, /)
+
+#undef MAKE_FIXED_ARITH
+
+    //
+    // conversion between floatbase_t and fixed-point arrays
+    //
+
+    template<fp_format from, int int_bits, int frac_bits, typename storage_t, fixed_rounding rounding, fixed_overflow overflow>
+    void convert(const floatbase_t<from> *src, fixed_t<int_bits, frac_bits, storage_t, rounding, overflow> *dst, size_t count,
+        thread_pool &pool = default_thread_pool())
+    {
+        using fixed_type = fixed_t<int_bits, frac_bits, storage_t, rounding, overflow>;
+        pool.parallel_for(0, count, 4096, [=](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                dst[i] = fixed_type(src[i]);
+            }
+        });
+    }
+
+    template<int int_bits, int frac_bits, typename storage_t, fixed_rounding rounding, fixed_overflow overflow, fp_format to>
+    void convert(const fixed_t<int_bits, frac_bits, storage_t, rounding, overflow> *src, floatbase_t<to> *dst, size_t count,
+        thread_pool &pool = default_thread_pool())
+    {
+        pool.parallel_for(0, count, 4096, [=](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                dst[i] = static_cast<floatbase_t<to>>(src[i]);
+            }
+        });
+    }
+}
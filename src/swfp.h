@@ -26,11 +26,24 @@ enum class fp_format
    binary16,
    binary32,
    binary64,
-   binary128
+   binary128,
+   float8_e5m2
 };
 
 template<fp_format f> struct fp_traits { };
 // todo: static assert only support fp_formats are instantiated
+template<> struct fp_traits<fp_format::float8_e5m2>
+{
+   using uint_t = uint8_t;
+   static constexpr int exponent_bitsize = 5;
+   static constexpr int bias = 15;
+};
+template<> struct fp_traits<fp_format::bfloat16>
+{
+   using uint_t = uint16_t;
+   static constexpr int exponent_bitsize = 8;
+   static constexpr int bias = 127;
+};
 template<> struct fp_traits<fp_format::binary16>
 {
    using uint_t = uint16_t;
@@ -56,6 +69,8 @@ template<> struct fp_traits<fp_format::binary128>
     static constexpr int bias = 16383;
 };
 
+template<fp_format format> class unpacked_t;
+
 template<fp_format format>
 class floatbase_t
 {
@@ -78,10 +93,13 @@ private:
     static constexpr exponent_t emax = bias;
     static constexpr exponent_t emin = 1 - emax;
 
+    friend floatbase_t<fp_format::float8_e5m2>;
+    friend floatbase_t<fp_format::bfloat16>;
     friend floatbase_t<fp_format::binary16>;
     friend floatbase_t<fp_format::binary32>;
     friend floatbase_t<fp_format::binary64>;
     friend floatbase_t<fp_format::binary128>;
+    template<fp_format> friend class unpacked_t;
 
 private:
 
@@ -393,6 +411,11 @@ public:
                 return widefp_t::zero(sign);
             }
 
+            // same exponent range (e.g. bfloat16 -> binary32): subnormals stay subnormal
+            if constexpr (widefp_t::emin == emin) {
+                return widefp_t::subnormal(sign, static_cast<widefp_t::uint_t>(narrow_significand) << significand_bitdiff);
+            }
+
             // subnormals of smaller type will become normals of the larger type
             exponent = emin;
             int distance = significand_adjustment(narrow_significand);
@@ -422,11 +445,7 @@ public:
         exponent_t exponent = (raw_value >> significand_bitsize) & exponent_mask;
         uint_t wide_significand = raw_value & significand_mask;
 
-        if (exponent == 0) {
-            // subnormals round to 0
-            return narrowfp_t::zero(sign);
-        }
-        else if (exponent == exponent_mask) {
+        if (exponent == exponent_mask) {
             // special values
             if (wide_significand == 0) {
                 return narrowfp_t::infinity(sign);
@@ -435,22 +454,42 @@ public:
             return narrowfp_t{ sign, narrowfp_t::exponent_mask, static_cast<narrowfp_t::uint_t>(wide_significand >> significand_bitdiff) };
         }
 
-        exponent -= bias;
-        wide_significand |= (uint_t(1) << significand_bitsize);
+        if (exponent == 0) {
+            if (wide_significand == 0) {
+                return narrowfp_t::zero(sign);
+            }
+
+            // normalize, the narrow type may share the exponent range (e.g. binary32 -> bfloat16)
+            int distance = significand_adjustment(wide_significand);
+            wide_significand <<= distance;
+            exponent = emin - distance;
+        }
+        else {
+            exponent -= bias;
+            wide_significand |= (uint_t(1) << significand_bitsize);
+        }
 
         narrowfp_t::uint_t narrow_significand = static_cast<narrowfp_t::uint_t>(wide_significand >> significand_bitdiff);
-        narrowfp_t::uint_t roundoff_bits = static_cast<narrowfp_t::uint_t>((wide_significand & mask) << (narrowfp_t::bitsize - significand_bitdiff));
+
+        // keep the leading dropped bits, anything that does not fit the narrow
+        // roundoff (e.g. binary32 -> float8_e5m2) is folded into a sticky bit
+        uint_t dropped_bits = (wide_significand & mask) << (bitsize - significand_bitdiff);
+        narrowfp_t::uint_t roundoff_bits = static_cast<narrowfp_t::uint_t>(dropped_bits >> (bitsize - narrowfp_t::bitsize));
+        if constexpr (significand_bitdiff > narrowfp_t::bitsize) {
+            roundoff_bits |= static_cast<narrowfp_t::uint_t>((dropped_bits << narrowfp_t::bitsize) != 0);
+        }
 
         // if the exponent is outside the range of the narrower FP
         // type see if it could be a denomral of tha narrrow FP type otherwise its zero
         if (exponent < narrowfp_t::emin) {
             while (exponent < narrowfp_t::emin) {
                 ++exponent;
-                roundoff_bits >>= 1;
+                roundoff_bits = (roundoff_bits >> 1) | (roundoff_bits & 1); // sticky
                 roundoff_bits |= (narrow_significand & 1) << (narrowfp_t::bitsize - 1);
                 narrow_significand >>= 1;
 
-                if (narrow_significand == 0 && roundoff_bits == 0) {
+                // one more shift leaves the roundoff bits below the midpoint
+                if (narrow_significand == 0 && exponent < narrowfp_t::emin) {
                     return narrowfp_t::zero(sign);
                 }
             }
@@ -469,63 +508,50 @@ public:
         return narrowfp_t::normal(sign, exponent, narrow_significand);
     }
 
-    explicit constexpr operator floatbase_t<fp_format::binary16>() const
+    // pick widening or narrowing by the exponent and significand sizes. Formats where
+    // neither contains the other (binary16 <-> bfloat16) go through binary32, which
+    // holds both exactly so the result is still rounded once
+    template<typename to_t> constexpr to_t convert_to() const
     {
-        static_assert(format != fp_format::binary16, "convert from T to T is impossible");
+        static_assert(!std::is_same_v<to_t, floatbase_t>, "convert from T to T is impossible");
 
-        // convert from bigger FP to smaller FP
-        if constexpr (format == fp_format::binary32
-            || format == fp_format::binary64
-            || format == fp_format::binary128)
+        if constexpr (to_t::exponent_bitsize >= exponent_bitsize && to_t::significand_bitsize >= significand_bitsize)
+        {
+            return to_widefp<to_t>();
+        }
+        else if constexpr (to_t::exponent_bitsize <= exponent_bitsize && to_t::significand_bitsize <= significand_bitsize)
         {
-            return to_narrowfp<float16_t>();
+            return to_narrowfp<to_t>();
         }
         else
         {
-            static_assert(false, "nyi: convert to hw float16");
-            return float16_t::indeterminate_nan();
+            return static_cast<to_t>(static_cast<floatbase_t<fp_format::binary32>>(*this));
         }
     }
 
-    explicit constexpr operator floatbase_t<fp_format::binary32>() const
+    explicit constexpr operator floatbase_t<fp_format::float8_e5m2>() const
     {
-        static_assert(format != fp_format::binary32, "convert from T to T is impossible");
+        return convert_to<floatbase_t<fp_format::float8_e5m2>>();
+    }
 
-        // convert smaller FP to bigger FP
-        if constexpr (format == fp_format::binary16)
-        {
-            return to_widefp<float32_t>();
-        }
-        else if constexpr ((format == fp_format::binary64)
-            || (format == fp_format::binary128))
-        {
-            return to_narrowfp<float32_t>();
-        }
-        else
-        {
-            static_assert(false, "nyi: convert to hw float32");
-            return float32_t::indeterminate_nan();
-        }
+    explicit constexpr operator floatbase_t<fp_format::bfloat16>() const
+    {
+        return convert_to<floatbase_t<fp_format::bfloat16>>();
     }
 
-    explicit constexpr operator floatbase_t<fp_format::binary64>() const
+    explicit constexpr operator floatbase_t<fp_format::binary16>() const
     {
-        static_assert(format != fp_format::binary64, "convert from T to T is impossible");
+        return convert_to<floatbase_t<fp_format::binary16>>();
+    }
 
-        if constexpr (format == fp_format::binary128)
-        {
-            return to_narrowfp<float64_t>();
-        }
-        else if constexpr (format == fp_format::binary16
-            || format == fp_format::binary32)
-        {
-            return to_widefp<float64_t>();
-        }
-        else
-        {
-            static_assert(false, "nyi: convert to hw float64");
-            return float64_t::indeterminate_nan();
-        }
+    explicit constexpr operator floatbase_t<fp_format::binary32>() const
+    {
+        return convert_to<floatbase_t<fp_format::binary32>>();
+    }
+
+    explicit constexpr operator floatbase_t<fp_format::binary64>() const
+    {
+        return convert_to<floatbase_t<fp_format::binary64>>();
     }
 
 #if 0
@@ -544,17 +570,20 @@ public:
 
 public:
 
+    // 8-bit formats would print as characters
+    using print_uint_t = details::selector_t<(bitsize < 16), unsigned, uint_t>;
+
     std::string to_triplet_string() const
     {
         fp_components x = decompose();
         std::stringstream ss;
-        ss << "{" << (x.sign ? "-" : "+") << ", " << x.exponent << ", 0x" << std::hex << x.significand << "}";
+        ss << "{" << (x.sign ? "-" : "+") << ", " << x.exponent << ", 0x" << std::hex << static_cast<print_uint_t>(x.significand) << "}";
         return ss.str();
     }
 
     std::string to_hex_string() const {
         std::stringstream ss;
-        ss << "0x" << std::hex << raw_value;
+        ss << "0x" << std::hex << static_cast<print_uint_t>(raw_value);
         return ss.str();
     }
 
@@ -1088,7 +1117,7 @@ public:
         if (exponent < emin) {
             while (exponent < emin) {
                 ++exponent;
-                roundoff_bits >>= 1;
+                roundoff_bits = (roundoff_bits >> 1) | (roundoff_bits & 1); // keep the sticky bit
                 roundoff_bits |= (significand & 1) << (bitsize - 1);
                 significand >>= 1;
 
@@ -1211,7 +1240,7 @@ public:
         else if (exponent < emin) {
             while (exponent < emin) {
                 ++exponent;
-                roundoff_bits >>= 1;
+                roundoff_bits = (roundoff_bits >> 1) | (roundoff_bits & 1); // keep the sticky bit
                 roundoff_bits |= (significand & 1) << (bitsize - 1);
                 significand >>= 1;
 
@@ -1246,7 +1275,7 @@ public:
     //
 public:
 
-    bool operator==(floatbase_t other)
+    bool operator==(floatbase_t other) const
     {
         auto is_nan = [](uint_t x) {
             constexpr uint_t exp_mask = (exponent_mask << significand_bitsize);
@@ -1271,7 +1300,7 @@ public:
         return false;
     }
 
-    bool operator!=(floatbase_t other) { return !operator==(other); }
+    bool operator!=(floatbase_t other) const { return !operator==(other); }
 
  private:
  
@@ -1319,7 +1348,7 @@ public:
 
  public:
 
-    bool operator<(floatbase_t other)
+    bool operator<(floatbase_t other) const
     {
         fp_components l = this->decompose();
         fp_components r = other.decompose();
@@ -1332,7 +1361,7 @@ public:
         return compare_lt<false>(l, r);
     }
 
-    bool operator<=(floatbase_t other)
+    bool operator<=(floatbase_t other) const
     {
         fp_components l = this->decompose();
         fp_components r = other.decompose();
@@ -1345,7 +1374,7 @@ public:
         return compare_lt<true>(l, r);
     }
 
-    bool operator>(floatbase_t other)
+    bool operator>(floatbase_t other) const
     {
         fp_components l = this->decompose();
         fp_components r = other.decompose();
@@ -1357,7 +1386,7 @@ public:
         return compare_lt<false>(r, l);
     }
 
-    bool operator>=(floatbase_t other)
+    bool operator>=(floatbase_t other) const
     {
         fp_components l = this->decompose();
         fp_components r = other.decompose();
@@ -1380,11 +1409,14 @@ public:
     // to keep floatbase_t interface similar to built-in float/double while
     // still allowing easy creation from integer values.
     static constexpr floatbase_t from_bitstring(uint_t t) { auto f = floatbase_t{}; f.raw_value = t; return f; }
+    constexpr uint_t to_bitstring() const { return raw_value; }
     static constexpr floatbase_t from_triplet(bool sign, exponent_t exponent, uint_t significand) {
         return floatbase_t{ static_cast<uint_t>(sign), exponent, significand };
     }
 };
 
+using float8_e5m2_t = floatbase_t<fp_format::float8_e5m2>;
+using bfloat16_t = floatbase_t<fp_format::bfloat16>;
 using float16_t = floatbase_t<fp_format::binary16>;
 using float32_t = floatbase_t<fp_format::binary32>;
 using float64_t = floatbase_t<fp_format::binary64>;
@@ -1392,6 +1424,8 @@ using float64_t = floatbase_t<fp_format::binary64>;
 using float128_t = floatbase_t<fp_format::binary128>;
 #endif
 
+inline std::string to_string(float8_e5m2_t swfp) { return std::to_string(static_cast<float>(swfp)); }
+inline std::string to_string(bfloat16_t swfp) { return std::to_string(static_cast<float>(swfp)); }
 inline std::string to_string(float16_t swfp) { return std::to_string(static_cast<float>(swfp)); }
 inline std::string to_string(float32_t swfp) { return std::to_string(static_cast<float>(swfp)); }
 inline std::string to_string(float64_t swfp) { return std::to_string(static_cast<double>(swfp)); }
@@ -1407,6 +1441,8 @@ inline std::string to_string(float128_t swfp)
 }
 #endif
 
+inline std::wstring to_wstring(float8_e5m2_t swfp) { return std::to_wstring(static_cast<float>(swfp)); }
+inline std::wstring to_wstring(bfloat16_t swfp) { return std::to_wstring(static_cast<float>(swfp)); }
 inline std::wstring to_wstring(float16_t swfp) { return std::to_wstring(static_cast<float>(swfp)); }
 inline std::wstring to_wstring(float32_t swfp) { return std::to_wstring(static_cast<float>(swfp)); }
 inline std::wstring to_wstring(float64_t swfp) { return std::to_wstring(static_cast<double>(swfp)); }
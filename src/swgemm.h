@@ -0,0 +1,248 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+#include "swfp.h"
+#include "swunpacked.h"
+#include "swbatch.h"
+#include "swexec.h"
+
+//
+// Mixed-precision matrix multiply
+//
+// gemm<acc, out>(m, n, k, a, lda, b, ldb, c, ldc) computes the row-major
+// product c = a * b of `in` values with an `acc` accumulator per element of c:
+//
+//      acc_0 = +0
+//      acc_p+1 = fma_wide<acc>(a[i][p], b[p][j], acc_p)    // rounds once
+//      c[i][j] = (out)acc_k
+//
+// The terms always go in in order of p, so the result does not depend on the
+// blocking or the thread count and matches an accelerator that accumulates
+// the same way. NaN results are stored as the indeterminate NaN of `out`.
+//
+// B is packed into kc x nr micro-panels that stay in L1 and kc x nc blocks
+// that stay in L3, A into mc x kc blocks that stay in L2. An mr x nr register
+// tile of accumulators is updated over a whole micro-panel at a time; row
+// blocks of C run on the thread pool, and the accumulators of C are kept
+// between kc blocks in the `acc` format, so every step still rounds once.
+//
+// When the products of `in` values are exact in double (inputs up to
+// binary32) and `acc` is binary32 or binary64, the kernel runs on hardware
+// doubles: the product is exact and the sum rounds once directly into a
+// binary64 accumulator, or to odd and then to nearest into a binary32 one,
+// which gives the same bits as fma_wide. Other combinations run fma_wide.
+//
+
+struct gemm_blocking
+{
+    size_t mc = 128;        // rows of A per packed block, L2
+    size_t kc = 256;        // depth of the packed panels, L1
+    size_t nc = 2048;       // columns of B per packed block, L3
+};
+
+namespace details
+{
+    constexpr size_t gemm_mr = 4;
+    constexpr size_t gemm_nr = 8;
+
+#if defined(USE_SSE2)
+    constexpr bool gemm_hardware = true;
+#else
+    constexpr bool gemm_hardware = false;
+#endif
+
+    template<fp_format in, fp_format acc>
+    constexpr bool gemm_lifted = gemm_hardware && (acc == fp_format::binary32 || acc == fp_format::binary64)
+        && sizeof(typename fp_traits<in>::uint_t) <= sizeof(uint32_t);
+
+    // c + a * b rounded once to binary32 for a * b exact in double: the sum
+    // is rounded to odd in double, 53 bits are enough for the final rounding
+    // to nearest to be correct
+    inline float gemm_fma_binary32(double a, double b, float c)
+    {
+        const double product = a * b;
+        const double sum = c + product;
+
+        // two_sum error of the double addition
+        const double bb = sum - c;
+        const double error = (c - (sum - bb)) + (product - bb);
+
+        uint64_t bits = bit_cast<uint64_t>(sum);
+        const uint64_t exponent_mask = 0x7ff0000000000000ull;
+        if (error != 0 && (bits & 1) == 0 && (bits & exponent_mask) != exponent_mask) {
+            // the neighbour towards the exact value is odd
+            bits = (error > 0) == (sum > 0) ? bits + 1 : bits - 1;
+        }
+        return static_cast<float>(bit_cast<double>(bits));
+    }
+
+    // packed operand and accumulator types and the multiply-add step
+    template<fp_format in, fp_format acc, bool lifted = gemm_lifted<in, acc>>
+    struct gemm_traits
+    {
+        using element_t = floatbase_t<in>;
+        using acc_t = floatbase_t<acc>;
+
+        static element_t load(floatbase_t<in> x) { return x; }
+        static acc_t zero() { return acc_t::zero(); }
+        static acc_t fma(element_t a, element_t b, acc_t c) { return fma_wide<acc>(a, b, c); }
+        static floatbase_t<acc> store(acc_t x) { return x; }
+    };
+
+    template<fp_format in>
+    struct gemm_traits<in, fp_format::binary64, true>
+    {
+        using element_t = double;
+        using acc_t = double;
+
+        static element_t load(floatbase_t<in> x) { return static_cast<double>(x); }
+        static acc_t zero() { return 0.0; }
+        static acc_t fma(element_t a, element_t b, acc_t c) { return c + a * b; }
+        static floatbase_t<fp_format::binary64> store(acc_t x) { return float64_t(x); }
+    };
+
+    template<fp_format in>
+    struct gemm_traits<in, fp_format::binary32, true>
+    {
+        using element_t = double;
+        using acc_t = float;
+
+        static element_t load(floatbase_t<in> x) { return static_cast<double>(x); }
+        static acc_t zero() { return 0.0f; }
+        static acc_t fma(element_t a, element_t b, acc_t c) { return gemm_fma_binary32(a, b, c); }
+        static floatbase_t<fp_format::binary32> store(acc_t x) { return float32_t(x); }
+    };
+
+    // rows [row, row + rows) x depth [depth, depth + depths) of A in mr-row
+    // panels, p-major inside a panel; missing rows are zero
+    template<typename traits, fp_format in>
+    void gemm_pack_a(const floatbase_t<in> *a, size_t lda, size_t row, size_t rows, size_t depth, size_t depths, typename traits::element_t *packed)
+    {
+        const auto zero = traits::load(floatbase_t<in>::zero());
+        for (size_t panel = 0; panel < rows; panel += gemm_mr) {
+            for (size_t p = 0; p < depths; ++p) {
+                for (size_t i = 0; i < gemm_mr; ++i) {
+                    *packed++ = panel + i < rows ? traits::load(a[(row + panel + i) * lda + depth + p]) : zero;
+                }
+            }
+        }
+    }
+
+    // depth [depth, depth + depths) x columns [column, column + columns) of B
+    // in nr-column panels, p-major inside a panel; missing columns are zero
+    template<typename traits, fp_format in>
+    void gemm_pack_b(const floatbase_t<in> *b, size_t ldb, size_t depth, size_t depths, size_t column, size_t columns, typename traits::element_t *packed)
+    {
+        const auto zero = traits::load(floatbase_t<in>::zero());
+        for (size_t panel = 0; panel < columns; panel += gemm_nr) {
+            for (size_t p = 0; p < depths; ++p) {
+                for (size_t j = 0; j < gemm_nr; ++j) {
+                    *packed++ = panel + j < columns ? traits::load(b[(depth + p) * ldb + column + panel + j]) : zero;
+                }
+            }
+        }
+    }
+
+    // the mr x nr tile of accumulators at c += a panel * b panel, only the
+    // first rows x columns of the tile exist
+    template<typename traits>
+    void gemm_microkernel(const typename traits::element_t *a, const typename traits::element_t *b, size_t depths,
+        typename traits::acc_t *c, size_t ldc, size_t rows, size_t columns)
+    {
+        typename traits::acc_t tile[gemm_mr][gemm_nr];
+        for (size_t i = 0; i < gemm_mr; ++i) {
+            for (size_t j = 0; j < gemm_nr; ++j) {
+                tile[i][j] = i < rows && j < columns ? c[i * ldc + j] : traits::zero();
+            }
+        }
+
+        for (size_t p = 0; p < depths; ++p, a += gemm_mr, b += gemm_nr) {
+            for (size_t i = 0; i < gemm_mr; ++i) {
+                for (size_t j = 0; j < gemm_nr; ++j) {
+                    tile[i][j] = traits::fma(a[i], b[j], tile[i][j]);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                c[i * ldc + j] = tile[i][j];
+            }
+        }
+    }
+
+    template<fp_format out, fp_format acc>
+    floatbase_t<out> gemm_result(floatbase_t<acc> x)
+    {
+        if (is_nan(x)) {
+            return floatbase_t<out>::indeterminate_nan();
+        }
+        return static_cast<floatbase_t<out>>(x);
+    }
+}
+
+template<fp_format acc, fp_format out = acc, fp_format in>
+void gemm(size_t m, size_t n, size_t k, const floatbase_t<in> *a, size_t lda, const floatbase_t<in> *b, size_t ldb,
+    floatbase_t<out> *c, size_t ldc, thread_pool &pool = default_thread_pool(), const gemm_blocking &blocking = {})
+{
+    using traits = details::gemm_traits<in, acc>;
+    using element_t = typename traits::element_t;
+    using acc_t = typename traits::acc_t;
+
+    static_assert(sizeof(typename fp_traits<in>::uint_t) <= sizeof(typename fp_traits<acc>::uint_t), "the accumulator cannot be narrower than the inputs");
+
+    constexpr size_t mr = details::gemm_mr;
+    constexpr size_t nr = details::gemm_nr;
+    const size_t mc = std::max(mr, blocking.mc / mr * mr);
+    const size_t nc = std::max(nr, blocking.nc / nr * nr);
+    const size_t kc = std::max<size_t>(1, blocking.kc);
+
+    std::vector<acc_t> accumulators(m * n, traits::zero());
+    std::vector<element_t> packed_b(kc * nc);
+    std::vector<std::vector<element_t>> packed_a(pool.size(), std::vector<element_t>(mc * kc));
+
+    const size_t row_blocks = (m + mc - 1) / mc;
+    for (size_t jc = 0; jc < n; jc += nc) {
+        const size_t columns = std::min(nc, n - jc);
+        const size_t panels = (columns + nr - 1) / nr;
+
+        for (size_t pc = 0; pc < k; pc += kc) {
+            const size_t depths = std::min(kc, k - pc);
+
+            pool.parallel_for(0, panels, 1, [&](size_t begin, size_t end, unsigned) {
+                for (size_t panel = begin; panel < end; ++panel) {
+                    details::gemm_pack_b<traits>(b, ldb, pc, depths, jc + panel * nr, std::min(nr, columns - panel * nr), packed_b.data() + panel * nr * depths);
+                }
+            });
+
+            pool.parallel_for(0, row_blocks, 1, [&](size_t begin, size_t end, unsigned worker) {
+                element_t *block = packed_a[worker].data();
+                for (size_t ic_block = begin; ic_block < end; ++ic_block) {
+                    const size_t ic = ic_block * mc;
+                    const size_t rows = std::min(mc, m - ic);
+                    details::gemm_pack_a<traits>(a, lda, ic, rows, pc, depths, block);
+
+                    for (size_t jr = 0; jr < columns; jr += nr) {
+                        for (size_t ir = 0; ir < rows; ir += mr) {
+                            details::gemm_microkernel<traits>(block + ir * depths, packed_b.data() + jr * depths, depths,
+                                accumulators.data() + (ic + ir) * n + jc + jr, n, std::min(mr, rows - ir), std::min(nr, columns - jr));
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    pool.parallel_for(0, m, 1, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                c[i * ldc + j] = details::gemm_result<out>(traits::store(accumulators[i * n + j]));
+            }
+        }
+    });
+}
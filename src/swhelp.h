@@ -2,6 +2,7 @@
 #pragma once
 
 #include <intrin.h>
+#include <stdlib.h>
 #include <type_traits>
 #if BIT_CAST_EXISTS
 #include <bit>
@@ -89,6 +90,115 @@ namespace details {
         }
     }
 
+    // wrappers for the popcnt, bit scan, byteswap and double shift intrinsics on
+    // unsigned built-in integers, with loops for constexpr evaluation
+    template<typename uint_t, typename = std::enable_if_t<std::is_integral_v<uint_t> && std::is_unsigned_v<uint_t>>>
+    constexpr int popcount(uint_t x)
+    {
+        if (is_constant_evaluated()) {
+            int count = 0;
+            for (; x != 0; x = static_cast<uint_t>(x & (x - 1))) {
+                ++count;
+            }
+            return count;
+        }
+        else if constexpr (sizeof(uint_t) <= sizeof(uint16_t)) {
+            return static_cast<int>(__popcnt16(x));
+        }
+        else if constexpr (sizeof(uint_t) == sizeof(uint32_t)) {
+            return static_cast<int>(__popcnt(x));
+        }
+        else {
+            return static_cast<int>(__popcnt64(x));
+        }
+    }
+
+    template<typename uint_t, typename = std::enable_if_t<std::is_integral_v<uint_t> && std::is_unsigned_v<uint_t>>>
+    constexpr int countl_zero(uint_t x)
+    {
+        constexpr int bitsize = sizeof(uint_t) * 8;
+        unsigned long index = 0;
+        return reverse_bit_scan(&index, x) ? bitsize - 1 - static_cast<int>(index) : bitsize;
+    }
+
+    template<typename uint_t, typename = std::enable_if_t<std::is_integral_v<uint_t> && std::is_unsigned_v<uint_t>>>
+    constexpr int countr_zero(uint_t x)
+    {
+        constexpr int bitsize = sizeof(uint_t) * 8;
+        if (is_constant_evaluated()) {
+            for (int i = 0; i < bitsize; ++i) {
+                if ((x >> i) & 1) {
+                    return i;
+                }
+            }
+            return bitsize;
+        }
+
+        unsigned long index = 0;
+        if constexpr (sizeof(uint_t) <= sizeof(uint32_t)) {
+            return _BitScanForward(&index, x) ? static_cast<int>(index) : bitsize;
+        }
+        else {
+            return _BitScanForward64(&index, x) ? static_cast<int>(index) : bitsize;
+        }
+    }
+
+    template<typename uint_t, typename = std::enable_if_t<std::is_integral_v<uint_t> && std::is_unsigned_v<uint_t>>>
+    constexpr uint_t byteswap(uint_t x)
+    {
+        if constexpr (sizeof(uint_t) == sizeof(uint8_t)) {
+            return x;
+        }
+        else if (is_constant_evaluated()) {
+            uint_t r = 0;
+            for (int i = 0; i < static_cast<int>(sizeof(uint_t)); ++i) {
+                r = static_cast<uint_t>((r << 8) | ((x >> (8 * i)) & 0xff));
+            }
+            return r;
+        }
+        else if constexpr (sizeof(uint_t) == sizeof(uint16_t)) {
+            return _byteswap_ushort(x);
+        }
+        else if constexpr (sizeof(uint_t) == sizeof(uint32_t)) {
+            return static_cast<uint_t>(_byteswap_ulong(x));
+        }
+        else {
+            return _byteswap_uint64(x);
+        }
+    }
+
+    // the upper half of (high:low) << amount, for 0 <= amount < bit size
+    template<typename uint_t, typename = std::enable_if_t<std::is_integral_v<uint_t> && std::is_unsigned_v<uint_t>>>
+    constexpr uint_t funnel_shift_left(uint_t high, uint_t low, int amount)
+    {
+        constexpr int bitsize = sizeof(uint_t) * 8;
+        if constexpr (sizeof(uint_t) < sizeof(uint64_t)) {
+            return static_cast<uint_t>((((uint64_t(high) << bitsize) | low) << amount) >> bitsize);
+        }
+        else if (is_constant_evaluated()) {
+            return amount == 0 ? high : (high << amount) | (low >> (bitsize - amount));
+        }
+        else {
+            return __shiftleft128(low, high, static_cast<unsigned char>(amount));
+        }
+    }
+
+    // the lower half of (high:low) >> amount, for 0 <= amount < bit size
+    template<typename uint_t, typename = std::enable_if_t<std::is_integral_v<uint_t> && std::is_unsigned_v<uint_t>>>
+    constexpr uint_t funnel_shift_right(uint_t high, uint_t low, int amount)
+    {
+        constexpr int bitsize = sizeof(uint_t) * 8;
+        if constexpr (sizeof(uint_t) < sizeof(uint64_t)) {
+            return static_cast<uint_t>(((uint64_t(high) << bitsize) | low) >> amount);
+        }
+        else if (is_constant_evaluated()) {
+            return amount == 0 ? low : (low >> amount) | (high << (bitsize - amount));
+        }
+        else {
+            return __shiftright128(low, high, static_cast<unsigned char>(amount));
+        }
+    }
+
     template<typename integral_t, typename = std::enable_if_t<std::is_integral_v<integral_t>>>
     constexpr bool is_pow_2(integral_t mask) {
         bool bitfound = false;
@@ -3,6 +3,10 @@
 
 #include <stdint.h>
 #include <cstddef>
+#include <array>
+#include <string>
+#include <cstring>
+#include <charconv>
 
 #include "swhelp.h"
 
@@ -10,19 +14,36 @@
 #define USE_SW_INT128 1
 #endif
 
+namespace details
+{
+    // intbase_t layouts: two halves of the next smaller type, or a flat array
+    // of 64-bit limbs (the default above 128 bits)
+    struct int_halves {};
+    struct int_limbs {};
+
+    template<size_t byte_size> using int_layout_t = selector_t<(byte_size > 16), int_limbs, int_halves>;
+}
+
 // forward declare
-template<size_t byte_size, bool is_signed> class intbase_t;
+template<size_t byte_size, bool is_signed, typename layout = details::int_layout_t<byte_size>> class intbase_t;
+
+template<size_t byte_size, bool is_signed, typename layout>
+std::to_chars_result to_chars(char *first, char *last, intbase_t<byte_size, is_signed, layout> value);
 
 // define software implementation of integral typess
 namespace details
 {
 
-template<size_t byte_size> struct int_traits { using halfint_t = typename intbase_t<byte_size / 2, false>; };
+template<size_t byte_size> struct int_traits { using halfint_t = typename intbase_t<byte_size / 2, false, int_halves>; };
 template<> struct int_traits<16> { using halfint_t = uint64_t; };
 template<> struct int_traits<8> { using halfint_t = uint32_t; };
 template<> struct int_traits<4> { using halfint_t = uint16_t; };
 template<> struct int_traits<2> { using halfint_t = uint8_t; };
 
+// signed type of a half, without instantiating std::make_signed for class types
+template<typename halfint_t, bool = std::is_integral_v<halfint_t>> struct signed_half { using type = std::make_signed_t<halfint_t>; };
+template<typename halfint_t> struct signed_half<halfint_t, false> { using type = intbase_t<sizeof(halfint_t), true, int_halves>; };
+
 template<typename uint_t, typename = std::enable_if_t<std::is_integral_v<uint_t> && std::is_unsigned_v<uint_t>>>
 constexpr uint_t add_carry(uint_t a, uint_t b, uint8_t &carry)
 {
@@ -135,7 +156,7 @@ __declspec(noreturn) __declspec(noinline) void divide_by_zero() {
 }
 
 
-template<size_t byte_size, bool is_signed>
+template<size_t byte_size, bool is_signed, typename layout>
 class intbase_t
 {
     static_assert(byte_size > 1, "expecting 2 bytes or more");
@@ -146,13 +167,10 @@ public:
     static constexpr bool is_signed = is_signed;
 
 private:
-    using signed_t = intbase_t<byte_size, true>;
-    using unsigned_t = intbase_t<byte_size, false>;
+    using signed_t = intbase_t<byte_size, true, layout>;
+    using unsigned_t = intbase_t<byte_size, false, layout>;
     using halfint_t = typename details::int_traits<byte_size>::halfint_t;
-    using shalfint_t = details::selector_t<std::is_integral_v<halfint_t>,
-        std::make_signed_t<halfint_t>,
-        intbase_t<sizeof(halfint_t), true>
-    >;
+    using shalfint_t = typename details::signed_half<halfint_t>::type;
 
     static constexpr size_t bitsize = byte_size * 8;
     static constexpr size_t half_bitsize = sizeof(halfint_t) * 8;
@@ -162,10 +180,94 @@ private:
     halfint_t lower_half;
     halfint_t upper_half;
 
+    template<size_t, bool, typename> friend class intbase_t;
+
     constexpr intbase_t(halfint_t upper_half, halfint_t lower_half) : lower_half(lower_half), upper_half(upper_half) {
 
     }
 
+    // carry chain steps on a half, built-in or intbase_t
+    static constexpr halfint_t half_add_carry(halfint_t a, halfint_t b, uint8_t &carry)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::add_carry(a, b, carry);
+        } else {
+            return halfint_t::add_carry(a, b, carry);
+        }
+    }
+
+    static constexpr halfint_t half_sub_borrow(halfint_t a, halfint_t b, uint8_t &borrow)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::sub_borrow(a, b, borrow);
+        } else {
+            return halfint_t::sub_borrow(a, b, borrow);
+        }
+    }
+
+    static constexpr halfint_t half_mul_extended(halfint_t a, halfint_t b, halfint_t &upper)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::mul_extended(a, b, upper);
+        } else {
+            return halfint_t::multiply_extended(a, b, upper);
+        }
+    }
+
+    static constexpr halfint_t half_funnel_shift_left(halfint_t high, halfint_t low, int amount)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::funnel_shift_left(high, low, amount);
+        } else {
+            return halfint_t::funnel_shift_left(high, low, amount);
+        }
+    }
+
+    static constexpr halfint_t half_funnel_shift_right(halfint_t high, halfint_t low, int amount)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::funnel_shift_right(high, low, amount);
+        } else {
+            return halfint_t::funnel_shift_right(high, low, amount);
+        }
+    }
+
+    static constexpr int half_popcount(halfint_t x)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::popcount(x);
+        } else {
+            return halfint_t::popcount(x);
+        }
+    }
+
+    static constexpr int half_countl_zero(halfint_t x)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::countl_zero(x);
+        } else {
+            return halfint_t::countl_zero(x);
+        }
+    }
+
+    static constexpr int half_countr_zero(halfint_t x)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::countr_zero(x);
+        } else {
+            return halfint_t::countr_zero(x);
+        }
+    }
+
+    static constexpr halfint_t half_byteswap(halfint_t x)
+    {
+        if constexpr (std::is_integral_v<halfint_t>) {
+            return details::byteswap(x);
+        } else {
+            return halfint_t::byteswap(x);
+        }
+    }
+
 public:
 
     intbase_t() = default;
@@ -178,12 +280,12 @@ public:
         }
         else if constexpr (sizeof(integral_t) <= sizeof(halfint_t))
         {
-            lower_half = val;
+            lower_half = static_cast<halfint_t>(val);
             if constexpr (std::is_signed_v<integral_t>) {
-                upper_half = (val & topbit_mask) ? allones_mask : 0;
+                upper_half = (val < 0) ? allones_mask : halfint_t(0);
             }
             else {
-                upper_half = 0;
+                upper_half = halfint_t(0);
             }
         }
         else
@@ -212,7 +314,7 @@ public:
 
     static constexpr intbase_t min() {
         if constexpr (is_signed) {
-            return intbase_t(static_cast<halfint_t>(halfint_t(1) << (half_bitsize - 1)), 0);
+            return intbase_t(topbit_mask, halfint_t(0));
         }
         else {
             return intbase_t(0);
@@ -269,20 +371,20 @@ public:
     constexpr intbase_t operator+(intbase_t other) const
     {
         uint8_t carry = 0;
-        halfint_t lower_sum = details::add_carry(this->lower_half, other.lower_half, carry);
-        return intbase_t(this->upper_half + other.upper_half + carry, lower_sum);
+        halfint_t lower_sum = half_add_carry(this->lower_half, other.lower_half, carry);
+        return intbase_t(this->upper_half + other.upper_half + halfint_t(carry), lower_sum);
     }
 
     constexpr intbase_t operator-(intbase_t other) const
     {
         uint8_t borrow = 0 ;
-        halfint_t lower_diff = details::sub_borrow(this->lower_half, other.lower_half, borrow);
-        return intbase_t(this->upper_half - other.upper_half - borrow, lower_diff);
+        halfint_t lower_diff = half_sub_borrow(this->lower_half, other.lower_half, borrow);
+        return intbase_t(this->upper_half - other.upper_half - halfint_t(borrow), lower_diff);
     }
 
     constexpr intbase_t operator*(intbase_t other) const
     {
-        halfint_t carry = 0, ll = details::mul_extended(this->lower_half, other.lower_half, carry);
+        halfint_t carry = halfint_t(0), ll = half_mul_extended(this->lower_half, other.lower_half, carry);
         halfint_t lu = this->lower_half * other.upper_half;
         halfint_t ul = this->upper_half * other.lower_half;
         return intbase_t(lu + ul + carry, ll);
@@ -295,26 +397,32 @@ private:
     {
         div_t result{};
 
-        if (divisor == intbase_t(0)) {
+        if (!divisor) {
             // handle divide-by-zero
             details::divide_by_zero();
         }
 
         int qsign = 0;
+        bool rem_negative = false;
         if constexpr (is_signed) {
             if (dividend.upper_half & topbit_mask) {
                 qsign ^= 1;
+                rem_negative = true;
                 dividend = -dividend;
             }
             if (divisor.upper_half & topbit_mask) {
                 qsign ^= 1;
                 divisor = -divisor;
             }
-        }
 
-        if (dividend.upper_half == 0 && divisor.upper_half == 0) {
+            // divide the magnitudes as unsigned, -min() only fits unsigned
+            const auto magnitude = unsigned_t::div(unsigned_t(dividend.upper_half, dividend.lower_half), unsigned_t(divisor.upper_half, divisor.lower_half));
+            result.quot = intbase_t(magnitude.quot.upper_half, magnitude.quot.lower_half);
+            result.rem = intbase_t(magnitude.rem.upper_half, magnitude.rem.lower_half);
+        }
+        else if (dividend.upper_half == halfint_t(0) && divisor.upper_half == halfint_t(0)) {
             result.quot.lower_half = dividend.lower_half / divisor.lower_half;
-            result.rem.lower_half = dividend.lower_half % divisor.lower_half;
+            result.rem.lower_half = static_cast<halfint_t>(dividend.lower_half - result.quot.lower_half * divisor.lower_half);
         }
         else {
 
@@ -361,9 +469,14 @@ private:
             if (qsign) {
                 result.quot = -result.quot;
             }
+            if (rem_negative) {
+                // the remainder has the sign of the dividend
+                result.rem = -result.rem;
+            }
         }
         else {
             (qsign);
+            (rem_negative);
         }
 
         return result;
@@ -379,15 +492,15 @@ public:
 
     constexpr intbase_t operator%(intbase_t other) const
     {
-        // todo: handle carry
-        return intbase_t(this->upper_half % other.upper_half, this->lower_half % other.lower_half);
+        auto result = div(*this, other);
+        return result.rem;
     }
 
     constexpr intbase_t operator-() const
     {
-        halfint_t l = static_cast<halfint_t>(-static_cast<shalfint_t>(this->lower_half));
-        halfint_t h = static_cast<halfint_t>(-static_cast<shalfint_t>(this->upper_half));
-        h = static_cast<halfint_t>(h - ((l != 0) ? 1 : 0));
+        halfint_t l = static_cast<halfint_t>(halfint_t(0) - this->lower_half);
+        halfint_t h = static_cast<halfint_t>(halfint_t(0) - this->upper_half);
+        h = static_cast<halfint_t>(h - ((l != halfint_t(0)) ? halfint_t(1) : halfint_t(0)));
         return intbase_t(h, l);
     }
 
@@ -472,34 +585,13 @@ public:
             all <<= amount;
             return static_cast<intbase_t>(all);
         }
-        else if constexpr (sizeof(intbase_t) == 16)
-        {
-            if ((amount & 63) != amount) {
-                return intbase_t(this->lower_half << (amount & 63), 0);
-            }
-
-            intbase_t out;
-            out.lower_half = this->lower_half << amount;
-            out.upper_half = __shiftleft128(this->lower_half, this->upper_half, static_cast<unsigned char>(amount));
-            return out;
-        }
         else
         {
-            // geneal purpose left shift
-            // todo: hand optimize for larger shifts as optimzer does a bad job of this
-
-            halfint_t h = this->upper_half;
-            halfint_t l = this->lower_half;
-
+            // the upper half takes the bits shifted out of the lower half
             if (amount >= half_bitsize) {
-                amount -= half_bitsize;
-                return intbase_t(l << amount, 0);
+                return intbase_t(this->lower_half << (amount - static_cast<int>(half_bitsize)), halfint_t(0));
             }
-
-            h <<= amount;
-            h |= l >> (half_bitsize - amount);
-            l <<= amount;
-            return intbase_t(h, l);
+            return intbase_t(half_funnel_shift_left(this->upper_half, this->lower_half, amount), this->lower_half << amount);
         }
     }
 
@@ -514,50 +606,18 @@ public:
             all >>= amount;
             return static_cast<intbase_t>(all);
         }
-        else if constexpr (sizeof(intbase_t) == 16)
-        {
-            using shift_type_t = details::selector_t<is_signed, shalfint_t, halfint_t>;
-            if ((amount & 63) != amount) {
-                halfint_t top_half = 0;
-                if constexpr (is_signed) {
-                    if (this->upper_half & topbit_mask) {
-                        top_half = allones_mask;
-                    }
-                }
-
-                return intbase_t(top_half, static_cast<shift_type_t>(this->upper_half) >> (amount & 63));
-            }
-
-            intbase_t out;
-            out.upper_half = static_cast<shift_type_t>(this->upper_half) >> amount;
-            out.lower_half = __shiftright128(this->lower_half, this->upper_half, static_cast<unsigned char>(amount));
-            return out;
-        }
         else {
-            halfint_t mask = ((halfint_t(1) << amount) - 1);
-
-            details::selector_t<is_signed, shalfint_t, halfint_t> h = this->upper_half;
-            halfint_t l = this->lower_half;
+            // the halves are unsigned, so shift in ones above a negative value
+            const bool negative = is_signed && !!(this->upper_half & topbit_mask);
+            const halfint_t fill = negative ? allones_mask : halfint_t(0);
 
             if (amount >= half_bitsize) {
-                amount -= half_bitsize;
-                if constexpr (is_signed) {
-                    if (h & topbit_mask) {
-                        return intbase_t(allones_mask, h >> amount);
-                    }
-                }
-                return intbase_t(0, h >> amount);
+                return intbase_t(fill, half_funnel_shift_right(fill, this->upper_half, amount - static_cast<int>(half_bitsize)));
             }
-
-            l >>= amount;
-            l |= (h & mask) << (half_bitsize - amount);
-            h >>= amount;
-
-            return intbase_t(h, l);
+            return intbase_t(half_funnel_shift_right(fill, this->upper_half, amount), half_funnel_shift_right(this->upper_half, this->lower_half, amount));
         }
     }
 
-
     constexpr intbase_t operator&(intbase_t other) const {
         return intbase_t(this->upper_half & other.upper_half, this->lower_half & other.lower_half);
     }
@@ -587,6 +647,12 @@ public:
     constexpr bool operator!=(intbase_t other) const { return !this->operator==(other); }
 
     constexpr bool operator<(intbase_t other) const {
+        if constexpr (is_signed) {
+            // opposite signs order by the sign bit alone
+            const bool negative = !!(this->upper_half & topbit_mask);
+            if (negative != !!(other.upper_half & topbit_mask))
+                return negative;
+        }
         if (this->upper_half < other.upper_half)
             return true;
         if (this->upper_half > other.upper_half)
@@ -594,6 +660,12 @@ public:
         return this->lower_half < other.lower_half; 
     }
     constexpr bool operator<=(intbase_t other) const {
+        if constexpr (is_signed) {
+            // opposite signs order by the sign bit alone
+            const bool negative = !!(this->upper_half & topbit_mask);
+            if (negative != !!(other.upper_half & topbit_mask))
+                return negative;
+        }
         if (this->upper_half < other.upper_half)
             return true;
         if (this->upper_half > other.upper_half)
@@ -613,41 +685,100 @@ public:
     {
         if constexpr (std::is_integral_v<halfint_t>) {
             if (details::reverse_bit_scan(index, value.upper_half)) {
-                return index + sizeof(halfint_t);
+                *index += static_cast<unsigned long>(half_bitsize);
+                return true;
             }
             return details::reverse_bit_scan(index, value.lower_half);
         } else {
             if (halfint_t::reverse_bit_scan(index, value.upper_half)) {
-                return index + sizeof(halfint_t);
+                *index += static_cast<unsigned long>(half_bitsize);
+                return true;
             }
             return halfint_t::reverse_bit_scan(index, value.lower_half);
         }
     }
 
-    static constexpr intbase_t add_carry(intbase_t a, intbase_t b, uint8_t &carry)
+    //
+    // bit manipulation, on the bit pattern for signed types
+    //
+
+    static constexpr int popcount(intbase_t value)
     {
-        if constexpr (std::is_integral_v<halfint_t>) {
-            halfint_t lower_sum = details::add_carry(a.lower_half, b.lower_half, carry);
-            halfint_t upper_sum = details::add_carry(a.upper_half, b.upper_half, carry);
-            return intbase_t(upper_sum, lower_sum);
-        } else {
-            halfint_t lower_sum = halfint_t::add_carry(a.lower_half, b.lower_half, carry);
-            halfint_t upper_sum = halfint_t::add_carry(a.upper_half, b.upper_half, carry);
-            return intbase_t(upper_sum, lower_sum);
+        return half_popcount(value.upper_half) + half_popcount(value.lower_half);
+    }
+
+    static constexpr int countl_zero(intbase_t value)
+    {
+        if (!value.upper_half) {
+            return static_cast<int>(half_bitsize) + half_countl_zero(value.lower_half);
         }
+        return half_countl_zero(value.upper_half);
     }
 
-    static constexpr intbase_t sub_borrow(intbase_t a, intbase_t b, uint8_t &borrow)
+    static constexpr int countr_zero(intbase_t value)
     {
-        if constexpr (std::is_integral_v<halfint_t>) {
-            halfint_t lower_diff = details::sub_borrow(a.lower_half, b.lower_half, borrow);
-            halfint_t upper_diff = details::sub_borrow(a.upper_half, b.upper_half, borrow);
-            return intbase_t(upper_diff, lower_diff);
-        } else {
-            halfint_t lower_diff = halfint_t::sub_borrow(a.lower_half, b.lower_half, borrow);
-            halfint_t upper_diff = halfint_t::sub_borrow(a.upper_half, b.upper_half, borrow);
-            return intbase_t(upper_diff, lower_diff);
+        if (!value.lower_half) {
+            return static_cast<int>(half_bitsize) + half_countr_zero(value.upper_half);
+        }
+        return half_countr_zero(value.lower_half);
+    }
+
+    // bits needed to represent value, 0 for 0
+    static constexpr int bit_width(intbase_t value)
+    {
+        return static_cast<int>(bitsize) - countl_zero(value);
+    }
+
+    static constexpr intbase_t byteswap(intbase_t value)
+    {
+        return intbase_t(half_byteswap(value.lower_half), half_byteswap(value.upper_half));
+    }
+
+    // the upper half of (high:low) << amount, for 0 <= amount < bitsize
+    static constexpr intbase_t funnel_shift_left(intbase_t high, intbase_t low, int amount)
+    {
+        if (amount >= half_bitsize) {
+            amount -= static_cast<int>(half_bitsize);
+            return intbase_t(half_funnel_shift_left(high.lower_half, low.upper_half, amount), half_funnel_shift_left(low.upper_half, low.lower_half, amount));
+        }
+        return intbase_t(half_funnel_shift_left(high.upper_half, high.lower_half, amount), half_funnel_shift_left(high.lower_half, low.upper_half, amount));
+    }
+
+    // the lower half of (high:low) >> amount, for 0 <= amount < bitsize
+    static constexpr intbase_t funnel_shift_right(intbase_t high, intbase_t low, int amount)
+    {
+        if (amount >= half_bitsize) {
+            amount -= static_cast<int>(half_bitsize);
+            return intbase_t(half_funnel_shift_right(high.upper_half, high.lower_half, amount), half_funnel_shift_right(high.lower_half, low.upper_half, amount));
         }
+        return intbase_t(half_funnel_shift_right(high.lower_half, low.upper_half, amount), half_funnel_shift_right(low.upper_half, low.lower_half, amount));
+    }
+
+    // rotates by any amount, negative amounts rotate the other way
+    static constexpr intbase_t rotl(intbase_t value, int amount)
+    {
+        amount %= static_cast<int>(bitsize);
+        return funnel_shift_left(value, value, amount < 0 ? amount + static_cast<int>(bitsize) : amount);
+    }
+
+    static constexpr intbase_t rotr(intbase_t value, int amount)
+    {
+        amount %= static_cast<int>(bitsize);
+        return funnel_shift_right(value, value, amount < 0 ? amount + static_cast<int>(bitsize) : amount);
+    }
+
+    static constexpr intbase_t add_carry(intbase_t a, intbase_t b, uint8_t &carry)
+    {
+        halfint_t lower_sum = half_add_carry(a.lower_half, b.lower_half, carry);
+        halfint_t upper_sum = half_add_carry(a.upper_half, b.upper_half, carry);
+        return intbase_t(upper_sum, lower_sum);
+    }
+
+    static constexpr intbase_t sub_borrow(intbase_t a, intbase_t b, uint8_t &borrow)
+    {
+        halfint_t lower_diff = half_sub_borrow(a.lower_half, b.lower_half, borrow);
+        halfint_t upper_diff = half_sub_borrow(a.upper_half, b.upper_half, borrow);
+        return intbase_t(upper_diff, lower_diff);
     }
 
     static constexpr intbase_t multiply_extended(intbase_t a, intbase_t b, intbase_t &prod_hi)
@@ -673,34 +804,22 @@ public:
         //   O -> upper-bits of lower-product, overflow goes to lower-bits of upper-product
         //   I -> upper-bits of lower-product, overflow goes to lower-bits of upper-product
         //   L -> lower-bits of lower-product, overflow goes to upper-bits of lower-product
-        halfint_t carry_ll = 0, ll;
-        halfint_t carry_lu = 0, lu;
-        halfint_t carry_ul = 0, ul;
-        halfint_t carry_uu = 0, uu;
-        if constexpr (std::is_integral_v<halfint_t>) {
-           ll = details::mul_extended(a.lower_half, b.lower_half, carry_ll);
-           lu = details::mul_extended(a.lower_half, b.upper_half, carry_lu);
-           ul = details::mul_extended(a.upper_half, b.lower_half, carry_ul);
-           uu = details::mul_extended(a.upper_half, b.upper_half, carry_uu);
-        }
-        else {
-           ll = halfint_t::multiply_extended(a.lower_half, b.lower_half, carry_ll);
-           lu = halfint_t::multiply_extended(a.lower_half, b.upper_half, carry_lu);
-           ul = halfint_t::multiply_extended(a.upper_half, b.lower_half, carry_ul);
-           uu = halfint_t::multiply_extended(a.upper_half, b.upper_half, carry_uu);
-        }
+        halfint_t carry_ll = halfint_t(0), ll = half_mul_extended(a.lower_half, b.lower_half, carry_ll);
+        halfint_t carry_lu = halfint_t(0), lu = half_mul_extended(a.lower_half, b.upper_half, carry_lu);
+        halfint_t carry_ul = halfint_t(0), ul = half_mul_extended(a.upper_half, b.lower_half, carry_ul);
+        halfint_t carry_uu = halfint_t(0), uu = half_mul_extended(a.upper_half, b.upper_half, carry_uu);
 
         uint8_t carry1 = 0;
         uint8_t carry2 = 0;
 
         auto prod_lo = intbase_t(carry_ll, ll);
-        prod_lo = add_carry(prod_lo, intbase_t(lu, 0), carry1);
-        prod_lo = add_carry(prod_lo, intbase_t(ul, 0), carry2);
+        prod_lo = add_carry(prod_lo, intbase_t(lu, halfint_t(0)), carry1);
+        prod_lo = add_carry(prod_lo, intbase_t(ul, halfint_t(0)), carry2);
 
         prod_hi = intbase_t(carry_uu, uu);
-        prod_hi += intbase_t(0, carry_lu);
-        prod_hi += intbase_t(0, carry_ul);
-        prod_hi += intbase_t(0, carry1 + carry2);
+        prod_hi += intbase_t(halfint_t(0), carry_lu);
+        prod_hi += intbase_t(halfint_t(0), carry_ul);
+        prod_hi += intbase_t(halfint_t(0), halfint_t(carry1 + carry2));
 
         if constexpr (is_signed) {
             if (qsign) {
@@ -718,6 +837,82 @@ public:
         return prod_lo;
     }
 
+    //
+    // overflow-checked and saturating arithmetic
+    //
+    // The _overflow forms return the wrapped result and set overflow when the
+    // exact result does not fit. The flags come from the carry of add_carry, the
+    // borrow of sub_borrow and the high half of multiply_extended, no wider
+    // type is needed. The _sat forms clamp to min() and max() instead.
+    //
+
+    static constexpr intbase_t add_overflow(intbase_t a, intbase_t b, bool &overflow)
+    {
+        uint8_t carry = 0;
+        const intbase_t sum = add_carry(a, b, carry);
+        overflow = carry_overflow(carry, a, b, sum);
+        return sum;
+    }
+
+    static constexpr intbase_t sub_overflow(intbase_t a, intbase_t b, bool &overflow)
+    {
+        uint8_t borrow = 0;
+        const intbase_t diff = sub_borrow(a, b, borrow);
+        overflow = carry_overflow(borrow, a, b, diff);
+        return diff;
+    }
+
+    static constexpr intbase_t mul_overflow(intbase_t a, intbase_t b, bool &overflow)
+    {
+        // the product fits when the high half only repeats the sign of the low half
+        intbase_t prod_hi;
+        const intbase_t prod_lo = multiply_extended(a, b, prod_hi);
+        overflow = prod_hi != (sign_bit(prod_lo) ? intbase_t(allones_mask, allones_mask) : intbase_t(halfint_t(0), halfint_t(0)));
+        return prod_lo;
+    }
+
+    static constexpr intbase_t add_sat(intbase_t a, intbase_t b)
+    {
+        bool overflow = false;
+        const intbase_t sum = add_overflow(a, b, overflow);
+        return !overflow ? sum : sign_bit(a) ? min() : max();
+    }
+
+    static constexpr intbase_t sub_sat(intbase_t a, intbase_t b)
+    {
+        bool overflow = false;
+        const intbase_t diff = sub_overflow(a, b, overflow);
+        return !overflow ? diff : (!is_signed || sign_bit(a)) ? min() : max();
+    }
+
+    static constexpr intbase_t mul_sat(intbase_t a, intbase_t b)
+    {
+        bool overflow = false;
+        const intbase_t prod = mul_overflow(a, b, overflow);
+        return !overflow ? prod : sign_bit(a) != sign_bit(b) ? min() : max();
+    }
+
+private:
+
+    // the sign bit of signed types, false for unsigned ones
+    static constexpr bool sign_bit(intbase_t x)
+    {
+        return is_signed && !!(x.upper_half & topbit_mask);
+    }
+
+    // unsigned overflow is the carry (or borrow) out of the top bit, signed
+    // overflow is the carry out differing from the carry into the sign bit,
+    // which is the result's sign bit less the operands'
+    static constexpr bool carry_overflow(uint8_t carry, intbase_t a, intbase_t b, intbase_t r)
+    {
+        if constexpr (is_signed) {
+            return (carry != 0) != (sign_bit(a) != (sign_bit(b) != sign_bit(r)));
+        }
+        else {
+            return carry != 0;
+        }
+    }
+
     
     //
     // to string
@@ -726,96 +921,1321 @@ public:
  public:
 
     static std::string to_string(intbase_t sw) {
-        if (!sw.upper_half) {
-            if constexpr (std::is_integral_v<halfint_t>) {
-                return std::to_string(sw.lower_half);
-            }
-            else {
-                return halfint_t::to_string(sw.upper_half);
-            }
-        }
-
-        std::string s;
-        while (sw)
-        {
-            //intbase_t digit = sw % intbase_t(10);
-            sw /= intbase_t(10);
-            s += '0' + 0;// (char)digit;
-        }
-
-        return s;
+        char buffer[bitsize * 30103 / 100000 + 3];
+        return std::string(buffer, to_chars(buffer, buffer + sizeof(buffer), sw).ptr);
     }
 };
 
 
-using int128sw_t = intbase_t<16, true>;
-using uint128sw_t = intbase_t<16, false>;
-using int64sw_t = intbase_t<8, true>;
-using uint64sw_t = intbase_t<8, false>;
-using int32sw_t = intbase_t<4, true>;
-using uint32sw_t = intbase_t<4, false>;
-using int16sw_t = intbase_t<2, true>;
-using uint16sw_t = intbase_t<2, false>;
-
-
 //
-// literals
+// Limb kernels for the flat layout
+//
+// Multiplies pick their method at compile time from the limb count: the
+// schoolbook method for short operands, Karatsuba from karatsuba_threshold
+// limbs and Toom-3 from toom3_threshold limbs, recursing on the parts. The
+// thresholds are the crossovers measured with `intbench multiply`.
 //
 
-#define MAKE_LITERAL_OPERATOR(swtype, name)                                 \
-    inline constexpr swtype operator "" name(unsigned long long int val) {  \
-        if (val > static_cast<unsigned long long int>(swtype::max()))       \
-            throw std::exception("literal out of range");                   \
-        return swtype(val);                                                 \
-    }                                                                       \
-
-MAKE_LITERAL_OPERATOR(int16sw_t, _i16sw)
-MAKE_LITERAL_OPERATOR(int32sw_t, _i32sw)
-MAKE_LITERAL_OPERATOR(int64sw_t, _i64sw)
-MAKE_LITERAL_OPERATOR(uint16sw_t, _u16sw)
-MAKE_LITERAL_OPERATOR(uint32sw_t, _u32sw)
-MAKE_LITERAL_OPERATOR(uint64sw_t, _u64sw)
+namespace details
+{
+    constexpr int karatsuba_threshold = 24;
+    constexpr int toom3_threshold = 112;
 
-#undef MAKE_LITERAL_OPERATOR
+    // sum = sum + a * b + carry, returns the high limb
+    constexpr uint64_t multiply_add(uint64_t a, uint64_t b, uint64_t carry, uint64_t &sum)
+    {
+        uint64_t hi = 0;
+        uint64_t lo = mul_extended(a, b, hi);
+
+        uint8_t c = 0;
+        lo = add_carry(lo, sum, c);
+        hi += c;
+        c = 0;
+        sum = add_carry(lo, carry, c);
+        return hi + c;
+    }
 
-inline int128sw_t operator "" _i128sw(const char * val)
-{
-    // cannot use strlen because its not constexpr???
-    size_t len = 0;
-    for (auto p = val; *p; ++p, ++len);
+    // r[0..rn) += a[0..an) with an <= rn, returns the carry out of r
+    constexpr uint8_t add_limbs(uint64_t *r, int rn, const uint64_t *a, int an)
+    {
+        uint8_t carry = 0;
+        int i = 0;
+        for (; i < an; ++i) {
+            r[i] = add_carry(r[i], a[i], carry);
+        }
+        for (; i < rn && carry; ++i) {
+            r[i] = add_carry(r[i], uint64_t(0), carry);
+        }
+        return carry;
+    }
 
-    int128sw_t out = int128sw_t(0);
+    // r[0..rn) -= a[0..an) with an <= rn, returns the borrow out of r
+    constexpr uint8_t sub_limbs(uint64_t *r, int rn, const uint64_t *a, int an)
+    {
+        uint8_t borrow = 0;
+        int i = 0;
+        for (; i < an; ++i) {
+            r[i] = sub_borrow(r[i], a[i], borrow);
+        }
+        for (; i < rn && borrow; ++i) {
+            r[i] = sub_borrow(r[i], uint64_t(0), borrow);
+        }
+        return borrow;
+    }
 
-    // non-decimal
-    if (val[0] == '0')
+    constexpr void negate_limbs(uint64_t *r, int n)
     {
-        if (val[1] == 'x' || val[1] == 'X')
-        {
-            len -= 2;
-            val += 2;
+        uint8_t borrow = 0;
+        for (int i = 0; i < n; ++i) {
+            r[i] = sub_borrow(uint64_t(0), r[i], borrow);
+        }
+    }
 
-            if (len > (sizeof(int128sw_t) * 2)) {
-                throw std::exception("literal out of range");
+    // r = |a - b| over n limbs, returns true when a < b
+    constexpr bool subtract_magnitudes(uint64_t *r, const uint64_t *a, const uint64_t *b, int n)
+    {
+        bool negative = false;
+        for (int i = n - 1; i >= 0; --i) {
+            if (a[i] != b[i]) {
+                negative = a[i] < b[i];
+                break;
             }
+        }
 
-            for (int i = 0; i < len; ++i)
-            {
-                char c = val[len - 1 - i];
-                if (c >= '1' && c <= '9') {
-                    out |= (static_cast<int128sw_t>(c - '0')) << (i * 4);
-                }
-                else if (c >= 'a' && c <= 'f') {
-                    out |= (static_cast<int128sw_t>(10 + c - 'a')) << (i * 4);
-                }
-                else if (c >= 'A' && c <= 'F') {
-                    out |= (static_cast<int128sw_t>(10 + c - 'A')) << (i * 4);
-                }
-                else if (c != '0') {
-                    throw std::exception("invalid hexadecimal literal");
-                }
-            }
+        const uint64_t *x = negative ? b : a, *y = negative ? a : b;
+        uint8_t borrow = 0;
+        for (int i = 0; i < n; ++i) {
+            r[i] = sub_borrow(x[i], y[i], borrow);
         }
-        else if (val[1] == 'b' || val[1] == 'B')
+        return negative;
+    }
+
+    // value /= divisor over n limbs, returns the remainder
+    constexpr uint32_t divide_limbs_small(uint64_t *value, int n, uint32_t divisor)
+    {
+        uint64_t rem = 0;
+        for (int i = n - 1; i >= 0; --i) {
+            const uint64_t hi = (rem << 32) | (value[i] >> 32);
+            rem = hi % divisor;
+            const uint64_t lo = (rem << 32) | (value[i] & 0xffffffff);
+            rem = lo % divisor;
+            value[i] = ((hi / divisor) << 32) | (lo / divisor);
+        }
+        return static_cast<uint32_t>(rem);
+    }
+
+    // 10^19, the largest power of 10 in a limb, and floor((2^128 - 1) / 10^19) - 2^64
+    constexpr uint64_t pow10_19 = 10000000000000000000ull;
+    constexpr uint64_t pow10_19_reciprocal = 0xd83c94fb6d2ac34aull;
+
+    // value /= 10^19 over n limbs, returns the remainder. Each 128-by-64 step
+    // multiplies by the precomputed reciprocal and corrects the estimate at most
+    // twice (Moller and Granlund), 10^19 already has its top bit set
+    inline uint64_t divide_limbs_pow10_19(uint64_t *value, int n)
+    {
+        uint64_t rem = 0;
+        for (int i = n - 1; i >= 0; --i) {
+            uint64_t q1 = 0;
+            uint64_t q0 = mul_extended(pow10_19_reciprocal, rem, q1);
+            uint8_t carry = 0;
+            q0 = add_carry(q0, value[i], carry);
+            q1 = add_carry(q1, rem, carry) + 1;
+
+            uint64_t r = value[i] - q1 * pow10_19;
+            if (r > q0) {
+                --q1;
+                r += pow10_19;
+            }
+            if (r >= pow10_19) {
+                ++q1;
+                r -= pow10_19;
+            }
+            value[i] = q1;
+            rem = r;
+        }
+        return rem;
+    }
+
+    template<int n> constexpr void multiply_limbs(const uint64_t *a, const uint64_t *b, uint64_t *product);
+
+    // product[0..2n) = a * b
+    template<int n>
+    constexpr void multiply_schoolbook(const uint64_t *a, const uint64_t *b, uint64_t *product)
+    {
+        for (int i = 0; i < 2 * n; ++i) {
+            product[i] = 0;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (a[i] == 0) {
+                continue;
+            }
+            uint64_t carry = 0;
+            for (int j = 0; j < n; ++j) {
+                carry = multiply_add(a[i], b[j], carry, product[i + j]);
+            }
+            product[i + n] = carry;
+        }
+    }
+
+    // a = a1 B^h + a0 with B = 2^64 and h = ceil(n / 2), then
+    // a * b = z2 B^2h + (z1 - z2 - z0) B^h + z0 with z0 = a0 b0, z2 = a1 b1
+    // and z1 = (a0 + a1)(b0 + b1): three half-size products instead of four
+    template<int n>
+    constexpr void multiply_karatsuba(const uint64_t *a, const uint64_t *b, uint64_t *product)
+    {
+        static_assert(n >= 2, "Karatsuba needs two parts");
+        constexpr int h = (n + 1) / 2, l = n - h;
+
+        // z0 and z2 go straight to their places in the product
+        multiply_limbs<h>(a, b, product);
+        multiply_limbs<l>(a + h, b + h, product + 2 * h);
+
+        uint64_t sa[h] = {}, sb[h] = {};
+        for (int i = 0; i < h; ++i) {
+            sa[i] = a[i];
+            sb[i] = b[i];
+        }
+        const uint8_t ca = add_limbs(sa, h, a + h, l);
+        const uint8_t cb = add_limbs(sb, h, b + h, l);
+
+        // z1 with the carries of the sums folded in
+        uint64_t z1[2 * h + 1] = {};
+        multiply_limbs<h>(sa, sb, z1);
+        if (ca) {
+            add_limbs(z1 + h, h + 1, sb, h);
+        }
+        if (cb) {
+            add_limbs(z1 + h, h + 1, sa, h);
+        }
+        if (ca && cb) {
+            ++z1[2 * h];
+        }
+
+        sub_limbs(z1, 2 * h + 1, product, 2 * h);
+        sub_limbs(z1, 2 * h + 1, product + 2 * h, 2 * l);
+
+        constexpr int middle = (2 * h + 1 < 2 * n - h) ? 2 * h + 1 : 2 * n - h;
+        add_limbs(product + h, 2 * n - h, z1, middle);
+    }
+
+    // x(1), |x(-1)| and |x(-2)| for x = x2 B^2k + x1 B^k + x0 with t limbs in
+    // x2, the magnitudes fit k + 1 limbs
+    template<int k, int t>
+    constexpr void toom3_evaluate(const uint64_t *x, uint64_t *p1, uint64_t *pm1, bool &m1_negative, uint64_t *pm2, bool &m2_negative)
+    {
+        uint64_t even[k + 1] = {}, even4[k + 1] = {}, odd[k + 1] = {}, odd2[k + 1] = {};
+        for (int i = 0; i < k; ++i) {
+            even[i] = even4[i] = x[i];
+            odd[i] = x[k + i];
+            odd2[i] = (x[k + i] << 1) | (i > 0 ? x[k + i - 1] >> 63 : 0);
+        }
+        odd2[k] = x[2 * k - 1] >> 63;
+
+        // x0 + x2 and x0 + 4 x2
+        uint64_t x2_4[k + 1] = {};
+        for (int i = 0; i < t; ++i) {
+            x2_4[i] = (x[2 * k + i] << 2) | (i > 0 ? x[2 * k + i - 1] >> 62 : 0);
+        }
+        x2_4[t] = x[2 * k + t - 1] >> 62;
+        even[k] = add_limbs(even, k, x + 2 * k, t);
+        add_limbs(even4, k + 1, x2_4, k + 1);
+
+        for (int i = 0; i <= k; ++i) {
+            p1[i] = even[i];
+        }
+        add_limbs(p1, k + 1, odd, k);
+
+        m1_negative = subtract_magnitudes(pm1, even, odd, k + 1);
+        m2_negative = subtract_magnitudes(pm2, even4, odd2, k + 1);
+    }
+
+    // a = a2 B^2k + a1 B^k + a0 with k = ceil(n / 3): the product polynomial
+    // is evaluated at 0, 1, -1, -2 and infinity, five third-size products
+    // instead of nine, and interpolated with the sequence of Bodrato and
+    // Zanoni in two's complement
+    template<int n>
+    constexpr void multiply_toom3(const uint64_t *a, const uint64_t *b, uint64_t *product)
+    {
+        constexpr int k = (n + 2) / 3, t = n - 2 * k;
+        constexpr int w = 2 * k + 2;
+        static_assert(t >= 1, "Toom-3 needs three parts");
+
+        // r(0) and r(inf) go straight to their places in the product
+        multiply_limbs<k>(a, b, product);
+        multiply_limbs<t>(a + 2 * k, b + 2 * k, product + 4 * k);
+        for (int i = 2 * k; i < 4 * k; ++i) {
+            product[i] = 0;
+        }
+        const uint64_t *r0 = product, *rinf = product + 4 * k;
+
+        uint64_t ap1[k + 1] = {}, apm1[k + 1] = {}, apm2[k + 1] = {};
+        uint64_t bp1[k + 1] = {}, bpm1[k + 1] = {}, bpm2[k + 1] = {};
+        bool am1_negative = false, am2_negative = false, bm1_negative = false, bm2_negative = false;
+        toom3_evaluate<k, t>(a, ap1, apm1, am1_negative, apm2, am2_negative);
+        toom3_evaluate<k, t>(b, bp1, bpm1, bm1_negative, bpm2, bm2_negative);
+
+        uint64_t r1[w] = {}, rm1[w] = {}, r3[w] = {};
+        multiply_limbs<k + 1>(ap1, bp1, r1);
+        multiply_limbs<k + 1>(apm1, bpm1, rm1);
+        multiply_limbs<k + 1>(apm2, bpm2, r3);
+        if (am1_negative != bm1_negative) {
+            negate_limbs(rm1, w);
+        }
+        if (am2_negative != bm2_negative) {
+            negate_limbs(r3, w);
+        }
+
+        // r3 = (r(-2) - r(1)) / 3
+        sub_limbs(r3, w, r1, w);
+        const bool r3_negative = (r3[w - 1] >> 63) != 0;
+        if (r3_negative) {
+            negate_limbs(r3, w);
+        }
+        divide_limbs_small(r3, w, 3);
+        if (r3_negative) {
+            negate_limbs(r3, w);
+        }
+
+        // r1 = (r(1) - r(-1)) / 2
+        sub_limbs(r1, w, rm1, w);
+        for (int i = 0; i < w - 1; ++i) {
+            r1[i] = (r1[i] >> 1) | (r1[i + 1] << 63);
+        }
+        r1[w - 1] = static_cast<uint64_t>(static_cast<int64_t>(r1[w - 1]) >> 1);
+
+        // r2 = r(-1) - r(0)
+        uint64_t *r2 = rm1;
+        sub_limbs(r2, w, r0, 2 * k);
+
+        // r3 = (r2 - r3) / 2 + 2 r(inf)
+        uint64_t d[w] = {};
+        for (int i = 0; i < w; ++i) {
+            d[i] = r2[i];
+        }
+        sub_limbs(d, w, r3, w);
+        for (int i = 0; i < w - 1; ++i) {
+            r3[i] = (d[i] >> 1) | (d[i + 1] << 63);
+        }
+        r3[w - 1] = static_cast<uint64_t>(static_cast<int64_t>(d[w - 1]) >> 1);
+        add_limbs(r3, w, rinf, 2 * t);
+        add_limbs(r3, w, rinf, 2 * t);
+
+        // r2 = r2 + r1 - r(inf), r1 = r1 - r3
+        add_limbs(r2, w, r1, w);
+        sub_limbs(r2, w, rinf, 2 * t);
+        sub_limbs(r1, w, r3, w);
+
+        // the coefficients are non-negative and the product fits 2n limbs,
+        // so limbs past the end are zero
+        add_limbs(product + k, 2 * n - k, r1, (w < 2 * n - k) ? w : 2 * n - k);
+        add_limbs(product + 2 * k, 2 * n - 2 * k, r2, (w < 2 * n - 2 * k) ? w : 2 * n - 2 * k);
+        add_limbs(product + 3 * k, 2 * n - 3 * k, r3, (w < 2 * n - 3 * k) ? w : 2 * n - 3 * k);
+    }
+
+    // product[0..2n) = a * b
+    template<int n>
+    constexpr void multiply_limbs(const uint64_t *a, const uint64_t *b, uint64_t *product)
+    {
+        if constexpr (n >= toom3_threshold) {
+            multiply_toom3<n>(a, b, product);
+        }
+        else if constexpr (n >= karatsuba_threshold) {
+            multiply_karatsuba<n>(a, b, product);
+        }
+        else {
+            multiply_schoolbook<n>(a, b, product);
+        }
+    }
+
+    // product[0..n) = a * b mod B^n
+    template<int n>
+    constexpr void multiply_low_limbs(const uint64_t *a, const uint64_t *b, uint64_t *product)
+    {
+        if constexpr (n >= karatsuba_threshold && n % 2 == 0) {
+            // the full product of the low halves plus the low halves of the
+            // cross products
+            constexpr int h = n / 2;
+            multiply_limbs<h>(a, b, product);
+
+            uint64_t cross[h] = {};
+            multiply_low_limbs<h>(a, b + h, cross);
+            add_limbs(product + h, h, cross, h);
+            multiply_low_limbs<h>(a + h, b, cross);
+            add_limbs(product + h, h, cross, h);
+        }
+        else {
+            for (int i = 0; i < n; ++i) {
+                product[i] = 0;
+            }
+            for (int i = 0; i < n; ++i) {
+                if (a[i] == 0) {
+                    continue;
+                }
+                uint64_t carry = 0;
+                for (int j = 0; i + j < n; ++j) {
+                    carry = multiply_add(a[i], b[j], carry, product[i + j]);
+                }
+            }
+        }
+    }
+}
+
+
+//
+// Flat layout for widths above 128 bits
+//
+// The halves layout expands each operation into calls on the two halves, so a
+// multiply of intbase_t<64> is 4^2 nested 128-bit multiplies and shifts and
+// division are deep template stacks. The limbs layout keeps byte_size / 8
+// 64-bit limbs, least significant first (the same memory layout as the halves),
+// and runs carry chains over them with add_carry, sub_borrow and mul_extended.
+// Products use the Karatsuba and Toom-3 kernels above once they pay off.
+//
+// Signed comparisons, division and remainder follow the C++ rules for the
+// built-in types: division truncates and the remainder has the sign of the
+// dividend.
+//
+
+template<size_t byte_size, bool is_signed>
+class intbase_t<byte_size, is_signed, details::int_limbs>
+{
+    static_assert(byte_size > 16 && details::is_pow_2(byte_size), "expecting a power of 2 above 16 bytes");
+
+public:
+
+    static constexpr bool is_signed = is_signed;
+
+private:
+
+    using signed_t = intbase_t<byte_size, true, details::int_limbs>;
+    using unsigned_t = intbase_t<byte_size, false, details::int_limbs>;
+
+    static constexpr size_t bitsize = byte_size * 8;
+    static constexpr int limb_count = static_cast<int>(byte_size / sizeof(uint64_t));
+    static constexpr int limb_bitsize = 64;
+
+    // least significant limb first
+    std::array<uint64_t, limb_count> limbs;
+
+public:
+
+    intbase_t() = default;
+
+    template<typename integral_t, typename = std::enable_if_t<std::is_integral_v<integral_t>>>
+    constexpr explicit intbase_t(integral_t val) : limbs{} {
+        uint64_t fill = 0;
+        if constexpr (std::is_signed_v<integral_t>) {
+            fill = val < 0 ? ~uint64_t(0) : 0;
+            limbs[0] = static_cast<uint64_t>(static_cast<int64_t>(val));
+        }
+        else {
+            limbs[0] = static_cast<uint64_t>(val);
+        }
+        for (int i = 1; i < limb_count; ++i) {
+            limbs[i] = fill;
+        }
+    }
+
+
+    //
+    // limits
+    //
+
+public:
+
+    static constexpr intbase_t max() {
+        intbase_t r = fill(~uint64_t(0));
+        if constexpr (is_signed) {
+            r.limbs[limb_count - 1] >>= 1;
+        }
+        return r;
+    }
+
+    static constexpr intbase_t min() {
+        intbase_t r = fill(0);
+        if constexpr (is_signed) {
+            r.limbs[limb_count - 1] = uint64_t(1) << (limb_bitsize - 1);
+        }
+        return r;
+    }
+
+    //
+    // conversion
+    //
+
+public:
+
+    template<typename integral_t,
+        typename = std::enable_if_t<
+            std::is_integral_v<integral_t> || std::is_same_v<integral_t, bool>
+    >>
+    constexpr explicit operator integral_t() const
+    {
+        if constexpr (std::is_same_v<integral_t, bool>) {
+            return !this->operator!();
+        }
+        else {
+            return static_cast<integral_t>(limbs[0]);
+        }
+    }
+
+
+    //
+    // arithmetic
+    //
+
+public:
+
+    constexpr intbase_t operator+(intbase_t other) const
+    {
+        uint8_t carry = 0;
+        return add_carry(*this, other, carry);
+    }
+
+    constexpr intbase_t operator-(intbase_t other) const
+    {
+        uint8_t borrow = 0;
+        return sub_borrow(*this, other, borrow);
+    }
+
+    // the low limb_count limbs of the product, the same for signed and unsigned
+    constexpr intbase_t operator*(intbase_t other) const
+    {
+        intbase_t r = fill(0);
+        details::multiply_low_limbs<limb_count>(limbs.data(), other.limbs.data(), r.limbs.data());
+        return r;
+    }
+
+private:
+
+    struct div_t { intbase_t quot; intbase_t rem; };
+    static constexpr div_t div(intbase_t dividend, intbase_t divisor)
+    {
+        if (!divisor) {
+            // handle divide-by-zero
+            details::divide_by_zero();
+        }
+
+        bool quot_negative = false, rem_negative = false;
+        if constexpr (is_signed) {
+            if (dividend.is_negative()) {
+                quot_negative = !quot_negative;
+                rem_negative = true;
+                dividend = -dividend;
+            }
+            if (divisor.is_negative()) {
+                quot_negative = !quot_negative;
+                divisor = -divisor;
+            }
+        }
+
+        div_t result{ fill(0), fill(0) };
+        divide_magnitudes(dividend, divisor, result.quot, result.rem);
+
+        if (quot_negative) {
+            result.quot = -result.quot;
+        }
+        if (rem_negative) {
+            result.rem = -result.rem;
+        }
+        return result;
+    }
+
+public:
+
+    constexpr intbase_t operator/(intbase_t other) const
+    {
+        return div(*this, other).quot;
+    }
+
+    constexpr intbase_t operator%(intbase_t other) const
+    {
+        return div(*this, other).rem;
+    }
+
+    constexpr intbase_t operator-() const
+    {
+        uint8_t borrow = 0;
+        return sub_borrow(fill(0), *this, borrow);
+    }
+
+    //
+    // increment
+    //
+public:
+    constexpr intbase_t operator--() {
+        *this = this->operator-(intbase_t(1));
+        return *this;
+    }
+    constexpr intbase_t operator--(int) {
+        auto t = *this;
+        *this = this->operator-(intbase_t(1));
+        return t;
+    }
+    constexpr intbase_t operator++() {
+        *this = this->operator+(intbase_t(1));
+        return *this;
+    }
+    constexpr intbase_t operator++(int) {
+        auto t = *this;
+        *this = this->operator+(intbase_t(1));
+        return t;
+    }
+
+    //
+    // op-eq operators
+    //
+
+public:
+
+    constexpr intbase_t operator+=(intbase_t other) {
+        *this = this->operator+(other);
+        return *this;
+    }
+    constexpr intbase_t operator-=(intbase_t other) {
+        *this = this->operator-(other);
+        return *this;
+    }
+    constexpr intbase_t operator*=(intbase_t other) {
+        *this = this->operator*(other);
+        return *this;
+    }
+    constexpr intbase_t operator/=(intbase_t other) {
+        *this = this->operator/(other);
+        return *this;
+    }
+    constexpr intbase_t operator%=(intbase_t other) {
+        *this = this->operator%(other);
+        return *this;
+    }
+
+    constexpr intbase_t operator<<=(int amount) {
+        *this = this->operator<<(amount);
+        return *this;
+    }
+    constexpr intbase_t operator>>=(int amount) {
+        *this = this->operator>>(amount);
+        return *this;
+    }
+    constexpr intbase_t operator|=(intbase_t other) {
+        *this = this->operator|(other);
+        return *this;
+    }
+    constexpr intbase_t operator&=(intbase_t other) {
+        *this = this->operator&(other);
+        return *this;
+    }
+    constexpr intbase_t operator^=(intbase_t other) {
+        *this = this->operator^(other);
+        return *this;
+    }
+
+
+    //
+    // bitwise
+    //
+
+public:
+
+    constexpr intbase_t operator<<(int amount) const
+    {
+        return funnel_shift_left(*this, fill(0), amount);
+    }
+
+    // arithmetic shift for signed types
+    constexpr intbase_t operator>>(int amount) const
+    {
+        return funnel_shift_right(fill(is_negative() ? ~uint64_t(0) : 0), *this, amount);
+    }
+
+
+    constexpr intbase_t operator&(intbase_t other) const {
+        for (int i = 0; i < limb_count; ++i) {
+            other.limbs[i] &= limbs[i];
+        }
+        return other;
+    }
+    constexpr intbase_t operator|(intbase_t other) const {
+        for (int i = 0; i < limb_count; ++i) {
+            other.limbs[i] |= limbs[i];
+        }
+        return other;
+    }
+    constexpr intbase_t operator^(intbase_t other) const {
+        for (int i = 0; i < limb_count; ++i) {
+            other.limbs[i] ^= limbs[i];
+        }
+        return other;
+    }
+
+    constexpr intbase_t operator~() const {
+        intbase_t out;
+        for (int i = 0; i < limb_count; ++i) {
+            out.limbs[i] = ~limbs[i];
+        }
+        return out;
+    }
+
+    constexpr bool operator!() const {
+        for (int i = 0; i < limb_count; ++i) {
+            if (limbs[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //
+    // relational operators
+    //
+
+public:
+    constexpr bool operator==(intbase_t other) const {
+        for (int i = 0; i < limb_count; ++i) {
+            if (limbs[i] != other.limbs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    constexpr bool operator!=(intbase_t other) const { return !this->operator==(other); }
+
+    constexpr bool operator<(intbase_t other) const { return compare(*this, other) < 0; }
+    constexpr bool operator<=(intbase_t other) const { return compare(*this, other) <= 0; }
+    constexpr bool operator>(intbase_t other) const { return compare(*this, other) > 0; }
+    constexpr bool operator>=(intbase_t other) const { return compare(*this, other) >= 0; }
+
+
+    //
+    // misc operations
+    //
+
+    // index of the highest set bit
+    static constexpr bool reverse_bit_scan(unsigned long *index, intbase_t value)
+    {
+        for (int i = limb_count - 1; i >= 0; --i) {
+            if (details::reverse_bit_scan(index, value.limbs[i])) {
+                *index += static_cast<unsigned long>(i * limb_bitsize);
+                return true;
+            }
+        }
+        *index = 0;
+        return false;
+    }
+
+    //
+    // bit manipulation, on the bit pattern for signed types
+    //
+
+    static constexpr int popcount(intbase_t value)
+    {
+        int count = 0;
+        for (int i = 0; i < limb_count; ++i) {
+            count += details::popcount(value.limbs[i]);
+        }
+        return count;
+    }
+
+    static constexpr int countl_zero(intbase_t value)
+    {
+        for (int i = limb_count - 1; i >= 0; --i) {
+            if (value.limbs[i] != 0) {
+                return (limb_count - 1 - i) * limb_bitsize + details::countl_zero(value.limbs[i]);
+            }
+        }
+        return static_cast<int>(bitsize);
+    }
+
+    static constexpr int countr_zero(intbase_t value)
+    {
+        for (int i = 0; i < limb_count; ++i) {
+            if (value.limbs[i] != 0) {
+                return i * limb_bitsize + details::countr_zero(value.limbs[i]);
+            }
+        }
+        return static_cast<int>(bitsize);
+    }
+
+    // bits needed to represent value, 0 for 0
+    static constexpr int bit_width(intbase_t value)
+    {
+        return static_cast<int>(bitsize) - countl_zero(value);
+    }
+
+    static constexpr intbase_t byteswap(intbase_t value)
+    {
+        intbase_t out;
+        for (int i = 0; i < limb_count; ++i) {
+            out.limbs[i] = details::byteswap(value.limbs[limb_count - 1 - i]);
+        }
+        return out;
+    }
+
+    // the upper half of (high:low) << amount, for 0 <= amount < bitsize
+    static constexpr intbase_t funnel_shift_left(intbase_t high, intbase_t low, int amount)
+    {
+        const int limb_shift = amount / limb_bitsize;
+        const int bit_shift = amount % limb_bitsize;
+        auto source = [&](int i) { return i < 0 ? uint64_t(0) : i < limb_count ? low.limbs[i] : high.limbs[i - limb_count]; };
+
+        intbase_t out;
+        for (int i = 0; i < limb_count; ++i) {
+            out.limbs[i] = details::funnel_shift_left(source(limb_count + i - limb_shift), source(limb_count + i - limb_shift - 1), bit_shift);
+        }
+        return out;
+    }
+
+    // the lower half of (high:low) >> amount, for 0 <= amount < bitsize
+    static constexpr intbase_t funnel_shift_right(intbase_t high, intbase_t low, int amount)
+    {
+        const int limb_shift = amount / limb_bitsize;
+        const int bit_shift = amount % limb_bitsize;
+        auto source = [&](int i) { return i < limb_count ? low.limbs[i] : i < 2 * limb_count ? high.limbs[i - limb_count] : uint64_t(0); };
+
+        intbase_t out;
+        for (int i = 0; i < limb_count; ++i) {
+            out.limbs[i] = details::funnel_shift_right(source(i + limb_shift + 1), source(i + limb_shift), bit_shift);
+        }
+        return out;
+    }
+
+    // rotates by any amount, negative amounts rotate the other way
+    static constexpr intbase_t rotl(intbase_t value, int amount)
+    {
+        amount %= static_cast<int>(bitsize);
+        return funnel_shift_left(value, value, amount < 0 ? amount + static_cast<int>(bitsize) : amount);
+    }
+
+    static constexpr intbase_t rotr(intbase_t value, int amount)
+    {
+        amount %= static_cast<int>(bitsize);
+        return funnel_shift_right(value, value, amount < 0 ? amount + static_cast<int>(bitsize) : amount);
+    }
+
+    static constexpr intbase_t add_carry(intbase_t a, intbase_t b, uint8_t &carry)
+    {
+        for (int i = 0; i < limb_count; ++i) {
+            a.limbs[i] = details::add_carry(a.limbs[i], b.limbs[i], carry);
+        }
+        return a;
+    }
+
+    static constexpr intbase_t sub_borrow(intbase_t a, intbase_t b, uint8_t &borrow)
+    {
+        for (int i = 0; i < limb_count; ++i) {
+            a.limbs[i] = details::sub_borrow(a.limbs[i], b.limbs[i], borrow);
+        }
+        return a;
+    }
+
+    static constexpr intbase_t multiply_extended(intbase_t a, intbase_t b, intbase_t &prod_hi)
+    {
+        bool negative = false;
+        if constexpr (is_signed) {
+            if (a.is_negative()) {
+                negative = !negative;
+                a = -a;
+            }
+            if (b.is_negative()) {
+                negative = !negative;
+                b = -b;
+            }
+        }
+
+        uint64_t product[2 * limb_count] = {};
+        details::multiply_limbs<limb_count>(a.limbs.data(), b.limbs.data(), product);
+
+        intbase_t prod_lo;
+        for (int i = 0; i < limb_count; ++i) {
+            prod_lo.limbs[i] = product[i];
+            prod_hi.limbs[i] = product[limb_count + i];
+        }
+
+        if (negative) {
+            // negate the double-width product
+            uint8_t borrow = 0;
+            prod_lo = sub_borrow(fill(0), prod_lo, borrow);
+            prod_hi = sub_borrow(fill(0), prod_hi, borrow);
+        }
+        return prod_lo;
+    }
+
+    //
+    // overflow-checked and saturating arithmetic, as for the halves layout
+    //
+
+    static constexpr intbase_t add_overflow(intbase_t a, intbase_t b, bool &overflow)
+    {
+        uint8_t carry = 0;
+        const intbase_t sum = add_carry(a, b, carry);
+        overflow = carry_overflow(carry, a, b, sum);
+        return sum;
+    }
+
+    static constexpr intbase_t sub_overflow(intbase_t a, intbase_t b, bool &overflow)
+    {
+        uint8_t borrow = 0;
+        const intbase_t diff = sub_borrow(a, b, borrow);
+        overflow = carry_overflow(borrow, a, b, diff);
+        return diff;
+    }
+
+    static constexpr intbase_t mul_overflow(intbase_t a, intbase_t b, bool &overflow)
+    {
+        // the product fits when the high limbs only repeat the sign of the low ones
+        intbase_t prod_hi;
+        const intbase_t prod_lo = multiply_extended(a, b, prod_hi);
+        overflow = prod_hi != fill(prod_lo.is_negative() ? ~uint64_t(0) : 0);
+        return prod_lo;
+    }
+
+    static constexpr intbase_t add_sat(intbase_t a, intbase_t b)
+    {
+        bool overflow = false;
+        const intbase_t sum = add_overflow(a, b, overflow);
+        return !overflow ? sum : a.is_negative() ? min() : max();
+    }
+
+    static constexpr intbase_t sub_sat(intbase_t a, intbase_t b)
+    {
+        bool overflow = false;
+        const intbase_t diff = sub_overflow(a, b, overflow);
+        return !overflow ? diff : (!is_signed || a.is_negative()) ? min() : max();
+    }
+
+    static constexpr intbase_t mul_sat(intbase_t a, intbase_t b)
+    {
+        bool overflow = false;
+        const intbase_t prod = mul_overflow(a, b, overflow);
+        return !overflow ? prod : a.is_negative() != b.is_negative() ? min() : max();
+    }
+
+
+    //
+    // to string
+    //
+
+ public:
+
+    static std::string to_string(intbase_t sw) {
+        char buffer[bitsize * 30103 / 100000 + 3];
+        return std::string(buffer, to_chars(buffer, buffer + sizeof(buffer), sw).ptr);
+    }
+
+    //
+    // utilities
+    //
+
+private:
+
+    template<size_t, bool, typename> friend class intbase_t;
+
+    static constexpr intbase_t fill(uint64_t value)
+    {
+        intbase_t r;
+        for (int i = 0; i < limb_count; ++i) {
+            r.limbs[i] = value;
+        }
+        return r;
+    }
+
+    constexpr bool is_negative() const
+    {
+        if constexpr (is_signed) {
+            return (limbs[limb_count - 1] >> (limb_bitsize - 1)) != 0;
+        }
+        else {
+            return false;
+        }
+    }
+
+    // unsigned overflow is the carry (or borrow) out of the top bit, signed
+    // overflow is the carry out differing from the carry into the sign bit
+    static constexpr bool carry_overflow(uint8_t carry, intbase_t a, intbase_t b, intbase_t r)
+    {
+        if constexpr (is_signed) {
+            return (carry != 0) != (a.is_negative() != (b.is_negative() != r.is_negative()));
+        }
+        else {
+            return carry != 0;
+        }
+    }
+
+    // -1, 0 or 1, the top limb carries the sign of signed types
+    static constexpr int compare(intbase_t a, intbase_t b)
+    {
+        if constexpr (is_signed) {
+            const int64_t ta = static_cast<int64_t>(a.limbs[limb_count - 1]), tb = static_cast<int64_t>(b.limbs[limb_count - 1]);
+            if (ta != tb) {
+                return ta < tb ? -1 : 1;
+            }
+        }
+        for (int i = limb_count - 1; i >= 0; --i) {
+            if (a.limbs[i] != b.limbs[i]) {
+                return a.limbs[i] < b.limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // Knuth's algorithm D over 32-bit digits for non-negative operands
+    static constexpr void divide_magnitudes(intbase_t dividend, intbase_t divisor, intbase_t &quot, intbase_t &rem)
+    {
+        constexpr int digit_count = 2 * limb_count;
+        uint32_t u[digit_count + 1] = {}, v[digit_count] = {}, q[digit_count] = {};
+        for (int i = 0; i < limb_count; ++i) {
+            u[2 * i] = static_cast<uint32_t>(dividend.limbs[i]);
+            u[2 * i + 1] = static_cast<uint32_t>(dividend.limbs[i] >> 32);
+            v[2 * i] = static_cast<uint32_t>(divisor.limbs[i]);
+            v[2 * i + 1] = static_cast<uint32_t>(divisor.limbs[i] >> 32);
+        }
+
+        int m = digit_count, n = digit_count;
+        while (m > 0 && u[m - 1] == 0) --m;
+        while (n > 0 && v[n - 1] == 0) --n;
+
+        quot = fill(0);
+        rem = fill(0);
+        if (m < n) {
+            rem = dividend;
+            return;
+        }
+
+        if (n == 1) {
+            uint64_t r = 0;
+            for (int j = m - 1; j >= 0; --j) {
+                const uint64_t cur = (r << 32) | u[j];
+                q[j] = static_cast<uint32_t>(cur / v[0]);
+                r = cur % v[0];
+            }
+            rem.limbs[0] = r;
+        }
+        else {
+            // normalize so the top digit of the divisor has its top bit set
+            unsigned long top = 0;
+            details::reverse_bit_scan(&top, v[n - 1]);
+            const int s = 31 - static_cast<int>(top);
+
+            uint32_t vn[digit_count] = {}, un[digit_count + 1] = {};
+            for (int i = n - 1; i > 0; --i) {
+                vn[i] = static_cast<uint32_t>((uint64_t(v[i]) << s) | (uint64_t(v[i - 1]) >> (32 - s)));
+            }
+            vn[0] = v[0] << s;
+            un[m] = static_cast<uint32_t>(uint64_t(u[m - 1]) >> (32 - s));
+            for (int i = m - 1; i > 0; --i) {
+                un[i] = static_cast<uint32_t>((uint64_t(u[i]) << s) | (uint64_t(u[i - 1]) >> (32 - s)));
+            }
+            un[0] = u[0] << s;
+
+            constexpr uint64_t base = uint64_t(1) << 32;
+            for (int j = m - n; j >= 0; --j) {
+                // estimate the quotient digit from the top two digits, at most 2 too large
+                const uint64_t top_digits = (uint64_t(un[j + n]) << 32) | un[j + n - 1];
+                uint64_t qhat = top_digits / vn[n - 1];
+                uint64_t rhat = top_digits % vn[n - 1];
+                while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+                    --qhat;
+                    rhat += vn[n - 1];
+                    if (rhat >= base) {
+                        break;
+                    }
+                }
+
+                // multiply and subtract
+                int64_t borrow = 0;
+                for (int i = 0; i < n; ++i) {
+                    const uint64_t p = qhat * vn[i];
+                    const int64_t t = int64_t(un[i + j]) - borrow - static_cast<int64_t>(p & 0xffffffff);
+                    un[i + j] = static_cast<uint32_t>(t);
+                    borrow = static_cast<int64_t>(p >> 32) - (t >> 32);
+                }
+                const int64_t t = int64_t(un[j + n]) - borrow;
+                un[j + n] = static_cast<uint32_t>(t);
+
+                // add back when the estimate was one too large
+                q[j] = static_cast<uint32_t>(qhat);
+                if (t < 0) {
+                    --q[j];
+                    uint64_t carry = 0;
+                    for (int i = 0; i < n; ++i) {
+                        const uint64_t sum = uint64_t(un[i + j]) + vn[i] + carry;
+                        un[i + j] = static_cast<uint32_t>(sum);
+                        carry = sum >> 32;
+                    }
+                    un[j + n] = static_cast<uint32_t>(un[j + n] + carry);
+                }
+            }
+
+            // unnormalize the remainder
+            for (int i = 0; i < n; ++i) {
+                const uint32_t digit = static_cast<uint32_t>((uint64_t(un[i]) >> s) | (uint64_t(un[i + 1]) << (32 - s)));
+                rem.limbs[i / 2] |= uint64_t(digit) << (32 * (i % 2));
+            }
+        }
+
+        for (int i = 0; i < digit_count; ++i) {
+            quot.limbs[i / 2] |= uint64_t(q[i]) << (32 * (i % 2));
+        }
+    }
+};
+
+
+using int512sw_t = intbase_t<64, true>;
+using uint512sw_t = intbase_t<64, false>;
+using int256sw_t = intbase_t<32, true>;
+using uint256sw_t = intbase_t<32, false>;
+using int128sw_t = intbase_t<16, true>;
+using uint128sw_t = intbase_t<16, false>;
+using int64sw_t = intbase_t<8, true>;
+using uint64sw_t = intbase_t<8, false>;
+using int32sw_t = intbase_t<4, true>;
+using uint32sw_t = intbase_t<4, false>;
+using int16sw_t = intbase_t<2, true>;
+using uint16sw_t = intbase_t<2, false>;
+
+
+//
+// decimal conversion
+//
+// to_chars and from_chars follow <charconv> in base 10: they write into and
+// read from caller buffers without allocating, accept no '+' or whitespace,
+// and leave the value alone on failure. Values are split into 19-digit chunks
+// by dividing the limbs by 10^19 with a precomputed reciprocal, and digits are
+// parsed eight at a time with SWAR arithmetic on one 64-bit word.
+//
+
+namespace details
+{
+    constexpr char digit_pairs[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+
+    // the 19 digits of x < 10^19, with leading zeros
+    inline void write_digits19(char *out, uint64_t x)
+    {
+        for (int i = 17; i > 0; i -= 2) {
+            memcpy(out + i, digit_pairs + 2 * (x % 100), 2);
+            x /= 100;
+        }
+        out[0] = static_cast<char>('0' + x);
+    }
+
+    inline int digit_count(uint64_t x)
+    {
+        int count = 1;
+        for (; x >= 10; x /= 10) {
+            ++count;
+        }
+        return count;
+    }
+
+    // eight characters read as a little-endian word
+    inline bool is_eight_digits(uint64_t word)
+    {
+        return ((word & 0xf0f0f0f0f0f0f0f0) | (((word + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) == 0x3333333333333333;
+    }
+
+    // pairs, then groups of four, then all eight digits in a few multiplies
+    inline uint32_t parse_eight_digits(uint64_t word)
+    {
+        word -= 0x3030303030303030;
+        word = (word * 10) + (word >> 8);
+        word = (((word & 0x000000ff000000ff) * (100 + (1000000ull << 32))) + (((word >> 16) & 0x000000ff000000ff) * (1 + (10000ull << 32)))) >> 32;
+        return static_cast<uint32_t>(word);
+    }
+
+    constexpr bool is_digit(char c) { return static_cast<unsigned>(c - '0') < 10; }
+}
+
+template<size_t byte_size, bool is_signed, typename layout>
+std::to_chars_result to_chars(char *first, char *last, intbase_t<byte_size, is_signed, layout> value)
+{
+    using int_t = intbase_t<byte_size, is_signed, layout>;
+    constexpr int limb_count = byte_size < sizeof(uint64_t) ? 1 : static_cast<int>(byte_size / sizeof(uint64_t));
+
+    // the magnitude as limbs, the negated minimum reads correctly as unsigned
+    bool negative = false;
+    if constexpr (is_signed) {
+        negative = value < int_t(0);
+        if (negative) {
+            value = -value;
+        }
+    }
+    uint64_t limbs[limb_count] = {};
+    memcpy(limbs, &value, byte_size);
+
+    // 10^19 chunks, least significant first, above them fewer than 20 digits
+    uint64_t chunks[limb_count + limb_count / 32 + 1];
+    int chunk_count = 0, n = limb_count;
+    while (n > 0 && limbs[n - 1] == 0) {
+        --n;
+    }
+    while (n > 1 || (n == 1 && limbs[0] >= details::pow10_19)) {
+        chunks[chunk_count++] = details::divide_limbs_pow10_19(limbs, n);
+        while (n > 0 && limbs[n - 1] == 0) {
+            --n;
+        }
+    }
+    uint64_t top = n ? limbs[0] : 0;
+
+    const int top_digits = details::digit_count(top);
+    const ptrdiff_t length = (negative ? 1 : 0) + top_digits + 19 * chunk_count;
+    if (last - first < length) {
+        return { last, std::errc::value_too_large };
+    }
+
+    char *out = first;
+    if (negative) {
+        *out++ = '-';
+    }
+    for (int i = top_digits - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + top % 10);
+        top /= 10;
+    }
+    out += top_digits;
+    for (int i = chunk_count - 1; i >= 0; --i) {
+        details::write_digits19(out, chunks[i]);
+        out += 19;
+    }
+    return { out, std::errc() };
+}
+
+template<size_t byte_size, bool is_signed, typename layout>
+std::from_chars_result from_chars(const char *first, const char *last, intbase_t<byte_size, is_signed, layout> &value)
+{
+    using int_t = intbase_t<byte_size, is_signed, layout>;
+    constexpr int limb_count = byte_size < sizeof(uint64_t) ? 1 : static_cast<int>(byte_size / sizeof(uint64_t));
+    constexpr int bitsize = static_cast<int>(byte_size * 8);
+
+    const char *p = first;
+    bool negative = false;
+    if constexpr (is_signed) {
+        if (p != last && *p == '-') {
+            negative = true;
+            ++p;
+        }
+    }
+    const char *digits = p;
+
+    // limbs = limbs * 10^k + (next k <= 19 digits), all digits are consumed
+    // even once the value is out of range
+    uint64_t limbs[limb_count] = {};
+    bool overflow = false;
+    while (p != last && details::is_digit(*p)) {
+        uint64_t chunk = 0, scale = 1;
+        int count = 0;
+        for (uint64_t word; count + 8 <= 19 && last - p >= 8; p += 8, count += 8) {
+            memcpy(&word, p, sizeof(word));
+            if (!details::is_eight_digits(word)) {
+                break;
+            }
+            chunk = chunk * 100000000 + details::parse_eight_digits(word);
+            scale *= 100000000;
+        }
+        for (; count < 19 && p != last && details::is_digit(*p); ++p, ++count) {
+            chunk = chunk * 10 + static_cast<uint64_t>(*p - '0');
+            scale *= 10;
+        }
+
+        uint64_t carry = chunk;
+        for (int i = 0; i < limb_count; ++i) {
+            const uint64_t limb = limbs[i];
+            limbs[i] = 0;
+            carry = details::multiply_add(limb, scale, carry, limbs[i]);
+        }
+        overflow |= carry != 0;
+    }
+
+    if (p == digits) {
+        return { first, std::errc::invalid_argument };
+    }
+
+    if constexpr (byte_size < sizeof(uint64_t)) {
+        overflow |= (limbs[0] >> bitsize) != 0;
+    }
+    if constexpr (is_signed) {
+        // up to 2^(N - 1) - 1, or 2^(N - 1) for negative values
+        const uint64_t top_bit = uint64_t(1) << ((bitsize - 1) % 64);
+        uint64_t &top = limbs[(bitsize - 1) / 64];
+        if (!overflow && (top & top_bit)) {
+            bool minimum = negative && top == top_bit;
+            for (int i = 0; i < (bitsize - 1) / 64; ++i) {
+                minimum = minimum && limbs[i] == 0;
+            }
+            overflow = !minimum;
+        }
+    }
+    if (overflow) {
+        return { p, std::errc::result_out_of_range };
+    }
+
+    int_t r;
+    memcpy(&r, limbs, byte_size);
+    value = negative ? -r : r;
+    return { p, std::errc() };
+}
+
+
+//
+// literals
+//
+
+#define MAKE_LITERAL_OPERATOR(swtype, name)                                 \
+    inline constexpr swtype operator "" name(unsigned long long int val) {  \
+        if (val > static_cast<unsigned long long int>(swtype::max()))       \
+            throw std::exception("literal out of range");                   \
+        return swtype(val);                                                 \
+    }                                                                       \
+
+MAKE_LITERAL_OPERATOR(int16sw_t, _i16sw)
+MAKE_LITERAL_OPERATOR(int32sw_t, _i32sw)
+MAKE_LITERAL_OPERATOR(int64sw_t, _i64sw)
+MAKE_LITERAL_OPERATOR(uint16sw_t, _u16sw)
+MAKE_LITERAL_OPERATOR(uint32sw_t, _u32sw)
+MAKE_LITERAL_OPERATOR(uint64sw_t, _u64sw)
+
+#undef MAKE_LITERAL_OPERATOR
+
+inline int128sw_t operator "" _i128sw(const char * val)
+{
+    // cannot use strlen because its not constexpr???
+    size_t len = 0;
+    for (auto p = val; *p; ++p, ++len);
+
+    int128sw_t out = int128sw_t(0);
+
+    // non-decimal
+    if (val[0] == '0')
+    {
+        if (val[1] == 'x' || val[1] == 'X')
+        {
+            len -= 2;
+            val += 2;
+
+            if (len > (sizeof(int128sw_t) * 2)) {
+                throw std::exception("literal out of range");
+            }
+
+            for (int i = 0; i < len; ++i)
+            {
+                char c = val[len - 1 - i];
+                if (c >= '1' && c <= '9') {
+                    out |= (static_cast<int128sw_t>(c - '0')) << (i * 4);
+                }
+                else if (c >= 'a' && c <= 'f') {
+                    out |= (static_cast<int128sw_t>(10 + c - 'a')) << (i * 4);
+                }
+                else if (c >= 'A' && c <= 'F') {
+                    out |= (static_cast<int128sw_t>(10 + c - 'A')) << (i * 4);
+                }
+                else if (c != '0') {
+                    throw std::exception("invalid hexadecimal literal");
+                }
+            }
+        }
+        else if (val[1] == 'b' || val[1] == 'B')
         {
             len -= 2;
             val += 2;
@@ -858,21 +2278,15 @@ inline int128sw_t operator "" _i128sw(const char * val)
     }
     else
     {
-        int128sw_t j = int128sw_t(1);
-        for (int i = 0; i < len; ++i, j *= int128sw_t(10))
-        {
-            char c = val[len - 1 - i];
-            if (c >= '1' && c <= '9') {
-                uint8_t carry = 0;
-                out = int128sw_t::add_carry(out, static_cast<int128sw_t>(c - '0') * j, carry);
-                if (carry) {
-                    throw std::exception("literal out of range");
-                }
-            }
-            else if (c != '0') {
-                throw std::exception("invalid decimal literal");
-            }
+        uint128sw_t value;
+        const std::from_chars_result result = from_chars(val, val + len, value);
+        if (result.ec == std::errc::invalid_argument || result.ptr != val + len) {
+            throw std::exception("invalid decimal literal");
+        }
+        if (result.ec == std::errc::result_out_of_range || value > details::bit_cast<uint128sw_t>(int128sw_t::max())) {
+            throw std::exception("literal out of range");
         }
+        out = details::bit_cast<int128sw_t>(value);
     }
 
     if (out > int128sw_t::max()) {
@@ -892,9 +2306,9 @@ inline std::string to_string(int128sw_t sw)
 {
     return int128sw_t::to_string(sw);
 }
-inline std::string to_string(uint128sw_t)
+inline std::string to_string(uint128sw_t sw)
 {
-    return "err";
+    return uint128sw_t::to_string(sw);
 }
 
 inline std::wstring to_wstring(int16sw_t sw) { return std::to_wstring(static_cast<int16_t>(sw)); }
@@ -903,13 +2317,15 @@ inline std::wstring to_wstring(int64sw_t sw) { return std::to_wstring(static_cas
 inline std::wstring to_wstring(uint16sw_t sw) { return std::to_wstring(static_cast<uint16_t>(sw)); }
 inline std::wstring to_wstring(uint32sw_t sw) { return std::to_wstring(static_cast<uint32_t>(sw)); }
 inline std::wstring to_wstring(uint64sw_t sw) { return std::to_wstring(static_cast<uint64_t>(sw)); }
-inline std::wstring to_wstring(int128sw_t)
+inline std::wstring to_wstring(int128sw_t sw)
 {
-    return L"err";
+    const std::string s = int128sw_t::to_string(sw);
+    return std::wstring(s.begin(), s.end());
 }
-inline std::wstring to_wstring(uint128sw_t)
+inline std::wstring to_wstring(uint128sw_t sw)
 {
-    return L"err";
+    const std::string s = uint128sw_t::to_string(sw);
+    return std::wstring(s.begin(), s.end());
 }
 
 #if USE_SW_INT128 // detect existence of HW 128-bit integer types
@@ -0,0 +1,1305 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <type_traits>
+
+#include "swfp.h"
+#include "swint.h"
+#include "swunpacked.h"
+#include "swbatch.h"
+#include "swexec.h"
+
+//
+// Correctly rounded elementary functions
+//
+// exp, exp2, expm1, log, log2, log1p, pow, sin, cos and tan of float32_t and
+// float64_t values, rounded to nearest-even like the arithmetic operators. The
+// results are the same bits on every platform, unlike the C runtime's.
+//
+// The functions are evaluated on multi-word significands (fp_wide of 64-bit
+// words), first with fixed-degree polynomials on the reduced argument with 64
+// bits for binary32 and 128 bits for binary64. When a rounding boundary is
+// within the error bound, the result is evaluated again by the series with two
+// more words (Ziv's strategy), which happens about once in 2^24 binary32 calls
+// and practically never for binary64. The exact results that can be midpoints,
+// of pow and of exp2 at integers, never round unambiguously and are detected
+// and rounded before. A result still undecided is rounded from a last
+// evaluation with four more words, so no function throws (see cr_evaluate).
+//
+// sin, cos and tan reduce their argument modulo pi/2 with Payne-Hanek: the
+// 64-bit significand is multiplied by a window of the bits of 2/pi chosen by
+// the exponent, so the reduced argument keeps its full relative precision for
+// every input up to the largest binary64.
+//
+
+namespace details
+{
+    template<int words>
+    using cr_real = fp_wide<uint64_t, words>;
+
+    // 512-bit constants, most significant word first
+    constexpr int cr_constant_words = 8;
+
+    // ln2 = 1.b17217f7... * 2^-1
+    constexpr uint64_t cr_ln2[cr_constant_words] = {
+        0xb17217f7d1cf79ab, 0xc9e3b39803f2f6af, 0x40f343267298b62d, 0x8a0d175b8baafa2b,
+        0xe7b876206debac98, 0x559552fb4afa1b10, 0xed2eae35c1382144, 0x27573b291169b825
+    };
+
+    // log2(e) = 1.b8aa3b29... * 2^0
+    constexpr uint64_t cr_log2e[cr_constant_words] = {
+        0xb8aa3b295c17f0bb, 0xbe87fed0691d3e88, 0xeb577aa8dd695a58, 0x8b25166cd1a13247,
+        0xde1c43f755176cd6, 0x24d92f75c16be0b3, 0xea90b9e60c4a909f, 0xc4bfaf0353df39b3
+    };
+
+    // pi/2 = 1.921fb544... * 2^0
+    constexpr uint64_t cr_pi_2[cr_constant_words] = {
+        0xc90fdaa22168c234, 0xc4c6628b80dc1cd1, 0x29024e088a67cc74, 0x020bbea63b139b22,
+        0x514a08798e3404dd, 0xef9519b3cd3a431b, 0x302b0a6df25f1437, 0x4fe1356d6d51c245
+    };
+
+    // 1536 bits of 2/pi after the binary point, enough to reduce any binary64
+    constexpr int cr_2_pi_words = 24;
+    constexpr uint64_t cr_2_pi[cr_2_pi_words] = {
+        0xa2f9836e4e441529, 0xfc2757d1f534ddc0, 0xdb6295993c439041, 0xfe5163abdebbc561,
+        0xb7246e3a424dd2e0, 0x06492eea09d1921c, 0xfe1deb1cb129a73e, 0xe88235f52ebb4484,
+        0xe99c7026b45f7e41, 0x3991d639835339f4, 0x9c845f8bbdf9283b, 0x1ff897ffde05980f,
+        0xef2f118b5a0a6d1f, 0x6d367ecf27cb09b7, 0x4f463f669e5fea2d, 0x7527bac7ebe5f17b,
+        0x3d0739f78a5292ea, 0x6bfb5fb11f8d5d08, 0x56033046fc7b6bab, 0xf0cfbc209af4361d,
+        0xa9e391615ee61b08, 0x6599855f14a06840, 0x8dffd8804d732731, 0x06061556ca73a8c9
+    };
+
+    template<int words>
+    constexpr cr_real<words> cr_constant(const uint64_t (&w)[cr_constant_words], int32_t exponent)
+    {
+        static_assert(words <= cr_constant_words, "the constants have 8 words");
+
+        auto c = cr_real<cr_constant_words>::make(unpacked_class::finite, 0);
+        c.exponent = exponent;
+        for (int i = 0; i < cr_constant_words; ++i) {
+            c.w[i] = w[i];
+        }
+        return c.template resize<words>();
+    }
+
+    template<int words, fp_format format>
+    constexpr cr_real<words> cr_from(floatbase_t<format> x)
+    {
+        return rewiden<uint64_t, words>(unpacked_t<format>(x).to_wide());
+    }
+
+    template<int words>
+    constexpr cr_real<words> cr_from_int(int64_t k)
+    {
+        if (k == 0) {
+            return cr_real<words>::make(unpacked_class::zero, 0);
+        }
+
+        auto r = cr_real<words>::make(unpacked_class::finite, k < 0 ? 1 : 0);
+        uint64_t m[1] = { k < 0 ? uint64_t(0) - uint64_t(k) : uint64_t(k) };
+        const int distance = leading_zeros(m);
+        r.w[0] = m[0] << distance;
+        r.exponent = 63 - distance;
+        return r;
+    }
+
+    // nearest binary64, for estimates
+    template<int words>
+    constexpr float64_t cr_to_float64(const cr_real<words> &x)
+    {
+        if (x.class_ != unpacked_class::finite) {
+            return float64_t::zero(x.sign);
+        }
+
+        uint64_t window = x.w[0];
+        for (int i = 1; i < words; ++i) {
+            window |= x.w[i] != 0 ? 1 : 0;
+        }
+        return round_window<fp_format::binary64>(x.sign, x.exponent, window);
+    }
+
+    template<int words>
+    constexpr cr_real<words> cr_scale(cr_real<words> x, int32_t exponent)
+    {
+        if (x.class_ == unpacked_class::finite) {
+            x.exponent += exponent;
+        }
+        return x;
+    }
+
+    template<int words>
+    constexpr cr_real<words> cr_sub(const cr_real<words> &a, const cr_real<words> &b)
+    {
+        return add(a, negate(b));
+    }
+
+    // a * b of finite or zero values, truncated with sticky bit
+    template<int words>
+    constexpr cr_real<words> cr_mul(const cr_real<words> &a, const cr_real<words> &b)
+    {
+        const uint8_t sign = a.sign ^ b.sign;
+        if (a.class_ == unpacked_class::zero || b.class_ == unpacked_class::zero) {
+            return cr_real<words>::make(unpacked_class::zero, sign);
+        }
+
+        auto r = cr_real<2 * words>::make(unpacked_class::finite, sign);
+        r.exponent = a.exponent + b.exponent + 1;
+        for (int i = words - 1; i >= 0; --i) {
+            uint64_t carry = 0;
+            for (int j = words - 1; j >= 0; --j) {
+                uint64_t upper = 0;
+                const uint64_t lower = mul_extended(a.w[i], b.w[j], upper);
+                uint64_t sum = r.w[i + j + 1] + lower;
+                upper += sum < lower ? 1 : 0;
+                sum += carry;
+                upper += sum < carry ? 1 : 0;
+                r.w[i + j + 1] = sum;
+                carry = upper;
+            }
+            r.w[i] = carry;
+        }
+
+        // [1, 2) * [1, 2) is in [1, 4)
+        if (leading_zeros(r.w) != 0) {
+            shift_left(r.w, 1);
+            r.exponent -= 1;
+        }
+        return r.template resize<words>();
+    }
+
+    // x / n for a small integer n
+    template<int words>
+    constexpr cr_real<words> cr_div_small(const cr_real<words> &x, uint32_t n)
+    {
+        if (x.class_ != unpacked_class::finite) {
+            return x;
+        }
+
+        // one more word of quotient for the normalization, 32 bits at a time
+        auto q = cr_real<words + 1>::make(unpacked_class::finite, x.sign);
+        q.exponent = x.exponent;
+        uint64_t remainder = 0;
+        for (int i = 0; i < words + 1; ++i) {
+            const uint64_t word = i < words ? x.w[i] : 0;
+            const uint64_t high = (remainder << 32) | (word >> 32);
+            remainder = high % n;
+            const uint64_t low = (remainder << 32) | (word & 0xffffffff);
+            remainder = low % n;
+            q.w[i] = ((high / n) << 32) | (low / n);
+        }
+        q.w[words] |= remainder != 0 ? 1 : 0;
+
+        const int distance = leading_zeros(q.w);
+        shift_left(q.w, distance);
+        q.exponent -= distance;
+        return q.template resize<words>();
+    }
+
+    // 1 / x by Newton's iteration from a 62-bit estimate
+    template<int words>
+    cr_real<words> cr_reciprocal(const cr_real<words> &x)
+    {
+        const uint128sw_t q = (uint128sw_t(1) << 127) / uint128sw_t(x.w[0]);
+        auto y = cr_real<words>::make(unpacked_class::finite, x.sign);
+        y.w[0] = static_cast<uint64_t>(q >> 64) != 0 ? ~uint64_t(0) : static_cast<uint64_t>(q);
+        y.exponent = -1 - x.exponent;
+
+        const auto one = cr_from_int<words>(1);
+        for (int bits = 62; bits < 64 * words; bits = 2 * bits - 2) {
+            y = add(y, cr_mul(y, cr_sub(one, cr_mul(x, y))));
+        }
+        return y;
+    }
+
+    template<int words>
+    cr_real<words> cr_div(const cr_real<words> &a, const cr_real<words> &b)
+    {
+        return cr_mul(a, cr_reciprocal(b));
+    }
+
+    // the terms of a series stop mattering below the last word of the sum
+    template<int words>
+    constexpr bool cr_negligible(const cr_real<words> &term, const cr_real<words> &sum)
+    {
+        return term.class_ != unpacked_class::finite ||
+            (sum.class_ == unpacked_class::finite && term.exponent < sum.exponent - 64 * words - 2);
+    }
+
+    //
+    // polynomials
+    //
+
+    // the fixed-degree polynomials are truncated Taylor series with their
+    // coefficients rounded down to 192 bits, which is enough for 3 words
+    constexpr int cr_poly_words = 3;
+
+    // c = 1.w * 2^exponent
+    struct cr_coefficient
+    {
+        int32_t exponent;
+        uint64_t w[cr_poly_words];
+    };
+
+    // 1/n! for n = 0 to 44
+    constexpr cr_coefficient cr_inverse_factorials[45] = {
+        { 0, { 0x8000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+        { 0, { 0x8000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+        { -1, { 0x8000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+        { -3, { 0xaaaaaaaaaaaaaaaa, 0xaaaaaaaaaaaaaaaa, 0xaaaaaaaaaaaaaaaa } },
+        { -5, { 0xaaaaaaaaaaaaaaaa, 0xaaaaaaaaaaaaaaaa, 0xaaaaaaaaaaaaaaaa } },
+        { -7, { 0x8888888888888888, 0x8888888888888888, 0x8888888888888888 } },
+        { -10, { 0xb60b60b60b60b60b, 0x60b60b60b60b60b6, 0x0b60b60b60b60b60 } },
+        { -13, { 0xd00d00d00d00d00d, 0x00d00d00d00d00d0, 0x0d00d00d00d00d00 } },
+        { -16, { 0xd00d00d00d00d00d, 0x00d00d00d00d00d0, 0x0d00d00d00d00d00 } },
+        { -19, { 0xb8ef1d2ab6399c7d, 0x560e4472800b8ef1, 0xd2ab6399c7d560e4 } },
+        { -22, { 0x93f27dbbc4fae397, 0x780b69f5333c725b, 0x0eef82e16caab3e9 } },
+        { -26, { 0xd7322b3faa271c7f, 0x3a3f25c1bee38f10, 0x15b9788db55562c8 } },
+        { -29, { 0x8f76c77fc6c4bdaa, 0x26d4c3d67f425f60, 0x0e7ba5b3ce38ec85 } },
+        { -33, { 0xb092309d43684be5, 0x1c198e91d7b4269d, 0x9babdfa238e39942 } },
+        { -37, { 0xc9cba54603e4e905, 0xd6f8a2efd1f27546, 0x68c46d4baebaf84b } },
+        { -41, { 0xd73f9f399dc0f88e, 0xc32b58774657f48f, 0x5eaf6383ed943c0c } },
+        { -45, { 0xd73f9f399dc0f88e, 0xc32b58774657f48f, 0x5eaf6383ed943c0c } },
+        { -49, { 0xca963b81856a5359, 0x3028cbbb8d7ff53b, 0xa468d621d08b83cf } },
+        { -53, { 0xb413c31dcbecbbdd, 0x8024435161554bc3, 0x3ccef73a807c0362 } },
+        { -57, { 0x97a4da340a0ab926, 0x50f61dbdcb3a5abf, 0x5ba0d03143c6bf7b } },
+        { -62, { 0xf2a15d201011283d, 0x4e5695fc785d5dfe, 0xf9014d1b9fa46592 } },
+        { -66, { 0xb8dc77b6e7ab8c5f, 0x78a37e77372290c2, 0x43d03abfb695a2b8 } },
+        { -70, { 0x8671cb6dbfc294a2, 0x86485bf99c763abb, 0xd43a59459c0fbc29 } },
+        { -75, { 0xbb0da098b1c0cecb, 0xdc3826ebfb13cc26, 0xb7f82329322c272e } },
+        { -80, { 0xf96780cb97abbe65, 0x25a033e54ec51033, 0x9ff58436ed90343d } },
+        { -84, { 0x9f9e66e8b2fd46a7, 0x22520cbbb7885c49, 0xfff94a60980a5edf } },
+        { -89, { 0xc4742fe35272cd1c, 0x790285d3580a4a33, 0xb132d1b1f63425ff } },
+        { -94, { 0xe8d58e16e6751905, 0x4d0c78aea13b9a50, 0x3a4f316a9f0e65ed } },
+        { -98, { 0x850c5131a842e9b9, 0xe2e28e1aa546a152, 0x6a7665617f75f119 } },
+        { -103, { 0x92cfcc5a1ac56bd5, 0xf1873bb378948eb3, 0x37aec824f693cc3f } },
+        { -108, { 0x9c9962823eb07306, 0x56f6a614c4e2ba58, 0xc3eda2498f8c9599 } },
+        { -113, { 0xa1a6973c1fade217, 0x0f7237d35fe1c89d, 0xb1796db749db7122 } },
+        { -118, { 0xa1a6973c1fade217, 0x0f7237d35fe1c89d, 0xb1796db749db7122 } },
+        { -123, { 0x9cc092a6e86a8da9, 0xc166ffd4ba113ea8, 0x6e092492b439a402 } },
+        { -128, { 0x9388118e07ebd09f, 0xc515a57ceb5b8644, 0x2b53e62fb8aeb87a } },
+        { -133, { 0x86e2ce38b6c8f941, 0x9e3fad3f0311d9d7, 0xed1981ffbecba15a } },
+        { -139, { 0xefcc194861654958, 0x35c6895393adf50e, 0x1749caaa36bf57bc } },
+        { -144, { 0xcf6468e4a742d7a6, 0x3c58ae1ec4e979fe, 0x5954939a2182e418 } },
+        { -149, { 0xaea565ce061d5748, 0x9e9b85276273c50c, 0x1554b230f3cc8a2f } },
+        { -154, { 0x8f4ca24d25d66f00, 0x8223b575a61d5979, 0x81178ba4e24bee1a } },
+        { -160, { 0xe5476a1509571800, 0xd0392255d6955bf5, 0x9b58df6e36dfe35d } },
+        { -165, { 0xb2f30e1ce812063f, 0x12e7e8d8d96e5442, 0xd0a9443d0b9c02a0 } },
+        { -170, { 0x8857a93a986f41b6, 0x26c912ee5c84d27c, 0x0cb1ba162139e99e } },
+        { -176, { 0xcaeda292bf28916e, 0x5d72b6f79b901b83, 0x0cf0b5b5c64a49da } },
+        { -181, { 0x93958d81ff63527e, 0xcf993f3fb6f47119, 0x7dc6559b78f035b5 } },
+    };
+
+    // 1/(2k + 1) for k = 0 to 37
+    constexpr cr_coefficient cr_inverse_odd[38] = {
+        { 0, { 0x8000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+        { -2, { 0xaaaaaaaaaaaaaaaa, 0xaaaaaaaaaaaaaaaa, 0xaaaaaaaaaaaaaaaa } },
+        { -3, { 0xcccccccccccccccc, 0xcccccccccccccccc, 0xcccccccccccccccc } },
+        { -3, { 0x9249249249249249, 0x2492492492492492, 0x4924924924924924 } },
+        { -4, { 0xe38e38e38e38e38e, 0x38e38e38e38e38e3, 0x8e38e38e38e38e38 } },
+        { -4, { 0xba2e8ba2e8ba2e8b, 0xa2e8ba2e8ba2e8ba, 0x2e8ba2e8ba2e8ba2 } },
+        { -4, { 0x9d89d89d89d89d89, 0xd89d89d89d89d89d, 0x89d89d89d89d89d8 } },
+        { -4, { 0x8888888888888888, 0x8888888888888888, 0x8888888888888888 } },
+        { -5, { 0xf0f0f0f0f0f0f0f0, 0xf0f0f0f0f0f0f0f0, 0xf0f0f0f0f0f0f0f0 } },
+        { -5, { 0xd79435e50d79435e, 0x50d79435e50d7943, 0x5e50d79435e50d79 } },
+        { -5, { 0xc30c30c30c30c30c, 0x30c30c30c30c30c3, 0x0c30c30c30c30c30 } },
+        { -5, { 0xb21642c8590b2164, 0x2c8590b21642c859, 0x0b21642c8590b216 } },
+        { -5, { 0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a3, 0xd70a3d70a3d70a3d } },
+        { -5, { 0x97b425ed097b425e, 0xd097b425ed097b42, 0x5ed097b425ed097b } },
+        { -5, { 0x8d3dcb08d3dcb08d, 0x3dcb08d3dcb08d3d, 0xcb08d3dcb08d3dcb } },
+        { -5, { 0x8421084210842108, 0x4210842108421084, 0x2108421084210842 } },
+        { -6, { 0xf83e0f83e0f83e0f, 0x83e0f83e0f83e0f8, 0x3e0f83e0f83e0f83 } },
+        { -6, { 0xea0ea0ea0ea0ea0e, 0xa0ea0ea0ea0ea0ea, 0x0ea0ea0ea0ea0ea0 } },
+        { -6, { 0xdd67c8a60dd67c8a, 0x60dd67c8a60dd67c, 0x8a60dd67c8a60dd6 } },
+        { -6, { 0xd20d20d20d20d20d, 0x20d20d20d20d20d2, 0x0d20d20d20d20d20 } },
+        { -6, { 0xc7ce0c7ce0c7ce0c, 0x7ce0c7ce0c7ce0c7, 0xce0c7ce0c7ce0c7c } },
+        { -6, { 0xbe82fa0be82fa0be, 0x82fa0be82fa0be82, 0xfa0be82fa0be82fa } },
+        { -6, { 0xb60b60b60b60b60b, 0x60b60b60b60b60b6, 0x0b60b60b60b60b60 } },
+        { -6, { 0xae4c415c9882b931, 0x0572620ae4c415c9, 0x882b9310572620ae } },
+        { -6, { 0xa72f05397829cbc1, 0x4e5e0a72f0539782, 0x9cbc14e5e0a72f05 } },
+        { -6, { 0xa0a0a0a0a0a0a0a0, 0xa0a0a0a0a0a0a0a0, 0xa0a0a0a0a0a0a0a0 } },
+        { -6, { 0x9a90e7d95bc609a9, 0x0e7d95bc609a90e7, 0xd95bc609a90e7d95 } },
+        { -6, { 0x94f2094f2094f209, 0x4f2094f2094f2094, 0xf2094f2094f2094f } },
+        { -6, { 0x8fb823ee08fb823e, 0xe08fb823ee08fb82, 0x3ee08fb823ee08fb } },
+        { -6, { 0x8ad8f2fba9386822, 0xb63cbeea4e1a08ad, 0x8f2fba9386822b63 } },
+        { -6, { 0x864b8a7de6d1d608, 0x64b8a7de6d1d6086, 0x4b8a7de6d1d60864 } },
+        { -6, { 0x8208208208208208, 0x2082082082082082, 0x0820820820820820 } },
+        { -7, { 0xfc0fc0fc0fc0fc0f, 0xc0fc0fc0fc0fc0fc, 0x0fc0fc0fc0fc0fc0 } },
+        { -7, { 0xf4898d5f85bb3950, 0x3d226357e16ece54, 0x0f4898d5f85bb395 } },
+        { -7, { 0xed7303b5cc0ed730, 0x3b5cc0ed7303b5cc, 0x0ed7303b5cc0ed73 } },
+        { -7, { 0xe6c2b4481cd85689, 0x039b0ad12073615a, 0x240e6c2b4481cd85 } },
+        { -7, { 0xe070381c0e070381, 0xc0e070381c0e0703, 0x81c0e070381c0e07 } },
+        { -7, { 0xda740da740da740d, 0xa740da740da740da, 0x740da740da740da7 } },
+    };
+
+    // terms of each polynomial for `words` words, the truncation is below
+    // 2^(-64 words - 4) relatively on the reduced arguments
+    struct cr_poly_terms { int expm1, sin, cos, atanh; };
+    constexpr cr_poly_terms cr_terms[cr_poly_words + 1] = {
+        { 0, 0, 0, 0 }, { 16, 10, 11, 13 }, { 27, 16, 17, 25 }, { 36, 22, 23, 38 }
+    };
+
+    template<int words>
+    constexpr cr_real<words> cr_coefficient_value(const cr_coefficient &c)
+    {
+        static_assert(words <= cr_poly_words, "the coefficients have 3 words");
+
+        auto r = cr_real<words>::make(unpacked_class::finite, 0);
+        r.exponent = c.exponent;
+        for (int i = 0; i < words; ++i) {
+            r.w[i] = c.w[i];
+        }
+        return r;
+    }
+
+    // c[first] + x (c[first + step] + x (...)) with `terms` coefficients of c
+    template<int words, size_t n>
+    cr_real<words> cr_horner(const cr_real<words> &x, const cr_coefficient (&c)[n], int first, int step, int terms)
+    {
+        auto sum = cr_coefficient_value<words>(c[first + step * (terms - 1)]);
+        for (int i = terms - 2; i >= 0; --i) {
+            sum = add(cr_mul(sum, x), cr_coefficient_value<words>(c[first + step * i]));
+        }
+        return sum;
+    }
+
+    //
+    // exponentials
+    //
+
+    // e^r - 1 for |r| up to about ln2
+    template<int words>
+    cr_real<words> cr_expm1_series(const cr_real<words> &r)
+    {
+        cr_real<words> sum = r, term = r;
+        for (uint32_t n = 2; ; ++n) {
+            term = cr_div_small(cr_mul(term, r), n);
+            if (cr_negligible(term, sum)) {
+                return sum;
+            }
+            sum = add(sum, term);
+        }
+    }
+
+    // e^r - 1 = r (1 + r/2! + r^2/3! + ...) for |r| up to 0.35
+    template<int words>
+    cr_real<words> cr_expm1_poly(const cr_real<words> &r)
+    {
+        return cr_mul(r, cr_horner(r, cr_inverse_factorials, 1, 1, cr_terms[words].expm1));
+    }
+
+    template<bool polynomial, int words>
+    cr_real<words> cr_expm1_reduced(const cr_real<words> &r)
+    {
+        if constexpr (polynomial) {
+            return cr_expm1_poly(r);
+        }
+        else {
+            return cr_expm1_series(r);
+        }
+    }
+
+    // x = k ln2 + r with |r| about ln2 / 2 or less, k ln2 is subtracted with
+    // one more word so that r is accurate for any k of the binary64 range
+    template<int words>
+    cr_real<words> cr_exp_reduce(const cr_real<words> &x, int32_t &k)
+    {
+        const float64_t estimate = cr_to_float64(x) * float64_t(1.4426950408889634);
+        k = static_cast<int32_t>(estimate < float64_t::zero() ? estimate - float64_t(0.5) : estimate + float64_t(0.5));
+        if (k == 0) {
+            return x;
+        }
+
+        const auto product = cr_mul(cr_from_int<words + 1>(k), cr_constant<words + 1>(cr_ln2, -1));
+        return cr_sub(x.template resize<words + 1>(), product).template resize<words>();
+    }
+
+    // e^x = 2^k (1 + (e^r - 1))
+    template<bool polynomial, int words>
+    cr_real<words> cr_exp(const cr_real<words> &x)
+    {
+        int32_t k = 0;
+        const auto r = cr_exp_reduce(x, k);
+        return cr_scale(add(cr_from_int<words>(1), cr_expm1_reduced<polynomial>(r)), k);
+    }
+
+    // e^x - 1, exact arithmetic near zero through the series or polynomial
+    template<bool polynomial, int words>
+    cr_real<words> cr_expm1(const cr_real<words> &x)
+    {
+        int32_t k = 0;
+        const auto m = cr_expm1_reduced<polynomial>(cr_exp_reduce(x, k));
+        if (k == 0) {
+            return m;
+        }
+
+        const auto one = cr_from_int<words>(1);
+        return cr_sub(cr_scale(add(one, m), k), one);
+    }
+
+    // 2^x = 2^k e^((x - k) ln2), x - k is exact
+    template<bool polynomial, int words, fp_format format>
+    cr_real<words> cr_exp2(floatbase_t<format> x)
+    {
+        const float64_t v = static_cast<float64_t>(x);
+        const auto k = static_cast<int32_t>(v < float64_t::zero() ? v - float64_t(0.5) : v + float64_t(0.5));
+        const auto f = cr_sub(cr_from<words>(x), cr_from_int<words>(k));
+        const auto m = cr_expm1_reduced<polynomial>(cr_mul(f, cr_constant<words>(cr_ln2, -1)));
+        return cr_scale(add(cr_from_int<words>(1), m), k);
+    }
+
+    //
+    // logarithms
+    //
+
+    // log((1 + z) / (1 - z)) = 2 atanh(z) for |z| up to 0.18
+    template<int words>
+    cr_real<words> cr_atanh_series(const cr_real<words> &z)
+    {
+        const auto z2 = cr_mul(z, z);
+        cr_real<words> sum = cr_from_int<words>(1), power = sum;
+        for (uint32_t n = 3; ; n += 2) {
+            power = cr_mul(power, z2);
+            const auto term = cr_div_small(power, n);
+            if (cr_negligible(term, sum)) {
+                break;
+            }
+            sum = add(sum, term);
+        }
+        return cr_scale(cr_mul(z, sum), 1);
+    }
+
+    // 2 z (1 + z^2/3 + z^4/5 + ...) for |z| up to 0.1716
+    template<int words>
+    cr_real<words> cr_atanh_poly(const cr_real<words> &z)
+    {
+        const auto sum = cr_horner(cr_mul(z, z), cr_inverse_odd, 0, 1, cr_terms[words].atanh);
+        return cr_scale(cr_mul(z, sum), 1);
+    }
+
+    template<bool polynomial, int words>
+    cr_real<words> cr_atanh(const cr_real<words> &z)
+    {
+        if constexpr (polynomial) {
+            return cr_atanh_poly(z);
+        }
+        else {
+            return cr_atanh_series(z);
+        }
+    }
+
+    // x = 2^e m with m in [sqrt(1/2), sqrt(2)), returns log(m)
+    template<bool polynomial, int words>
+    cr_real<words> cr_log_significand(cr_real<words> x, int32_t &e)
+    {
+        e = x.exponent;
+        x.exponent = 0;
+        if (x.w[0] > 0xb504f333f9de6484) {
+            x.exponent = -1;
+            ++e;
+        }
+
+        const auto one = cr_from_int<words>(1);
+        return cr_atanh<polynomial>(cr_div(cr_sub(x, one), add(x, one)));
+    }
+
+    // log(x) of a positive x
+    template<bool polynomial, int words>
+    cr_real<words> cr_log(const cr_real<words> &x)
+    {
+        int32_t e = 0;
+        const auto m = cr_log_significand<polynomial>(x, e);
+        if (e == 0) {
+            return m;
+        }
+        return add(cr_mul(cr_from_int<words>(e), cr_constant<words>(cr_ln2, -1)), m);
+    }
+
+    //
+    // trigonometric functions
+    //
+
+    // bits [first, first + 64) of 2/pi, bit i is worth 2^-i
+    inline uint64_t cr_2_pi_bits(int32_t first)
+    {
+        const int32_t position = first - 1;
+        const int32_t word = position >= 0 ? position / 64 : -((63 - position) / 64);
+        const int shift = position - word * 64;
+
+        auto at = [](int32_t i) { return i >= 0 && i < cr_2_pi_words ? cr_2_pi[i] : uint64_t(0); };
+        return shift ? (at(word) << shift) | (at(word + 1) >> (64 - shift)) : at(word);
+    }
+
+    // x = (k + f) pi/2 for a positive x, returns r = f pi/2 with |f| <= 1/2 and
+    // k mod 4
+    template<int words>
+    cr_real<words> cr_trig_reduce(const cr_real<words> &x, int &quadrant)
+    {
+        quadrant = 0;
+        if (cr_to_float64(x) < float64_t(0.78539816339744828)) {
+            return x;
+        }
+
+        // x = m 2^e; the bits of 2/pi worth more than 2^(1 - e) only add
+        // multiples of 4 to x 2/pi, the window starts below them and ends
+        // 64 (words + 2) bits below the binary point of the product
+        constexpr int window = words + 3;
+        const uint64_t m = x.w[0];
+        const int32_t e = x.exponent - 63;
+        const int32_t last = e + 64 * (words + 2);
+
+        uint64_t product[window + 1] = {};
+        uint128sw_t carry(0);
+        for (int i = window - 1; i >= 0; --i) {
+            const uint128sw_t p = uint128sw_t(m) * uint128sw_t(cr_2_pi_bits(last - 64 * (window - i) + 1)) + carry;
+            product[i + 1] = static_cast<uint64_t>(p);
+            carry = p >> 64;
+        }
+        product[0] = static_cast<uint64_t>(carry);
+
+        // the integer part ends in product[1], the fraction is the rest
+        quadrant = static_cast<int>(product[1] & 3);
+        auto f = cr_real<words + 2>::make(unpacked_class::finite, 0);
+        for (int i = 0; i < words + 2; ++i) {
+            f.w[i] = product[i + 2];
+        }
+
+        // f >= 1/2 goes to the next quadrant as f - 1, negated in two's complement
+        if (f.w[0] >> 63) {
+            quadrant = (quadrant + 1) & 3;
+            f.sign = 1;
+            bool carry = true;
+            for (int i = words + 1; i >= 0; --i) {
+                f.w[i] = ~f.w[i] + (carry ? 1 : 0);
+                carry = carry && f.w[i] == 0;
+            }
+        }
+        if (words_zero(f.w)) {
+            return cr_real<words>::make(unpacked_class::zero, 0);
+        }
+
+        const int distance = leading_zeros(f.w);
+        shift_left(f.w, distance);
+        f.exponent = -1 - distance;
+        return cr_mul(f.template resize<words>(), cr_constant<words>(cr_pi_2, 0));
+    }
+
+    // sin(r) for |r| <= pi/4
+    template<int words>
+    cr_real<words> cr_sin_series(const cr_real<words> &r)
+    {
+        const auto r2 = cr_mul(r, r);
+        cr_real<words> sum = r, term = r;
+        for (uint32_t n = 2; ; n += 2) {
+            term = negate(cr_div_small(cr_mul(term, r2), n * (n + 1)));
+            if (cr_negligible(term, sum)) {
+                return sum;
+            }
+            sum = add(sum, term);
+        }
+    }
+
+    // cos(r) for |r| <= pi/4
+    template<int words>
+    cr_real<words> cr_cos_series(const cr_real<words> &r)
+    {
+        const auto r2 = cr_mul(r, r);
+        cr_real<words> sum = cr_from_int<words>(1), term = sum;
+        for (uint32_t n = 1; ; n += 2) {
+            term = negate(cr_div_small(cr_mul(term, r2), n * (n + 1)));
+            if (cr_negligible(term, sum)) {
+                return sum;
+            }
+            sum = add(sum, term);
+        }
+    }
+
+    // sin(r) = r (1 - r^2/3! + r^4/5! - ...) for |r| <= pi/4
+    template<int words>
+    cr_real<words> cr_sin_poly(const cr_real<words> &r)
+    {
+        return cr_mul(r, cr_horner(negate(cr_mul(r, r)), cr_inverse_factorials, 1, 2, cr_terms[words].sin));
+    }
+
+    // cos(r) = 1 - r^2/2! + r^4/4! - ... for |r| <= pi/4
+    template<int words>
+    cr_real<words> cr_cos_poly(const cr_real<words> &r)
+    {
+        return cr_horner(negate(cr_mul(r, r)), cr_inverse_factorials, 0, 2, cr_terms[words].cos);
+    }
+
+    template<bool polynomial, int words>
+    cr_real<words> cr_sin(const cr_real<words> &r)
+    {
+        if constexpr (polynomial) {
+            return cr_sin_poly(r);
+        }
+        else {
+            return cr_sin_series(r);
+        }
+    }
+
+    template<bool polynomial, int words>
+    cr_real<words> cr_cos(const cr_real<words> &r)
+    {
+        if constexpr (polynomial) {
+            return cr_cos_poly(r);
+        }
+        else {
+            return cr_cos_series(r);
+        }
+    }
+
+    //
+    // rounding
+    //
+
+    // bits [first, first + count) of w, counted from the top, all equal bit
+    template<int words>
+    constexpr bool cr_bits_equal(const uint64_t (&w)[words], int first, int count, bool bit)
+    {
+        for (int i = first; i < first + count; ++i) {
+            if (((w[i / 64] >> (63 - i % 64)) & 1) != (bit ? 1u : 0u)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // x to nearest-even in `out`, x being exact
+    template<fp_format out, int words>
+    floatbase_t<out> cr_round_exact(const cr_real<words> &x)
+    {
+        using packed_t = floatbase_t<out>;
+        constexpr int precision = unpacked_t<out>::precision;
+        constexpr int32_t emax = fp_traits<out>::bias;
+        constexpr int32_t emin = 1 - emax;
+
+        if (x.class_ == unpacked_class::zero) {
+            return packed_t::zero(x.sign);
+        }
+        if (x.exponent > emax) {
+            return packed_t::infinity(x.sign);
+        }
+
+        // below half the smallest subnormal
+        if (x.exponent < emin - precision - 1) {
+            return packed_t::zero(x.sign);
+        }
+
+        uint64_t window = x.w[0];
+        for (int i = 1; i < words; ++i) {
+            window |= x.w[i] != 0 ? 1 : 0;
+        }
+        return round_window<out>(x.sign, x.exponent, window);
+    }
+
+    // x to nearest-even in `out` when x is within 2^(error_bits - 64 words) of
+    // the exact value relatively; `decided` is false when a midpoint between
+    // two results of `out` is within that distance
+    template<fp_format out, int words>
+    floatbase_t<out> cr_round(const cr_real<words> &x, int error_bits, bool &decided)
+    {
+        using packed_t = floatbase_t<out>;
+        constexpr int precision = unpacked_t<out>::precision;
+        constexpr int32_t emax = fp_traits<out>::bias;
+        constexpr int32_t emin = 1 - emax;
+
+        decided = true;
+        if (x.class_ == unpacked_class::zero || x.exponent > emax) {
+            return cr_round_exact<out>(x);
+        }
+
+        // bits kept by the rounding, fewer for subnormal results; with -1 kept
+        // bits the midpoint is the half of the smallest subnormal above x
+        const int32_t kept = x.exponent < emin ? precision - (emin - x.exponent) : precision;
+        if (kept < -1) {
+            return packed_t::zero(x.sign);
+        }
+
+        const int count = 64 * words - error_bits - static_cast<int>(kept);
+        bool near = false;
+        if (kept < 0) {
+            near = cr_bits_equal(x.w, 0, count, true);
+        }
+        else {
+            const bool bit = ((x.w[kept / 64] >> (63 - kept % 64)) & 1) != 0;
+            near = cr_bits_equal(x.w, static_cast<int>(kept) + 1, count - 1, !bit);
+        }
+
+        if (near) {
+            decided = false;
+            return packed_t::zero(x.sign);
+        }
+        return cr_round_exact<out>(x);
+    }
+
+    // evaluate fn(words, polynomial) with the polynomials on 1 word for binary32
+    // and 2 for binary64, then with the series on 2 more words when the result
+    // is too close to a rounding boundary, and round the series on 4 more words
+    // without a test when it is still undecided.
+    //
+    // The callers round the exact results that can be midpoints themselves. Any
+    // other result is irrational (Lindemann-Weierstrass for e^x, log x and the
+    // trigonometric functions at nonzero x, and x^y for a dyadic y = n / 2^k is
+    // either dyadic or irrational), so it lies strictly on one side of its
+    // midpoint and some width decides it. The widths reached are:
+    //
+    //      binary32 exp, exp2, expm1, log, log2, log1p, sin, cos, tan
+    //          every input was checked: apart from exp2 at integers, no
+    //          result is within 2^-66 of a midpoint relatively (the closest
+    //          is log1p(0x1.800006p-21)), so the second pass, 176 bits,
+    //          decides them all
+    //      binary64 unary functions, 368 bits on the last pass
+    //      binary32 and binary64 pow, 356 and 420 bits on the last pass
+    //
+    // No exhaustive bound is known for the binary64 functions or for pow. If
+    // the bits beyond the rounding bit are spread uniformly, n inputs with
+    // p-bit results have about n 2^(p + 1 - bits) results within 2^-bits of a
+    // midpoint: 2^-250 for the binary64 unary functions, 2^-267 for binary32
+    // pow and 2^-238 for the 2^128 binary64 pow inputs. The last pass is not
+    // expected to be reached; if it is, it rounds the closest value known
+    // rather than throwing in the middle of a batch kernel.
+    template<fp_format format, typename fn_t>
+    floatbase_t<format> cr_evaluate(int error_bits, fn_t fn)
+    {
+        static_assert(format == fp_format::binary32 || format == fp_format::binary64, "the elementary functions take binary32 or binary64 values");
+
+        constexpr int fast = format == fp_format::binary32 ? 1 : 2;
+        bool decided = false;
+        auto r = cr_round<format>(fn(std::integral_constant<int, fast>(), std::true_type()), error_bits, decided);
+        if (!decided) {
+            r = cr_round<format>(fn(std::integral_constant<int, fast + 2>(), std::false_type()), error_bits, decided);
+        }
+        if (!decided) {
+            r = cr_round_exact<format>(fn(std::integral_constant<int, fast + 4>(), std::false_type()));
+        }
+        return r;
+    }
+
+    // 0 for non-integers, 1 for odd and 2 for even integers
+    template<fp_format format>
+    constexpr int cr_integer_kind(floatbase_t<format> y)
+    {
+        using uint_t = typename fp_traits<format>::uint_t;
+        constexpr int bitsize = unpacked_t<format>::bitsize;
+
+        const unpacked_t<format> u(y);
+        if (u.class_ == unpacked_class::zero) {
+            return 2;
+        }
+        if (u.class_ != unpacked_class::finite || u.exponent < 0) {
+            return 0;
+        }
+
+        const int fraction_bits = bitsize - 1 - u.exponent;
+        if (fraction_bits <= 0) {
+            return 2;
+        }
+        if (static_cast<uint_t>(u.significand << (bitsize - fraction_bits)) != 0) {
+            return 0;
+        }
+        return ((u.significand >> fraction_bits) & 1) ? 1 : 2;
+    }
+
+    // |x|^y of finite nonzero x and y when it is m 2^e with m < 2^64, which
+    // includes every midpoint between two results. With |x| = mx 2^ex and
+    // y = ny 2^ey for odd mx and ny, a power of two gives 2^(ex y) when ex y is
+    // an integer, and otherwise y > 0 and mx = t^(2^-ey) give t^ny 2^(ex y) for
+    // ey < 0, and mx^y 2^(ex y) for integers
+    template<fp_format format>
+    bool cr_pow_exact(floatbase_t<format> x, floatbase_t<format> y, cr_real<1> &r)
+    {
+        constexpr int bitsize = unpacked_t<format>::bitsize;
+
+        const unpacked_t<format> ux(x), uy(y);
+        uint64_t mx = static_cast<uint64_t>(ux.significand);
+        uint64_t ny = static_cast<uint64_t>(uy.significand);
+        const int x_zeros = countr_zero(mx), y_zeros = countr_zero(ny);
+        mx >>= x_zeros;
+        ny >>= y_zeros;
+        int64_t e = ux.exponent - (bitsize - 1) + x_zeros;
+        int32_t ey = uy.exponent - (bitsize - 1) + y_zeros;
+
+        uint64_t m = 1;
+        if (mx == 1) {
+            // |ex| < 2^11, only 0 is a multiple of a larger power of two
+            if (ey < 0) {
+                if (ey < -11 || e % (int64_t(1) << -ey) != 0) {
+                    return false;
+                }
+                e /= int64_t(1) << -ey;
+                ey = 0;
+            }
+
+            // results beyond 2^4096 either way are left to the overflow and
+            // underflow estimates
+            if (e != 0) {
+                if (ey > 12 || ny > 4096) {
+                    return false;
+                }
+                e *= static_cast<int64_t>(ny << ey);
+                if (e > 4096 || e < -4096) {
+                    return false;
+                }
+            }
+            if (uy.sign) {
+                e = -e;
+            }
+        }
+        else {
+            // 1 / t^n is not a binary fraction for odd t > 1, and 3^(2^6) has
+            // more bits than any significand
+            if (uy.sign || ey < -5) {
+                return false;
+            }
+
+            uint64_t t = mx;
+            if (ey < 0) {
+                for (int i = 0; i < -ey; ++i) {
+                    bool exact = false;
+                    t = isqrt128(0, t, exact);
+                    if (!exact) {
+                        return false;
+                    }
+                }
+                if (e % (int64_t(1) << -ey) != 0) {
+                    return false;
+                }
+                e /= int64_t(1) << -ey;
+                ey = 0;
+            }
+
+            // 3^41 has more than 64 bits
+            if (ey > 5 || (ny << ey) > 40) {
+                return false;
+            }
+
+            const uint64_t n = ny << ey;
+            for (uint64_t i = 0; i < n; ++i) {
+                uint64_t upper = 0;
+                m = mul_extended(m, t, upper);
+                if (upper != 0) {
+                    return false;
+                }
+            }
+            e *= static_cast<int64_t>(n);
+        }
+
+        const int distance = countl_zero(m);
+        r = cr_real<1>::make(unpacked_class::finite, 0);
+        r.w[0] = m << distance;
+        r.exponent = static_cast<int32_t>(e) + 63 - distance;
+        return true;
+    }
+
+    template<fp_format format>
+    struct cr_limits
+    {
+        static constexpr int precision = unpacked_t<format>::precision;
+        static constexpr int emax = fp_traits<format>::bias;
+        static constexpr int emin = 1 - emax;
+
+        // 2^x overflows above `overflow` and rounds to zero below `underflow`
+        static constexpr double overflow = emax + 2;
+        static constexpr double underflow = emin - precision - 2;
+    };
+
+    enum class trig_op { sin, cos, tan };
+
+    template<trig_op op, fp_format format>
+    floatbase_t<format> cr_trig(floatbase_t<format> x)
+    {
+        using packed_t = floatbase_t<format>;
+
+        const unpacked_t<format> u(x);
+        switch (u.class_)
+        {
+        case unpacked_class::nan:
+            return x;
+        case unpacked_class::infinity:
+            return packed_t::indeterminate_nan();
+        case unpacked_class::zero:
+            return op == trig_op::cos ? packed_t(1.0f) : x;
+        default:
+            break;
+        }
+
+        // odd functions of |x|
+        const uint8_t sign = op == trig_op::cos ? 0 : u.sign;
+        return cr_evaluate<format>(16, [&](auto size, auto polynomial) {
+            constexpr int words = decltype(size)::value;
+            constexpr bool poly = decltype(polynomial)::value;
+            auto magnitude = cr_from<words>(x);
+            magnitude.sign = 0;
+
+            int quadrant = 0;
+            const auto r = cr_trig_reduce(magnitude, quadrant);
+            cr_real<words> y;
+            if (op == trig_op::tan) {
+                const auto s = cr_sin<poly>(r), c = cr_cos<poly>(r);
+                y = quadrant & 1 ? negate(cr_div(c, s)) : cr_div(s, c);
+            }
+            else {
+                if (op == trig_op::cos) {
+                    quadrant = (quadrant + 1) & 3;
+                }
+                y = quadrant & 1 ? cr_cos<poly>(r) : cr_sin<poly>(r);
+                if (quadrant & 2) {
+                    y = negate(y);
+                }
+            }
+            y.sign ^= sign;
+            return y;
+        });
+    }
+}
+
+//
+// exponentials
+//
+
+template<fp_format format>
+floatbase_t<format> exp(floatbase_t<format> x)
+{
+    using packed_t = floatbase_t<format>;
+    using limits = details::cr_limits<format>;
+
+    const unpacked_t<format> u(x);
+    switch (u.class_)
+    {
+    case unpacked_class::nan:
+        return x;
+    case unpacked_class::infinity:
+        return u.sign ? packed_t::zero() : x;
+    case unpacked_class::zero:
+        return packed_t(1.0f);
+    default:
+        break;
+    }
+
+    const double v = static_cast<double>(x);
+    if (v > limits::overflow * 0.6931471805599453) {
+        return packed_t::infinity();
+    }
+    if (v < limits::underflow * 0.6931471805599453) {
+        return packed_t::zero();
+    }
+
+    return details::cr_evaluate<format>(16, [&](auto size, auto polynomial) {
+        constexpr int words = decltype(size)::value;
+        return details::cr_exp<decltype(polynomial)::value>(details::cr_from<words>(x));
+    });
+}
+
+template<fp_format format>
+floatbase_t<format> exp2(floatbase_t<format> x)
+{
+    using packed_t = floatbase_t<format>;
+    using limits = details::cr_limits<format>;
+
+    const unpacked_t<format> u(x);
+    switch (u.class_)
+    {
+    case unpacked_class::nan:
+        return x;
+    case unpacked_class::infinity:
+        return u.sign ? packed_t::zero() : x;
+    case unpacked_class::zero:
+        return packed_t(1.0f);
+    default:
+        break;
+    }
+
+    const double v = static_cast<double>(x);
+    if (v > limits::overflow) {
+        return packed_t::infinity();
+    }
+    if (v < limits::underflow) {
+        return packed_t::zero();
+    }
+
+    // powers of two are exact, and half the smallest subnormal is a midpoint
+    if (details::cr_integer_kind(x) != 0) {
+        return details::cr_round_exact<format>(details::cr_scale(details::cr_from_int<1>(1), static_cast<int32_t>(v)));
+    }
+
+    return details::cr_evaluate<format>(16, [&](auto size, auto polynomial) {
+        constexpr int words = decltype(size)::value;
+        return details::cr_exp2<decltype(polynomial)::value, words>(x);
+    });
+}
+
+template<fp_format format>
+floatbase_t<format> expm1(floatbase_t<format> x)
+{
+    using packed_t = floatbase_t<format>;
+    using limits = details::cr_limits<format>;
+
+    const unpacked_t<format> u(x);
+    switch (u.class_)
+    {
+    case unpacked_class::nan:
+    case unpacked_class::zero:
+        return x;
+    case unpacked_class::infinity:
+        return u.sign ? packed_t(-1.0f) : x;
+    default:
+        break;
+    }
+
+    // below -(precision + 2) ln2, e^x is less than half an ulp of -1
+    const double v = static_cast<double>(x);
+    if (v > limits::overflow * 0.6931471805599453) {
+        return packed_t::infinity();
+    }
+    if (v < -(limits::precision + 2) * 0.6931471805599453) {
+        return packed_t(-1.0f);
+    }
+
+    return details::cr_evaluate<format>(16, [&](auto size, auto polynomial) {
+        constexpr int words = decltype(size)::value;
+        return details::cr_expm1<decltype(polynomial)::value>(details::cr_from<words>(x));
+    });
+}
+
+//
+// logarithms
+//
+
+template<fp_format format>
+floatbase_t<format> log(floatbase_t<format> x)
+{
+    using packed_t = floatbase_t<format>;
+
+    const unpacked_t<format> u(x);
+    if (u.class_ == unpacked_class::nan) {
+        return x;
+    }
+    if (u.class_ == unpacked_class::zero) {
+        return packed_t::infinity(1);
+    }
+    if (u.sign) {
+        return packed_t::indeterminate_nan();
+    }
+    if (u.class_ == unpacked_class::infinity) {
+        return x;
+    }
+
+    return details::cr_evaluate<format>(16, [&](auto size, auto polynomial) {
+        constexpr int words = decltype(size)::value;
+        return details::cr_log<decltype(polynomial)::value>(details::cr_from<words>(x));
+    });
+}
+
+template<fp_format format>
+floatbase_t<format> log2(floatbase_t<format> x)
+{
+    using packed_t = floatbase_t<format>;
+
+    const unpacked_t<format> u(x);
+    if (u.class_ == unpacked_class::nan) {
+        return x;
+    }
+    if (u.class_ == unpacked_class::zero) {
+        return packed_t::infinity(1);
+    }
+    if (u.sign) {
+        return packed_t::indeterminate_nan();
+    }
+    if (u.class_ == unpacked_class::infinity) {
+        return x;
+    }
+
+    // e + log(m) log2(e), exact for powers of two
+    return details::cr_evaluate<format>(16, [&](auto size, auto polynomial) {
+        constexpr int words = decltype(size)::value;
+        int32_t e = 0;
+        const auto m = details::cr_log_significand<decltype(polynomial)::value>(details::cr_from<words>(x), e);
+        return add(details::cr_from_int<words>(e), details::cr_mul(m, details::cr_constant<words>(details::cr_log2e, 0)));
+    });
+}
+
+template<fp_format format>
+floatbase_t<format> log1p(floatbase_t<format> x)
+{
+    using packed_t = floatbase_t<format>;
+
+    const unpacked_t<format> u(x);
+    switch (u.class_)
+    {
+    case unpacked_class::nan:
+    case unpacked_class::zero:
+        return x;
+    case unpacked_class::infinity:
+        return u.sign ? packed_t::indeterminate_nan() : x;
+    default:
+        break;
+    }
+
+    const double v = static_cast<double>(x);
+    if (v == -1.0) {
+        return packed_t::infinity(1);
+    }
+    if (v < -1.0) {
+        return packed_t::indeterminate_nan();
+    }
+
+    // for 1 + x in [sqrt(1/2), sqrt(2)), log1p(x) = 2 atanh(x / (2 + x)) keeps
+    // the precision of small x; elsewhere 1 + x has no significant rounding
+    const bool near_zero = v > -0.29289321881345243 && v < 0.41421356237309503;
+    return details::cr_evaluate<format>(16, [&](auto size, auto polynomial) {
+        constexpr int words = decltype(size)::value;
+        constexpr bool poly = decltype(polynomial)::value;
+        const auto y = details::cr_from<words>(x);
+        const auto two = details::cr_from_int<words>(2);
+        if (near_zero) {
+            return details::cr_atanh<poly>(details::cr_div(y, add(two, y)));
+        }
+        return details::cr_log<poly>(add(details::cr_from_int<words>(1), y));
+    });
+}
+
+//
+// power
+//
+
+// x^y with the special cases of C99 pow
+template<fp_format format>
+floatbase_t<format> pow(floatbase_t<format> x, floatbase_t<format> y)
+{
+    using packed_t = floatbase_t<format>;
+    using limits = details::cr_limits<format>;
+
+    const unpacked_t<format> ux(x), uy(y);
+    const packed_t one(1.0f);
+
+    if (uy.class_ == unpacked_class::zero || x.to_bitstring() == one.to_bitstring()) {
+        return one;
+    }
+    if (ux.class_ == unpacked_class::nan) {
+        return x;
+    }
+    if (uy.class_ == unpacked_class::nan) {
+        return y;
+    }
+
+    const int kind = details::cr_integer_kind(y);
+    const uint8_t odd_sign = kind == 1 ? ux.sign : 0;
+    if (ux.class_ == unpacked_class::zero) {
+        return uy.sign ? packed_t::infinity(odd_sign) : packed_t::zero(odd_sign);
+    }
+    if (uy.class_ == unpacked_class::infinity) {
+        // |x| is 1 only for x = -1 here
+        if (x.to_bitstring() == (-one).to_bitstring()) {
+            return one;
+        }
+        const bool below_one = ux.class_ == unpacked_class::finite && ux.exponent < 0;
+        return below_one == (uy.sign != 0) ? packed_t::infinity() : packed_t::zero();
+    }
+    if (ux.class_ == unpacked_class::infinity) {
+        return uy.sign ? packed_t::zero(odd_sign) : packed_t::infinity(odd_sign);
+    }
+    if (ux.sign && kind == 0) {
+        return packed_t::indeterminate_nan();
+    }
+
+    // exact results are rounded directly, the midpoints among them would
+    // never round unambiguously
+    details::cr_real<1> exact;
+    if (details::cr_pow_exact(x, y, exact)) {
+        exact.sign = odd_sign;
+        return details::cr_round_exact<format>(exact);
+    }
+
+    // e^(y log|x|), evaluated one word wider since the error of log|x| grows
+    // with y log|x|, up to the ~2^10 where the result overflows
+    return details::cr_evaluate<format>(28, [&](auto size, auto polynomial) {
+        constexpr int words = decltype(size)::value + 1;
+        constexpr bool poly = decltype(polynomial)::value;
+        auto magnitude = details::cr_from<words>(x);
+        magnitude.sign = 0;
+
+        const auto t = details::cr_mul(details::cr_log<poly>(magnitude), details::cr_from<words>(y));
+        const double estimate = static_cast<double>(details::cr_to_float64(t)) * 1.4426950408889634;
+
+        details::cr_real<words> r;
+        if (estimate > limits::overflow) {
+            r = details::cr_scale(details::cr_from_int<words>(1), limits::emax + 1);
+        }
+        else if (estimate < limits::underflow) {
+            r = details::cr_scale(details::cr_from_int<words>(1), static_cast<int32_t>(limits::underflow) - 1);
+        }
+        else {
+            r = details::cr_exp<poly>(t);
+        }
+        r.sign = odd_sign;
+        return r;
+    });
+}
+
+//
+// trigonometric functions
+//
+
+template<fp_format format>
+floatbase_t<format> sin(floatbase_t<format> x)
+{
+    return details::cr_trig<details::trig_op::sin>(x);
+}
+
+template<fp_format format>
+floatbase_t<format> cos(floatbase_t<format> x)
+{
+    return details::cr_trig<details::trig_op::cos>(x);
+}
+
+template<fp_format format>
+floatbase_t<format> tan(floatbase_t<format> x)
+{
+    return details::cr_trig<details::trig_op::tan>(x);
+}
+
+//
+// batch variants: out[i] = f(a[i])
+//
+
+namespace details
+{
+    // elements per task, each is a few microseconds of work
+    constexpr size_t cr_grain = 64;
+}
+
+namespace batch
+{
+#define MAKE_BATCH_MATH(name)                                                                                       \
+    template<fp_format format>                                                                                      \
+    void name(const floatbase_t<format> *a, floatbase_t<format> *out, size_t count, thread_pool &pool = default_thread_pool()) { \
+        pool.parallel_for(0, count, details::cr_grain, [=](size_t begin, size_t end, unsigned) {                    \
+            for (size_t i = begin; i < end; ++i) { out[i] = ::name(a[i]); }                                         \
+        });                                                                                                         \
+    }                                                                                                               \
+
+    MAKE_BATCH_MATH(exp)
+    MAKE_BATCH_MATH(exp2)
+    MAKE_BATCH_MATH(expm1)
+    MAKE_BATCH_MATH(log)
+    MAKE_BATCH_MATH(log2)
+    MAKE_BATCH_MATH(log1p)
+    MAKE_BATCH_MATH(sin)
+    MAKE_BATCH_MATH(cos)
+    MAKE_BATCH_MATH(tan)
+
+#undef MAKE_BATCH_MATH
+
+    // out[i] = a[i]^b[i]
+    template<fp_format format>
+    void pow(const floatbase_t<format> *a, const floatbase_t<format> *b, floatbase_t<format> *out, size_t count,
+        thread_pool &pool = default_thread_pool())
+    {
+        pool.parallel_for(0, count, details::cr_grain, [=](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) { out[i] = ::pow(a[i], b[i]); }
+        });
+    }
+}
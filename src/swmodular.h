@@ -0,0 +1,262 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <array>
+
+#include "swint.h"
+#include "swexec.h"
+
+//
+// Montgomery modular arithmetic
+//
+// For an odd modulus m of an unsigned intbase_t with n 64-bit limbs and
+// R = 2^(64 n), the Montgomery form of x is x R mod m. Products of values in
+// Montgomery form are reduced with multiply-add carry chains instead of a
+// division:
+//
+//      mul(a R, b R) = a b R mod m
+//
+// montgomery_context precomputes R mod m, R^2 mod m and -m^-1 mod 2^64 once per
+// modulus:
+//
+//      montgomery_context<uint256sw_t> ctx(m);
+//      auto x = ctx.to_montgomery(a);      // a R mod m
+//      auto y = ctx.pow(x, e);             // a^e R mod m
+//      auto z = ctx.from_montgomery(y);    // a^e mod m
+//
+// or ctx.mod_pow(a, e) for plain values. Any value below R can be converted,
+// the results are always reduced below m. batch::mod_pow runs independent
+// modular exponentiations on the thread pool.
+//
+
+template<typename uint_t> class montgomery_context;
+
+template<size_t byte_size, typename layout>
+class montgomery_context<intbase_t<byte_size, false, layout>>
+{
+    static_assert(byte_size % sizeof(uint64_t) == 0, "expecting whole 64-bit limbs");
+
+public:
+
+    using uint_t = intbase_t<byte_size, false, layout>;
+
+    explicit montgomery_context(uint_t modulus) : m(to_limbs(modulus))
+    {
+        if ((m[0] & 1) == 0) {
+            throw std::exception("montgomery_context needs an odd modulus");
+        }
+
+        // m^-1 mod 2^64 by Newton's iteration, each step doubles the correct
+        // low bits and m * m = 1 mod 8 gives the first three
+        uint64_t inverse = m[0];
+        for (int i = 0; i < 5; ++i) {
+            inverse *= 2 - m[0] * inverse;
+        }
+        m_inverse = 0 - inverse;
+
+        // R mod m and R^2 mod m by doubling 1
+        limbs_t x = {};
+        x[0] = (modulus == uint_t(1)) ? 0 : 1;
+        for (int i = 0; i < limb_count * 64; ++i) {
+            x = double_mod(x);
+        }
+        r_mod_m = x;
+        for (int i = 0; i < limb_count * 64; ++i) {
+            x = double_mod(x);
+        }
+        r2_mod_m = x;
+    }
+
+    uint_t modulus() const { return from_limbs(m); }
+
+    // 1 in Montgomery form
+    uint_t one() const { return from_limbs(r_mod_m); }
+
+    uint_t to_montgomery(uint_t x) const
+    {
+        return from_limbs(multiply(to_limbs(x), r2_mod_m));
+    }
+
+    uint_t from_montgomery(uint_t x) const
+    {
+        limbs_t one = {};
+        one[0] = 1;
+        return from_limbs(multiply(to_limbs(x), one));
+    }
+
+    // a b R^-1 mod m, the Montgomery form of the product for operands in Montgomery form
+    uint_t mul(uint_t a, uint_t b) const
+    {
+        return from_limbs(multiply(to_limbs(a), to_limbs(b)));
+    }
+
+    uint_t sqr(uint_t a) const
+    {
+        return from_limbs(square(to_limbs(a)));
+    }
+
+    // base^exponent for base in Montgomery form, by sliding windows over the
+    // exponent: a window of up to w bits ending in a 1 costs one multiply by a
+    // precomputed odd power of the base
+    uint_t pow(uint_t base, uint_t exponent) const
+    {
+        const limbs_t e = to_limbs(exponent);
+        unsigned long top = 0;
+        if (!uint_t::reverse_bit_scan(&top, exponent)) {
+            return one();
+        }
+        const int bits = static_cast<int>(top) + 1;
+        const int window = bits <= 8 ? 1 : bits <= 24 ? 2 : bits <= 80 ? 3 : bits <= 240 ? 4 : bits <= 672 ? 5 : 6;
+        auto bit = [&](int i) { return static_cast<int>((e[i / 64] >> (i % 64)) & 1); };
+
+        // base^1, base^3, ..., base^(2^window - 1)
+        limbs_t odd_powers[1 << 5];
+        odd_powers[0] = to_limbs(base);
+        const limbs_t base2 = square(odd_powers[0]);
+        for (int i = 1; i < (1 << (window - 1)); ++i) {
+            odd_powers[i] = multiply(odd_powers[i - 1], base2);
+        }
+
+        limbs_t r = r_mod_m;
+        bool started = false;
+        for (int i = bits - 1; i >= 0; ) {
+            if (!bit(i)) {
+                r = square(r);
+                --i;
+                continue;
+            }
+
+            // the longest window from bit i down that ends in a 1
+            int low = i - window + 1 > 0 ? i - window + 1 : 0;
+            while (!bit(low)) {
+                ++low;
+            }
+            int value = 0;
+            for (int j = i; j >= low; --j) {
+                value = (value << 1) | bit(j);
+            }
+
+            if (started) {
+                for (int j = i; j >= low; --j) {
+                    r = square(r);
+                }
+                r = multiply(r, odd_powers[value >> 1]);
+            }
+            else {
+                r = odd_powers[value >> 1];
+                started = true;
+            }
+            i = low - 1;
+        }
+        return from_limbs(r);
+    }
+
+    // base^exponent mod m for plain values
+    uint_t mod_pow(uint_t base, uint_t exponent) const
+    {
+        return from_montgomery(pow(to_montgomery(base), exponent));
+    }
+
+private:
+
+    static constexpr int limb_count = static_cast<int>(byte_size / sizeof(uint64_t));
+    using limbs_t = std::array<uint64_t, limb_count>;
+
+    static limbs_t to_limbs(uint_t x) { return details::bit_cast<limbs_t>(x); }
+    static uint_t from_limbs(const limbs_t &x) { return details::bit_cast<uint_t>(x); }
+
+    // x - m when the value carry:x is at least m, for values below 2 m
+    limbs_t subtract_modulus(limbs_t x, uint64_t carry) const
+    {
+        limbs_t d = x;
+        const uint8_t borrow = details::sub_limbs(d.data(), limb_count, m.data(), limb_count);
+        return (carry || !borrow) ? d : x;
+    }
+
+    limbs_t double_mod(const limbs_t &x) const
+    {
+        limbs_t d;
+        for (int i = limb_count - 1; i > 0; --i) {
+            d[i] = (x[i] << 1) | (x[i - 1] >> 63);
+        }
+        d[0] = x[0] << 1;
+        return subtract_modulus(d, x[limb_count - 1] >> 63);
+    }
+
+    // t R^-1 mod m for the 2n-limb t < m R: each step adds the multiple of m
+    // that clears the lowest remaining limb
+    limbs_t reduce(uint64_t *t) const
+    {
+        uint64_t top = 0;
+        for (int i = 0; i < limb_count; ++i) {
+            const uint64_t q = t[i] * m_inverse;
+            uint64_t carry = 0;
+            for (int j = 0; j < limb_count; ++j) {
+                carry = details::multiply_add(q, m[j], carry, t[i + j]);
+            }
+            top += details::add_limbs(t + i + limb_count, limb_count - i, &carry, 1);
+        }
+
+        limbs_t r;
+        for (int i = 0; i < limb_count; ++i) {
+            r[i] = t[limb_count + i];
+        }
+        return subtract_modulus(r, top);
+    }
+
+    limbs_t multiply(const limbs_t &a, const limbs_t &b) const
+    {
+        uint64_t t[2 * limb_count];
+        details::multiply_limbs<limb_count>(a.data(), b.data(), t);
+        return reduce(t);
+    }
+
+    // the cross products a[i] a[j] are computed once and doubled
+    limbs_t square(const limbs_t &a) const
+    {
+        uint64_t t[2 * limb_count] = {};
+        for (int i = 0; i < limb_count; ++i) {
+            uint64_t carry = 0;
+            for (int j = i + 1; j < limb_count; ++j) {
+                carry = details::multiply_add(a[i], a[j], carry, t[i + j]);
+            }
+            t[i + limb_count] = carry;
+        }
+        // t[0] holds no cross product
+        for (int i = 2 * limb_count - 1; i > 1; --i) {
+            t[i] = (t[i] << 1) | (t[i - 1] >> 63);
+        }
+        t[1] <<= 1;
+
+        uint8_t carry = 0;
+        for (int i = 0; i < limb_count; ++i) {
+            uint64_t hi = 0;
+            const uint64_t lo = details::mul_extended(a[i], a[i], hi);
+            t[2 * i] = details::add_carry(t[2 * i], lo, carry);
+            t[2 * i + 1] = details::add_carry(t[2 * i + 1], hi, carry);
+        }
+        return reduce(t);
+    }
+
+    limbs_t m;
+    uint64_t m_inverse;     // -m^-1 mod 2^64
+    limbs_t r_mod_m;
+    limbs_t r2_mod_m;
+};
+
+namespace batch
+{
+    // out[i] = base[i]^exponent[i] mod m for plain values
+    template<typename uint_t>
+    void mod_pow(const montgomery_context<uint_t> &context, const uint_t *base, const uint_t *exponent, uint_t *out, size_t count,
+        thread_pool &pool = default_thread_pool())
+    {
+        pool.parallel_for(0, count, 16, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = context.mod_pow(base[i], exponent[i]);
+            }
+        });
+    }
+}
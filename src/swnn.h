@@ -0,0 +1,261 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+#include "swfp.h"
+#include "swunpacked.h"
+#include "swbatch.h"
+#include "swexec.h"
+
+//
+// Neural network primitives over 16-bit floating-point values
+//
+// softmax, layernorm, rmsnorm, gelu and silu read and write binary16 or
+// bfloat16 and compute in float32_t. All arithmetic is floatbase_t arithmetic
+// with a fixed evaluation order, so the results are the same bits on every
+// machine, compiler and thread count:
+//
+//  - reductions over a row are pairwise with sequential runs of 8 at the
+//    leaves, rows are never split between threads
+//  - exp is a fixed polynomial after a Cody-Waite reduction, sqrt is the
+//    correctly rounded one
+//  - gelu is the tanh approximation, evaluated as x * sigmoid(2u) with
+//    u = sqrt(2/pi) * (x + 0.044715 x^3), which is 0.5 x (1 + tanh(u))
+//    without the cancellation of 1 + tanh(u) for negative x
+//
+// Element-wise functions of a single 16-bit input are looked up in a table of
+// all 65536 results, built once per format on first use.
+//
+
+namespace details
+{
+    // e^x with an error of about an ulp
+    inline float32_t nn_exp(float32_t x)
+    {
+        const float32_t zero = float32_t::zero();
+        const float32_t half(0.5f), one(1.0f);
+        const float32_t log2e(1.44269504f);
+        const float32_t ln2_hi(0.693145752f);    // 15 bits, k * ln2_hi is exact
+        const float32_t ln2_lo(1.42860677e-06f);
+
+        if (is_nan(x)) {
+            return x;
+        }
+        if (x > float32_t(88.7228394f)) {
+            return float32_t::infinity();
+        }
+        if (x < float32_t(-103.972084f)) {
+            return zero;
+        }
+
+        // x = k ln2 + r with |r| <= ln2 / 2
+        const float32_t scaled = x * log2e;
+        const int k = static_cast<int>(scaled < zero ? scaled - half : scaled + half);
+        const float32_t kf(k);
+        const float32_t r = (x - kf * ln2_hi) - kf * ln2_lo;
+
+        // Taylor series to degree 7
+        float32_t p(1.0f / 5040.0f);
+        p = p * r + float32_t(1.0f / 720.0f);
+        p = p * r + float32_t(1.0f / 120.0f);
+        p = p * r + float32_t(1.0f / 24.0f);
+        p = p * r + float32_t(1.0f / 6.0f);
+        p = p * r + half;
+        p = p * r + one;
+        p = p * r + one;
+
+        // p * 2^k in two steps, the first is exact and the second rounds once
+        // when the result is subnormal
+        const int k1 = k / 2, k2 = k - k1;
+        auto power = [](int e) { return float32_t::from_bitstring(static_cast<uint32_t>(e + 127) << 23); };
+        return (p * power(k1)) * power(k2);
+    }
+
+    // x / (1 + e^-t), without overflowing e^-t for negative t
+    inline float32_t nn_sigmoid_scaled(float32_t x, float32_t t)
+    {
+        const float32_t one(1.0f);
+        if (t < float32_t::zero()) {
+            const float32_t e = nn_exp(t);
+            return x * e / (one + e);
+        }
+        return x / (one + nn_exp(-t));
+    }
+
+    inline float32_t nn_gelu(float32_t x)
+    {
+        const float32_t u = float32_t(0.797884561f) * (x + float32_t(0.044715f) * x * x * x);
+        return nn_sigmoid_scaled(x, u + u);
+    }
+
+    inline float32_t nn_silu(float32_t x)
+    {
+        return nn_sigmoid_scaled(x, x);
+    }
+
+    // pairwise sum, sequential at the leaves
+    inline float32_t nn_sum(const float32_t *x, size_t count)
+    {
+        if (count <= 8) {
+            float32_t sum = float32_t::zero();
+            for (size_t i = 0; i < count; ++i) {
+                sum = sum + x[i];
+            }
+            return sum;
+        }
+
+        const size_t half = count / 2;
+        return nn_sum(x, half) + nn_sum(x + half, count - half);
+    }
+
+    template<fp_format format>
+    constexpr void nn_check_format()
+    {
+        static_assert(format == fp_format::binary16 || format == fp_format::bfloat16, "the nn kernels take binary16 or bfloat16 values");
+    }
+
+    // results of fn for all 16-bit values
+    template<fp_format format, float32_t (*fn)(float32_t)>
+    const std::vector<floatbase_t<format>> &nn_table()
+    {
+        static const std::vector<floatbase_t<format>> table = [] {
+            std::vector<floatbase_t<format>> values(65536);
+            for (uint32_t i = 0; i < 65536; ++i) {
+                auto x = static_cast<float32_t>(floatbase_t<format>::from_bitstring(static_cast<uint16_t>(i)));
+                values[i] = static_cast<floatbase_t<format>>(fn(x));
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    template<fp_format format, float32_t (*fn)(float32_t)>
+    void nn_lookup(const floatbase_t<format> *x, floatbase_t<format> *out, size_t count, thread_pool &pool)
+    {
+        nn_check_format<format>();
+
+        const floatbase_t<format> *table = nn_table<format, fn>().data();
+        pool.parallel_for(0, count, batch_grain<format>(), [=](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = table[x[i].to_bitstring()];
+            }
+        });
+    }
+
+    // run fn(row, scratch) for each row with a float32_t row buffer per worker
+    template<fp_format format, typename fn_t>
+    void nn_rows(size_t rows, size_t columns, thread_pool &pool, fn_t fn)
+    {
+        nn_check_format<format>();
+
+        std::vector<std::vector<float32_t>> scratch(pool.size(), std::vector<float32_t>(columns));
+        const size_t grain = std::max<size_t>(1, batch_grain<format>() / std::max<size_t>(1, columns));
+        pool.parallel_for(0, rows, grain, [&](size_t begin, size_t end, unsigned worker) {
+            for (size_t row = begin; row < end; ++row) {
+                fn(row, scratch[worker].data());
+            }
+        });
+    }
+}
+
+namespace batch
+{
+    // out[i] = gelu(x[i]), tanh approximation
+    template<fp_format format>
+    void gelu(const floatbase_t<format> *x, floatbase_t<format> *out, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        details::nn_lookup<format, details::nn_gelu>(x, out, count, pool);
+    }
+
+    // out[i] = x[i] * sigmoid(x[i])
+    template<fp_format format>
+    void silu(const floatbase_t<format> *x, floatbase_t<format> *out, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        details::nn_lookup<format, details::nn_silu>(x, out, count, pool);
+    }
+
+    // softmax of each row of a row-major rows x columns matrix
+    template<fp_format format>
+    void softmax(const floatbase_t<format> *x, floatbase_t<format> *out, size_t rows, size_t columns, thread_pool &pool = default_thread_pool())
+    {
+        details::nn_rows<format>(rows, columns, pool, [=](size_t row, float32_t *e) {
+            const floatbase_t<format> *in = x + row * columns;
+
+            // the largest value, NaN if there is one
+            float32_t max = -float32_t::infinity();
+            for (size_t j = 0; j < columns; ++j) {
+                const auto v = static_cast<float32_t>(in[j]);
+                if (details::is_nan(v)) {
+                    max = v;
+                    break;
+                }
+                max = v > max ? v : max;
+            }
+
+            for (size_t j = 0; j < columns; ++j) {
+                e[j] = details::nn_exp(static_cast<float32_t>(in[j]) - max);
+            }
+            const float32_t sum = details::nn_sum(e, columns);
+            for (size_t j = 0; j < columns; ++j) {
+                out[row * columns + j] = static_cast<floatbase_t<format>>(e[j] / sum);
+            }
+        });
+    }
+
+    // (x - mean) / sqrt(variance + epsilon) * gamma + beta over each row, the
+    // variance is the mean of the squared differences
+    template<fp_format format>
+    void layernorm(const floatbase_t<format> *x, const floatbase_t<format> *gamma, const floatbase_t<format> *beta, floatbase_t<format> *out,
+        size_t rows, size_t columns, float32_t epsilon, thread_pool &pool = default_thread_pool())
+    {
+        const float32_t n(static_cast<uint64_t>(columns));
+        details::nn_rows<format>(rows, columns, pool, [=](size_t row, float32_t *d) {
+            const floatbase_t<format> *in = x + row * columns;
+
+            for (size_t j = 0; j < columns; ++j) {
+                d[j] = static_cast<float32_t>(in[j]);
+            }
+            const float32_t mean = details::nn_sum(d, columns) / n;
+
+            // squared differences, recomputed for the output
+            for (size_t j = 0; j < columns; ++j) {
+                const float32_t diff = static_cast<float32_t>(in[j]) - mean;
+                d[j] = diff * diff;
+            }
+            const float32_t variance = details::nn_sum(d, columns) / n;
+
+            const float32_t rstd = float32_t(1.0f) / sqrt(variance + epsilon);
+            for (size_t j = 0; j < columns; ++j) {
+                const float32_t diff = static_cast<float32_t>(in[j]) - mean;
+                const float32_t y = diff * rstd * static_cast<float32_t>(gamma[j]) + static_cast<float32_t>(beta[j]);
+                out[row * columns + j] = static_cast<floatbase_t<format>>(y);
+            }
+        });
+    }
+
+    // x / sqrt(mean(x^2) + epsilon) * gamma over each row
+    template<fp_format format>
+    void rmsnorm(const floatbase_t<format> *x, const floatbase_t<format> *gamma, floatbase_t<format> *out,
+        size_t rows, size_t columns, float32_t epsilon, thread_pool &pool = default_thread_pool())
+    {
+        const float32_t n(static_cast<uint64_t>(columns));
+        details::nn_rows<format>(rows, columns, pool, [=](size_t row, float32_t *squares) {
+            const floatbase_t<format> *in = x + row * columns;
+
+            for (size_t j = 0; j < columns; ++j) {
+                const auto v = static_cast<float32_t>(in[j]);
+                squares[j] = v * v;
+            }
+            const float32_t rstd = float32_t(1.0f) / sqrt(details::nn_sum(squares, columns) / n + epsilon);
+
+            for (size_t j = 0; j < columns; ++j) {
+                const float32_t y = static_cast<float32_t>(in[j]) * rstd * static_cast<float32_t>(gamma[j]);
+                out[row * columns + j] = static_cast<floatbase_t<format>>(y);
+            }
+        });
+    }
+}
@@ -0,0 +1,297 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <array>
+
+#include "swint.h"
+#include "swfp.h"
+#include "swexec.h"
+
+//
+// Counter-based random numbers
+//
+// philox4x32 is Philox4x32-10 (Salmon et al., "Parallel random numbers: as
+// easy as 1, 2, 3"): ten rounds of a keyed bijection over a 128-bit counter.
+// The output for a counter does not depend on any other output, so element i
+// of a computation can draw the block for counter i on whichever thread it runs
+// and a seed gives the same numbers for any chunking or thread count.
+//
+// The key is the 64-bit seed, the counter is a 64-bit block index followed by a
+// 64-bit stream number:
+//
+//      philox4x32 rng(seed);
+//      auto block = rng.block(i / 4, stream);      // 4 x 32 random bits
+//      uint32_t r = block[i % 4];
+//
+
+class philox4x32
+{
+public:
+
+    using block_t = std::array<uint32_t, 4>;
+
+    static constexpr int rounds = 10;
+
+    explicit constexpr philox4x32(uint64_t seed = 0)
+        : key{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) }
+    {
+    }
+
+    // the random block for a 128-bit counter, counter[0] is the lowest word
+    constexpr block_t operator()(block_t counter) const
+    {
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int i = 0; i < rounds; ++i) {
+            const uint64_t p0 = uint64_t(multiplier0) * counter[0];
+            const uint64_t p1 = uint64_t(multiplier1) * counter[2];
+            counter = {
+                static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ k0,
+                static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ k1,
+                static_cast<uint32_t>(p0)
+            };
+            k0 += weyl0;
+            k1 += weyl1;
+        }
+        return counter;
+    }
+
+    constexpr block_t block(uint64_t index, uint64_t stream = 0) const
+    {
+        return (*this)({ static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+            static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32) });
+    }
+
+private:
+
+    static constexpr uint32_t multiplier0 = 0xd2511f53;
+    static constexpr uint32_t multiplier1 = 0xcd9e8d57;
+    static constexpr uint32_t weyl0 = 0x9e3779b9;
+    static constexpr uint32_t weyl1 = 0xbb67ae85;
+
+    uint32_t key[2];
+};
+
+//
+// Sequential 64-bit outputs of a Philox stream
+//
+// Output n of philox_engine(seed, stream) is half n % 2 of block n / 2, low
+// word first, so advance and discard only move the position.
+//
+
+class philox_engine
+{
+public:
+
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    explicit constexpr philox_engine(uint64_t seed = 0, uint64_t stream = 0)
+        : seed(seed), generator(seed), stream(stream)
+    {
+    }
+
+    uint64_t operator()()
+    {
+        if (position % 2 == 0 || !cached) {
+            block = generator.block(position / 2, stream);
+            cached = true;
+        }
+        const int half = static_cast<int>(position++ % 2) * 2;
+        return uint64_t(block[half]) | (uint64_t(block[half + 1]) << 32);
+    }
+
+    // skip the next delta outputs
+    void advance(uint64_t delta)
+    {
+        position += delta;
+        cached = false;
+    }
+
+    void discard(unsigned long long z) { advance(z); }
+
+    friend bool operator==(const philox_engine &a, const philox_engine &b)
+    {
+        return a.seed == b.seed && a.stream == b.stream && a.position == b.position;
+    }
+
+    friend bool operator!=(const philox_engine &a, const philox_engine &b) { return !(a == b); }
+
+private:
+
+    uint64_t seed;
+    philox4x32 generator;
+    uint64_t stream;
+    uint64_t position = 0;
+    philox4x32::block_t block = {};
+    bool cached = false;
+};
+
+//
+// PCG64
+//
+// pcg64 is PCG-XSL-RR 128/64 (O'Neill, "PCG: A family of simple fast
+// space-efficient statistically good algorithms for random number generation"),
+// the pcg64 of the reference implementation and numpy. The state is a 128-bit
+// LCG stepped with one uint128sw_t multiply and add:
+//
+//      state = state * multiplier + increment      (mod 2^128)
+//
+// and an output is the xor of the two halves of the state rotated right by its
+// top 6 bits. The odd increment selects one of 2^127 streams, seeding follows
+// pcg64_srandom_r so pcg64(42, 54) gives the reference sequence.
+//
+// advance(delta) jumps delta outputs in O(log delta) steps by composing the LCG
+// with itself (Brown, "Random number generation with arbitrary strides"). To
+// split one stream between workers, copy the generator and advance each copy
+// to the start of its slice.
+//
+
+class pcg64
+{
+public:
+
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    explicit constexpr pcg64(uint128sw_t seed = uint128sw_t(0), uint128sw_t stream = uint128sw_t(0))
+        : state(0), increment((stream << 1) | uint128sw_t(1))
+    {
+        step();
+        state += seed;
+        step();
+    }
+
+    constexpr uint64_t operator()()
+    {
+        step();
+        const uint64_t x = static_cast<uint64_t>(state >> 64) ^ static_cast<uint64_t>(state);
+        const int r = static_cast<int>(state >> 122);
+        return (x >> r) | (x << ((64 - r) & 63));
+    }
+
+    // skip the next delta outputs, 2^128 - n goes back n outputs
+    constexpr void advance(uint128sw_t delta)
+    {
+        uint128sw_t acc_mult(1), acc_plus(0);
+        uint128sw_t cur_mult = multiplier, cur_plus = increment;
+        while (delta != uint128sw_t(0)) {
+            if (static_cast<bool>(delta & uint128sw_t(1))) {
+                acc_mult *= cur_mult;
+                acc_plus = acc_plus * cur_mult + cur_plus;
+            }
+            cur_plus = (cur_mult + uint128sw_t(1)) * cur_plus;
+            cur_mult *= cur_mult;
+            delta >>= 1;
+        }
+        state = acc_mult * state + acc_plus;
+    }
+
+    constexpr void discard(unsigned long long z) { advance(uint128sw_t(z)); }
+
+    friend constexpr bool operator==(const pcg64 &a, const pcg64 &b) { return a.state == b.state && a.increment == b.increment; }
+    friend constexpr bool operator!=(const pcg64 &a, const pcg64 &b) { return !(a == b); }
+
+private:
+
+    static constexpr uint128sw_t multiplier = (uint128sw_t(0x2360ed051fc65da4ull) << 64) | uint128sw_t(0x4385df649fccf645ull);
+
+    constexpr void step() { state = state * multiplier + increment; }
+
+    uint128sw_t state;
+    uint128sw_t increment;
+};
+
+//
+// Uniform floating-point values
+//
+// uniform<format>(rng) is k * 2^-p in [0, 1) for the precision p of the format
+// (3, 8, 11, 24, 53 or 113) and k uniform in [0, 2^p), each value exact and
+// equally likely. k is the top p bits of one 64-bit output, of two for
+// binary128, and the bit pattern of k * 2^-p is written directly: the highest
+// set bit of k gives the exponent and the bits below it the significand. There
+// is no integer to floating-point conversion, rounding or floating-point
+// arithmetic, and every non-zero result is normal.
+//
+//      pcg64 rng(seed, stream);
+//      float32_t u = uniform<fp_format::binary32>(rng);
+//
+
+namespace details
+{
+    template<fp_format format>
+    struct uniform_traits
+    {
+        using uint_t = typename fp_traits<format>::uint_t;
+
+        static constexpr int precision = static_cast<int>(sizeof(uint_t) * 8) - fp_traits<format>::exponent_bitsize;
+        static constexpr int words = precision > 64 ? 2 : 1;
+    };
+}
+
+// k * 2^-p from the top p bits of high:low, low is only read for binary128
+template<fp_format format>
+constexpr floatbase_t<format> uniform_from_bits(uint64_t high, uint64_t low = 0)
+{
+    using uint_t = typename details::uniform_traits<format>::uint_t;
+    constexpr int precision = details::uniform_traits<format>::precision;
+
+    uint_t k;
+    if constexpr (precision <= 64) {
+        k = static_cast<uint_t>(high >> (64 - precision));
+    }
+    else {
+        k = (uint_t(high) << (precision - 64)) | uint_t(low >> (128 - precision));
+    }
+
+    unsigned long lead = 0;
+    if (!details::reverse_bit_scan(&lead, k)) {
+        return floatbase_t<format>::from_bitstring(uint_t(0));
+    }
+
+    // the leading bit of k moves to the implicit bit, 2^lead * 2^-p sets the exponent
+    const uint_t significand_mask = static_cast<uint_t>((uint_t(1) << (precision - 1)) - uint_t(1));
+    const uint_t significand = static_cast<uint_t>(static_cast<uint_t>(k << (precision - 1 - static_cast<int>(lead))) & significand_mask);
+    const uint_t exponent = static_cast<uint_t>(fp_traits<format>::bias + static_cast<int>(lead) - precision);
+    return floatbase_t<format>::from_bitstring(static_cast<uint_t>(static_cast<uint_t>(exponent << (precision - 1)) | significand));
+}
+
+template<fp_format format, typename engine_t>
+floatbase_t<format> uniform(engine_t &rng)
+{
+    if constexpr (details::uniform_traits<format>::words == 1) {
+        return uniform_from_bits<format>(rng());
+    }
+    else {
+        const uint64_t high = rng();
+        return uniform_from_bits<format>(high, rng());
+    }
+}
+
+namespace batch
+{
+    // dst[i] = uniform<format>(rng) for i in [0, count) in the order of
+    // sequential calls, and rng is left after the last output used. Each chunk
+    // advances a copy of rng to its first output, so the values do not depend
+    // on the thread count
+    template<fp_format format, typename engine_t>
+    void uniform(engine_t &rng, floatbase_t<format> *dst, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        constexpr int words = details::uniform_traits<format>::words;
+        const engine_t start = rng;
+        pool.parallel_for(0, count, 8192, [=, &start](size_t begin, size_t end, unsigned) {
+            engine_t chunk = start;
+            chunk.discard(static_cast<unsigned long long>(begin) * words);
+            for (size_t i = begin; i < end; ++i) {
+                dst[i] = ::uniform<format>(chunk);
+            }
+        });
+        rng.discard(static_cast<unsigned long long>(count) * words);
+    }
+}
@@ -0,0 +1,392 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+#include "swfp.h"
+#include "swint.h"
+#include "swunpacked.h"
+#include "swaccum.h"
+#include "swbatch.h"
+#include "swexec.h"
+
+//
+// Reproducible binned summation
+//
+// binned_accumulator<format, fold> keeps a sum as `fold` 32-bit bins of a
+// fixed-point number whose bit 0 is worth the smallest product of two
+// subnormals, like long_accumulator. Bin b holds bits [32b, 32b + 32). Only the
+// `fold` bins below the leading bin of the largest term seen are kept: the
+// window moves up when a larger term arrives, and the bits of every term that
+// fall below the window are dropped.
+//
+// Bin boundaries do not depend on the data, so the bits a term contributes are
+// the same whichever order it arrives in and whatever else has been added, and
+// the bins add exactly. The result is the exact sum of the kept bits rounded
+// once: identical for any order, chunking and thread count. With the default
+// fold of 3 at least 64 bits below the leading bit of the largest term are
+// kept, so the error is below count * 2^-64 * max|x[i]| before the final
+// rounding.
+//
+// Each term costs `fold` shifts, masks and 64-bit adds with no carries between
+// bins, against a carry chain through the full-width long accumulator. Every
+// bin also carries the overflow of its 32 bits in its own 64-bit counter, so
+// 2^30 terms go in between two renormalizations.
+//
+// repro::reduce, repro::dot, repro::asum and repro::nrm2 run over a thread_pool
+// with a binned accumulator per worker.
+//
+
+template<fp_format format, int fold = 3>
+class binned_accumulator
+{
+public:
+
+    using packed_t = floatbase_t<format>;
+    using uint_t = typename fp_traits<format>::uint_t;
+
+    static_assert(sizeof(uint_t) <= sizeof(uint64_t), "binned_accumulator supports formats up to binary64");
+    static_assert(fold >= 2, "binned_accumulator needs at least 2 bins");
+
+    static constexpr int significand_bitsize = unpacked_t<format>::precision - 1;
+    static constexpr int32_t emin = 1 - fp_traits<format>::bias;
+    static constexpr int bin_bits = 32;
+
+    // weight of bit 0 of bin 0
+    static constexpr int32_t lsb_exponent = 2 * (emin - significand_bitsize);
+
+    constexpr binned_accumulator() = default;
+
+    constexpr void clear() { *this = binned_accumulator(); }
+
+    // acc += x
+    constexpr void add(packed_t x)
+    {
+        unpacked_t<format> u(x);
+        if (!terms.track(u, x)) {
+            return;
+        }
+
+        int32_t exponent = 0;
+        uint64_t significand = details::integer_significand(u, exponent);
+        add_term(exponent - significand_bitsize - lsb_exponent, 0, significand, u.sign != 0);
+    }
+
+    // acc += |x|
+    constexpr void add_abs(packed_t x)
+    {
+        unpacked_t<format> u(x);
+        if (u.class_ != unpacked_class::nan) {
+            u.sign = 0;
+        }
+        if (!terms.track(u, x)) {
+            return;
+        }
+
+        int32_t exponent = 0;
+        uint64_t significand = details::integer_significand(u, exponent);
+        add_term(exponent - significand_bitsize - lsb_exponent, 0, significand, false);
+    }
+
+    // acc += a * b, the product is not rounded
+    constexpr void add_product(packed_t a, packed_t b)
+    {
+        unpacked_t<format> ua(a), ub(b);
+        if (!terms.track_product(ua, ub, a, b)) {
+            return;
+        }
+
+        uint64_t hi = 0, lo = 0;
+        int32_t exponent = 0;
+        details::integer_product(ua, ub, hi, lo, exponent);
+        add_term(exponent - lsb_exponent, hi, lo, (ua.sign ^ ub.sign) != 0);
+    }
+
+    // acc += other
+    constexpr void merge(const binned_accumulator &other)
+    {
+        terms.merge(other.terms);
+        if (other.top == empty) {
+            return;
+        }
+
+        binned_accumulator addend = other;
+        addend.renormalize();
+        raise(addend.top);
+        addend.raise(top);
+        renormalize();
+
+        for (int k = 0; k < fold; ++k) {
+            bins[k].sum += addend.bins[k].sum;
+            bins[k].carry += addend.bins[k].carry;
+        }
+    }
+
+    // the accumulated value rounded to nearest-even
+    template<fp_format out = format>
+    constexpr floatbase_t<out> round() const
+    {
+        floatbase_t<out> special;
+        if (terms.special_result(special)) {
+            return special;
+        }
+        if (top == empty) {
+            return floatbase_t<out>::zero(terms.zero_sign());
+        }
+
+        uint64_t limbs[limb_count] = {};
+        to_limbs(limbs);
+        return details::round_limbs<out>(limbs, window_lsb_exponent(), terms.zero_sign());
+    }
+
+    // square root of the accumulated value rounded to nearest-even, for sums
+    // of squares
+    template<fp_format out = format>
+    constexpr floatbase_t<out> sqrt() const
+    {
+        floatbase_t<out> special;
+        if (terms.special_result(special)) {
+            return special;
+        }
+        if (top == empty) {
+            return floatbase_t<out>::zero(terms.zero_sign());
+        }
+
+        uint64_t limbs[limb_count] = {};
+        to_limbs(limbs);
+
+        uint64_t magnitude[limb_count] = {};
+        if (details::limbs_magnitude(limbs, magnitude)) {
+            return floatbase_t<out>::indeterminate_nan();
+        }
+        if (details::limbs_zero(magnitude)) {
+            return floatbase_t<out>::zero(terms.zero_sign());
+        }
+
+        // take 127 or 128 bits from the leading bit so that the exponent of
+        // the last one is even, the root of that has 64 bits
+        uint64_t window = 0;
+        const int lead = details::limbs_window(magnitude, window);
+        int32_t exponent = lead + window_lsb_exponent() - 127;
+        int from = lead - 127;
+        if (exponent % 2 != 0) {
+            ++exponent;
+            ++from;
+        }
+
+        uint64_t hi = bits_from(magnitude, from + 64, 64);
+        uint64_t lo = bits_from(magnitude, from, 64);
+        bool sticky = from > 0 && bits_below(magnitude, from);
+
+        bool exact = false;
+        const uint64_t root = details::isqrt128(hi, lo, exact);
+        sticky |= !exact;
+
+        return details::round_window<out>(0, exponent / 2 + 63, root | (sticky ? 1 : 0));
+    }
+
+private:
+
+    static constexpr int32_t empty = INT32_MIN;
+
+    // sum + carry * 2^32 per bin, 64 bits of headroom above the top bin and a sign bit
+    static constexpr int limb_count = (fold * bin_bits + 64 + 64 + 1 + 63) / 64;
+
+    struct bin_t
+    {
+        int64_t sum = 0;
+        int64_t carry = 0;
+    };
+
+    // add or subtract the value hi:lo shifted left by `offset` bits
+    constexpr void add_term(int32_t offset, uint64_t hi, uint64_t lo, bool negative)
+    {
+        unsigned long index = 0;
+        int32_t lead = offset;
+        if (hi) {
+            details::reverse_bit_scan(&index, hi);
+            lead += 64 + static_cast<int32_t>(index);
+        }
+        else {
+            details::reverse_bit_scan(&index, lo);
+            lead += static_cast<int32_t>(index);
+        }
+        raise(lead / bin_bits);
+
+        for (int k = 0; k < fold; ++k) {
+            const int64_t piece = static_cast<int64_t>(term_bits(hi, lo, (top - k) * bin_bits - offset));
+            bins[k].sum += negative ? -piece : piece;
+        }
+
+        if (++pending == max_pending) {
+            renormalize();
+        }
+    }
+
+    // move the window up so that `bin` is the top bin, dropping the bins
+    // that fall below it
+    constexpr void raise(int32_t bin)
+    {
+        if (top != empty && bin <= top) {
+            return;
+        }
+
+        const int32_t shift = top == empty ? fold : bin - top;
+        for (int k = fold - 1; k >= 0; --k) {
+            bins[k] = k >= shift ? bins[k - shift] : bin_t();
+        }
+        top = bin;
+    }
+
+    // move the bits above the low 32 of each sum into its carry, the value of
+    // every bin is unchanged
+    constexpr void renormalize()
+    {
+        for (int k = 0; k < fold; ++k) {
+            bins[k].carry += bins[k].sum >> bin_bits;
+            bins[k].sum &= (int64_t(1) << bin_bits) - 1;
+        }
+        pending = 0;
+    }
+
+    // 32 bits of hi:lo starting at bit `from`, which may be negative
+    static constexpr uint64_t term_bits(uint64_t hi, uint64_t lo, int32_t from)
+    {
+        constexpr uint64_t mask = (uint64_t(1) << bin_bits) - 1;
+
+        if (from <= -bin_bits || from >= 128) {
+            return 0;
+        }
+        if (from < 0) {
+            return (lo << -from) & mask;
+        }
+        if (from < 64) {
+            return ((lo >> from) | (from > 64 - bin_bits ? hi << (64 - from) : 0)) & mask;
+        }
+        return (hi >> (from - 64)) & mask;
+    }
+
+    // `count` bits of a magnitude starting at bit `from`, which may be negative
+    static constexpr uint64_t bits_from(const uint64_t (&magnitude)[limb_count], int from, int count)
+    {
+        uint64_t bits = 0;
+        for (int i = 0; i < count; ++i) {
+            const int bit = from + i;
+            if (bit >= 0 && bit < limb_count * 64) {
+                bits |= ((magnitude[bit / 64] >> (bit % 64)) & 1) << i;
+            }
+        }
+        return bits;
+    }
+
+    // any bit below bit `from` set
+    static constexpr bool bits_below(const uint64_t (&magnitude)[limb_count], int from)
+    {
+        for (int bit = 0; bit < from && bit < limb_count * 64; ++bit) {
+            if ((magnitude[bit / 64] >> (bit % 64)) & 1) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // weight of bit 0 of the lowest bin in the window
+    constexpr int32_t window_lsb_exponent() const { return lsb_exponent + (top - fold + 1) * bin_bits; }
+
+    // the window as a two's-complement integer in units of its lowest bit
+    constexpr void to_limbs(uint64_t (&limbs)[limb_count]) const
+    {
+        for (int k = 0; k < fold; ++k) {
+            const int32_t offset = (fold - 1 - k) * bin_bits;
+            add_signed(limbs, offset, bins[k].sum);
+            add_signed(limbs, offset + bin_bits, bins[k].carry);
+        }
+    }
+
+    static constexpr void add_signed(uint64_t (&limbs)[limb_count], int32_t offset, int64_t value)
+    {
+        const uint64_t magnitude = value < 0 ? uint64_t(0) - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        details::add_limbs_at(limbs, offset, 0, magnitude, value < 0);
+    }
+
+    static constexpr int max_pending = 1 << 30;
+
+    bin_t bins[fold] = {};                  // bins[0] is the top bin
+    int32_t top = empty;
+    int pending = 0;
+    details::accumulator_terms<format> terms;
+};
+
+namespace details
+{
+    // run fn(acc, begin, end) over grain-sized chunks with a binned accumulator
+    // per worker and merge them in worker order
+    template<fp_format format, typename fn_t>
+    binned_accumulator<format> binned_accumulate(size_t count, thread_pool &pool, fn_t fn)
+    {
+        std::vector<binned_accumulator<format>> partial(pool.size());
+        pool.parallel_for(0, count, batch_grain<format>(), [&](size_t begin, size_t end, unsigned worker) {
+            fn(partial[worker], begin, end);
+        });
+
+        binned_accumulator<format> acc;
+        for (auto &p : partial) {
+            acc.merge(p);
+        }
+        return acc;
+    }
+}
+
+namespace repro
+{
+    // sum of x[i]
+    template<fp_format format, fp_format out = format>
+    floatbase_t<out> reduce(const floatbase_t<format> *x, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        auto acc = details::binned_accumulate<format>(count, pool, [&](binned_accumulator<format> &a, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                a.add(x[i]);
+            }
+        });
+        return acc.template round<out>();
+    }
+
+    // sum of x[i] * y[i]
+    template<fp_format format, fp_format out = format>
+    floatbase_t<out> dot(const floatbase_t<format> *x, const floatbase_t<format> *y, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        auto acc = details::binned_accumulate<format>(count, pool, [&](binned_accumulator<format> &a, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                a.add_product(x[i], y[i]);
+            }
+        });
+        return acc.template round<out>();
+    }
+
+    // sum of |x[i]|
+    template<fp_format format, fp_format out = format>
+    floatbase_t<out> asum(const floatbase_t<format> *x, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        auto acc = details::binned_accumulate<format>(count, pool, [&](binned_accumulator<format> &a, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                a.add_abs(x[i]);
+            }
+        });
+        return acc.template round<out>();
+    }
+
+    // square root of the sum of x[i]^2; the squares are exact, so there is no
+    // intermediate overflow or underflow to scale around
+    template<fp_format format, fp_format out = format>
+    floatbase_t<out> nrm2(const floatbase_t<format> *x, size_t count, thread_pool &pool = default_thread_pool())
+    {
+        auto acc = details::binned_accumulate<format>(count, pool, [&](binned_accumulator<format> &a, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                a.add_product(x[i], x[i]);
+            }
+        });
+        return acc.template sqrt<out>();
+    }
+}
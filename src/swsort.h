@@ -0,0 +1,266 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "swfp.h"
+#include "swbatch.h"
+#include "swexec.h"
+
+//
+// IEEE754 totalOrder and radix sorting of floatbase_t arrays
+//
+// Sorting works on the unsigned totalOrder key of the bit pattern rather than
+// on decomposed values, so it is a strict weak order even with NaNs present.
+// All sorts are stable.
+//
+
+// where NaNs end up after sorting
+enum class nan_placement
+{
+    total_order,    // -NaN first, +NaN last (IEEE754 totalOrder)
+    first,          // all NaNs first
+    last            // all NaNs last
+};
+
+// IEEE754 totalOrder(a, b): true if a orders at or before b
+template<fp_format format>
+constexpr bool total_order(floatbase_t<format> a, floatbase_t<format> b)
+{
+    using key_traits = details::fp_key_traits<format>;
+    return key_traits::ordered_key(a.to_bitstring()) <= key_traits::ordered_key(b.to_bitstring());
+}
+
+namespace details
+{
+    // run fn(t) for t in [0, threads) as separate chunks on the default pool
+    template<typename fn_t>
+    void parallel_invoke(unsigned threads, fn_t fn)
+    {
+        default_thread_pool().parallel_for(0, threads, 1, [&fn](size_t begin, size_t end, unsigned) {
+            for (size_t t = begin; t < end; ++t) {
+                fn(static_cast<unsigned>(t));
+            }
+        });
+    }
+
+    inline unsigned sort_thread_count(size_t count)
+    {
+        // below this many elements per partition the histogram merge dominates
+        constexpr size_t min_per_thread = size_t(1) << 16;
+        size_t workers = default_thread_pool().size();
+        return static_cast<unsigned>(std::min(workers, std::max<size_t>(1, count / min_per_thread)));
+    }
+
+    // one stable counting-sort scatter per digit, least significant digit first.
+    // `keys`/`values` point at the sorted data on return (which may be the tmp buffers)
+    template<int digit_bits, bool with_values, typename uint_t, typename value_t>
+    void radix_sort(uint_t *&keys, uint_t *&keys_tmp, value_t *&values, value_t *&values_tmp, size_t count)
+    {
+        constexpr size_t buckets = size_t(1) << digit_bits;
+        constexpr size_t digit_mask = buckets - 1;
+        constexpr int passes = (sizeof(uint_t) * 8) / digit_bits;
+
+        const unsigned threads = sort_thread_count(count);
+        std::vector<size_t> histograms(threads * buckets);
+
+        auto chunk_begin = [count, threads](unsigned t) { return count * t / threads; };
+
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            const int shift = pass * digit_bits;
+            auto digit = [shift](uint_t key) { return static_cast<size_t>(key >> shift) & digit_mask; };
+
+            parallel_invoke(threads, [&](unsigned t) {
+                size_t *histogram = &histograms[t * buckets];
+                std::fill(histogram, histogram + buckets, size_t(0));
+                for (size_t i = chunk_begin(t), end = chunk_begin(t + 1); i < end; ++i) {
+                    ++histogram[digit(keys[i])];
+                }
+            });
+
+            // skip the pass if every key has the same digit
+            size_t first_total = 0;
+            for (unsigned t = 0; t < threads; ++t) {
+                first_total += histograms[t * buckets + digit(keys[0])];
+            }
+            if (first_total == count) {
+                continue;
+            }
+
+            // exclusive prefix sum ordered by (digit, thread) keeps the scatter stable
+            size_t sum = 0;
+            for (size_t d = 0; d < buckets; ++d) {
+                for (unsigned t = 0; t < threads; ++t) {
+                    size_t c = histograms[t * buckets + d];
+                    histograms[t * buckets + d] = sum;
+                    sum += c;
+                }
+            }
+
+            parallel_invoke(threads, [&](unsigned t) {
+                size_t *offsets = &histograms[t * buckets];
+                for (size_t i = chunk_begin(t), end = chunk_begin(t + 1); i < end; ++i) {
+                    size_t dst = offsets[digit(keys[i])]++;
+                    keys_tmp[dst] = keys[i];
+                    if constexpr (with_values) {
+                        values_tmp[dst] = values[i];
+                    }
+                }
+            });
+
+            std::swap(keys, keys_tmp);
+            std::swap(values, values_tmp);
+        }
+    }
+
+    // keys-only sort of 16-bit keys: histogram every bit pattern once and
+    // rewrite the array from the counts, no scatter required
+    template<typename uint_t>
+    void counting_sort16(uint_t *keys, size_t count)
+    {
+        static_assert(sizeof(uint_t) == 2, "counting sort expects 16-bit keys");
+        constexpr size_t buckets = size_t(1) << 16;
+
+        const unsigned threads = sort_thread_count(count);
+        std::vector<size_t> histograms(threads * buckets);
+
+        parallel_invoke(threads, [&](unsigned t) {
+            size_t *histogram = &histograms[t * buckets];
+            for (size_t i = count * t / threads, end = count * (t + 1) / threads; i < end; ++i) {
+                ++histogram[keys[i]];
+            }
+        });
+
+        size_t pos = 0;
+        for (size_t d = 0; d < buckets; ++d) {
+            size_t total = 0;
+            for (unsigned t = 0; t < threads; ++t) {
+                total += histograms[t * buckets + d];
+            }
+            std::fill(keys + pos, keys + pos + total, static_cast<uint_t>(d));
+            pos += total;
+        }
+    }
+
+    // move NaNs away from their totalOrder position
+    template<fp_format format, bool with_values, typename value_t>
+    void place_nans(typename fp_key_traits<format>::uint_t *keys, value_t *values, size_t count, nan_placement nans)
+    {
+        using key_traits = fp_key_traits<format>;
+        using uint_t = typename key_traits::uint_t;
+
+        if (nans == nan_placement::total_order) {
+            return;
+        }
+
+        // keys are sorted: negative NaNs form a prefix, positive NaNs a suffix
+        auto is_negative_nan = [](uint_t k) { uint_t x = key_traits::from_ordered_key(k); return key_traits::is_nan(x) && (x & key_traits::sign_mask); };
+        auto is_positive_nan = [](uint_t k) { uint_t x = key_traits::from_ordered_key(k); return key_traits::is_nan(x) && !(x & key_traits::sign_mask); };
+
+        size_t middle = 0;
+        if (nans == nan_placement::last) {
+            middle = static_cast<size_t>(std::partition_point(keys, keys + count, is_negative_nan) - keys);
+        }
+        else {
+            middle = static_cast<size_t>(std::partition_point(keys, keys + count, [&](uint_t k) { return !is_positive_nan(k); }) - keys);
+        }
+
+        std::rotate(keys, keys + middle, keys + count);
+        if constexpr (with_values) {
+            std::rotate(values, values + middle, values + count);
+        }
+    }
+
+    template<fp_format format, bool with_values, typename value_t>
+    void sort_keys(typename fp_key_traits<format>::uint_t *keys, value_t *values, size_t count, nan_placement nans)
+    {
+        using uint_t = typename fp_key_traits<format>::uint_t;
+        static_assert(std::is_integral_v<uint_t>, "sorting expects a native integer encoding");
+
+        if (count < 2) {
+            return;
+        }
+
+        if constexpr (!with_values && sizeof(uint_t) == 2)
+        {
+            counting_sort16(keys, count);
+        }
+        else
+        {
+            std::vector<uint_t> keys_tmp(count);
+            std::vector<value_t> values_tmp(with_values ? count : 0);
+
+            uint_t *k = keys, *kt = keys_tmp.data();
+            value_t *v = values, *vt = values_tmp.data();
+
+            // 16-bit keys take a single 16-bit digit pass, wider keys use 8-bit digits
+            radix_sort<(sizeof(uint_t) == 2) ? 16 : 8, with_values>(k, kt, v, vt, count);
+
+            if (k != keys) {
+                std::copy(k, k + count, keys);
+                if constexpr (with_values) {
+                    std::copy(v, v + count, values);
+                }
+            }
+        }
+
+        place_nans<format, with_values>(keys, values, count, nans);
+    }
+
+    template<fp_format format>
+    std::vector<typename fp_key_traits<format>::uint_t> make_ordered_keys(const floatbase_t<format> *data, size_t count)
+    {
+        using key_traits = fp_key_traits<format>;
+        std::vector<typename key_traits::uint_t> keys(count);
+        for (size_t i = 0; i < count; ++i) {
+            keys[i] = key_traits::ordered_key(data[i].to_bitstring());
+        }
+        return keys;
+    }
+
+    template<fp_format format>
+    void store_ordered_keys(const typename fp_key_traits<format>::uint_t *keys, floatbase_t<format> *data, size_t count)
+    {
+        using key_traits = fp_key_traits<format>;
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = floatbase_t<format>::from_bitstring(key_traits::from_ordered_key(keys[i]));
+        }
+    }
+}
+
+namespace batch
+{
+    // sort values in place
+    template<fp_format format>
+    void sort(floatbase_t<format> *data, size_t count, nan_placement nans = nan_placement::total_order)
+    {
+        auto keys = details::make_ordered_keys(data, count);
+        details::sort_keys<format, false, int>(keys.data(), nullptr, count, nans);
+        details::store_ordered_keys(keys.data(), data, count);
+    }
+
+    // sort values in place, applying the same permutation to `values`
+    template<fp_format format, typename value_t>
+    void sort(floatbase_t<format> *data, value_t *values, size_t count, nan_placement nans = nan_placement::total_order)
+    {
+        auto keys = details::make_ordered_keys(data, count);
+        details::sort_keys<format, true>(keys.data(), values, count, nans);
+        details::store_ordered_keys(keys.data(), data, count);
+    }
+
+    // write the permutation that sorts `data` into `indices`
+    template<fp_format format, typename index_t>
+    void argsort(const floatbase_t<format> *data, size_t count, index_t *indices, nan_placement nans = nan_placement::total_order)
+    {
+        static_assert(std::is_integral_v<index_t>, "expecting integral index type");
+
+        auto keys = details::make_ordered_keys(data, count);
+        std::iota(indices, indices + count, index_t(0));
+        details::sort_keys<format, true>(keys.data(), indices, count, nans);
+    }
+}
@@ -0,0 +1,347 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "swfp.h"
+#include "swunpacked.h"
+#include "swbatch.h"
+#include "swexec.h"
+#include "swrandom.h"
+
+//
+// Stochastic rounding
+//
+// Round-to-nearest loses every update smaller than half an ulp of the
+// accumulator, which stalls low-precision training. Stochastic rounding
+// rounds up with probability equal to the discarded fraction instead, so the
+// expected value of the rounded result is the exact result:
+//
+//      P(round up) = (x - truncate(x)) / ulp
+//
+// The discarded fraction is compared with 32 random bits: the probability is
+// exact for fractions of up to 32 bits and truncated to 32 bits below that.
+// Values below the smallest subnormal round to it or to zero, values above the
+// largest finite round to it or to infinity.
+//
+// The scalar functions take the random bits as an argument, stochastic_rounding
+// draws them from a Philox stream:
+//
+//      stochastic_rounding sr(seed, thread_index);
+//      acc = sr.add<fp_format::bfloat16>(float32_t(acc), update);
+//
+// The batch kernels draw the bits of element i from Philox block i / 4 of the
+// stream, so the results are the same for any thread count.
+//
+
+namespace details
+{
+    // stochastically round sign * window * 2^(exponent - 63) into `out`, the
+    // window has its top bit set
+    template<fp_format out>
+    constexpr floatbase_t<out> round_window_stochastic(uint8_t sign, int32_t exponent, uint64_t window, uint32_t random)
+    {
+        constexpr int precision = unpacked_t<out>::precision;
+        constexpr int32_t emin = 1 - fp_traits<out>::bias;
+        static_assert(precision < 64, "stochastic rounding supports formats up to binary64");
+
+        // significand bits kept at this exponent, fewer for subnormals
+        const int32_t kept = exponent >= emin ? precision : precision - (emin - exponent);
+
+        // the discarded fraction of an ulp, left-aligned
+        uint64_t fraction = 0;
+        if (kept > 0) {
+            fraction = window << kept;
+        }
+        else {
+            fraction = -kept < 64 ? window >> -kept : 1;
+        }
+        const bool up = (fraction >> 32) + random > 0xffffffffu;
+
+        if (kept <= 0) {
+            // below half the smallest subnormal: zero or the smallest subnormal
+            if (!up) {
+                return floatbase_t<out>::zero(sign);
+            }
+            return round_window<out>(sign, emin - precision + 1, uint64_t(1) << 63);
+        }
+
+        // the neighbour picked has no bits below the format, rounding it again is exact
+        window &= ~(~uint64_t(0) >> kept);
+        if (up) {
+            window += uint64_t(1) << (64 - kept);
+            if (window == 0) {
+                window = uint64_t(1) << 63;
+                ++exponent;
+            }
+        }
+        return round_window<out>(sign, exponent, window);
+    }
+
+    // stochastically round a finite, zero or infinite value, NaNs become the default NaN
+    template<fp_format out, typename uint_t, int words>
+    constexpr floatbase_t<out> pack_stochastic(const fp_wide<uint_t, words> &value, uint32_t random)
+    {
+        static_assert(sizeof(uint_t) <= sizeof(uint64_t), "stochastic rounding supports formats up to binary64");
+
+        switch (value.class_)
+        {
+        case unpacked_class::nan:
+            return floatbase_t<out>::indeterminate_nan();
+        case unpacked_class::infinity:
+            return floatbase_t<out>::infinity(value.sign);
+        case unpacked_class::zero:
+            return floatbase_t<out>::zero(value.sign);
+        default:
+            break;
+        }
+
+        const auto window = rewiden<uint64_t, 1>(value);
+        return round_window_stochastic<out>(window.sign, window.exponent, window.w[0], random);
+    }
+
+    // static_cast between formats, the identity for the same format
+    template<fp_format out, fp_format in>
+    constexpr floatbase_t<out> convert_format(floatbase_t<in> x)
+    {
+        if constexpr (out == in) {
+            return x;
+        }
+        else {
+            return static_cast<floatbase_t<out>>(x);
+        }
+    }
+
+    template<fp_format in>
+    constexpr auto wide_operand(floatbase_t<in> x)
+    {
+        return unpacked_t<in>(x).to_wide().template resize<2>();
+    }
+}
+
+// x stochastically rounded into `out`
+template<fp_format out, fp_format in>
+constexpr floatbase_t<out> round_stochastic(floatbase_t<in> x, uint32_t random)
+{
+    if (details::is_nan(x)) {
+        return details::convert_format<out>(x);
+    }
+    return details::pack_stochastic<out>(unpacked_t<in>(x).to_wide(), random);
+}
+
+// a + b stochastically rounded into `out`
+template<fp_format out, fp_format in>
+constexpr floatbase_t<out> add_stochastic(floatbase_t<in> a, floatbase_t<in> b, uint32_t random)
+{
+    if (details::is_nan(a)) {
+        return details::convert_format<out>(a);
+    }
+    if (details::is_nan(b)) {
+        return details::convert_format<out>(b);
+    }
+    return details::pack_stochastic<out>(details::add(details::wide_operand(a), details::wide_operand(b)), random);
+}
+
+// a - b stochastically rounded into `out`
+template<fp_format out, fp_format in>
+constexpr floatbase_t<out> sub_stochastic(floatbase_t<in> a, floatbase_t<in> b, uint32_t random)
+{
+    return add_stochastic<out>(a, -b, random);
+}
+
+// a * b stochastically rounded into `out`
+template<fp_format out, fp_format in>
+constexpr floatbase_t<out> mul_stochastic(floatbase_t<in> a, floatbase_t<in> b, uint32_t random)
+{
+    if (details::is_nan(a)) {
+        return details::convert_format<out>(a);
+    }
+    if (details::is_nan(b)) {
+        return details::convert_format<out>(b);
+    }
+    return details::pack_stochastic<out>(details::multiply_exact(unpacked_t<in>(a).to_wide(), unpacked_t<in>(b).to_wide()), random);
+}
+
+// a * b + c stochastically rounded into `out`, from the exact product
+template<fp_format out, fp_format in>
+constexpr floatbase_t<out> fma_stochastic(floatbase_t<in> a, floatbase_t<in> b, floatbase_t<in> c, uint32_t random)
+{
+    if (details::is_nan(a)) {
+        return details::convert_format<out>(a);
+    }
+    if (details::is_nan(b)) {
+        return details::convert_format<out>(b);
+    }
+    if (details::is_nan(c)) {
+        return details::convert_format<out>(c);
+    }
+    auto product = details::multiply_exact(unpacked_t<in>(a).to_wide(), unpacked_t<in>(b).to_wide());
+    return details::pack_stochastic<out>(details::add(product, details::wide_operand(c)), random);
+}
+
+//
+// Stochastic rounding policy over a Philox stream
+//
+// Each call takes the next 32 bits of stream `stream` of `seed`. Give every
+// thread its own stream: the same seed, stream and sequence of calls give the
+// same results.
+//
+
+class stochastic_rounding
+{
+public:
+
+    explicit stochastic_rounding(uint64_t seed, uint64_t stream = 0)
+        : generator(seed), stream(stream)
+    {
+    }
+
+    // the next 32 random bits
+    uint32_t next()
+    {
+        if (used == 4) {
+            block = generator.block(index++, stream);
+            used = 0;
+        }
+        return block[used++];
+    }
+
+    template<fp_format out, fp_format in>
+    floatbase_t<out> convert(floatbase_t<in> x) { return round_stochastic<out>(x, next()); }
+
+    template<fp_format out, fp_format in>
+    floatbase_t<out> add(floatbase_t<in> a, floatbase_t<in> b) { return add_stochastic<out>(a, b, next()); }
+
+    template<fp_format out, fp_format in>
+    floatbase_t<out> sub(floatbase_t<in> a, floatbase_t<in> b) { return sub_stochastic<out>(a, b, next()); }
+
+    template<fp_format out, fp_format in>
+    floatbase_t<out> mul(floatbase_t<in> a, floatbase_t<in> b) { return mul_stochastic<out>(a, b, next()); }
+
+    template<fp_format out, fp_format in>
+    floatbase_t<out> fma(floatbase_t<in> a, floatbase_t<in> b, floatbase_t<in> c) { return fma_stochastic<out>(a, b, c, next()); }
+
+private:
+
+    philox4x32 generator;
+    uint64_t stream;
+    uint64_t index = 0;
+    philox4x32::block_t block = {};
+    int used = 4;
+};
+
+namespace details
+{
+    // call fn(i, random) for each element of [begin, end) with the bits of
+    // element i of the stream
+    template<typename fn_t>
+    void stochastic_elements(const philox4x32 &generator, uint64_t stream, size_t begin, size_t end, fn_t fn)
+    {
+        philox4x32::block_t block = generator.block(begin / 4, stream);
+        for (size_t i = begin; i < end; ++i) {
+            if (i % 4 == 0 && i != begin) {
+                block = generator.block(i / 4, stream);
+            }
+            fn(i, block[i % 4]);
+        }
+    }
+
+    // overflow and underflow of a finite, non-zero input like convert_kernel
+    template<fp_format from, fp_format to>
+    fp_flags conversion_flags(floatbase_t<from> x, floatbase_t<to> r)
+    {
+        using src_traits = fp_key_traits<from>;
+        using dst_traits = fp_key_traits<to>;
+
+        auto magnitude = static_cast<typename src_traits::uint_t>(x.to_bitstring() & src_traits::magnitude_mask);
+        if (magnitude == 0 || magnitude >= src_traits::infinity_bits) {
+            return fp_flags::none;
+        }
+
+        auto result = static_cast<typename dst_traits::uint_t>(r.to_bitstring() & dst_traits::magnitude_mask);
+        if (result == dst_traits::infinity_bits) {
+            return fp_flags::overflow;
+        }
+        if (result < dst_traits::min_normal_bits) {
+            return fp_flags::underflow;
+        }
+        return fp_flags::none;
+    }
+
+    template<fp_format from, fp_format to>
+    fp_flags round_stochastic_kernel(const floatbase_t<from> *src, floatbase_t<to> *dst, const philox4x32 &generator, uint64_t stream, size_t begin, size_t end)
+    {
+        fp_flags flags = fp_flags::none;
+
+#if USE_SSE2
+        if constexpr (from == fp_format::binary32 && to == fp_format::bfloat16) {
+            // binary32 and bfloat16 share the exponent range: adding the top 16
+            // random bits to the 16 discarded bits and truncating is the scalar
+            // rounding, subnormals and overflow included. NaNs truncate like the
+            // conversion does
+            const __m128i magnitude_mask = _mm_set1_epi32(0x7fffffff);
+            const __m128i infinity = _mm_set1_epi32(0x7f800000);
+            for (; begin % 4 != 0 && begin < end; ++begin) {
+                const auto block = generator.block(begin / 4, stream);
+                dst[begin] = round_stochastic<to>(src[begin], block[begin % 4]);
+                flags |= conversion_flags(src[begin], dst[begin]);
+            }
+            for (; begin + 4 <= end; begin += 4) {
+                const auto block = generator.block(begin / 4, stream);
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + begin));
+                const __m128i random = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block.data()));
+                const __m128i nan = _mm_cmpgt_epi32(_mm_and_si128(x, magnitude_mask), infinity);
+                const __m128i sum = _mm_add_epi32(x, _mm_andnot_si128(nan, _mm_srli_epi32(random, 16)));
+
+                // arithmetic shift and pack keep the sign bit in the 16-bit lanes
+                const __m128i r = _mm_packs_epi32(_mm_srai_epi32(sum, 16), _mm_setzero_si128());
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + begin), r);
+                for (size_t i = begin; i < begin + 4; ++i) {
+                    flags |= conversion_flags(src[i], dst[i]);
+                }
+            }
+        }
+#endif
+
+        stochastic_elements(generator, stream, begin, end, [&](size_t i, uint32_t random) {
+            dst[i] = round_stochastic<to>(src[i], random);
+            flags |= conversion_flags(src[i], dst[i]);
+        });
+        return flags;
+    }
+}
+
+namespace batch
+{
+    // dst[i] = src[i] stochastically rounded with the bits of element i of
+    // stream `stream` of `seed`, returns the merged exception flags
+    template<fp_format from, fp_format to>
+    fp_flags round_stochastic(const floatbase_t<from> *src, floatbase_t<to> *dst, size_t count, uint64_t seed, uint64_t stream = 0,
+        thread_pool &pool = default_thread_pool())
+    {
+        const philox4x32 generator(seed);
+        return details::run_batch<from>(pool, count, [=, &generator](size_t begin, size_t end) {
+            return details::round_stochastic_kernel<from, to>(src, dst, generator, stream, begin, end);
+        });
+    }
+
+    // acc[i] = acc[i] + x[i] in `wide` stochastically rounded back into the
+    // accumulator format, e.g. a bfloat16 weight update from binary32 gradients
+    template<fp_format format, fp_format wide>
+    fp_flags accumulate_stochastic(floatbase_t<format> *acc, const floatbase_t<wide> *x, size_t count, uint64_t seed, uint64_t stream = 0,
+        thread_pool &pool = default_thread_pool())
+    {
+        const philox4x32 generator(seed);
+        return details::run_batch<format>(pool, count, [=, &generator](size_t begin, size_t end) {
+            fp_flags flags = fp_flags::none;
+            details::stochastic_elements(generator, stream, begin, end, [&](size_t i, uint32_t random) {
+                const auto a = details::convert_format<wide>(acc[i]);
+                acc[i] = add_stochastic<format>(a, x[i], random);
+                flags |= details::arith_flags<details::arith_op::add, wide>(a.to_bitstring(), x[i].to_bitstring(),
+                    details::convert_format<wide>(acc[i]).to_bitstring());
+            });
+            return flags;
+        });
+    }
+}
@@ -0,0 +1,379 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "swfp.h"
+#include "swbatch.h"
+#include "swexec.h"
+#include "swfile.h"
+
+//
+// Zero-copy loading of .npy and raw tensor files
+//
+// The file is memory mapped and the values are used in place: view<format>()
+// returns a typed view straight onto the mapping, view_as<format>() returns a
+// view that converts each value when it is read. Nothing is copied at load
+// time, so opening a file costs one mapping and (for .npy) a header parse.
+//
+// .npy files name binary16/32/64 through their dtype ('<f2', '<f4', '<f8').
+// numpy has no dtype for bfloat16 or float8_e5m2; files holding them store an
+// opaque dtype of the right size ('<V2', '<u2', '|V1', ...) and the caller
+// names the format when opening. Only native (little-endian) byte order can
+// be viewed in place.
+//
+
+// contiguous read-only view of values, the C++17 stand-in for std::span<const T>
+template<typename T>
+class value_view
+{
+public:
+    using value_type = T;
+    using const_iterator = const T *;
+
+    constexpr value_view() = default;
+    constexpr value_view(const T *data, size_t count) : ptr(data), count(count) { }
+
+    constexpr const T *data() const { return ptr; }
+    constexpr size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+
+    constexpr const T &operator[](size_t i) const { return ptr[i]; }
+    constexpr const T *begin() const { return ptr; }
+    constexpr const T *end() const { return ptr + count; }
+
+    constexpr value_view subview(size_t offset, size_t length) const { return value_view(ptr + offset, length); }
+
+private:
+    const T *ptr = nullptr;
+    size_t count = 0;
+};
+
+namespace details
+{
+    // per (stored, requested) format pair: load one value and convert a range
+    template<fp_format from, fp_format to>
+    struct tensor_converter
+    {
+        static floatbase_t<to> load(const uint8_t *data, size_t i)
+        {
+            floatbase_t<from> x;
+            memcpy(&x, data + i * sizeof(x), sizeof(x));
+            if constexpr (from == to) {
+                return x;
+            }
+            else {
+                return static_cast<floatbase_t<to>>(x);
+            }
+        }
+
+        static fp_flags copy(const uint8_t *data, size_t begin, size_t count, floatbase_t<to> *out, thread_pool &pool)
+        {
+            const auto *src = reinterpret_cast<const floatbase_t<from> *>(data) + begin;
+            if constexpr (from == to) {
+                memcpy(out, src, count * sizeof(*out));
+                return fp_flags::none;
+            }
+            else {
+                return batch::convert(src, out, count, pool);
+            }
+        }
+    };
+}
+
+// read-only view converting stored values to `format` on access
+template<fp_format format>
+class converting_view
+{
+public:
+    using value_type = floatbase_t<format>;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = floatbase_t<format>;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        const_iterator(const converting_view *view, size_t i) : view(view), i(i) { }
+
+        value_type operator*() const { return (*view)[i]; }
+        const_iterator &operator++() { ++i; return *this; }
+        const_iterator operator++(int) { auto tmp = *this; ++i; return tmp; }
+        bool operator==(const const_iterator &other) const { return i == other.i; }
+        bool operator!=(const const_iterator &other) const { return i != other.i; }
+
+    private:
+        const converting_view *view;
+        size_t i;
+    };
+
+    converting_view() = default;
+
+    template<fp_format from>
+    static converting_view from_data(const uint8_t *data, size_t count)
+    {
+        converting_view view;
+        view.ptr = data;
+        view.count = count;
+        view.loader = &details::tensor_converter<from, format>::load;
+        view.copier = &details::tensor_converter<from, format>::copy;
+        return view;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    value_type operator[](size_t i) const { return loader(ptr, i); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+    // convert [begin, begin + length) into `out` with the batch kernels,
+    // returns the merged exception flags
+    fp_flags copy_to(size_t begin, size_t length, value_type *out, thread_pool &pool = default_thread_pool()) const
+    {
+        return copier(ptr, begin, length, out, pool);
+    }
+
+private:
+    const uint8_t *ptr = nullptr;
+    size_t count = 0;
+    value_type (*loader)(const uint8_t *, size_t) = nullptr;
+    fp_flags (*copier)(const uint8_t *, size_t, size_t, value_type *, thread_pool &) = nullptr;
+};
+
+class tensor_file
+{
+public:
+
+    tensor_file() = default;
+
+    // open a .npy file whose dtype is a float ('<f2', '<f4', '<f8')
+    static tensor_file open(const std::string &path)
+    {
+        tensor_file tensor;
+        tensor.file = mapped_file::open(path);
+        tensor.parse_npy(false, fp_format::binary32);
+        return tensor;
+    }
+
+    // open a .npy file, values with a dtype numpy cannot name (e.g. '<V2'
+    // for bfloat16) are taken to be `opaque_format`
+    static tensor_file open(const std::string &path, fp_format opaque_format)
+    {
+        tensor_file tensor;
+        tensor.file = mapped_file::open(path);
+        tensor.parse_npy(true, opaque_format);
+        return tensor;
+    }
+
+    // open a headerless file of packed values, shape is {count} unless given
+    static tensor_file open_raw(const std::string &path, fp_format format, std::vector<size_t> shape = {})
+    {
+        tensor_file tensor;
+        tensor.file = mapped_file::open(path);
+        tensor.value_format = format;
+        tensor.value_size = format_size(format);
+        tensor.data_offset = 0;
+
+        if (tensor.file.size() % tensor.value_size != 0) {
+            throw std::exception("file size is not a multiple of the value size");
+        }
+        tensor.count = static_cast<size_t>(tensor.file.size() / tensor.value_size);
+        tensor.dims = shape.empty() ? std::vector<size_t>{ tensor.count } : std::move(shape);
+        tensor.check_shape();
+        return tensor;
+    }
+
+    fp_format format() const { return value_format; }
+    const std::vector<size_t> &shape() const { return dims; }
+    bool fortran_order() const { return is_fortran_order; }
+    size_t size() const { return count; }
+
+    // typed view onto the mapping, the stored format must be `view_format`
+    template<fp_format view_format>
+    value_view<floatbase_t<view_format>> view() const
+    {
+        if (view_format != value_format) {
+            throw std::exception("tensor has a different format");
+        }
+        return value_view<floatbase_t<view_format>>(reinterpret_cast<const floatbase_t<view_format> *>(values()), count);
+    }
+
+    // view converting the stored values to `view_format` on access
+    template<fp_format view_format>
+    converting_view<view_format> view_as() const
+    {
+        switch (value_format)
+        {
+        case fp_format::float8_e5m2: return converting_view<view_format>::template from_data<fp_format::float8_e5m2>(values(), count);
+        case fp_format::bfloat16: return converting_view<view_format>::template from_data<fp_format::bfloat16>(values(), count);
+        case fp_format::binary16: return converting_view<view_format>::template from_data<fp_format::binary16>(values(), count);
+        case fp_format::binary32: return converting_view<view_format>::template from_data<fp_format::binary32>(values(), count);
+        case fp_format::binary64: return converting_view<view_format>::template from_data<fp_format::binary64>(values(), count);
+        default: throw std::exception("unsupported tensor format");
+        }
+    }
+
+private:
+
+    static size_t format_size(fp_format format)
+    {
+        switch (format)
+        {
+        case fp_format::float8_e5m2: return 1;
+        case fp_format::bfloat16: return 2;
+        case fp_format::binary16: return 2;
+        case fp_format::binary32: return 4;
+        case fp_format::binary64: return 8;
+        default: throw std::exception("unsupported tensor format");
+        }
+    }
+
+    const uint8_t *values() const { return file.data() ? file.data() + data_offset : nullptr; }
+
+    // product of the dimensions, a shape whose product does not fit size_t is rejected
+    static size_t element_count(const std::vector<size_t> &shape)
+    {
+        if (std::find(shape.begin(), shape.end(), size_t(0)) != shape.end()) {
+            return 0;
+        }
+
+        size_t product = 1;
+        for (size_t d : shape) {
+            if (product > SIZE_MAX / d) {
+                throw std::exception("tensor shape is too large");
+            }
+            product *= d;
+        }
+        return product;
+    }
+
+    void check_shape()
+    {
+        if (element_count(dims) != count) {
+            throw std::exception("shape does not match the number of values");
+        }
+    }
+
+    // value of `key` in the header dict, up to the next top-level ',' or '}'
+    static std::string header_field(const std::string &header, const char *key)
+    {
+        size_t pos = header.find(std::string("'") + key + "'");
+        if (pos == std::string::npos) {
+            throw std::exception("malformed .npy header");
+        }
+        pos = header.find(':', pos);
+        if (pos == std::string::npos) {
+            throw std::exception("malformed .npy header");
+        }
+
+        size_t end = ++pos;
+        int depth = 0;
+        for (; end < header.size(); ++end) {
+            char c = header[end];
+            if (c == '(') ++depth;
+            else if (c == ')') --depth;
+            else if (depth == 0 && (c == ',' || c == '}')) break;
+        }
+
+        std::string value = header.substr(pos, end - pos);
+        size_t first = value.find_first_not_of(" \t");
+        size_t last = value.find_last_not_of(" \t");
+        return first == std::string::npos ? std::string() : value.substr(first, last - first + 1);
+    }
+
+    void parse_npy(bool allow_opaque, fp_format opaque_format)
+    {
+        const uint8_t *bytes = file.data();
+        const uint64_t file_size = file.size();
+
+        static const uint8_t magic[] = { 0x93, 'N', 'U', 'M', 'P', 'Y' };
+        if (file_size < 10 || memcmp(bytes, magic, sizeof(magic)) != 0) {
+            throw std::exception("not a .npy file");
+        }
+
+        // version 1 has a 2-byte header length, versions 2 and 3 a 4-byte one
+        const uint8_t major = bytes[6];
+        size_t header_begin = 10;
+        size_t header_size = bytes[8] | (size_t(bytes[9]) << 8);
+        if (major >= 2) {
+            if (file_size < 12) {
+                throw std::exception("not a .npy file");
+            }
+            header_begin = 12;
+            header_size |= (size_t(bytes[10]) << 16) | (size_t(bytes[11]) << 24);
+        }
+        if (header_begin + header_size > file_size) {
+            throw std::exception("malformed .npy header");
+        }
+
+        const std::string header(reinterpret_cast<const char *>(bytes) + header_begin, header_size);
+        data_offset = header_begin + header_size;
+
+        // dtype: byte order, kind and size, e.g. '<f2'
+        std::string descr = header_field(header, "descr");
+        if (descr.size() < 5 || (descr.front() != '\'' && descr.front() != '"')) {
+            throw std::exception("unsupported .npy dtype");
+        }
+        descr = descr.substr(1, descr.size() - 2);
+
+        const char order = descr[0];
+        const char kind = descr[1];
+        const size_t size = static_cast<size_t>(atoi(descr.c_str() + 2));
+
+        // '|' is "not applicable": numpy writes it for single bytes and for void
+        // dtypes ('|V2' from a.view('V2')), whose bytes are opaque
+        if (order == '>' || (order == '|' && size > 1 && kind != 'V')) {
+            throw std::exception("only little-endian .npy data can be viewed in place");
+        }
+
+        if (kind == 'f' && size == 2) value_format = fp_format::binary16;
+        else if (kind == 'f' && size == 4) value_format = fp_format::binary32;
+        else if (kind == 'f' && size == 8) value_format = fp_format::binary64;
+        else if (allow_opaque && (kind == 'V' || kind == 'u' || kind == 'i') && size == format_size(opaque_format)) value_format = opaque_format;
+        else throw std::exception("unsupported .npy dtype");
+        value_size = size;
+
+        is_fortran_order = header_field(header, "fortran_order") == "True";
+
+        // shape: '()', '(n,)' or '(n, m, ...)'
+        const std::string shape = header_field(header, "shape");
+        dims.clear();
+        for (size_t pos = 0; pos < shape.size(); ) {
+            if (shape[pos] >= '0' && shape[pos] <= '9') {
+                char *end = nullptr;
+                dims.push_back(static_cast<size_t>(strtoull(shape.c_str() + pos, &end, 10)));
+                pos = static_cast<size_t>(end - shape.c_str());
+            }
+            else {
+                ++pos;
+            }
+        }
+
+        count = element_count(dims);
+        if (count > (file_size - data_offset) / value_size) {
+            throw std::exception("truncated .npy file");
+        }
+        if (data_offset % value_size != 0) {
+            throw std::exception("misaligned .npy data");
+        }
+    }
+
+    mapped_file file;
+    fp_format value_format = fp_format::binary32;
+    size_t value_size = 4;
+    size_t data_offset = 0;
+    size_t count = 0;
+    std::vector<size_t> dims;
+    bool is_fortran_order = false;
+};
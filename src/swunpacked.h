@@ -0,0 +1,724 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include "swfp.h"
+#include "swint.h"
+
+//
+// Unpacked floating-point values
+//
+// floatbase_t packs every result back into its IEEE754 encoding and the next
+// operator classifies and unpacks it again. unpacked_t keeps the decomposed
+// form between operations: class, sign, unbiased exponent and a left-aligned
+// significand with guard bits below the format precision. Unpacking and
+// packing happen only at the ends of a computation.
+//
+// Each operation computes the exact result and truncates it to the width of
+// the significand, ORing any discarded bits into the lowest bit (round-to-odd).
+// With at least two guard bits this keeps enough information that pack()
+// rounds to nearest-even as if directly from the exact result, so a single
+// operation followed by pack() is correctly rounded like a floatbase_t operator.
+// Chained operations keep the guard bits and the unbounded exponent between
+// steps; call round() where the chain should round like floatbase_t does.
+//
+
+enum class unpacked_class { nan, infinity, zero, finite };
+
+namespace details
+{
+    // multi-word significand arithmetic, w[0] is the most significant word
+
+    template<typename uint_t>
+    constexpr int word_bitsize() { return static_cast<int>(sizeof(uint_t) * 8); }
+
+    template<typename uint_t, int words>
+    constexpr bool words_zero(const uint_t (&w)[words])
+    {
+        for (int i = 0; i < words; ++i) {
+            if (w[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // shift right, returns true if any set bit was shifted out
+    template<typename uint_t, int words>
+    constexpr bool shift_right_sticky(uint_t (&w)[words], int64_t amount)
+    {
+        constexpr int bits = word_bitsize<uint_t>();
+        if (amount <= 0) {
+            return false;
+        }
+        if (amount >= int64_t(words) * bits) {
+            bool lost = !words_zero(w);
+            for (int i = 0; i < words; ++i) {
+                w[i] = 0;
+            }
+            return lost;
+        }
+
+        const int word_shift = static_cast<int>(amount / bits);
+        const int bit_shift = static_cast<int>(amount % bits);
+
+        bool lost = false;
+        for (int i = words - word_shift; i < words; ++i) {
+            lost |= w[i] != 0;
+        }
+        if (bit_shift) {
+            lost |= static_cast<uint_t>(w[words - word_shift - 1] << (bits - bit_shift)) != 0;
+        }
+
+        for (int i = words - 1; i >= 0; --i) {
+            int src = i - word_shift;
+            uint_t value = 0;
+            if (src >= 0) {
+                value = static_cast<uint_t>(w[src] >> bit_shift);
+                if (bit_shift && src > 0) {
+                    value |= static_cast<uint_t>(w[src - 1] << (bits - bit_shift));
+                }
+            }
+            w[i] = value;
+        }
+        return lost;
+    }
+
+    template<typename uint_t, int words>
+    constexpr void shift_left(uint_t (&w)[words], int amount)
+    {
+        constexpr int bits = word_bitsize<uint_t>();
+        const int word_shift = amount / bits;
+        const int bit_shift = amount % bits;
+
+        for (int i = 0; i < words; ++i) {
+            int src = i + word_shift;
+            uint_t value = 0;
+            if (src < words) {
+                value = static_cast<uint_t>(w[src] << bit_shift);
+                if (bit_shift && src + 1 < words) {
+                    value |= static_cast<uint_t>(w[src + 1] >> (bits - bit_shift));
+                }
+            }
+            w[i] = value;
+        }
+    }
+
+    // a += b, returns the carry out of the top word
+    template<typename uint_t, int words>
+    constexpr bool add_words(uint_t (&a)[words], const uint_t (&b)[words])
+    {
+        bool carry = false;
+        for (int i = words - 1; i >= 0; --i) {
+            uint_t sum = static_cast<uint_t>(a[i] + b[i]);
+            bool c1 = sum < a[i];
+            uint_t total = static_cast<uint_t>(sum + (carry ? 1 : 0));
+            bool c2 = total < sum;
+            a[i] = total;
+            carry = c1 || c2;
+        }
+        return carry;
+    }
+
+    // a -= b, a must not be less than b
+    template<typename uint_t, int words>
+    constexpr void sub_words(uint_t (&a)[words], const uint_t (&b)[words])
+    {
+        bool borrow = false;
+        for (int i = words - 1; i >= 0; --i) {
+            uint_t diff = static_cast<uint_t>(a[i] - b[i]);
+            bool b1 = a[i] < b[i];
+            uint_t total = static_cast<uint_t>(diff - (borrow ? 1 : 0));
+            bool b2 = diff < (borrow ? 1 : 0);
+            a[i] = total;
+            borrow = b1 || b2;
+        }
+    }
+
+    // subtract one unit in the last place
+    template<typename uint_t, int words>
+    constexpr void decrement_words(uint_t (&a)[words])
+    {
+        for (int i = words - 1; i >= 0; --i) {
+            if (a[i]-- != 0) {
+                return;
+            }
+        }
+    }
+
+    template<typename uint_t, int words>
+    constexpr int compare_words(const uint_t (&a)[words], const uint_t (&b)[words])
+    {
+        for (int i = 0; i < words; ++i) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // full product of two words
+    template<typename uint_t>
+    constexpr uint_t multiply_words(uint_t a, uint_t b, uint_t &upper)
+    {
+        if constexpr (sizeof(uint_t) < sizeof(uint64_t)) {
+            uint64_t full = uint64_t(a) * b;
+            upper = static_cast<uint_t>(full >> word_bitsize<uint_t>());
+            return static_cast<uint_t>(full);
+        }
+        else {
+            return details::mul_extended(a, b, upper);
+        }
+    }
+
+    template<typename uint_t, int words>
+    constexpr int leading_zeros(const uint_t (&w)[words])
+    {
+        constexpr int bits = word_bitsize<uint_t>();
+        for (int i = 0; i < words; ++i) {
+            if (w[i] != 0) {
+                unsigned long index = 0;
+                details::reverse_bit_scan(&index, w[i]);
+                return i * bits + (bits - 1 - static_cast<int>(index));
+            }
+        }
+        return words * bits;
+    }
+
+    // Value with a `words`-word significand, the building block of unpacked_t
+    // and of the fused kernels. Finite values have the top bit of w[0] set and
+    // are worth 1.w * 2^exponent; the lowest bit is sticky. A NaN carries the
+    // packed bits of the NaN it propagates in w[0], or zero for a new NaN.
+    template<typename uint_t, int words>
+    struct fp_wide
+    {
+        static constexpr int bitsize = words * word_bitsize<uint_t>();
+
+        unpacked_class class_ = unpacked_class::zero;
+        uint8_t sign = 0;
+        int32_t exponent = 0;
+        uint_t w[words] = {};
+
+        static constexpr fp_wide make(unpacked_class class_, uint8_t sign)
+        {
+            fp_wide r;
+            r.class_ = class_;
+            r.sign = sign;
+            return r;
+        }
+
+        // change the significand width, dropped bits become sticky
+        template<int out_words>
+        constexpr fp_wide<uint_t, out_words> resize() const
+        {
+            fp_wide<uint_t, out_words> r;
+            r.class_ = class_;
+            r.sign = sign;
+            r.exponent = exponent;
+            for (int i = 0; i < std::min(words, out_words); ++i) {
+                r.w[i] = w[i];
+            }
+            if constexpr (out_words < words) {
+                for (int i = out_words; i < words; ++i) {
+                    r.w[out_words - 1] |= (w[i] != 0) ? 1 : 0;
+                }
+            }
+            return r;
+        }
+    };
+
+    // exact product of single-word significands
+    template<typename uint_t>
+    constexpr fp_wide<uint_t, 2> multiply_exact(const fp_wide<uint_t, 1> &a, const fp_wide<uint_t, 1> &b)
+    {
+        using result_t = fp_wide<uint_t, 2>;
+        const uint8_t sign = a.sign ^ b.sign;
+
+        if (a.class_ == unpacked_class::nan) {
+            return a.template resize<2>();
+        }
+        if (b.class_ == unpacked_class::nan) {
+            return b.template resize<2>();
+        }
+        if (a.class_ == unpacked_class::infinity || b.class_ == unpacked_class::infinity) {
+            if (a.class_ == unpacked_class::zero || b.class_ == unpacked_class::zero) {
+                return result_t::make(unpacked_class::nan, 1);
+            }
+            return result_t::make(unpacked_class::infinity, sign);
+        }
+        if (a.class_ == unpacked_class::zero || b.class_ == unpacked_class::zero) {
+            return result_t::make(unpacked_class::zero, sign);
+        }
+
+        result_t r = result_t::make(unpacked_class::finite, sign);
+        uint_t upper = 0;
+        uint_t lower = multiply_words(a.w[0], b.w[0], upper);
+        r.w[0] = upper;
+        r.w[1] = lower;
+        r.exponent = a.exponent + b.exponent + 1;
+
+        // [1, 2) * [1, 2) is in [1, 4)
+        if (leading_zeros(r.w) != 0) {
+            shift_left(r.w, 1);
+            r.exponent -= 1;
+        }
+        return r;
+    }
+
+    // a + b truncated to `words` words with sticky bit (round-to-odd). The
+    // operands are aligned in a window twice as wide: bits only fall out of it
+    // when the exponents are so far apart that at most one bit cancels
+    template<typename uint_t, int words>
+    constexpr fp_wide<uint_t, words> add(fp_wide<uint_t, words> a, fp_wide<uint_t, words> b)
+    {
+        using result_t = fp_wide<uint_t, words>;
+
+        if (a.class_ == unpacked_class::nan) {
+            return a;
+        }
+        if (b.class_ == unpacked_class::nan) {
+            return b;
+        }
+        if (a.class_ == unpacked_class::infinity) {
+            if (b.class_ == unpacked_class::infinity && a.sign != b.sign) {
+                return result_t::make(unpacked_class::nan, 1);
+            }
+            return a;
+        }
+        if (b.class_ == unpacked_class::infinity) {
+            return b;
+        }
+        if (a.class_ == unpacked_class::zero) {
+            if (b.class_ == unpacked_class::zero) {
+                return result_t::make(unpacked_class::zero, a.sign & b.sign);
+            }
+            return b;
+        }
+        if (b.class_ == unpacked_class::zero) {
+            return a;
+        }
+
+        // order by magnitude
+        if (a.exponent < b.exponent || (a.exponent == b.exponent && compare_words(a.w, b.w) < 0)) {
+            std::swap(a, b);
+        }
+
+        uint_t x[2 * words] = {};
+        uint_t y[2 * words] = {};
+        for (int i = 0; i < words; ++i) {
+            x[i] = a.w[i];
+            y[i] = b.w[i];
+        }
+        const bool lost = shift_right_sticky(y, int64_t(a.exponent) - b.exponent);
+
+        result_t r = result_t::make(unpacked_class::finite, a.sign);
+        r.exponent = a.exponent;
+        bool sticky = lost;
+
+        if (a.sign == b.sign)
+        {
+            if (add_words(x, y)) {
+                sticky |= shift_right_sticky(x, 1);
+                x[0] |= static_cast<uint_t>(uint_t(1) << (word_bitsize<uint_t>() - 1));
+                r.exponent += 1;
+            }
+        }
+        else
+        {
+            // the shifted-out tail of y is in (0, 1) units of the window: borrow
+            // one unit and keep the remainder as the sticky bit
+            sub_words(x, y);
+            if (lost) {
+                decrement_words(x);
+            }
+            if (words_zero(x)) {
+                return result_t::make(unpacked_class::zero, 0);
+            }
+
+            int distance = leading_zeros(x);
+            shift_left(x, distance);
+            r.exponent -= distance;
+        }
+
+        for (int i = 0; i < words; ++i) {
+            r.w[i] = x[i];
+        }
+        for (int i = words; i < 2 * words; ++i) {
+            sticky |= x[i] != 0;
+        }
+        r.w[words - 1] |= sticky ? 1 : 0;
+        return r;
+    }
+
+    template<typename uint_t, int words>
+    constexpr fp_wide<uint_t, words> negate(fp_wide<uint_t, words> a)
+    {
+        if (a.class_ != unpacked_class::nan) {
+            a.sign ^= 1;
+        }
+        return a;
+    }
+}
+
+template<fp_format format>
+class unpacked_t
+{
+public:
+
+    using packed_t = floatbase_t<format>;
+    using uint_t = typename fp_traits<format>::uint_t;
+
+    static constexpr int bitsize = sizeof(uint_t) * 8;
+    static constexpr int precision = packed_t::significand_bitsize + 1;
+    static constexpr int guard_bits = bitsize - precision;
+
+    static_assert(guard_bits >= 2, "round-to-odd needs two guard bits");
+
+    // the value is 1.significand * 2^exponent for finite values, the top bit of
+    // `significand` is the leading one and the low `guard_bits` are guard bits
+    unpacked_class class_;
+    uint8_t sign;
+    int32_t exponent;
+    uint_t significand;
+
+    unpacked_t() = default;
+
+    explicit constexpr unpacked_t(packed_t x)
+    {
+        auto c = x.decompose();
+        sign = c.sign;
+        exponent = 0;
+        significand = 0;
+
+        switch (c.class_)
+        {
+        case packed_t::fp_class::nan:
+            class_ = unpacked_class::nan;
+            significand = x.to_bitstring();
+            return;
+        case packed_t::fp_class::infinity:
+            class_ = unpacked_class::infinity;
+            return;
+        case packed_t::fp_class::zero:
+            class_ = unpacked_class::zero;
+            return;
+        case packed_t::fp_class::subnormal:
+        {
+            int distance = packed_t::significand_adjustment(c.significand);
+            c.significand <<= distance;
+            c.exponent -= distance;
+            break;
+        }
+        default:
+            break;
+        }
+
+        class_ = unpacked_class::finite;
+        exponent = c.exponent;
+        significand = static_cast<uint_t>(c.significand << guard_bits);
+    }
+
+    // round to nearest-even into the packed format
+    constexpr packed_t pack() const { return pack(to_wide()); }
+
+    // round to the format precision and range, staying unpacked
+    constexpr unpacked_t round() const { return unpacked_t(pack()); }
+
+    constexpr unpacked_t operator+(const unpacked_t &other) const { return from_wide(details::add(to_wide(), other.to_wide())); }
+    constexpr unpacked_t operator-(const unpacked_t &other) const { return from_wide(details::add(to_wide(), details::negate(other.to_wide()))); }
+    constexpr unpacked_t operator*(const unpacked_t &other) const
+    {
+        return from_wide(details::multiply_exact(to_wide(), other.to_wide()).template resize<1>());
+    }
+    constexpr unpacked_t operator-() const
+    {
+        // like floatbase_t, negation flips the sign of NaNs too
+        unpacked_t r = *this;
+        r.sign ^= 1;
+        if (class_ == unpacked_class::nan) {
+            r.significand ^= static_cast<uint_t>(uint_t(1) << (bitsize - 1));
+        }
+        return r;
+    }
+
+    // a * b + c from the exact product
+    friend constexpr unpacked_t fma(const unpacked_t &a, const unpacked_t &b, const unpacked_t &c)
+    {
+        auto product = details::multiply_exact(a.to_wide(), b.to_wide());
+        return from_wide(details::add(product, c.to_wide().template resize<2>()).template resize<1>());
+    }
+
+    //
+    // conversion from/to the multi-word form used by the fused kernels
+    //
+
+    constexpr details::fp_wide<uint_t, 1> to_wide() const
+    {
+        details::fp_wide<uint_t, 1> r;
+        r.class_ = class_;
+        r.sign = sign;
+        r.exponent = exponent;
+        r.w[0] = significand;
+        return r;
+    }
+
+    static constexpr unpacked_t from_wide(const details::fp_wide<uint_t, 1> &r)
+    {
+        unpacked_t u;
+        u.class_ = r.class_;
+        u.sign = r.sign;
+        u.exponent = r.exponent;
+        u.significand = r.w[0];
+        return u;
+    }
+
+    // round a multi-word value to nearest-even into the packed format
+    template<int words>
+    static constexpr packed_t pack(const details::fp_wide<uint_t, words> &value)
+    {
+        switch (value.class_)
+        {
+        case unpacked_class::nan:
+            return value.w[0] ? packed_t::from_bitstring(value.w[0]) : packed_t::indeterminate_nan();
+        case unpacked_class::infinity:
+            return packed_t::infinity(value.sign);
+        case unpacked_class::zero:
+            return packed_t::zero(value.sign);
+        default:
+            break;
+        }
+
+        // round-to-odd into one word first, then to nearest-even
+        auto narrow = value.template resize<1>();
+        uint_t bits = narrow.w[0];
+        int32_t exp = narrow.exponent;
+
+        if (exp > packed_t::emax) {
+            return packed_t::infinity(value.sign);
+        }
+
+        if (exp < packed_t::emin) {
+            // denormalize: keep the guard bits below the subnormal significand
+            uint_t w[1] = { bits };
+            bool lost = details::shift_right_sticky(w, int64_t(packed_t::emin) - exp);
+            bits = static_cast<uint_t>(w[0] | (lost ? 1 : 0));
+
+            uint_t subnormal_significand = static_cast<uint_t>(bits >> guard_bits);
+            uint_t roundoff_bits = static_cast<uint_t>(bits << (bitsize - guard_bits));
+            if (packed_t::round_subnormal_significand(subnormal_significand, roundoff_bits)) {
+                return packed_t::subnormal(value.sign, subnormal_significand);
+            }
+            return packed_t::normal(value.sign, packed_t::emin, subnormal_significand);
+        }
+
+        uint_t normal_significand = static_cast<uint_t>(bits >> guard_bits);
+        uint_t roundoff_bits = static_cast<uint_t>(bits << (bitsize - guard_bits));
+        if (!packed_t::round_significand(normal_significand, exp, roundoff_bits)) {
+            return packed_t::infinity(value.sign);
+        }
+        return packed_t::normal(value.sign, exp, normal_significand);
+    }
+};
+
+template<fp_format format>
+constexpr unpacked_t<format> unpack(floatbase_t<format> x) { return unpacked_t<format>(x); }
+
+//
+// Widening operations
+//
+// The product of two binary16 values is exact in binary32, and so is the
+// product of two binary32 values in binary64. mul_wide, add_wide and fma_wide
+// take narrow operands and round once into the wider format, working from the
+// unpacked narrow significands instead of converting both operands with
+// to_widefp and running a full-width operation:
+//
+//      float32_t p = mul_wide<fp_format::binary32>(a16, b16);       // exact
+//      acc32 = fma_wide<fp_format::binary32>(a16, b16, acc32);      // rounds once
+//
+// Any pair of formats works as long as the wide significand word is at least
+// as large as the narrow one; when the product does not fit (bfloat16 into
+// binary32 at the edges of the exponent range) the result is correctly rounded.
+//
+
+namespace details
+{
+    // move a significand into words of another size, dropped bits become sticky
+    template<typename out_t, int out_words, typename in_t, int in_words>
+    constexpr fp_wide<out_t, out_words> rewiden(const fp_wide<in_t, in_words> &x)
+    {
+        static_assert(sizeof(out_t) >= sizeof(in_t), "rewiden only widens the significand words");
+        constexpr int in_bits = word_bitsize<in_t>();
+        constexpr int out_bits = word_bitsize<out_t>();
+
+        fp_wide<out_t, out_words> r;
+        r.class_ = x.class_;
+        r.sign = x.sign;
+        r.exponent = x.exponent;
+
+        bool sticky = false;
+        for (int i = 0; i < in_words; ++i) {
+            const int word = (i * in_bits) / out_bits;
+            const int shift = out_bits - in_bits - (i * in_bits) % out_bits;
+            if (word < out_words) {
+                r.w[word] |= static_cast<out_t>(static_cast<out_t>(x.w[i]) << shift);
+            }
+            else {
+                sticky |= x.w[i] != 0;
+            }
+        }
+        r.w[out_words - 1] |= sticky ? 1 : 0;
+        return r;
+    }
+
+    template<fp_format wide, fp_format narrow>
+    constexpr auto widen(floatbase_t<narrow> x)
+    {
+        return rewiden<typename fp_traits<wide>::uint_t, 2>(unpacked_t<narrow>(x).to_wide());
+    }
+
+    template<fp_format format>
+    constexpr bool is_nan(floatbase_t<format> x)
+    {
+        return unpacked_t<format>(x).class_ == unpacked_class::nan;
+    }
+}
+
+// a * b rounded once into `wide`
+template<fp_format wide, fp_format narrow>
+constexpr floatbase_t<wide> mul_wide(floatbase_t<narrow> a, floatbase_t<narrow> b)
+{
+    using wide_uint_t = typename fp_traits<wide>::uint_t;
+
+    // NaNs propagate like the conversion to the wide format does
+    if (details::is_nan(a)) {
+        return static_cast<floatbase_t<wide>>(a);
+    }
+    if (details::is_nan(b)) {
+        return static_cast<floatbase_t<wide>>(b);
+    }
+
+    auto product = details::multiply_exact(unpacked_t<narrow>(a).to_wide(), unpacked_t<narrow>(b).to_wide());
+    return unpacked_t<wide>::pack(details::rewiden<wide_uint_t, 2>(product));
+}
+
+// a + b rounded once into `wide`
+template<fp_format wide, fp_format narrow>
+constexpr floatbase_t<wide> add_wide(floatbase_t<narrow> a, floatbase_t<narrow> b)
+{
+    if (details::is_nan(a)) {
+        return static_cast<floatbase_t<wide>>(a);
+    }
+    if (details::is_nan(b)) {
+        return static_cast<floatbase_t<wide>>(b);
+    }
+
+    return unpacked_t<wide>::pack(details::add(details::widen<wide>(a), details::widen<wide>(b)));
+}
+
+// a * b + c rounded once into `wide`, c is already wide
+template<fp_format wide, fp_format narrow>
+constexpr floatbase_t<wide> fma_wide(floatbase_t<narrow> a, floatbase_t<narrow> b, floatbase_t<wide> c)
+{
+    using wide_uint_t = typename fp_traits<wide>::uint_t;
+
+    if (details::is_nan(a)) {
+        return static_cast<floatbase_t<wide>>(a);
+    }
+    if (details::is_nan(b)) {
+        return static_cast<floatbase_t<wide>>(b);
+    }
+
+    auto product = details::multiply_exact(unpacked_t<narrow>(a).to_wide(), unpacked_t<narrow>(b).to_wide());
+    auto addend = unpacked_t<wide>(c).to_wide().template resize<2>();
+    return unpacked_t<wide>::pack(details::add(details::rewiden<wide_uint_t, 2>(product), addend));
+}
+
+//
+// square root
+//
+// sqrt(x) is correctly rounded for formats up to binary64: the integer square
+// root of the significand, scaled to 128 bits, gives a 64-bit root and a
+// sticky bit that round once into the format.
+//
+
+namespace details
+{
+    // round sign * window * 2^(exponent - 63) to nearest-even in `out`, the
+    // window is round-to-odd: 64 bits leave enough guard bits for every format
+    template<fp_format out>
+    constexpr floatbase_t<out> round_window(uint8_t sign, int32_t exponent, uint64_t window)
+    {
+        using uint_t = typename fp_traits<out>::uint_t;
+        constexpr int words = static_cast<int>(sizeof(uint64_t) / sizeof(uint_t));
+
+        fp_wide<uint_t, words> value;
+        value.class_ = unpacked_class::finite;
+        value.sign = sign;
+        value.exponent = exponent;
+        for (int i = 0; i < words; ++i) {
+            value.w[i] = static_cast<uint_t>(window >> (64 - (i + 1) * word_bitsize<uint_t>()));
+        }
+        return unpacked_t<out>::pack(value);
+    }
+
+    // floor(sqrt(hi:lo)) digit by digit, `exact` if there is no remainder
+    constexpr uint64_t isqrt128(uint64_t hi, uint64_t lo, bool &exact)
+    {
+        uint64_t root = 0;
+        for (int bit = 63; bit >= 0; --bit) {
+            const uint64_t candidate = root | (uint64_t(1) << bit);
+            uint64_t square_hi = 0;
+            const uint64_t square_lo = mul_extended(candidate, candidate, square_hi);
+            if (square_hi < hi || (square_hi == hi && square_lo <= lo)) {
+                root = candidate;
+            }
+        }
+
+        uint64_t square_hi = 0;
+        const uint64_t square_lo = mul_extended(root, root, square_hi);
+        exact = square_hi == hi && square_lo == lo;
+        return root;
+    }
+}
+
+template<fp_format format>
+constexpr floatbase_t<format> sqrt(floatbase_t<format> x)
+{
+    static_assert(sizeof(typename fp_traits<format>::uint_t) <= sizeof(uint64_t), "sqrt supports formats up to binary64");
+
+    const unpacked_t<format> u(x);
+    switch (u.class_)
+    {
+    case unpacked_class::nan:
+    case unpacked_class::zero:
+        return x;
+    case unpacked_class::infinity:
+        return u.sign ? floatbase_t<format>::indeterminate_nan() : x;
+    default:
+        break;
+    }
+    if (u.sign) {
+        return floatbase_t<format>::indeterminate_nan();
+    }
+
+    // x = m * 2^e, m shifted so that its top bit is bit 126 or 127 of the
+    // radicand and the exponent left is even: the root has 64 bits
+    constexpr int bitsize = unpacked_t<format>::bitsize;
+    const uint64_t m = static_cast<uint64_t>(u.significand);
+    const int32_t e = u.exponent - (bitsize - 1);
+    int shift = 128 - bitsize;
+    if ((e - shift) % 2 != 0) {
+        --shift;
+    }
+
+    const uint64_t hi = shift >= 64 ? m << (shift - 64) : m >> (64 - shift);
+    const uint64_t lo = shift >= 64 ? 0 : m << shift;
+
+    bool exact = false;
+    const uint64_t root = details::isqrt128(hi, lo, exact);
+    return details::round_window<format>(0, (e - shift) / 2 + 63, root | (exact ? 0 : 1));
+}
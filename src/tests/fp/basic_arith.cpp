@@ -271,6 +271,28 @@ void validate_arithmetic()
     T::validate(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() / 1000);
     cout << "okay!" << endl;
 
+    cout << "testing results deep in the subnormal range...";
+    {
+        // 0x1a80050d * 0x1a9ff9b0 lies just above 2.5 times the smallest
+        // subnormal, and the bits that put it above are shifted out while the
+        // product is denormalized: without a sticky bit it rounds to 2, not 3.
+        // the last two pairs denormalize quotients by more than the guard bits
+        uint32_t values[][2] = {
+            { 0x1a80050d, 0x1a9ff9b0 },
+            { 0x1a9ff9b0, 0x1a80050d },
+            { 0x9a80050d, 0x1a9ff9b0 },
+            { 0x1a80050d, 0x60aaaaab },
+            { 0x1a9ff9b0, 0x5fc00001 },
+        };
+
+        for (int i = 0; i < _countof(values); ++i) {
+            float x = *(float *)&values[i][0];
+            float y = *(float *)&values[i][1];
+            T::validate(x, y);
+        }
+    }
+    cout << "okay!" << endl;
+
     cout << "testing special values...";
     {
         float values[] = { 0.0f, 1.0f, 2.0f,
@@ -0,0 +1,255 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+#include <limits>
+
+#include "swbatch.h"
+
+// disable constant arithmetic warnings
+#pragma warning(disable:4756)
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the thread pool and the batch arithmetic/conversion kernels
+//  every 16-bit value against a sample of 16-bit values, checked against the scalar operators
+//  exception flags for each kind of special case
+//  exceptions from a chunk reach the caller of parallel_for
+//  identical results and flags for different pool sizes
+//
+
+constexpr size_t value_count = std::numeric_limits<uint16_t>::max() + 1;
+
+template <typename fp_t>
+void fail(fp_t a, fp_t b, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+    cout << "b: " << b.to_hex_string() << " " << b.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+void validate_parallel_for(thread_pool &pool)
+{
+    for (size_t grain : { size_t(1), size_t(7), size_t(64), size_t(1000), size_t(100000) })
+    {
+        constexpr size_t count = 12345;
+        std::vector<std::atomic<int>> visits(count);
+        std::atomic<bool> bad_worker{ false };
+
+        pool.parallel_for(0, count, grain, [&](size_t begin, size_t end, unsigned worker) {
+            if (worker >= pool.size() || (end - begin) > grain) {
+                bad_worker = true;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                visits[i]++;
+            }
+
+            // nested calls run inline on the same worker
+            pool.parallel_for(0, 3, 1, [&](size_t, size_t, unsigned nested_worker) {
+                if (nested_worker != worker) {
+                    bad_worker = true;
+                }
+            });
+        });
+
+        if (bad_worker) {
+            throw std::exception("bad worker index");
+        }
+        for (auto &v : visits) {
+            if (v != 1) {
+                throw std::exception("bad parallel_for coverage");
+            }
+        }
+    }
+}
+
+void validate_parallel_for_exception(thread_pool &pool)
+{
+    struct chunk_error {};
+
+    // the first exception from any chunk is rethrown on the calling thread,
+    // after which the pool takes new jobs as before
+    for (size_t failing : { size_t(0), size_t(5000), size_t(12344) })
+    {
+        bool caught = false;
+        try {
+            pool.parallel_for(0, 12345, 7, [&](size_t begin, size_t end, unsigned) {
+                if (begin <= failing && failing < end) {
+                    throw chunk_error{};
+                }
+            });
+        }
+        catch (chunk_error) {
+            caught = true;
+        }
+
+        if (!caught) {
+            throw std::exception("parallel_for lost an exception");
+        }
+    }
+
+    validate_parallel_for(pool);
+}
+
+template<typename fp_t>
+fp_flags flags_of(fp_t a, fp_t b, fp_t (*op)(fp_t, fp_t), fp_flags (*batch_op)(const fp_t *, const fp_t *, fp_t *, size_t, thread_pool &))
+{
+    fp_t out;
+    fp_flags flags = batch_op(&a, &b, &out, 1, default_thread_pool());
+    if (out.to_bitstring() != op(a, b).to_bitstring()) {
+        fail(a, b, "bad single element result");
+    }
+    return flags;
+}
+
+void validate_flags()
+{
+    using fp_t = float32_t;
+    auto add = [](fp_t a, fp_t b) { return a + b; };
+    auto sub = [](fp_t a, fp_t b) { return a - b; };
+    auto mul = [](fp_t a, fp_t b) { return a * b; };
+    auto div = [](fp_t a, fp_t b) { return a / b; };
+
+    const fp_t one(1.0f), zero(0.0f), inf = fp_t::infinity(), nan = fp_t::indeterminate_nan();
+    const fp_t big(std::numeric_limits<float>::max()), small(std::numeric_limits<float>::min());
+
+    struct { fp_t a, b; fp_t (*op)(fp_t, fp_t); fp_flags (*batch_op)(const fp_t *, const fp_t *, fp_t *, size_t, thread_pool &); fp_flags expected; } cases[] = {
+        { one, one, add, batch::add<fp_format::binary32>, fp_flags::none },
+        { inf, -inf, add, batch::add<fp_format::binary32>, fp_flags::invalid },
+        { inf, inf, sub, batch::sub<fp_format::binary32>, fp_flags::invalid },
+        { nan, one, add, batch::add<fp_format::binary32>, fp_flags::none },
+        { big, big, add, batch::add<fp_format::binary32>, fp_flags::overflow },
+        { big, fp_t(2.0f), mul, batch::mul<fp_format::binary32>, fp_flags::overflow },
+        { zero, inf, mul, batch::mul<fp_format::binary32>, fp_flags::invalid },
+        { small, fp_t(0.3f), mul, batch::mul<fp_format::binary32>, fp_flags::underflow },
+        { one, zero, div, batch::div<fp_format::binary32>, fp_flags::divide_by_zero },
+        { zero, zero, div, batch::div<fp_format::binary32>, fp_flags::invalid },
+        { inf, inf, div, batch::div<fp_format::binary32>, fp_flags::invalid },
+        { inf, zero, div, batch::div<fp_format::binary32>, fp_flags::none },
+        { small, big, div, batch::div<fp_format::binary32>, fp_flags::underflow },
+        { big, small, div, batch::div<fp_format::binary32>, fp_flags::overflow },
+    };
+
+    for (auto &c : cases) {
+        if (flags_of(c.a, c.b, c.op, c.batch_op) != c.expected) {
+            fail(c.a, c.b, "bad flags");
+        }
+    }
+
+    // conversion flags
+    float32_t wide[] = { float32_t(1.0f), float32_t(1e10f), float32_t(1e-10f), float32_t::indeterminate_nan() };
+    float16_t narrow[4];
+    if (batch::convert(wide, narrow, 1) != fp_flags::none
+        || batch::convert(wide + 1, narrow, 1) != fp_flags::overflow
+        || batch::convert(wide + 2, narrow, 1) != fp_flags::underflow
+        || batch::convert(wide + 3, narrow, 1) != fp_flags::none
+        || batch::convert(wide, narrow, 4) != (fp_flags::overflow | fp_flags::underflow)) {
+        throw std::exception("bad conversion flags");
+    }
+}
+
+void validate_arith16(thread_pool &pool)
+{
+    std::vector<float16_t> values(value_count), lhs(value_count), out(value_count);
+    for (size_t i = 0; i < value_count; ++i) {
+        values[i] = float16_t::from_bitstring(uint16_t(i));
+    }
+
+    for (size_t i = 0; i < value_count; i += 61)
+    {
+        float16_t a = values[i];
+        std::fill(lhs.begin(), lhs.end(), a);
+
+        batch::add(lhs.data(), values.data(), out.data(), value_count, pool);
+        for (size_t j = 0; j < value_count; ++j) {
+            if (out[j].to_bitstring() != (a + values[j]).to_bitstring()) fail(a, values[j], "bad add");
+        }
+
+        batch::sub(lhs.data(), values.data(), out.data(), value_count, pool);
+        for (size_t j = 0; j < value_count; ++j) {
+            if (out[j].to_bitstring() != (a - values[j]).to_bitstring()) fail(a, values[j], "bad sub");
+        }
+
+        batch::mul(lhs.data(), values.data(), out.data(), value_count, pool);
+        for (size_t j = 0; j < value_count; ++j) {
+            if (out[j].to_bitstring() != (a * values[j]).to_bitstring()) fail(a, values[j], "bad mul");
+        }
+
+        batch::div(lhs.data(), values.data(), out.data(), value_count, pool);
+        for (size_t j = 0; j < value_count; ++j) {
+            if (out[j].to_bitstring() != (a / values[j]).to_bitstring()) fail(a, values[j], "bad div");
+        }
+
+        if (i % 6100 == 0) {
+            cout << ".";
+        }
+    }
+
+    // conversions round-trip through float32
+    std::vector<float32_t> wide(value_count);
+    batch::convert(values.data(), wide.data(), value_count, pool);
+    batch::convert(wide.data(), out.data(), value_count, pool);
+    for (size_t j = 0; j < value_count; ++j) {
+        if (wide[j].to_bitstring() != static_cast<float32_t>(values[j]).to_bitstring()) fail(values[j], values[j], "bad widen");
+        if (out[j].to_bitstring() != static_cast<float16_t>(wide[j]).to_bitstring()) fail(values[j], out[j], "bad narrow");
+    }
+}
+
+void validate_determinism()
+{
+    // results and merged flags do not depend on the number of workers
+    std::vector<float32_t> a(1 << 18), b(a.size()), expected(a.size()), actual(a.size());
+    uint32_t state = 0x12345678;
+    for (size_t i = 0; i < a.size(); ++i) {
+        state = state * 1664525u + 1013904223u;
+        a[i] = float32_t::from_bitstring(state);
+        state = state * 1664525u + 1013904223u;
+        b[i] = float32_t::from_bitstring(state);
+    }
+
+    thread_pool serial(1);
+    fp_flags expected_flags = batch::mul(a.data(), b.data(), expected.data(), a.size(), serial);
+
+    for (unsigned threads : { 2u, 3u, 8u })
+    {
+        thread_pool pool(threads, threads == 2);
+        fp_flags flags = batch::mul(a.data(), b.data(), actual.data(), a.size(), pool);
+        if (flags != expected_flags || memcmp(expected.data(), actual.data(), expected.size() * sizeof(float32_t)) != 0) {
+            throw std::exception("bad determinism");
+        }
+    }
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool(4);
+
+        validate_parallel_for(pool);
+        validate_parallel_for(default_thread_pool());
+        validate_parallel_for_exception(pool);
+        validate_flags();
+        validate_determinism();
+        validate_arith16(pool);
+        cout << "\n";
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
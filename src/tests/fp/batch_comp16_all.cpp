@@ -0,0 +1,198 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <execution>
+#include <atomic>
+
+#include <limits>
+
+#include "swbatch.h"
+#include "../test_random.h"
+
+// disable constant arithmetic warnings
+#pragma warning(disable:4756)
+
+using std::cout;
+using std::endl;
+
+//
+// Validate batch comparison and classification kernels
+//  all 16-bit values against every 16-bit scalar, checked against the scalar operators
+//  32-bit and 64-bit pseudo-random values checked the same way
+//
+
+constexpr size_t value_count = std::numeric_limits<uint16_t>::max() + 1;
+
+template <typename fp_t>
+void fail(fp_t a, fp_t b, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+    cout << "b: " << b.to_hex_string() << " " << b.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+bool test_bit(const std::vector<uint64_t> &mask, size_t i)
+{
+    return (mask[i / 64] >> (i % 64)) & 1;
+}
+
+template<typename fp_t>
+void validate_masks(const fp_t *a, const fp_t *b, size_t count, bool scalar_rhs)
+{
+    std::vector<uint64_t> lt(batch::mask_words(count)), le(lt.size()), eq(lt.size()), ne(lt.size()), gt(lt.size()), ge(lt.size());
+
+    if (scalar_rhs) {
+        batch::lt(a, *b, count, lt.data());
+        batch::le(a, *b, count, le.data());
+        batch::eq(a, *b, count, eq.data());
+        batch::ne(a, *b, count, ne.data());
+        batch::gt(a, *b, count, gt.data());
+        batch::ge(a, *b, count, ge.data());
+    }
+    else {
+        batch::lt(a, b, count, lt.data());
+        batch::le(a, b, count, le.data());
+        batch::eq(a, b, count, eq.data());
+        batch::ne(a, b, count, ne.data());
+        batch::gt(a, b, count, gt.data());
+        batch::ge(a, b, count, ge.data());
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        fp_t x = a[i];
+        fp_t y = scalar_rhs ? *b : b[i];
+
+        if (test_bit(lt, i) != (x < y)) fail(x, y, "bad lt");
+        if (test_bit(le, i) != (x <= y)) fail(x, y, "bad le");
+        if (test_bit(eq, i) != (x == y)) fail(x, y, "bad eq");
+        if (test_bit(ne, i) != (x != y)) fail(x, y, "bad ne");
+        if (test_bit(gt, i) != (x > y)) fail(x, y, "bad gt");
+        if (test_bit(ge, i) != (x >= y)) fail(x, y, "bad ge");
+    }
+
+    // bits past the end must be clear
+    if (count % 64) {
+        uint64_t tail = ~((uint64_t(1) << (count % 64)) - 1);
+        if ((lt.back() | le.back() | eq.back() | ne.back() | gt.back() | ge.back()) & tail) {
+            fail(a[count - 1], scalar_rhs ? *b : b[count - 1], "bad tail");
+        }
+    }
+}
+
+template<typename fp_t>
+void validate_classify(const fp_t *a, size_t count)
+{
+    std::vector<uint64_t> nan(batch::mask_words(count)), inf(nan.size()), sub(nan.size());
+    batch::isnan(a, count, nan.data());
+    batch::isinf(a, count, inf.data());
+    batch::issubnormal(a, count, sub.data());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        fp_t x = a[i];
+        const fp_t min_normal = fp_t::from_triplet(0, 1, 0);
+        bool is_nan = (x != x);
+        bool is_inf = (x == fp_t::infinity(0)) || (x == fp_t::infinity(1));
+        bool is_subnormal = (x != fp_t::zero()) && (x < min_normal) && (x > -min_normal);
+
+        if (test_bit(nan, i) != is_nan) fail(x, x, "bad isnan");
+        if (test_bit(inf, i) != is_inf) fail(x, x, "bad isinf");
+        if (test_bit(sub, i) != is_subnormal) fail(x, x, "bad issubnormal");
+    }
+}
+
+template<typename fp_t, typename uint_t>
+std::vector<fp_t> make_values(size_t count, uint_t seed)
+{
+    // xorshift over the full bit pattern with a few interesting values mixed in
+    std::vector<fp_t> values(count);
+    xorshift64 rng(seed | 1);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = fp_t::from_bitstring(static_cast<uint_t>(rng()));
+    }
+
+    values[0] = fp_t::zero(0);
+    values[1] = fp_t::zero(1);
+    values[2] = fp_t::infinity(0);
+    values[3] = fp_t::infinity(1);
+    values[4] = fp_t::indeterminate_nan();
+    values[5] = fp_t::from_bitstring(1);
+    return values;
+}
+
+std::atomic<int> count = 0;
+
+int main()
+{
+    try
+    {
+        std::vector<float16_t> values(value_count);
+        for (size_t i = 0; i < value_count; ++i) {
+            values[i] = float16_t::from_bitstring(uint16_t(i));
+        }
+
+        validate_classify(values.data(), values.size());
+
+        // column-column with every alignment of the tail
+        std::vector<float16_t> rotated(values.rbegin(), values.rend());
+        for (size_t n = value_count - 70; n <= value_count; ++n) {
+            validate_masks(values.data(), rotated.data(), n, false);
+        }
+
+        // column-scalar for every scalar, parallelizing the outer loop
+        std::for_each(std::execution::par_unseq, values.begin(), values.end(), [&values](float16_t b) {
+            try
+            {
+                validate_masks(values.data(), &b, values.size(), true);
+
+                // output progress
+                int old_value = count.fetch_add(1);
+                if (old_value % 10000 == 0) {
+                    cout << "@";
+                }
+                else if (old_value % 1000 == 0) {
+                    cout << "$";
+                }
+                else if (old_value % 100 == 0) {
+                    cout << ".";
+                }
+            }
+            catch (std::exception e)
+            {
+                cout << "test failed: " << e.what() << endl;
+                std::terminate();
+            }
+        });
+        cout << "\n";
+
+        auto values32 = make_values<float32_t>(100003, uint32_t(0x1234567));
+        auto other32 = make_values<float32_t>(100003, uint32_t(0x7654321));
+        validate_classify(values32.data(), values32.size());
+        validate_masks(values32.data(), other32.data(), values32.size(), false);
+        for (size_t i = 0; i < 64; ++i) {
+            validate_masks(values32.data(), &other32[i], values32.size(), true);
+        }
+
+        auto values64 = make_values<float64_t>(10007, uint64_t(0x123456789abcdef));
+        auto other64 = make_values<float64_t>(10007, uint64_t(0xfedcba987654321));
+        validate_classify(values64.data(), values64.size());
+        validate_masks(values64.data(), other64.data(), values64.size(), false);
+        validate_masks(values64.data(), &other64[10], values64.size(), true);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
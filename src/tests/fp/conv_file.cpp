@@ -0,0 +1,203 @@
+
+#include <stdint.h>
+#include <stdio.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <limits>
+
+#include "swconv.h"
+
+// disable constant arithmetic warnings
+#pragma warning(disable:4756)
+
+using std::cout;
+using std::endl;
+
+//
+// Validate conversions to/from the bfloat16 and float8_e5m2 formats and the streaming file converter
+//  bfloat16 and float8_e5m2 are the upper halves of binary32 and binary16, so
+//  narrowing must match round-to-nearest-even applied to the wider bit pattern
+//  files converted in parallel windows match the scalar conversions
+//
+
+template <typename fp_t>
+void fail(fp_t a, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+uint16_t round_upper_half(uint32_t x) { return static_cast<uint16_t>((x + 0x7fff + ((x >> 16) & 1)) >> 16); }
+uint8_t round_upper_half(uint16_t x) { return static_cast<uint8_t>((x + 0x7f + ((x >> 8) & 1)) >> 8); }
+
+void validate_formats()
+{
+    // every bfloat16 widens exactly and narrows back
+    for (uint32_t i = 0; i <= std::numeric_limits<uint16_t>::max(); ++i) {
+        auto b = bfloat16_t::from_bitstring(uint16_t(i));
+        auto f = static_cast<float32_t>(b);
+        if (f.to_bitstring() != (i << 16)) fail(b, "bad bfloat16 -> binary32");
+        if (static_cast<bfloat16_t>(f).to_bitstring() != i) fail(b, "bad bfloat16 round-trip");
+    }
+
+    // binary32 -> bfloat16, including subnormals and overflow to infinity
+    for (uint64_t i = 0; i <= std::numeric_limits<uint32_t>::max(); i += 251) {
+        auto f = float32_t::from_bitstring(uint32_t(i));
+        if (f != f) {
+            continue;
+        }
+        if (static_cast<bfloat16_t>(f).to_bitstring() != round_upper_half(uint32_t(i))) fail(f, "bad binary32 -> bfloat16");
+    }
+
+    // every binary16 -> float8_e5m2, directly and from the wider formats
+    for (uint32_t i = 0; i <= std::numeric_limits<uint16_t>::max(); ++i) {
+        auto h = float16_t::from_bitstring(uint16_t(i));
+        if (h != h) {
+            continue;
+        }
+        uint8_t expected = round_upper_half(uint16_t(i));
+        if (static_cast<float8_e5m2_t>(h).to_bitstring() != expected) fail(h, "bad binary16 -> float8_e5m2");
+        if (static_cast<float8_e5m2_t>(static_cast<float32_t>(h)).to_bitstring() != expected) fail(h, "bad binary32 -> float8_e5m2");
+        if (static_cast<float8_e5m2_t>(static_cast<float64_t>(h)).to_bitstring() != expected) fail(h, "bad binary64 -> float8_e5m2");
+
+        // no intermediate double rounding between binary16 and bfloat16
+        if (static_cast<bfloat16_t>(h).to_bitstring() != round_upper_half(static_cast<float32_t>(h).to_bitstring())) fail(h, "bad binary16 -> bfloat16");
+    }
+
+    for (uint32_t i = 0; i <= std::numeric_limits<uint8_t>::max(); ++i) {
+        auto e = float8_e5m2_t::from_bitstring(uint8_t(i));
+        if (static_cast<float16_t>(e).to_bitstring() != (i << 8)) fail(e, "bad float8_e5m2 -> binary16");
+    }
+
+    // dropped bits below the narrow roundoff still break ties: 1 + 2^-11 + 2^-52 rounds up
+    auto above_tie = float64_t::from_bitstring(0x3ff0000000000000ull | (1ull << 41) | 1);
+    if (static_cast<float16_t>(above_tie).to_bitstring() != 0x3c01) fail(above_tie, "bad sticky rounding");
+}
+
+template<typename fp_t>
+void write_file(const char *path, const std::vector<fp_t> &values)
+{
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(fp_t));
+}
+
+template<typename fp_t>
+std::vector<fp_t> read_file(const char *path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    std::vector<fp_t> values(static_cast<size_t>(file.tellg()) / sizeof(fp_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(values.data()), values.size() * sizeof(fp_t));
+    return values;
+}
+
+template<fp_format from, fp_format to>
+void validate_file(const std::vector<floatbase_t<from>> &values, thread_pool &pool)
+{
+    const char *src_path = "conv_file_src.bin";
+    const char *dst_path = "conv_file_dst.bin";
+
+    write_file(src_path, values);
+    convert_stats stats = convert_file<from, to>(src_path, dst_path, pool);
+    auto converted = read_file<floatbase_t<to>>(dst_path);
+
+    std::vector<floatbase_t<to>> expected(values.size());
+    fp_flags expected_flags = fp_flags::none;
+    if constexpr (from == to) {
+        expected = values;
+    }
+    else {
+        expected_flags = batch::convert(values.data(), expected.data(), values.size());
+    }
+
+    if (stats.count != values.size() || converted.size() != values.size()
+        || stats.bytes_written != values.size() * sizeof(floatbase_t<to>)) {
+        throw std::exception("bad converted size");
+    }
+    if (stats.flags != expected_flags) {
+        throw std::exception("bad conversion flags");
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (converted[i].to_bitstring() != expected[i].to_bitstring()) fail(values[i], "bad file conversion");
+    }
+
+    remove(src_path);
+    remove(dst_path);
+}
+
+void validate_files()
+{
+    thread_pool pool(3);
+
+    std::vector<float16_t> all16(std::numeric_limits<uint16_t>::max() + 1);
+    for (size_t i = 0; i < all16.size(); ++i) {
+        all16[i] = float16_t::from_bitstring(uint16_t(i));
+    }
+    validate_file<fp_format::binary16, fp_format::binary32>(all16, pool);
+    validate_file<fp_format::binary16, fp_format::float8_e5m2>(all16, pool);
+    validate_file<fp_format::binary16, fp_format::binary16>(all16, pool);
+    cout << ".";
+
+    // more than one window with an odd tail
+    std::vector<float32_t> values(convert_window_bytes / sizeof(float32_t) + 12345);
+    uint32_t state = 0x12345678;
+    for (auto &v : values) {
+        state = state * 1664525u + 1013904223u;
+        v = float32_t::from_bitstring(state);
+    }
+    validate_file<fp_format::binary32, fp_format::bfloat16>(values, pool);
+    cout << ".";
+
+    values.resize(1001);
+    validate_file<fp_format::binary32, fp_format::binary16>(values, pool);
+    validate_file<fp_format::binary32, fp_format::float8_e5m2>(values, pool);
+    validate_file<fp_format::binary32, fp_format::binary64>(values, pool);
+    cout << ".";
+
+    // empty files convert to empty files
+    validate_file<fp_format::binary32, fp_format::bfloat16>(std::vector<float32_t>{}, pool);
+
+    // runtime formats, truncated input is rejected
+    fp_format from, to;
+    if (!parse_fp_format("fp16", from) || !parse_fp_format("bf16", to) || parse_fp_format("fp128", to)) {
+        throw std::exception("bad format names");
+    }
+    write_file("conv_file_src.bin", std::vector<uint8_t>(3));
+    bool rejected = false;
+    try {
+        convert_file("conv_file_src.bin", from, "conv_file_dst.bin", to, pool);
+    }
+    catch (std::exception) {
+        rejected = true;
+    }
+    remove("conv_file_src.bin");
+    remove("conv_file_dst.bin");
+    if (!rejected) {
+        throw std::exception("truncated input accepted");
+    }
+}
+
+int main()
+{
+    try
+    {
+        validate_formats();
+        validate_files();
+        cout << "\n";
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
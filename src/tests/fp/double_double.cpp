@@ -0,0 +1,247 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <limits>
+
+#define SWFP_DD_FLOAT128
+#include "swdd.h"
+#include "swaccum.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate double-double and quad-double arithmetic
+//  two_sum, fast_two_sum and two_product are error-free
+//  +, -, *, / and sqrt are accurate to about 2^-104 (dd) and 2^-208 (qd):
+//  the residual of every result is computed exactly with the long accumulator
+//  special values, batch kernels
+//
+
+void fail(double a, double b, double residual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a << " b: " << b << " residual: " << residual << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+// random value in +-[2^-20, 2^20)
+float64_t random_value()
+{
+    const uint64_t exponent = 1023 - 20 + next() % 40;
+    return float64_t::from_bitstring((next() & 0x800fffffffffffffull) | (exponent << 52));
+}
+
+// a value at most ulp(x) / 2 below x
+float64_t random_tail(float64_t x)
+{
+    const uint64_t bits = x.to_bitstring();
+    const uint64_t exponent = ((bits >> 52) & 0x7ff) - 54 - next() % 4;
+    return float64_t::from_bitstring((next() & 0x800fffffffffffffull) | (exponent << 52));
+}
+
+dd64_t random_dd()
+{
+    const float64_t hi = random_value();
+    float64_t e;
+    const float64_t s = fast_two_sum(hi, random_tail(hi), e);
+    return { s, e };
+}
+
+qd64_t random_qd()
+{
+    const float64_t x0 = random_value();
+    const float64_t x1 = random_tail(x0);
+    const float64_t x2 = random_tail(x1);
+    return qd64_t::renormalize(x0, x1, x2, random_tail(x2), float64_t(0.0));
+}
+
+// |residual| <= 2^-bits * |reference|
+void check_residual(long_accumulator<fp_format::binary64> &residual, float64_t reference, int bits, char const *what)
+{
+    double r = static_cast<double>(residual.round());
+    double bound = static_cast<double>(reference);
+    for (int i = 0; i < bits; ++i) bound /= 2;
+    if (r < 0) r = -r;
+    if (bound < 0) bound = -bound;
+    if (r > bound) fail(static_cast<double>(reference), bound, r, what);
+}
+
+template<typename multi_t>
+void add_to(long_accumulator<fp_format::binary64> &acc, const multi_t &x, bool negate)
+{
+    if constexpr (std::is_same_v<multi_t, dd64_t>) {
+        acc.add(negate ? -x.hi : x.hi);
+        acc.add(negate ? -x.lo : x.lo);
+    }
+    else {
+        for (auto c : x.x) acc.add(negate ? -c : c);
+    }
+}
+
+// acc += sign * a * b, exact
+template<typename multi_t>
+void add_product_to(long_accumulator<fp_format::binary64> &acc, const multi_t &a, const multi_t &b, bool negate)
+{
+    if constexpr (std::is_same_v<multi_t, dd64_t>) {
+        float64_t x[] = { a.hi, a.lo }, y[] = { b.hi, b.lo };
+        for (auto u : x) for (auto v : y) acc.add_product(negate ? -u : u, v);
+    }
+    else {
+        for (auto u : a.x) for (auto v : b.x) acc.add_product(negate ? -u : u, v);
+    }
+}
+
+void validate_transformations(uint64_t samples)
+{
+    for (uint64_t i = 0; i < samples; ++i) {
+        const float64_t a = random_value(), b = random_value();
+        float64_t e;
+
+        long_accumulator<fp_format::binary64> acc;
+        const float64_t s = two_sum(a, b, e);
+        acc.add(a); acc.add(b); acc.add(-s); acc.add(-e);
+        if (acc.round() != float64_t(0.0)) fail(static_cast<double>(a), static_cast<double>(b), static_cast<double>(acc.round()), "two_sum");
+
+        acc.clear();
+        const float64_t big = static_cast<double>(a) < 0 ? -a : a;
+        const float64_t small = random_tail(big);
+        const float64_t f = fast_two_sum(big, small, e);
+        acc.add(big); acc.add(small); acc.add(-f); acc.add(-e);
+        if (acc.round() != float64_t(0.0)) fail(static_cast<double>(big), static_cast<double>(small), static_cast<double>(acc.round()), "fast_two_sum");
+
+        acc.clear();
+        const float64_t p = two_product(a, b, e);
+        acc.add_product(a, b); acc.add(-p); acc.add(-e);
+        if (acc.round() != float64_t(0.0)) fail(static_cast<double>(a), static_cast<double>(b), static_cast<double>(acc.round()), "two_product");
+    }
+}
+
+template<typename multi_t>
+void validate_arithmetic(multi_t a, multi_t b, int bits)
+{
+    using acc_t = long_accumulator<fp_format::binary64>;
+    const double da = static_cast<double>(a), db = static_cast<double>(b);
+
+    // c - (a + b)
+    multi_t c = a + b;
+    acc_t acc;
+    add_to(acc, c, false); add_to(acc, a, true); add_to(acc, b, true);
+    check_residual(acc, float64_t((da < 0 ? -da : da) + (db < 0 ? -db : db)), bits, "add");
+
+    // c - (a - b)
+    c = a - b;
+    acc.clear();
+    add_to(acc, c, false); add_to(acc, a, true); add_to(acc, b, false);
+    check_residual(acc, float64_t((da < 0 ? -da : da) + (db < 0 ? -db : db)), bits, "sub");
+
+    // c - a * b
+    c = a * b;
+    acc.clear();
+    add_to(acc, c, false); add_product_to(acc, a, b, true);
+    check_residual(acc, float64_t(da * db), bits, "mul");
+
+    // a - b * c
+    c = a / b;
+    acc.clear();
+    add_to(acc, a, false); add_product_to(acc, b, c, true);
+    check_residual(acc, float64_t(da), bits, "div");
+
+    // |a| - c * c
+    const multi_t abs_a = da < 0 ? -a : a;
+    c = sqrt(abs_a);
+    acc.clear();
+    add_to(acc, abs_a, false); add_product_to(acc, c, c, true);
+    check_residual(acc, float64_t(da < 0 ? -da : da), bits, "sqrt");
+}
+
+template<typename multi_t>
+void validate_specials()
+{
+    const float64_t inf = float64_t::infinity(), zero(0.0), one(1.0);
+
+    if (static_cast<double>(multi_t(inf) + multi_t(one)) != static_cast<double>(inf)) throw std::exception("inf + 1");
+    if (static_cast<double>(multi_t(inf) * multi_t(-one)) != -static_cast<double>(inf)) throw std::exception("inf * -1");
+    if (static_cast<double>(multi_t(one) / multi_t(zero)) != static_cast<double>(inf)) throw std::exception("1 / 0");
+    if (static_cast<double>(sqrt(multi_t(inf))) != static_cast<double>(inf)) throw std::exception("sqrt(inf)");
+    if (static_cast<double>(sqrt(multi_t(zero))) != 0) throw std::exception("sqrt(0)");
+
+    double nan = static_cast<double>(sqrt(multi_t(-one)));
+    if (nan == nan) throw std::exception("sqrt(-1)");
+    nan = static_cast<double>(multi_t(inf) - multi_t(inf));
+    if (nan == nan) throw std::exception("inf - inf");
+}
+
+int main()
+{
+    try
+    {
+        validate_transformations(1000000);
+
+        for (int i = 0; i < 200000; ++i) {
+            validate_arithmetic(random_dd(), random_dd(), 103);
+        }
+        for (int i = 0; i < 20000; ++i) {
+            validate_arithmetic(random_qd(), random_qd(), 205);
+        }
+
+        validate_specials<dd64_t>();
+        validate_specials<qd64_t>();
+
+        // (1 + 2^-80) - 1 is lost in binary64 and kept in double-double
+        const float64_t one(1.0), tiny(0x1p-80);
+        const float128_t x = float128_t(one) + float128_t(tiny) - float128_t(one);
+        if (static_cast<double>(x) != 0x1p-80 || static_cast<double>((one + tiny) - one) != 0) {
+            throw std::exception("double-double precision");
+        }
+
+        // (1 + 2^-80)^2 = 1 + 2^-79 + 2^-160: the last term needs a quad-double
+        const qd64_t y = qd64_t(one) + qd64_t(tiny);
+        const qd64_t square = y * y;
+        if (static_cast<double>(square.x[0]) != 1 || static_cast<double>(square.x[1]) != 0x1p-79 || static_cast<double>(square.x[2]) != 0x1p-160) {
+            throw std::exception("quad-double precision");
+        }
+
+        // batch kernels match the operators
+        const size_t count = 10000;
+        std::vector<dd64_t> a(count), b(count), out(count);
+        for (size_t i = 0; i < count; ++i) {
+            a[i] = random_dd();
+            b[i] = random_dd();
+        }
+        thread_pool pool(4);
+        batch::mul(a.data(), b.data(), out.data(), count, pool);
+        for (size_t i = 0; i < count; ++i) {
+            if (out[i] != a[i] * b[i]) throw std::exception("batch::mul");
+        }
+        batch::div(a.data(), b.data(), out.data(), count, pool);
+        for (size_t i = 0; i < count; ++i) {
+            if (out[i] != a[i] / b[i]) throw std::exception("batch::div");
+        }
+
+        std::vector<qd64_t> qa(count), qout(count);
+        for (auto &q : qa) {
+            q = random_qd();
+            if (static_cast<double>(q) < 0) q = -q;
+        }
+        batch::sqrt(qa.data(), qout.data(), count, pool);
+        for (size_t i = 0; i < count; ++i) {
+            if (qout[i] != sqrt(qa[i])) throw std::exception("batch::sqrt");
+        }
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,434 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cmath>
+
+#include <limits>
+
+#include "swfixed.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate fixed_t for built-in and intbase_t storage, every rounding and overflow policy
+//  add, sub, mul and div against exact rational results rounded in int256sw_t
+//  mul, div and integral values for every pair of 8-bit raw values
+//  conversions from every binary16 and bfloat16 value and random binary32 and
+//  binary64 values against double references
+//  conversions to floatbase_t against a single rounding of the exact value
+//  batch kernels match the scalar operators for any thread count
+//
+
+using ref_t = int256sw_t;
+
+template<typename fixed_t>
+constexpr int value_bits() { return fixed_t::integer_bits + fixed_t::fraction_bits + 1; }
+
+// raw values with every magnitude and the edges of the range
+template<typename fixed_t>
+fixed_t random_fixed()
+{
+    using storage_t = typename fixed_t::storage_type;
+    constexpr int bits = value_bits<fixed_t>();
+
+    switch (next() % 8) {
+    case 0: return fixed_t::max();
+    case 1: return fixed_t::min();
+    case 2: return fixed_t::from_raw(storage_t(static_cast<int64_t>(next() % 7) - 3));
+    default: break;
+    }
+
+    uint64_t limbs[(sizeof(storage_t) + 7) / 8];
+    for (auto &limb : limbs) {
+        limb = next();
+    }
+    storage_t raw;
+    memcpy(&raw, limbs, sizeof(raw));
+
+    // sign-extend a random number of low bits
+    const int width = 1 + static_cast<int>(next() % bits);
+    const int unused = static_cast<int>(sizeof(storage_t) * 8) - width;
+    if constexpr (std::is_integral_v<storage_t>) {
+        using uint_t = std::make_unsigned_t<storage_t>;
+        raw = static_cast<storage_t>(static_cast<storage_t>(static_cast<uint_t>(static_cast<uint_t>(raw) << unused)) >> unused);
+    }
+    else {
+        raw = (raw << unused) >> unused;
+    }
+    return fixed_t::from_raw(raw);
+}
+
+template<typename storage_t>
+ref_t to_ref(storage_t x)
+{
+    if constexpr (std::is_integral_v<storage_t>) {
+        return ref_t(static_cast<int64_t>(x));
+    }
+    else {
+        uint8_t bytes[sizeof(ref_t)];
+        memset(bytes, x < storage_t(0) ? 0xff : 0, sizeof(bytes));
+        memcpy(bytes, &x, sizeof(x));
+        ref_t r;
+        memcpy(&r, bytes, sizeof(r));
+        return r;
+    }
+}
+
+// num / den rounded and brought into range by the policies of fixed_t, den > 0
+template<typename fixed_t>
+ref_t reference_round(ref_t num, ref_t den)
+{
+    constexpr int bits = value_bits<fixed_t>();
+
+    ref_t q = num / den, r = num % den;
+    if (r < ref_t(0)) {
+        q -= ref_t(1);
+        r += den;
+    }
+
+    bool increment = false;
+    switch (fixed_t::rounding_mode) {
+    case fixed_rounding::toward_zero: increment = num < ref_t(0) && r != ref_t(0); break;
+    case fixed_rounding::down: break;
+    case fixed_rounding::nearest_up: increment = !(r + r < den); break;
+    case fixed_rounding::nearest_even: increment = den < r + r || (r + r == den && !!(q & ref_t(1))); break;
+    }
+    if (increment) {
+        q += ref_t(1);
+    }
+
+    const ref_t limit = ref_t(1) << (bits - 1);
+    if (fixed_t::overflow_mode == fixed_overflow::saturate) {
+        if (!(q < limit)) {
+            return limit - ref_t(1);
+        }
+        if (q < ref_t(0) - limit) {
+            return ref_t(0) - limit;
+        }
+        return q;
+    }
+    q = q & ((limit << 1) - ref_t(1));
+    return q < limit ? q : q - (limit << 1);
+}
+
+template<typename fixed_t>
+void validate_arithmetic(int count)
+{
+    constexpr int n = fixed_t::fraction_bits;
+    const ref_t one(1);
+
+    for (int i = 0; i < count; ++i) {
+        const fixed_t a = random_fixed<fixed_t>(), b = random_fixed<fixed_t>();
+        const ref_t ra = to_ref(a.raw()), rb = to_ref(b.raw());
+
+        if (to_ref((a + b).raw()) != reference_round<fixed_t>(ra + rb, one)) throw std::exception("add");
+        if (to_ref((a - b).raw()) != reference_round<fixed_t>(ra - rb, one)) throw std::exception("sub");
+        if (to_ref((-a).raw()) != reference_round<fixed_t>(ref_t(0) - ra, one)) throw std::exception("negate");
+        if (to_ref((a * b).raw()) != reference_round<fixed_t>(ra * rb, one << n)) {
+            cout << "a = " << ref_t::to_string(ra) << ", b = " << ref_t::to_string(rb) << ", a * b = " << ref_t::to_string(to_ref((a * b).raw())) << endl;
+            throw std::exception("mul");
+        }
+
+        if (b.raw() != typename fixed_t::storage_type(0)) {
+            const ref_t num = rb < ref_t(0) ? ref_t(0) - (ra << n) : ra << n;
+            const ref_t den = rb < ref_t(0) ? ref_t(0) - rb : rb;
+            if (to_ref((a / b).raw()) != reference_round<fixed_t>(num, den)) {
+                cout << "a = " << ref_t::to_string(ra) << ", b = " << ref_t::to_string(rb) << ", a / b = " << ref_t::to_string(to_ref((a / b).raw())) << endl;
+                throw std::exception("div");
+            }
+        }
+
+        if ((a < b) != (ra < rb) || (a == b) != (ra == rb) || (a >= b) != !(ra < rb)) throw std::exception("compare");
+    }
+
+    // integral values
+    const int64_t integers[] = { 0, 1, -1, 3, -7, 100, -100, 40000, -40000, int64_t(1) << 40, INT64_MIN, INT64_MAX };
+    for (int64_t x : integers) {
+        if (to_ref(fixed_t(x).raw()) != reference_round<fixed_t>(ref_t(x) << n, one)) throw std::exception("from integer");
+    }
+}
+
+// every pair of raw values of an 8-bit type: the integral constructor, products and
+// quotients shift negative values left in the 16-bit wide type
+template<typename fixed_t>
+void validate_small_negative()
+{
+    using storage_t = typename fixed_t::storage_type;
+    constexpr int n = fixed_t::fraction_bits;
+    const ref_t one(1);
+
+    for (int x = -20; x <= 20; ++x) {
+        if (to_ref(fixed_t(x).raw()) != reference_round<fixed_t>(ref_t(x) << n, one)) throw std::exception("small from integer");
+    }
+
+    for (int i = -128; i < 128; ++i) {
+        for (int j = -128; j < 128; ++j) {
+            const fixed_t a = fixed_t::from_raw(static_cast<storage_t>(i)), b = fixed_t::from_raw(static_cast<storage_t>(j));
+            const ref_t ra(i), rb(j);
+            if (to_ref((a * b).raw()) != reference_round<fixed_t>(ra * rb, one << n)) throw std::exception("small mul");
+            if (j != 0) {
+                const ref_t num = j < 0 ? ref_t(0) - (ra << n) : ra << n;
+                if (to_ref((a / b).raw()) != reference_round<fixed_t>(num, j < 0 ? ref_t(-j) : rb)) throw std::exception("small div");
+            }
+        }
+    }
+}
+
+// x * 2^n rounded and brought into range by the policies of fixed_t, from a double
+template<typename fixed_t>
+ref_t reference_from_double(double v)
+{
+    constexpr int bits = value_bits<fixed_t>();
+    const ref_t limit = ref_t(1) << (bits - 1);
+
+    if (std::isnan(v)) {
+        return ref_t(0);
+    }
+    if (std::isinf(v)) {
+        return v < 0 ? ref_t(0) - limit : limit - ref_t(1);
+    }
+
+    // scaled past the double range the value is a multiple of 2^128
+    const double s = std::ldexp(v, fixed_t::fraction_bits);
+    if (std::isinf(s)) {
+        return fixed_t::overflow_mode == fixed_overflow::wrap ? ref_t(0) : v < 0 ? ref_t(0) - limit : limit - ref_t(1);
+    }
+    const double floor = std::floor(s), fraction = s - floor;
+    double rounded = floor;
+    switch (fixed_t::rounding_mode) {
+    case fixed_rounding::toward_zero: rounded = std::trunc(s); break;
+    case fixed_rounding::down: break;
+    case fixed_rounding::nearest_up: rounded = fraction >= 0.5 ? floor + 1 : floor; break;
+    case fixed_rounding::nearest_even: rounded = (fraction > 0.5 || (fraction == 0.5 && std::fmod(floor, 2) != 0)) ? floor + 1 : floor; break;
+    }
+
+    // the magnitude modulo 2^128 as two exact 64-bit pieces
+    const double magnitude = std::fabs(rounded);
+    const double high = std::floor(std::fmod(magnitude, 0x1p128) / 0x1p64);
+    const double low = std::fmod(magnitude, 0x1p64);
+    ref_t r = (ref_t(static_cast<uint64_t>(high)) << 64) + ref_t(static_cast<uint64_t>(low));
+    if (rounded < 0) {
+        r = ref_t(0) - r;
+    }
+
+    if (fixed_t::overflow_mode == fixed_overflow::saturate) {
+        if (rounded >= std::ldexp(1.0, bits - 1)) {
+            return limit - ref_t(1);
+        }
+        return rounded < -std::ldexp(1.0, bits - 1) ? ref_t(0) - limit : r;
+    }
+    r = r & ((limit << 1) - ref_t(1));
+    return r < limit ? r : r - (limit << 1);
+}
+
+template<typename fixed_t, fp_format format>
+void validate_from_float(floatbase_t<format> x)
+{
+    const double v = static_cast<double>(x);
+    if (to_ref(fixed_t(x).raw()) != reference_from_double<fixed_t>(v)) {
+        cout << "x = " << x.to_hex_string() << " " << v << endl;
+        cout << "fixed: " << ref_t::to_string(to_ref(fixed_t(x).raw())) << ", expected " << ref_t::to_string(reference_from_double<fixed_t>(v)) << endl;
+        throw std::exception("from floatbase_t");
+    }
+}
+
+template<typename fixed_t>
+void validate_from_float16()
+{
+    for (uint32_t bits = 0; bits < 0x10000; ++bits) {
+        validate_from_float<fixed_t>(float16_t::from_bitstring(static_cast<uint16_t>(bits)));
+        validate_from_float<fixed_t>(bfloat16_t::from_bitstring(static_cast<uint16_t>(bits)));
+    }
+    for (uint32_t bits = 0; bits < 0x100; ++bits) {
+        validate_from_float<fixed_t>(float8_e5m2_t::from_bitstring(static_cast<uint8_t>(bits)));
+    }
+}
+
+// binary32 and binary64 values near the range and the resolution of fixed_t
+template<typename fixed_t>
+void validate_from_float_random(int count)
+{
+    constexpr int n = fixed_t::fraction_bits, m = fixed_t::integer_bits;
+
+    for (int i = 0; i < count; ++i) {
+        const int exponent = -n - 3 + static_cast<int>(next() % (m + n + 8));
+        const double v = std::ldexp(static_cast<double>(next() >> 11) / 0x1p53 + 1, exponent) * (next() & 1 ? -1 : 1);
+        validate_from_float<fixed_t>(float64_t(v));
+        validate_from_float<fixed_t>(float32_t(static_cast<float>(v)));
+
+        // ties of the rounding
+        const double tie = std::ldexp(static_cast<double>(static_cast<int64_t>(next() % 64) - 32) + 0.5, -n);
+        validate_from_float<fixed_t>(float64_t(tie));
+    }
+
+    validate_from_float<fixed_t>(float64_t(std::numeric_limits<double>::max()));
+    validate_from_float<fixed_t>(float64_t(-std::numeric_limits<double>::max()));
+    validate_from_float<fixed_t>(float64_t(std::numeric_limits<double>::denorm_min()));
+}
+
+// raw * 2^-n rounded once into `format`: the raw value rounded to odd in 62
+// bits rounds to binary64 like the exact value, and rounded to odd in 52 bits
+// is exact in binary64 and rounds to the narrower formats like the exact value
+template<fp_format format, typename fixed_t>
+floatbase_t<format> reference_to_float(fixed_t x)
+{
+    const int precision = format == fp_format::binary64 ? 62 : 52;
+    ref_t r = to_ref(x.raw());
+    const bool negative = r < ref_t(0);
+    if (negative) {
+        r = ref_t(0) - r;
+    }
+
+    int shift = 0;
+    bool sticky = false;
+    while (!(r < (ref_t(1) << precision))) {
+        sticky |= !!(r & ref_t(1));
+        r = r >> 1;
+        ++shift;
+    }
+    int64_t odd = static_cast<int64_t>(r) | (sticky ? 1 : 0);
+    if (negative) {
+        odd = -odd;
+    }
+
+    const float64_t wide = float64_t(odd) * float64_t(std::ldexp(1.0, shift - fixed_t::fraction_bits));
+    return static_cast<floatbase_t<format>>(wide);
+}
+
+template<typename fixed_t, fp_format format>
+void validate_to_float(fixed_t x)
+{
+    const floatbase_t<format> actual = static_cast<floatbase_t<format>>(x);
+    const floatbase_t<format> expected = reference_to_float<format>(x);
+    if (actual.to_bitstring() != expected.to_bitstring()) {
+        cout << "x = " << ref_t::to_string(to_ref(x.raw())) << endl;
+        cout << "actual " << actual.to_hex_string() << ", expected " << expected.to_hex_string() << endl;
+        throw std::exception("to floatbase_t");
+    }
+}
+
+template<typename fixed_t>
+void validate_to_float(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const fixed_t x = random_fixed<fixed_t>();
+        validate_to_float<fixed_t, fp_format::binary64>(x);
+        validate_to_float<fixed_t, fp_format::binary32>(x);
+        validate_to_float<fixed_t, fp_format::binary16>(x);
+        validate_to_float<fixed_t, fp_format::bfloat16>(x);
+        validate_to_float<fixed_t, fp_format::float8_e5m2>(x);
+
+        // binary64 holds up to 53 bits exactly and converts back
+        if constexpr (value_bits<fixed_t>() <= 53) {
+            if (fixed_t(static_cast<float64_t>(x)) != x) throw std::exception("binary64 round trip");
+        }
+    }
+}
+
+template<typename fixed_t>
+void validate_batch(thread_pool &pool1, thread_pool &pool4)
+{
+    const size_t count = 10007;
+    std::vector<fixed_t> a(count), b(count), out1(count), out4(count);
+    std::vector<float32_t> f(count), f1(count), f4(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = random_fixed<fixed_t>();
+        b[i] = random_fixed<fixed_t>();
+        if (b[i].raw() == typename fixed_t::storage_type(0)) {
+            b[i] = fixed_t::epsilon();
+        }
+        f[i] = float32_t(static_cast<float>(std::ldexp(static_cast<double>(static_cast<int64_t>(next())), -60)));
+    }
+
+#define VALIDATE_BATCH(name, op)                                                                                    \
+    batch::name(a.data(), b.data(), out1.data(), count, pool1);                                                     \
+    batch::name(a.data(), b.data(), out4.data(), count, pool4);                                                     \
+    for (size_t i = 0; i < count; ++i) {                                                                            \
+        if (out1[i] != (a[i] op b[i]) || out4[i] != out1[i]) throw std::exception("batch " #name);                  \
+    }                                                                                                               \
+
+    VALIDATE_BATCH(add, +)
+    VALIDATE_BATCH(sub, -)
+    VALIDATE_BATCH(mul, *)
+    VALIDATE_BATCH(div, /)
+
+#undef VALIDATE_BATCH
+
+    batch::convert(f.data(), out1.data(), count, pool1);
+    batch::convert(f.data(), out4.data(), count, pool4);
+    batch::convert(a.data(), f1.data(), count, pool1);
+    batch::convert(a.data(), f4.data(), count, pool4);
+    for (size_t i = 0; i < count; ++i) {
+        if (out1[i] != fixed_t(f[i]) || out4[i] != out1[i]) throw std::exception("batch convert to fixed");
+        if (f1[i].to_bitstring() != static_cast<float32_t>(a[i]).to_bitstring() || f4[i].to_bitstring() != f1[i].to_bitstring()) throw std::exception("batch convert to float");
+    }
+}
+
+template<int int_bits, int frac_bits, typename storage_t, fixed_rounding rounding, fixed_overflow overflow>
+void validate_type(int count, bool small)
+{
+    using fixed_type = fixed_t<int_bits, frac_bits, storage_t, rounding, overflow>;
+
+    validate_arithmetic<fixed_type>(count);
+    validate_to_float<fixed_type>(count);
+    validate_from_float_random<fixed_type>(count);
+    if (small) {
+        validate_from_float16<fixed_type>();
+    }
+}
+
+template<int int_bits, int frac_bits, typename storage_t = details::fixed_storage_t<int_bits + frac_bits + 1>>
+void validate_policies(int count, bool small = false)
+{
+    validate_type<int_bits, frac_bits, storage_t, fixed_rounding::toward_zero, fixed_overflow::wrap>(count, small);
+    validate_type<int_bits, frac_bits, storage_t, fixed_rounding::down, fixed_overflow::wrap>(count, small);
+    validate_type<int_bits, frac_bits, storage_t, fixed_rounding::nearest_up, fixed_overflow::wrap>(count, small);
+    validate_type<int_bits, frac_bits, storage_t, fixed_rounding::nearest_even, fixed_overflow::wrap>(count, small);
+    validate_type<int_bits, frac_bits, storage_t, fixed_rounding::toward_zero, fixed_overflow::saturate>(count, small);
+    validate_type<int_bits, frac_bits, storage_t, fixed_rounding::down, fixed_overflow::saturate>(count, small);
+    validate_type<int_bits, frac_bits, storage_t, fixed_rounding::nearest_up, fixed_overflow::saturate>(count, small);
+    validate_type<int_bits, frac_bits, storage_t, fixed_rounding::nearest_even, fixed_overflow::saturate>(count, small);
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool1(1), pool4(4);
+
+        static_assert(std::is_same_v<fixed_t<0, 15>::storage_type, int16_t>, "Q0.15 in int16_t");
+        static_assert(std::is_same_v<fixed_t<20, 40>::storage_type, int64_t>, "Q20.40 in int64_t");
+        static_assert(std::is_same_v<fixed_t<40, 80>::storage_type, int128sw_t>, "Q40.80 in int128sw_t");
+
+        // full and partly used storage of every kind
+        validate_policies<0, 15>(20000, true);
+        validate_policies<3, 10>(20000, true);
+        validate_policies<7, 24>(20000);
+        validate_policies<20, 40>(10000);
+        validate_policies<31, 32>(10000);
+        validate_policies<40, 80>(5000);
+        validate_policies<63, 64>(5000);
+        validate_policies<15, 16, int64sw_t>(5000);
+        validate_small_negative<fixed_t<3, 4>>();
+        validate_small_negative<fixed_t<3, 4, int8_t, fixed_rounding::down, fixed_overflow::wrap>>();
+        validate_small_negative<fixed_t<0, 7, int8_t, fixed_rounding::toward_zero, fixed_overflow::wrap>>();
+
+        validate_batch<fixed_t<0, 15>>(pool1, pool4);
+        validate_batch<fixed_t<31, 32, int64_t, fixed_rounding::down, fixed_overflow::wrap>>(pool1, pool4);
+        validate_batch<fixed_t<40, 80>>(pool1, pool4);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,159 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <limits>
+
+#include "swexpr.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate fused expressions
+//  a*b + c, a*b - c*d and sum(x*y) round once, other expressions match the
+//  floatbase_t operators; the reference is computed in HW at 64-bit whenever
+//  that is exact
+//
+
+template <typename fp_t>
+void fail(fp_t a, fp_t b, fp_t expected, fp_t actual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+    cout << "b: " << b.to_hex_string() << " " << b.to_triplet_string() << endl;
+    cout << "expected: " << expected.to_hex_string() << " " << expected.to_triplet_string() << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+// a + b in double, false if the sum is inexact
+bool exact_sum(double a, double b, double &sum)
+{
+    sum = a + b;
+    if (sum != sum || sum - sum != 0) {
+        return true;
+    }
+
+    double bb = sum - a;
+    return (a - (sum - bb)) + (b - bb) == 0;
+}
+
+template<fp_format format>
+void check(floatbase_t<format> a, floatbase_t<format> b, double exact, floatbase_t<format> actual, char const *what)
+{
+    auto expected = static_cast<floatbase_t<format>>(float64_t(exact));
+    if (exact != exact) {
+        if (static_cast<double>(actual) == static_cast<double>(actual)) fail(a, b, expected, actual, what);
+    }
+    else if (expected.to_bitstring() != actual.to_bitstring()) {
+        fail(a, b, expected, actual, what);
+    }
+}
+
+template<fp_format format>
+void check_same(floatbase_t<format> a, floatbase_t<format> b, floatbase_t<format> expected, floatbase_t<format> actual, char const *what)
+{
+    if (expected.to_bitstring() != actual.to_bitstring()) fail(a, b, expected, actual, what);
+}
+
+template<fp_format format>
+void validate_expressions(fused_t<format> a, fused_t<format> b, fused_t<format> c, fused_t<format> d)
+{
+    using fp_t = floatbase_t<format>;
+    double w = static_cast<double>(a), x = static_cast<double>(b), y = static_cast<double>(c), z = static_cast<double>(d);
+    double exact;
+
+    // fused forms
+    if (exact_sum(w * x, y, exact)) {
+        fp_t r = a * b + c;
+        check(a, b, exact, r, "a*b + c");
+        check(a, b, exact, fused_fma<format>(a, b, c), "fused_fma");
+    }
+    if (exact_sum(y, -w * x, exact)) {
+        fp_t r = c - a * b;
+        check(a, b, exact, r, "c - a*b");
+    }
+    if (exact_sum(w * x, -y * z, exact)) {
+        fp_t r = a * b - c * d;
+        check(a, b, exact, r, "a*b - c*d");
+    }
+
+    // a plain floatbase_t addend fuses too
+    fp_t plain = c;
+    if (exact_sum(w * x, y, exact)) {
+        fp_t r = a * b + plain;
+        check(a, b, exact, r, "a*b + plain");
+    }
+
+    // everything else is evaluated an operator at a time
+    fp_t pa = a, pb = b, pc = c;
+    check_same(a, b, pa + pb, a + b, "a + b");
+    check_same(a, b, pa / pb, a / b, "a / b");
+    check_same(a, b, (pa * pb) * pc, a * b * c, "a*b*c");
+    check_same(a, b, (pa + pb) * pc, fp_t((a + b) * c), "(a + b)*c");
+    check_same(a, b, -pa, -a, "-a");
+}
+
+template<fp_format format, typename uint_t>
+void validate_format(uint64_t samples)
+{
+    using fp_t = fused_t<format>;
+
+    xorshift64 rng;
+    auto next = [&]() { return fp_t(floatbase_t<format>::from_bitstring(static_cast<uint_t>(rng()))); };
+
+    for (uint64_t i = 0; i < samples; ++i) {
+        auto a = next(), b = next(), c = next(), d = next();
+        validate_expressions(a, b, c, d);
+    }
+
+    // dot products and sums of small integers
+    std::vector<floatbase_t<format>> p, q;
+    for (int i = 1; i <= 8; ++i) {
+        p.push_back(floatbase_t<format>(i));
+        q.push_back(floatbase_t<format>(i % 2 ? i : -i));
+    }
+    floatbase_t<format> r = sum(fused(p) * fused(q));
+    if (r.to_bitstring() != floatbase_t<format>(-36.0).to_bitstring()) {
+        throw std::exception("bad dot");
+    }
+    floatbase_t<format> s = sum(fused(p));
+    if (s.to_bitstring() != floatbase_t<format>(36.0).to_bitstring()) {
+        throw std::exception("bad sum");
+    }
+}
+
+int main()
+{
+    try
+    {
+        validate_format<fp_format::binary16, uint16_t>(2000000);
+        validate_format<fp_format::bfloat16, uint16_t>(2000000);
+        validate_format<fp_format::float8_e5m2, uint8_t>(200000);
+
+        // with u = 1 + 2^-10 and v = 1 + 2^-9, u*u - v is 2^-20, rounding
+        // the products first gives 0
+        fused16_t u = float16_t(1.0009765625f), v = float16_t(1.001953125f), one = float16_t(1.0f);
+        float16_t r = u * u - v * one;
+        std::vector<float16_t> x = { u, v }, y = { u, -one };
+        float16_t dot = sum(fused(x) * fused(y));
+        if (static_cast<float>(r) != 0x1p-20f || static_cast<float>(dot) != 0x1p-20f || static_cast<float>(float16_t(u * u) - v) != 0) {
+            throw std::exception("bad single rounding");
+        }
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,142 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <limits>
+
+#include "swgemm.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the mixed-precision gemm
+//  every element matches a triple loop of fma_wide in order of k, for the
+//  hardware and the soft kernels, any blocking and any thread count
+//  the inputs are random encodings: subnormals, overflow, infinities and NaNs
+//
+
+template <typename fp_t>
+void fail(size_t i, size_t j, fp_t expected, fp_t actual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "element: " << i << ", " << j << endl;
+    cout << "expected: " << expected.to_hex_string() << " " << expected.to_triplet_string() << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+// random encodings, or values near 1 that cancel less
+template<fp_format format>
+std::vector<floatbase_t<format>> random_matrix(size_t count, bool any_encoding)
+{
+    using uint_t = typename fp_traits<format>::uint_t;
+    constexpr int significand_bitsize = unpacked_t<format>::precision - 1;
+
+    std::vector<floatbase_t<format>> x(count);
+    for (auto &v : x) {
+        uint_t bits = static_cast<uint_t>(next());
+        if (!any_encoding) {
+            // exponents in [-4, 3]
+            const uint_t exponent = static_cast<uint_t>(fp_traits<format>::bias - 4 + next() % 8);
+            const uint_t sign = static_cast<uint_t>(uint_t(next() & 1) << (sizeof(uint_t) * 8 - 1));
+            bits = static_cast<uint_t>(sign | (exponent << significand_bitsize) | (bits & ((uint_t(1) << significand_bitsize) - 1)));
+        }
+        v = floatbase_t<format>::from_bitstring(bits);
+    }
+    return x;
+}
+
+template<fp_format acc, fp_format out, fp_format in>
+void validate(size_t m, size_t n, size_t k, bool any_encoding, thread_pool &pool1, thread_pool &pool4)
+{
+    const auto a = random_matrix<in>(m * k, any_encoding);
+    const auto b = random_matrix<in>(k * n, any_encoding);
+
+    std::vector<floatbase_t<out>> expected(m * n);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            auto sum = floatbase_t<acc>::zero();
+            for (size_t p = 0; p < k; ++p) {
+                sum = fma_wide<acc>(a[i * k + p], b[p * n + j], sum);
+            }
+            expected[i * n + j] = details::is_nan(sum) ? floatbase_t<out>::indeterminate_nan() : static_cast<floatbase_t<out>>(sum);
+        }
+    }
+
+    gemm_blocking tiny;
+    tiny.mc = 8;
+    tiny.kc = 5;
+    tiny.nc = 16;
+
+    std::vector<floatbase_t<out>> c(m * n);
+    for (int run = 0; run < 3; ++run) {
+        if (run == 0) gemm<acc, out>(m, n, k, a.data(), k, b.data(), n, c.data(), n, pool1);
+        if (run == 1) gemm<acc, out>(m, n, k, a.data(), k, b.data(), n, c.data(), n, pool4);
+        if (run == 2) gemm<acc, out>(m, n, k, a.data(), k, b.data(), n, c.data(), n, pool4, tiny);
+
+        for (size_t i = 0; i < m * n; ++i) {
+            if (expected[i].to_bitstring() != c[i].to_bitstring()) fail(i / n, i % n, expected[i], c[i], "gemm");
+        }
+    }
+}
+
+template<fp_format acc, fp_format out, fp_format in>
+void validate_shapes(thread_pool &pool1, thread_pool &pool4)
+{
+    validate<acc, out, in>(37, 29, 53, true, pool1, pool4);
+    validate<acc, out, in>(37, 29, 53, false, pool1, pool4);
+    validate<acc, out, in>(1, 1, 300, false, pool1, pool4);
+    validate<acc, out, in>(9, 17, 1, true, pool1, pool4);
+    validate<acc, out, in>(3, 5, 0, true, pool1, pool4);
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool1(1), pool4(4);
+
+        // hardware kernels
+        validate_shapes<fp_format::binary32, fp_format::binary32, fp_format::binary16>(pool1, pool4);
+        validate_shapes<fp_format::binary32, fp_format::bfloat16, fp_format::bfloat16>(pool1, pool4);
+        validate_shapes<fp_format::binary32, fp_format::binary16, fp_format::float8_e5m2>(pool1, pool4);
+        validate_shapes<fp_format::binary64, fp_format::binary32, fp_format::bfloat16>(pool1, pool4);
+        validate_shapes<fp_format::binary32, fp_format::binary32, fp_format::binary32>(pool1, pool4);
+        validate_shapes<fp_format::binary64, fp_format::binary64, fp_format::binary32>(pool1, pool4);
+
+        // soft kernel
+        validate_shapes<fp_format::binary64, fp_format::binary64, fp_format::binary64>(pool1, pool4);
+        validate_shapes<fp_format::binary64, fp_format::binary16, fp_format::binary64>(pool1, pool4);
+        if (details::gemm_lifted<fp_format::binary64, fp_format::binary64>) {
+            throw std::exception("binary64 products are not exact in double");
+        }
+
+        // 1 + 2^-23 - 2^-24 * (1 - 2^-46) is just above a binary32 midpoint,
+        // rounding the sum to nearest in double first would land on it
+        const float32_t da[] = { float32_t(1.0f), float32_t(-1.00000012f) };
+        const float32_t db[] = { float32_t(1.00000012f), float32_t(0x1.fffffcp-25f) };
+        float32_t dc[1];
+        gemm<fp_format::binary32>(1, 1, 2, da, 2, db, 1, dc, 1, pool1);
+        if (dc[0].to_bitstring() != 0x3f800001) {
+            throw std::exception("double rounding");
+        }
+
+        // a larger product across several blocks of every level
+        validate<fp_format::binary32, fp_format::binary32, fp_format::binary16>(300, 2100, 70, false, pool1, pool4);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,162 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "swaccum.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the exact long accumulator
+//  sums and dot products round once: compare to HW at 64-bit on inputs whose
+//  exact result fits in a double
+//  results do not depend on the order of the terms or on the thread count
+//  massive cancellation, extreme exponents and special values
+//
+
+template <typename fp_t>
+void fail(fp_t expected, fp_t actual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "expected: " << expected.to_hex_string() << " " << expected.to_triplet_string() << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+template<typename fp_t>
+void check(fp_t expected, fp_t actual, char const *what)
+{
+    if (expected.to_bitstring() != actual.to_bitstring()) fail(expected, actual, what);
+}
+
+// exact results against double, reproducibility across orders and pools
+template<fp_format format>
+void validate_random(int emin, int emax, size_t count, int trials, thread_pool &pool1, thread_pool &pool4)
+{
+    using fp_t = floatbase_t<format>;
+
+    for (int t = 0; t < trials; ++t) {
+        std::vector<fp_t> x(count), y(count);
+        double sum = 0, dot = 0;
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = random_value<format>(emin, emax);
+            y[i] = random_value<format>(emin, emax);
+            sum += static_cast<double>(x[i]);
+            dot += static_cast<double>(x[i]) * static_cast<double>(y[i]);
+        }
+
+        // the exponent range is chosen so that both sums are exact in double
+        check(from_double<format>(sum), batch::accumulate(x.data(), count, pool4), "accumulate");
+        check(from_double<format>(dot), batch::dot(x.data(), y.data(), count, pool4), "dot");
+
+        auto expected_dot = batch::dot(x.data(), y.data(), count, pool1);
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), xorshift64(next()));
+
+        long_accumulator<format> acc;
+        for (size_t i : order) {
+            acc.add_product(x[i], y[i]);
+        }
+        check(expected_dot, acc.round(), "dot in another order");
+    }
+}
+
+template<fp_format format>
+void validate_cancellation()
+{
+    using fp_t = floatbase_t<format>;
+    const fp_t max = fp_t::from_bitstring(static_cast<typename fp_traits<format>::uint_t>(fp_t::infinity().to_bitstring() - 1));
+    const fp_t tiny = fp_t::from_bitstring(1);
+    const fp_t one = from_double<format>(1.0);
+
+    // max + tiny - max is tiny
+    fp_t terms[] = { max, tiny, -max };
+    check(tiny, batch::accumulate(terms, 3), "cancellation");
+
+    // max * max - max * max + tiny * tiny rounds the exact 2^(2*emin) to 0,
+    // with one more tiny added it is tiny
+    fp_t x[] = { max, max, tiny, one };
+    fp_t y[] = { max, -max, tiny, tiny };
+    check(tiny, batch::dot(x, y, 4), "product cancellation");
+    check(fp_t::zero(), batch::dot(x, y, 3), "tiny product");
+
+    // sums near the top of the range round to infinity only if they overflow
+    fp_t large[] = { max, max, -max };
+    check(max, batch::accumulate(large, 3), "intermediate overflow");
+    check(fp_t::infinity(), batch::accumulate(large, 2), "overflow");
+}
+
+template<fp_format format>
+void validate_specials()
+{
+    using fp_t = floatbase_t<format>;
+    const fp_t one = from_double<format>(1.0);
+    const fp_t inf = fp_t::infinity();
+    const fp_t neg_zero = fp_t::zero(1);
+
+    long_accumulator<format> acc;
+    check(fp_t::zero(), acc.round(), "empty");
+
+    fp_t zeros[] = { neg_zero, neg_zero };
+    check(neg_zero, batch::accumulate(zeros, 2), "negative zeros");
+    fp_t mixed_zeros[] = { neg_zero, fp_t::zero() };
+    check(fp_t::zero(), batch::accumulate(mixed_zeros, 2), "mixed zeros");
+    fp_t cancel[] = { one, -one };
+    check(fp_t::zero(), batch::accumulate(cancel, 2), "exact zero");
+
+    fp_t infs[] = { one, inf, one };
+    check(inf, batch::accumulate(infs, 3), "infinity");
+    fp_t both_infs[] = { -inf, one, inf };
+    if (static_cast<double>(batch::accumulate(both_infs, 3)) == static_cast<double>(batch::accumulate(both_infs, 3))) {
+        throw std::exception("inf - inf is not NaN");
+    }
+
+    fp_t x[] = { inf, one }, y[] = { fp_t::zero(), one };
+    if (static_cast<double>(batch::dot(x, y, 2)) == static_cast<double>(batch::dot(x, y, 2))) {
+        throw std::exception("inf * 0 is not NaN");
+    }
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool1(1), pool4(4);
+
+        // e.g. binary16 products of values in [2^-4, 2^4) are multiples of
+        // 2^-28 below 2^8, 4096 of them add up exactly in a double
+        validate_random<fp_format::binary16>(-4, 3, 4096, 20, pool1, pool4);
+        validate_random<fp_format::bfloat16>(-4, 3, 4096, 20, pool1, pool4);
+        validate_random<fp_format::binary32>(0, 0, 16, 500, pool1, pool4);
+
+        validate_cancellation<fp_format::binary16>();
+        validate_cancellation<fp_format::bfloat16>();
+        validate_cancellation<fp_format::binary32>();
+        validate_cancellation<fp_format::binary64>();
+
+        validate_specials<fp_format::binary16>();
+        validate_specials<fp_format::binary32>();
+        validate_specials<fp_format::binary64>();
+
+        // large sums reproduce across pools
+        std::vector<float32_t> big(1 << 20);
+        for (auto &v : big) v = random_value<fp_format::binary32>(-100, 100);
+        check(batch::accumulate(big.data(), big.size(), pool1), batch::accumulate(big.data(), big.size(), pool4), "pool sizes");
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,191 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include <limits>
+
+#include "swmath.h"
+#include "../test_random.h"
+#include "math_reference.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the correctly rounded elementary functions
+//  binary32 and binary64 against the correctly rounded values of
+//  math_reference.h, binary32 including results close enough to a midpoint
+//  that the first evaluation cannot decide them
+//  special values, the exact midpoints of pow and exp2 and the batch variants
+//
+
+template <typename fp_t>
+void fail(char const *name, fp_t a, fp_t expected, fp_t actual)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+    cout << "expected: " << expected.to_hex_string() << " " << expected.to_triplet_string() << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + name + "'";
+    throw std::exception(err.c_str());
+}
+
+template <typename fp_t>
+void check(char const *name, fp_t a, fp_t expected, fp_t actual)
+{
+    if (details::is_nan(expected) || details::is_nan(actual)) {
+        if (details::is_nan(expected) != details::is_nan(actual)) fail(name, a, expected, actual);
+    }
+    else if (expected.to_bitstring() != actual.to_bitstring()) {
+        fail(name, a, expected, actual);
+    }
+}
+
+// random encodings, then values in the ranges where the functions are finite
+float32_t random_input(int i)
+{
+    const double u = static_cast<double>(next() >> 11) * 0x1p-53;
+    switch (i % 4)
+    {
+    case 0: return float32_t::from_bitstring(static_cast<uint32_t>(next()));
+    case 1: return float32_t(static_cast<float>((2 * u - 1) * 10));
+    case 2: return float32_t(static_cast<float>((2 * u - 1) * 150));
+    default: return float32_t(static_cast<float>(std::ldexp(2 * u - 1, -static_cast<int>(next() % 40))));
+    }
+}
+
+template<fp_format format, typename uint_t, size_t unary_count, size_t pow_count>
+void validate_reference(const unary_reference<uint_t> (&unary)[unary_count], const pow_reference<uint_t> (&binary)[pow_count])
+{
+    using fp_t = floatbase_t<format>;
+
+    for (const auto &c : unary) {
+        const std::string name = c.name;
+        const fp_t a = fp_t::from_bitstring(c.a), expected = fp_t::from_bitstring(c.expected);
+        fp_t actual;
+        if (name == "exp") actual = exp(a);
+        if (name == "exp2") actual = exp2(a);
+        if (name == "expm1") actual = expm1(a);
+        if (name == "log") actual = log(a);
+        if (name == "log2") actual = log2(a);
+        if (name == "log1p") actual = log1p(a);
+        if (name == "sin") actual = sin(a);
+        if (name == "cos") actual = cos(a);
+        if (name == "tan") actual = tan(a);
+        check(c.name, a, expected, actual);
+    }
+
+    for (const auto &c : binary) {
+        const fp_t a = fp_t::from_bitstring(c.a), b = fp_t::from_bitstring(c.b);
+        check("pow", a, fp_t::from_bitstring(c.expected), pow(a, b));
+    }
+}
+
+template<fp_format format>
+void validate_special()
+{
+    using fp_t = floatbase_t<format>;
+    const fp_t zero = fp_t::zero(), inf = fp_t::infinity(), nan = fp_t::indeterminate_nan();
+    const fp_t one(1.0f), two(2.0f), half(0.5f);
+
+    check("exp", inf, zero, exp(-inf));
+    check("exp", inf, inf, exp(inf));
+    check("exp", zero, one, exp(-zero));
+    check("exp2", two, fp_t(4.0f), exp2(two));
+    check("expm1", zero, -zero, expm1(-zero));
+    check("expm1", inf, -one, expm1(-inf));
+    check("log", zero, -inf, log(zero));
+    check("log", one, zero, log(one));
+    check("log", two, nan, log(-two));
+    check("log2", fp_t(1024.0f), fp_t(10.0f), log2(fp_t(1024.0f)));
+    check("log2", half, -one, log2(half));
+    check("log1p", one, -inf, log1p(-one));
+    check("log1p", two, nan, log1p(-two));
+    check("log1p", zero, -zero, log1p(-zero));
+    check("sin", zero, -zero, sin(-zero));
+    check("sin", inf, nan, sin(inf));
+    check("cos", zero, one, cos(-zero));
+    check("tan", zero, -zero, tan(-zero));
+
+    check("pow", nan, one, pow(nan, zero));
+    check("pow", one, one, pow(one, nan));
+    check("pow", zero, -inf, pow(-zero, -fp_t(3.0f)));
+    check("pow", zero, inf, pow(-zero, -two));
+    check("pow", zero, -zero, pow(-zero, fp_t(3.0f)));
+    check("pow", one, one, pow(-one, inf));
+    check("pow", half, zero, pow(half, inf));
+    check("pow", half, inf, pow(half, -inf));
+    check("pow", inf, -zero, pow(-inf, -fp_t(3.0f)));
+    check("pow", inf, inf, pow(-inf, two));
+    check("pow", two, nan, pow(-two, half));
+    check("pow", two, -fp_t(8.0f), pow(-two, fp_t(3.0f)));
+    check("pow", fp_t(9.0f), fp_t(3.0f), pow(fp_t(9.0f), half));
+}
+
+// results that are exactly midpoints round to even
+void validate_exact()
+{
+    // (1 + 2^-12)^2 = 1 + 2^-11 + 2^-24
+    const float32_t m(1.000244140625f);
+    check("pow", m, float32_t(1.00048828125f), pow(m, float32_t(2.0f)));
+
+    // 257^3 = 16974593 and 29^5 = 20511149 are odd with 25 bits
+    check("pow", float32_t(66049.0f), float32_t(16974592.0f), pow(float32_t(66049.0f), float32_t(1.5f)));
+    check("pow", float32_t(707281.0f), float32_t(20511148.0f), pow(float32_t(707281.0f), float32_t(1.25f)));
+
+    // 243 2^-150 is 121.5 times the smallest subnormal, 2^-150 is half of it
+    const float32_t x32 = float32_t::from_bitstring(0x31400000);
+    check("pow", x32, float32_t::from_bitstring(0x0000007a), pow(x32, float32_t(5.0f)));
+    check("pow", float32_t(2.0f), float32_t::zero(), pow(float32_t(2.0f), float32_t(-150.0f)));
+    check("exp2", float32_t(-150.0f), float32_t::zero(), exp2(float32_t(-150.0f)));
+
+    // (1 + 2^-27)^2 = 1 + 2^-26 + 2^-54, and 208065^3 is odd with 54 bits
+    const float64_t m64(0x1.0000002000000p+0);
+    check("pow", m64, float64_t(0x1.0000004000000p+0), pow(m64, float64_t(2.0)));
+    check("pow", float64_t(0x1.428b1d3020000p+35), float64_t(0x1.00011add69b20p+53), pow(float64_t(0x1.428b1d3020000p+35), float64_t(1.5)));
+
+    const float64_t x64(0x1.8000000000000p-214);
+    check("pow", x64, float64_t(0x0.000000000007ap-1022), pow(x64, float64_t(5.0)));
+    check("pow", float64_t(0.25), float64_t::zero(), pow(float64_t(0.25), float64_t(537.5)));
+    check("exp2", float64_t(-1075.0), float64_t::zero(), exp2(float64_t(-1075.0)));
+}
+
+int main()
+{
+    try
+    {
+        validate_reference<fp_format::binary32>(unary32, pow32);
+        validate_reference<fp_format::binary64>(unary64, pow64);
+
+        validate_special<fp_format::binary32>();
+        validate_special<fp_format::binary64>();
+        validate_exact();
+
+        // the batch variants match the scalar functions
+        thread_pool pool(4);
+        std::vector<float64_t> a(1000), b(1000), out(1000);
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] = static_cast<float64_t>(random_input(static_cast<int>(i)));
+            b[i] = static_cast<float64_t>(random_input(static_cast<int>(i + 1)));
+        }
+        batch::sin(a.data(), out.data(), a.size(), pool);
+        for (size_t i = 0; i < a.size(); ++i) check("batch sin", a[i], sin(a[i]), out[i]);
+        batch::log1p(a.data(), out.data(), a.size(), pool);
+        for (size_t i = 0; i < a.size(); ++i) check("batch log1p", a[i], log1p(a[i]), out[i]);
+        batch::pow(a.data(), b.data(), out.data(), a.size(), pool);
+        for (size_t i = 0; i < a.size(); ++i) check("batch pow", a[i], pow(a[i], b[i]), out[i]);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,241 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include <limits>
+
+#include "swnn.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the nn kernels
+//  the same bits for any thread count
+//  within 2 ulps of the output format of a double reference, gelu and silu
+//  for all 16-bit inputs
+//  NaN, infinite and overflowing inputs
+//
+
+template <typename fp_t>
+void fail(size_t i, double expected, fp_t actual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "element: " << i << endl;
+    cout << "expected: " << expected << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+// |expected - actual| within ulps of the format at expected
+template<fp_format format>
+void check(size_t i, double expected, floatbase_t<format> actual, int ulps, char const *what)
+{
+    const double a = static_cast<double>(actual);
+    if (expected != expected || a != a) {
+        if ((expected != expected) != (a != a)) fail(i, expected, actual, what);
+        return;
+    }
+    if (std::isinf(expected) || std::isinf(a)) {
+        if (expected != a) fail(i, expected, actual, what);
+        return;
+    }
+
+    constexpr int precision = unpacked_t<format>::precision;
+    const double smallest = std::ldexp(1.0, 1 - fp_traits<format>::bias - precision + 1);
+    const double ulp = std::max(smallest, std::ldexp(1.0, std::ilogb(expected == 0 ? smallest : expected) - precision + 1));
+    if (std::fabs(expected - a) > ulps * ulp) fail(i, expected, actual, what);
+}
+
+template<fp_format format>
+void same_bits(const std::vector<floatbase_t<format>> &a, const std::vector<floatbase_t<format>> &b, char const *what)
+{
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].to_bitstring() != b[i].to_bitstring()) fail(i, static_cast<double>(a[i]), b[i], what);
+    }
+}
+
+template<fp_format format>
+std::vector<floatbase_t<format>> random_values(size_t count, double scale)
+{
+    std::vector<floatbase_t<format>> x(count);
+    for (auto &v : x) {
+        const double u = static_cast<double>(next() >> 11) * 0x1p-53 * 2 - 1;
+        v = static_cast<floatbase_t<format>>(float64_t(u * scale));
+    }
+    return x;
+}
+
+double gelu(double x)
+{
+    // 0.5 x (1 + tanh(u)) loses all bits to cancellation for large negative x
+    const double u = 0.7978845608028654 * (x + 0.044715 * x * x * x);
+    return x / (1 + std::exp(-2 * u));
+}
+
+double silu(double x)
+{
+    return x / (1 + std::exp(-x));
+}
+
+template<fp_format format>
+void validate_elementwise(thread_pool &pool1, thread_pool &pool4)
+{
+    std::vector<floatbase_t<format>> x(65536);
+    for (uint32_t i = 0; i < 65536; ++i) {
+        x[i] = floatbase_t<format>::from_bitstring(static_cast<uint16_t>(i));
+    }
+
+    std::vector<floatbase_t<format>> out1(x.size()), out4(x.size());
+    batch::gelu(x.data(), out1.data(), x.size(), pool1);
+    batch::gelu(x.data(), out4.data(), x.size(), pool4);
+    same_bits(out1, out4, "gelu threads");
+    for (size_t i = 0; i < x.size(); ++i) {
+        check(i, gelu(static_cast<double>(x[i])), out1[i], 1, "gelu");
+    }
+
+    batch::silu(x.data(), out1.data(), x.size(), pool1);
+    batch::silu(x.data(), out4.data(), x.size(), pool4);
+    same_bits(out1, out4, "silu threads");
+    for (size_t i = 0; i < x.size(); ++i) {
+        check(i, silu(static_cast<double>(x[i])), out1[i], 1, "silu");
+    }
+}
+
+template<fp_format format>
+void validate_rows(size_t rows, size_t columns, double scale, thread_pool &pool1, thread_pool &pool4)
+{
+    const auto x = random_values<format>(rows * columns, scale);
+    const auto gamma = random_values<format>(columns, 2);
+    const auto beta = random_values<format>(columns, 1);
+    const float32_t epsilon(1e-5f);
+
+    std::vector<floatbase_t<format>> out1(x.size()), out4(x.size());
+    std::vector<double> expected(x.size());
+
+    // softmax
+    for (size_t i = 0; i < rows; ++i) {
+        double max = -INFINITY, sum = 0;
+        for (size_t j = 0; j < columns; ++j) max = std::max(max, static_cast<double>(x[i * columns + j]));
+        for (size_t j = 0; j < columns; ++j) sum += std::exp(static_cast<double>(x[i * columns + j]) - max);
+        for (size_t j = 0; j < columns; ++j) expected[i * columns + j] = std::exp(static_cast<double>(x[i * columns + j]) - max) / sum;
+    }
+    batch::softmax(x.data(), out1.data(), rows, columns, pool1);
+    batch::softmax(x.data(), out4.data(), rows, columns, pool4);
+    same_bits(out1, out4, "softmax threads");
+    for (size_t i = 0; i < x.size(); ++i) check(i, expected[i], out1[i], 2, "softmax");
+
+    // layernorm
+    for (size_t i = 0; i < rows; ++i) {
+        double mean = 0, variance = 0;
+        for (size_t j = 0; j < columns; ++j) mean += static_cast<double>(x[i * columns + j]);
+        mean /= columns;
+        for (size_t j = 0; j < columns; ++j) variance += std::pow(static_cast<double>(x[i * columns + j]) - mean, 2);
+        variance /= columns;
+        const double rstd = 1 / std::sqrt(variance + static_cast<double>(epsilon));
+        for (size_t j = 0; j < columns; ++j) {
+            expected[i * columns + j] = (static_cast<double>(x[i * columns + j]) - mean) * rstd * static_cast<double>(gamma[j]) + static_cast<double>(beta[j]);
+        }
+    }
+    batch::layernorm(x.data(), gamma.data(), beta.data(), out1.data(), rows, columns, epsilon, pool1);
+    batch::layernorm(x.data(), gamma.data(), beta.data(), out4.data(), rows, columns, epsilon, pool4);
+    same_bits(out1, out4, "layernorm threads");
+    for (size_t i = 0; i < x.size(); ++i) check(i, expected[i], out1[i], 2, "layernorm");
+
+    // rmsnorm
+    for (size_t i = 0; i < rows; ++i) {
+        double squares = 0;
+        for (size_t j = 0; j < columns; ++j) squares += std::pow(static_cast<double>(x[i * columns + j]), 2);
+        const double rstd = 1 / std::sqrt(squares / columns + static_cast<double>(epsilon));
+        for (size_t j = 0; j < columns; ++j) {
+            expected[i * columns + j] = static_cast<double>(x[i * columns + j]) * rstd * static_cast<double>(gamma[j]);
+        }
+    }
+    batch::rmsnorm(x.data(), gamma.data(), out1.data(), rows, columns, epsilon, pool1);
+    batch::rmsnorm(x.data(), gamma.data(), out4.data(), rows, columns, epsilon, pool4);
+    same_bits(out1, out4, "rmsnorm threads");
+    for (size_t i = 0; i < x.size(); ++i) check(i, expected[i], out1[i], 2, "rmsnorm");
+}
+
+void validate_exp()
+{
+    // e^x against double over the whole binary32 range that does not round
+    // to 0 or infinity, and past it
+    for (int i = 0; i < 1000000; ++i) {
+        const float32_t x = float32_t::from_bitstring(static_cast<uint32_t>(next()));
+        const double e = std::exp(static_cast<double>(x));
+        const auto r = details::nn_exp(x);
+        const double expected = static_cast<double>(float32_t(static_cast<float>(e)));
+        check(i, expected, r, 1, "exp");
+    }
+
+    if (details::nn_exp(float32_t(89.0f)).to_bitstring() != 0x7f800000) throw std::exception("exp overflow");
+    if (details::nn_exp(float32_t(-104.0f)).to_bitstring() != 0) throw std::exception("exp underflow");
+    if (details::nn_exp(float32_t::zero()).to_bitstring() != 0x3f800000) throw std::exception("exp 0");
+}
+
+template<fp_format format>
+void validate_special(thread_pool &pool)
+{
+    using fp_t = floatbase_t<format>;
+
+    // softmax of a row with +inf is NaN, a row of huge values does not overflow
+    fp_t x[] = { fp_t(1.0f), fp_t::infinity(), fp_t(2.0f), fp_t::indeterminate_nan(), fp_t(3.0f), fp_t(-1.0f) };
+    fp_t big[] = { fp_t(60000.0f), fp_t(60000.0f), fp_t(-60000.0f), fp_t(0.0f) };
+    fp_t out[6];
+
+    batch::softmax(x, out, 1, 2, pool);
+    if (!details::is_nan(out[0]) || !details::is_nan(out[1])) throw std::exception("softmax infinity");
+    batch::softmax(x + 2, out, 1, 2, pool);
+    if (!details::is_nan(out[0]) || !details::is_nan(out[1])) throw std::exception("softmax NaN");
+    batch::softmax(big, out, 1, 4, pool);
+    if (static_cast<float>(out[0]) != 0.5f || static_cast<float>(out[1]) != 0.5f || static_cast<float>(out[2]) != 0) {
+        throw std::exception("softmax large values");
+    }
+
+    // a constant row normalizes to beta, rmsnorm of zeros is zero
+    fp_t constant[] = { fp_t(7.0f), fp_t(7.0f), fp_t(7.0f) };
+    fp_t ones[] = { fp_t(1.0f), fp_t(1.0f), fp_t(1.0f) };
+    fp_t zeros[] = { fp_t(0.0f), fp_t(0.0f), fp_t(0.0f) };
+    batch::layernorm(constant, ones, ones, out, 1, 3, float32_t(1e-5f), pool);
+    if (static_cast<float>(out[0]) != 1 || static_cast<float>(out[2]) != 1) throw std::exception("layernorm constant");
+    batch::rmsnorm(zeros, ones, out, 1, 3, float32_t(1e-5f), pool);
+    if (static_cast<float>(out[0]) != 0 || static_cast<float>(out[2]) != 0) throw std::exception("rmsnorm zeros");
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool1(1), pool4(4);
+
+        validate_exp();
+
+        validate_elementwise<fp_format::binary16>(pool1, pool4);
+        validate_elementwise<fp_format::bfloat16>(pool1, pool4);
+
+        validate_rows<fp_format::binary16>(7, 1000, 4, pool1, pool4);
+        validate_rows<fp_format::binary16>(300, 13, 8, pool1, pool4);
+        validate_rows<fp_format::binary16>(3, 1, 1, pool1, pool4);
+        validate_rows<fp_format::bfloat16>(7, 1000, 4, pool1, pool4);
+        validate_rows<fp_format::bfloat16>(300, 13, 100, pool1, pool4);
+
+        validate_special<fp_format::binary16>(pool4);
+        validate_special<fp_format::bfloat16>(pool4);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,237 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include <limits>
+
+#include "swrandom.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the random number generators and uniform values
+//  PCG64 known answers of the reference implementation
+//  advance and discard land where repeated calls land, forwards and back
+//  Philox engine outputs are the words of the counter blocks
+//  uniform bit patterns are k * 2^-p for every k of the small formats and
+//  random k of the others, binary128 against a normalization loop
+//  the mean of many uniforms is 1/2
+//  batch fills match sequential calls for 1 and 4 threads
+//
+
+uint128sw_t make_uint128(uint64_t high, uint64_t low)
+{
+    return (uint128sw_t(high) << 64) | uint128sw_t(low);
+}
+
+template<fp_format format>
+double to_double(floatbase_t<format> x)
+{
+    if constexpr (format == fp_format::binary64) {
+        return static_cast<double>(x);
+    }
+    else {
+        return static_cast<float>(x);
+    }
+}
+
+void validate_pcg64()
+{
+    pcg64 rng(uint128sw_t(42), uint128sw_t(54));
+    const uint64_t expected[] = { 0x86b1da1d72062b68, 0x1304aa46c9853d39, 0xa3670e9e0dd50358,
+        0xf9090e529a7dae00, 0xc85b9fd837996f2c, 0x606121f8e3919196 };
+    for (uint64_t e : expected) {
+        if (rng() != e) throw std::exception("pcg64 known answer");
+    }
+
+    // the output after a million steps of another stream, stepped and jumped
+    const pcg64 start(make_uint128(0x0123456789abcdef, 0xfedcba9876543210), make_uint128(0xdeadbeefcafef00d, 0x0f1e2d3c4b5a6978));
+    pcg64 stepped = start, jumped = start;
+    for (int i = 0; i < 1000000; ++i) {
+        stepped();
+    }
+    jumped.advance(uint128sw_t(1000000));
+    if (stepped != jumped) throw std::exception("pcg64 advance");
+    if (jumped() != 0xc9de945ea43f4e14) throw std::exception("pcg64 advance known answer");
+
+    // jumps compose and wrap backwards
+    for (int i = 0; i < 100; ++i) {
+        const uint64_t n = next() % 1000, m = next() % 1000;
+        pcg64 a = start, b = start;
+        for (uint64_t j = 0; j < n + m; ++j) {
+            a();
+        }
+        b.discard(n);
+        b.discard(m);
+        if (a != b) throw std::exception("pcg64 discard");
+
+        b.advance(uint128sw_t(0) - uint128sw_t(n + m));
+        if (b != start) throw std::exception("pcg64 advance backwards");
+    }
+
+    if (pcg64(uint128sw_t(1), uint128sw_t(2)) == pcg64(uint128sw_t(1), uint128sw_t(3))) throw std::exception("pcg64 streams");
+}
+
+void validate_philox_engine()
+{
+    const philox4x32 generator(7);
+    philox_engine rng(7, 3);
+    for (uint64_t i = 0; i < 64; ++i) {
+        const auto block = generator.block(i / 2, 3);
+        const int half = static_cast<int>(i % 2) * 2;
+        if (rng() != (uint64_t(block[half]) | (uint64_t(block[half + 1]) << 32))) throw std::exception("philox engine output");
+    }
+
+    // jumps to odd positions read the second half of the block
+    for (int i = 0; i < 100; ++i) {
+        const uint64_t n = next() % 100, m = next() % 100;
+        philox_engine a(7, 3), b(7, 3);
+        for (uint64_t j = 0; j < n + m; ++j) {
+            a();
+        }
+        b.discard(n);
+        b.discard(m);
+        if (a != b || a() != b()) throw std::exception("philox engine discard");
+    }
+}
+
+// every k of a format with few significand bits, the bits below k ignored
+template<fp_format format>
+void validate_uniform_all()
+{
+    constexpr int precision = details::uniform_traits<format>::precision;
+    double previous = -1;
+    for (uint64_t k = 0; k < (uint64_t(1) << precision); ++k) {
+        const uint64_t bits = (k << (64 - precision)) | (next() >> precision);
+        const double u = to_double(uniform_from_bits<format>(bits));
+        if (u != std::ldexp(double(k), -precision)) throw std::exception("uniform value");
+        if (!(u > previous)) throw std::exception("uniform order");
+        previous = u;
+    }
+}
+
+template<fp_format format>
+void validate_uniform_random()
+{
+    constexpr int precision = details::uniform_traits<format>::precision;
+    const uint64_t edges[] = { 0, ~uint64_t(0), uint64_t(1) << 63, uint64_t(1) << (64 - precision), (uint64_t(1) << (64 - precision)) - 1 };
+    for (uint64_t bits : edges) {
+        const double u = to_double(uniform_from_bits<format>(bits));
+        if (u != std::ldexp(double(bits >> (64 - precision)), -precision)) throw std::exception("uniform edge");
+    }
+
+    for (int i = 0; i < 1000000; ++i) {
+        const uint64_t bits = next() >> (next() % 64);
+        const double u = to_double(uniform_from_bits<format>(bits));
+        if (u != std::ldexp(double(bits >> (64 - precision)), -precision)) throw std::exception("uniform random");
+    }
+}
+
+void validate_uniform128()
+{
+    using uint_t = uint128sw_t;
+    const uint_t top = uint_t(1) << 112;
+
+    for (int i = 0; i < 200000; ++i) {
+        const uint64_t high = next() >> (next() % 64), low = next() % 2 ? next() : next() >> (next() % 64);
+        const uint_t actual = uniform_from_bits<fp_format::binary128>(high, low).to_bitstring();
+
+        uint_t m = (make_uint128(high, low) >> 15);
+        uint_t expected(0);
+        if (m != uint_t(0)) {
+            int exponent = 16383 - 1;
+            while (static_cast<bool>((m & top) == uint_t(0))) {
+                m <<= 1;
+                --exponent;
+            }
+            expected = (uint_t(exponent) << 112) | (m - top);
+        }
+        if (actual != expected) throw std::exception("uniform binary128");
+    }
+
+    if (uniform_from_bits<fp_format::binary128>(0, uint64_t(1) << 15).to_bitstring() != uint_t(16383 - 113) << 112) throw std::exception("uniform binary128 smallest");
+}
+
+void validate_mean()
+{
+    pcg64 rng(uint128sw_t(2024));
+    const int count = 1000000;
+    double sum = 0;
+    for (int i = 0; i < count; ++i) {
+        const double u = static_cast<double>(uniform<fp_format::binary64>(rng));
+        if (!(u >= 0 && u < 1)) throw std::exception("uniform range");
+        sum += u;
+    }
+
+    // five standard deviations of the mean of count uniforms
+    if (std::fabs(sum / count - 0.5) > 5 * std::sqrt(1.0 / 12 / count)) throw std::exception("uniform mean");
+}
+
+template<fp_format format, typename engine_t>
+void validate_batch(const engine_t &start, thread_pool &pool1, thread_pool &pool4)
+{
+    const size_t counts[] = { 0, 1, 7, 8192, 8193, 50001 };
+    for (size_t count : counts) {
+        engine_t sequential = start;
+        std::vector<floatbase_t<format>> expected(count);
+        for (auto &x : expected) {
+            x = uniform<format>(sequential);
+        }
+
+        thread_pool *pools[2] = { &pool1, &pool4 };
+        for (thread_pool *pool : pools) {
+            engine_t rng = start;
+            std::vector<floatbase_t<format>> actual(count);
+            batch::uniform(rng, actual.data(), count, *pool);
+            for (size_t i = 0; i < count; ++i) {
+                if (actual[i].to_bitstring() != expected[i].to_bitstring()) throw std::exception("batch uniform");
+            }
+            if (rng != sequential) throw std::exception("batch uniform generator state");
+        }
+    }
+}
+
+template<fp_format format>
+void validate_batch(thread_pool &pool1, thread_pool &pool4)
+{
+    validate_batch<format>(pcg64(uint128sw_t(99), uint128sw_t(5)), pool1, pool4);
+    validate_batch<format>(philox_engine(99, 5), pool1, pool4);
+}
+
+int main()
+{
+    try
+    {
+        validate_pcg64();
+        validate_philox_engine();
+
+        validate_uniform_all<fp_format::float8_e5m2>();
+        validate_uniform_all<fp_format::bfloat16>();
+        validate_uniform_all<fp_format::binary16>();
+        validate_uniform_random<fp_format::binary32>();
+        validate_uniform_random<fp_format::binary64>();
+        validate_uniform128();
+        validate_mean();
+
+        thread_pool pool1(1), pool4(4);
+        validate_batch<fp_format::bfloat16>(pool1, pool4);
+        validate_batch<fp_format::binary16>(pool1, pool4);
+        validate_batch<fp_format::binary32>(pool1, pool4);
+        validate_batch<fp_format::binary64>(pool1, pool4);
+        validate_batch<fp_format::binary128>(pool1, pool4);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,179 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "swrepro.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate reproducible binned summation
+//  results do not depend on the order of the terms, the chunking or the
+//  thread count
+//  well-conditioned sums and dot products match the exact long accumulator
+//  asum, nrm2, extreme exponents and special values
+//
+
+template <typename fp_t>
+void fail(fp_t expected, fp_t actual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "expected: " << expected.to_hex_string() << " " << expected.to_triplet_string() << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+template<typename fp_t>
+void check(fp_t expected, fp_t actual, char const *what)
+{
+    if (expected.to_bitstring() != actual.to_bitstring()) fail(expected, actual, what);
+}
+
+// the same bits for any pool, any order and any split into merged parts
+template<fp_format format>
+void validate_reproducible(int emin, int emax, size_t count, thread_pool &pool1, thread_pool &pool4)
+{
+    using fp_t = floatbase_t<format>;
+
+    std::vector<fp_t> x(count), y(count);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = random_value<format>(emin, emax);
+        y[i] = random_value<format>(emin, emax);
+    }
+
+    const fp_t sum = repro::reduce(x.data(), count, pool1);
+    const fp_t dot = repro::dot(x.data(), y.data(), count, pool1);
+    check(sum, repro::reduce(x.data(), count, pool4), "reduce on 4 threads");
+    check(dot, repro::dot(x.data(), y.data(), count, pool4), "dot on 4 threads");
+    check(repro::asum(x.data(), count, pool1), repro::asum(x.data(), count, pool4), "asum on 4 threads");
+    check(repro::nrm2(x.data(), count, pool1), repro::nrm2(x.data(), count, pool4), "nrm2 on 4 threads");
+
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), xorshift64(next()));
+
+    // shuffled terms in three parts merged in reverse
+    binned_accumulator<format> sums[3], dots[3];
+    for (size_t i = 0; i < count; ++i) {
+        sums[i % 3].add(x[order[i]]);
+        dots[i * 7 / count % 3].add_product(x[order[i]], y[order[i]]);
+    }
+    sums[2].merge(sums[1]);
+    sums[2].merge(sums[0]);
+    dots[2].merge(dots[1]);
+    dots[2].merge(dots[0]);
+    check(sum, sums[2].round(), "reduce in another order");
+    check(dot, dots[2].round(), "dot in another order");
+}
+
+// terms within 64 bits of the largest one sum exactly, binary64 products have
+// more bits than that
+template<fp_format format>
+void validate_exact(int emin, int emax, size_t count, int trials, bool products)
+{
+    using fp_t = floatbase_t<format>;
+
+    for (int t = 0; t < trials; ++t) {
+        std::vector<fp_t> x(count), y(count), abs_x(count);
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = random_value<format>(emin, emax);
+            y[i] = random_value<format>(emin, emax);
+            abs_x[i] = x[i].to_bitstring() >> (sizeof(x[i].to_bitstring()) * 8 - 1) ? -x[i] : x[i];
+        }
+
+        check(batch::accumulate(x.data(), count), repro::reduce(x.data(), count), "reduce");
+        if (products) check(batch::dot(x.data(), y.data(), count), repro::dot(x.data(), y.data(), count), "dot");
+        check(batch::accumulate(abs_x.data(), count), repro::asum(x.data(), count), "asum");
+    }
+}
+
+template<fp_format format>
+void validate_edges()
+{
+    using fp_t = floatbase_t<format>;
+    const fp_t max = fp_t::from_bitstring(static_cast<typename fp_traits<format>::uint_t>(fp_t::infinity().to_bitstring() - 1));
+    const fp_t tiny = fp_t::from_bitstring(1);
+    const fp_t one = from_double<format>(1.0);
+    const fp_t inf = fp_t::infinity();
+    const fp_t neg_zero = fp_t::zero(1);
+
+    // 3-4-5 at the bottom, in the middle and at the top of the range
+    fp_t tiny_sides[] = { fp_t::from_bitstring(3), -fp_t::from_bitstring(4) };
+    check(fp_t::from_bitstring(5), repro::nrm2(tiny_sides, 2), "nrm2 of subnormals");
+    fp_t sides[] = { from_double<format>(-3.0), from_double<format>(4.0) };
+    check(from_double<format>(5.0), repro::nrm2(sides, 2), "nrm2");
+    check(from_double<format>(7.0), repro::asum(sides, 2), "asum");
+    fp_t huge_sides[] = { max, max };
+    check(inf, repro::nrm2(huge_sides, 2), "nrm2 overflow");
+    fp_t two[] = { one, one };
+    check(from_double<format>(1.4142135623730951), repro::nrm2(two, 2), "nrm2 inexact");
+
+    // the window drops bits far below the largest term, the whole binary16
+    // range fits in it
+    fp_t terms[] = { max, tiny, -max };
+    check(format == fp_format::binary16 ? tiny : fp_t::zero(), repro::reduce(terms, 3), "far cancellation");
+    const fp_t big = from_double<format>(32768.0);
+    fp_t near_terms[] = { big, one, -big };
+    check(one, repro::reduce(near_terms, 3), "near cancellation");
+    fp_t large[] = { max, max, -max };
+    check(max, repro::reduce(large, 3), "intermediate overflow");
+
+    // specials and zeros
+    binned_accumulator<format> acc;
+    check(fp_t::zero(), acc.round(), "empty");
+    fp_t zeros[] = { neg_zero, neg_zero };
+    check(neg_zero, repro::reduce(zeros, 2), "negative zeros");
+    check(fp_t::zero(), repro::asum(zeros, 2), "asum of negative zeros");
+    fp_t cancel[] = { one, -one };
+    check(fp_t::zero(), repro::reduce(cancel, 2), "exact zero");
+    fp_t infs[] = { one, -inf };
+    check(-inf, repro::reduce(infs, 2), "infinity");
+    check(inf, repro::asum(infs, 2), "asum of infinity");
+    check(inf, repro::nrm2(infs, 2), "nrm2 of infinity");
+    fp_t both_infs[] = { -inf, one, inf };
+    if (static_cast<double>(repro::reduce(both_infs, 3)) == static_cast<double>(repro::reduce(both_infs, 3))) {
+        throw std::exception("inf - inf is not NaN");
+    }
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool1(1), pool4(4);
+
+        validate_reproducible<fp_format::binary16>(-24, 15, 100000, pool1, pool4);
+        validate_reproducible<fp_format::bfloat16>(-100, 100, 100000, pool1, pool4);
+        validate_reproducible<fp_format::binary32>(-100, 100, 100000, pool1, pool4);
+        validate_reproducible<fp_format::binary64>(-500, 500, 100000, pool1, pool4);
+
+        validate_exact<fp_format::binary16>(-4, 3, 4096, 10, true);
+        validate_exact<fp_format::bfloat16>(-4, 3, 4096, 10, true);
+        validate_exact<fp_format::binary32>(-4, 3, 4096, 10, true);
+        validate_exact<fp_format::binary64>(0, 0, 4096, 10, false);
+
+        validate_edges<fp_format::binary16>();
+        validate_edges<fp_format::bfloat16>();
+        validate_edges<fp_format::binary32>();
+        validate_edges<fp_format::binary64>();
+
+        // narrow inputs summed into a wider result
+        float16_t halfs[] = { float16_t(65504.0f), float16_t(65504.0f) };
+        check(float32_t(131008.0f), repro::reduce<fp_format::binary16, fp_format::binary32>(halfs, 2), "wider result");
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -11,6 +11,24 @@
  mul16_all.cpp
  div16_all.cpp
  comp16_all.cpp
+ batch_comp16_all.cpp
+ sort16_all.cpp
+ batch_arith16_all.cpp
+ conv_file.cpp
+ tensor_file.cpp
+ unpacked16_all.cpp
+ fused_expr.cpp
+ wide16_all.cpp
+ long_accum.cpp
+ repro_sum.cpp
+ double_double.cpp
+ gemm.cpp
+ sqrt16_all.cpp
+ nn_kernels.cpp
+ math_functions.cpp
+ stochastic_rounding.cpp
+ fixed_point.cpp
+ random_uniform.cpp
 
 ) do @(
  pushd %tmp%
@@ -0,0 +1,185 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+#include <limits>
+
+#include "swsort.h"
+#include "../test_random.h"
+
+// disable constant arithmetic warnings
+#pragma warning(disable:4756)
+
+using std::cout;
+using std::endl;
+
+//
+// Validate totalOrder and the radix sorts
+//  sort every 16-bit value, compare key-value and argsort against std::stable_sort
+//  using the totalOrder predicate for 16/32/64-bit values
+//
+
+template <typename fp_t>
+void fail(fp_t a, fp_t b, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+    cout << "b: " << b.to_hex_string() << " " << b.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+template<typename fp_t>
+bool is_nan(fp_t x) { return x != x; }
+
+template<typename fp_t>
+bool is_negative(fp_t x) { return (x.to_bitstring() >> (sizeof(fp_t) * 8 - 1)) != 0; }
+
+// strict weak order that matches each nan_placement
+template<typename fp_t>
+bool ordered_before(fp_t a, fp_t b, nan_placement nans)
+{
+    if (nans != nan_placement::total_order && (is_nan(a) || is_nan(b))) {
+        if (is_nan(a) && is_nan(b)) {
+            // the -NaN block is rotated behind the +NaN block, each keeps its totalOrder
+            if (is_negative(a) != is_negative(b)) {
+                return !is_negative(a);
+            }
+            return !total_order(b, a);
+        }
+        return (nans == nan_placement::last) ? is_nan(b) : is_nan(a);
+    }
+    return !total_order(b, a);
+}
+
+void validate_total_order()
+{
+    // totalOrder agrees with operator< for ordered, non-equal values
+    for (int i = 0; i <= std::numeric_limits<uint16_t>::max(); i += 7) {
+        for (int j = 0; j <= std::numeric_limits<uint16_t>::max(); j += 13) {
+            auto a = float16_t::from_bitstring(uint16_t(i));
+            auto b = float16_t::from_bitstring(uint16_t(j));
+
+            if (!total_order(a, a)) {
+                fail(a, a, "bad totalOrder reflexive");
+            }
+            if (!total_order(a, b) && !total_order(b, a)) {
+                fail(a, b, "bad totalOrder total");
+            }
+            if (a < b && !(total_order(a, b) && !total_order(b, a))) {
+                fail(a, b, "bad totalOrder vs <");
+            }
+        }
+    }
+
+    if (!total_order(float16_t::zero(1), float16_t::zero(0)) || total_order(float16_t::zero(0), float16_t::zero(1))) {
+        fail(float16_t::zero(1), float16_t::zero(0), "bad totalOrder -0 < +0");
+    }
+}
+
+template<typename fp_t>
+void validate_sorted(const std::vector<fp_t> &expected, const std::vector<fp_t> &actual, char const *what)
+{
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i].to_bitstring() != actual[i].to_bitstring()) {
+            fail(expected[i], actual[i], what);
+        }
+    }
+}
+
+template<typename fp_t>
+void validate_sort(std::vector<fp_t> values)
+{
+    for (auto nans : { nan_placement::total_order, nan_placement::first, nan_placement::last })
+    {
+        auto less = [nans](fp_t a, fp_t b) { return ordered_before(a, b, nans); };
+
+        std::vector<fp_t> expected = values;
+        std::stable_sort(expected.begin(), expected.end(), less);
+
+        // keys only
+        std::vector<fp_t> actual = values;
+        batch::sort(actual.data(), actual.size(), nans);
+        validate_sorted(expected, actual, "bad sort");
+
+        // argsort matches a stable sort of the indices
+        std::vector<uint32_t> expected_indices(values.size()), indices(values.size());
+        std::iota(expected_indices.begin(), expected_indices.end(), 0u);
+        std::stable_sort(expected_indices.begin(), expected_indices.end(), [&](uint32_t a, uint32_t b) { return less(values[a], values[b]); });
+        batch::argsort(values.data(), values.size(), indices.data(), nans);
+        if (indices != expected_indices) {
+            throw std::exception("bad argsort");
+        }
+
+        // key-value carries the payload along
+        actual = values;
+        std::vector<uint64_t> payload(values.size());
+        std::iota(payload.begin(), payload.end(), uint64_t(0));
+        batch::sort(actual.data(), payload.data(), actual.size(), nans);
+        validate_sorted(expected, actual, "bad key-value sort");
+        for (size_t i = 0; i < payload.size(); ++i) {
+            if (payload[i] != expected_indices[i]) {
+                throw std::exception("bad key-value payload");
+            }
+        }
+    }
+}
+
+template<typename fp_t, typename uint_t>
+std::vector<fp_t> make_values(size_t count, uint64_t seed, int distinct_bits)
+{
+    std::vector<fp_t> values(count);
+    xorshift64 rng(seed | 1);
+    for (size_t i = 0; i < count; ++i) {
+        // limit distinct values so duplicates exercise stability
+        uint_t bits = static_cast<uint_t>(rng());
+        if (distinct_bits < int(sizeof(uint_t) * 8)) {
+            bits = static_cast<uint_t>(bits & ~((uint_t(1) << (sizeof(uint_t) * 8 - distinct_bits)) - 1));
+        }
+        values[i] = fp_t::from_bitstring(bits);
+    }
+    return values;
+}
+
+int main()
+{
+    try
+    {
+        validate_total_order();
+
+        // every 16-bit value, reversed
+        std::vector<float16_t> all(std::numeric_limits<uint16_t>::max() + 1);
+        for (size_t i = 0; i < all.size(); ++i) {
+            all[i] = float16_t::from_bitstring(uint16_t(all.size() - 1 - i));
+        }
+        validate_sort(all);
+        cout << ".";
+
+        validate_sort(make_values<float16_t, uint16_t>(1 << 20, 0x1234567, 16));
+        cout << ".";
+        validate_sort(make_values<float32_t, uint32_t>(1 << 20, 0x7654321, 12));
+        cout << ".";
+        validate_sort(make_values<float32_t, uint32_t>(100003, 0x2468ace, 32));
+        cout << ".";
+        validate_sort(make_values<float64_t, uint64_t>(1 << 19, 0x13579bd, 20));
+        cout << ".";
+        validate_sort(make_values<float64_t, uint64_t>(1001, 0xfdb9753, 64));
+        cout << ".";
+        validate_sort(std::vector<float32_t>{});
+        cout << "\n";
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,82 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cmath>
+
+#include <limits>
+
+#include "swunpacked.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the correctly rounded sqrt
+//  all 16-bit and 8-bit values against HW at 64-bit rounded once more, which
+//  is exact for formats of up to 25 bits of precision
+//  sampled binary32 and binary64 values against HW at their own precision
+//
+
+template <typename fp_t>
+void fail(fp_t a, fp_t expected, fp_t actual)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+    cout << "expected: " << expected.to_hex_string() << " " << expected.to_triplet_string() << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    throw std::exception("Failure: 'sqrt'");
+}
+
+template<fp_format format>
+void check(floatbase_t<format> a, floatbase_t<format> expected)
+{
+    auto actual = sqrt(a);
+    double e = static_cast<double>(expected), r = static_cast<double>(actual);
+    if (e != e) {
+        if (r == r) fail(a, expected, actual);
+    }
+    else if (expected.to_bitstring() != actual.to_bitstring()) {
+        fail(a, expected, actual);
+    }
+}
+
+template<fp_format format, typename uint_t>
+void validate_all()
+{
+    for (uint64_t i = 0; i <= std::numeric_limits<uint_t>::max(); ++i) {
+        auto a = floatbase_t<format>::from_bitstring(static_cast<uint_t>(i));
+        check(a, static_cast<floatbase_t<format>>(float64_t(std::sqrt(static_cast<double>(a)))));
+    }
+}
+
+int main()
+{
+    try
+    {
+        validate_all<fp_format::binary16, uint16_t>();
+        validate_all<fp_format::bfloat16, uint16_t>();
+        validate_all<fp_format::float8_e5m2, uint8_t>();
+
+        xorshift64 rng;
+        for (int i = 0; i < 4000000; ++i) {
+            const uint64_t bits = rng();
+
+            auto a32 = float32_t::from_bitstring(static_cast<uint32_t>(bits));
+            check(a32, float32_t(std::sqrt(static_cast<float>(a32))));
+            auto a64 = float64_t::from_bitstring(bits);
+            check(a64, float64_t(std::sqrt(static_cast<double>(a64))));
+        }
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,248 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include <limits>
+
+#include "swstochastic.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate stochastic rounding
+//  Philox4x32-10 known answers
+//  conversions and arithmetic pick the neighbour a double reference picks
+//  from the discarded fraction and the random bits
+//  the mean of many roundings is the exact value
+//  batch kernels match the scalar functions for any thread count
+//
+
+template <typename fp_t>
+void fail(size_t i, double expected, fp_t actual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "element: " << i << endl;
+    cout << "expected: " << expected << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+void validate_philox()
+{
+    // known answers of the reference implementation
+    struct { philox4x32::block_t counter; uint64_t seed; philox4x32::block_t expected; } const tests[] = {
+        { { 0, 0, 0, 0 }, 0, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+        { { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, 0xffffffffffffffff, { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+        { { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, 0x299f31d0a4093822, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+    };
+
+    for (auto &t : tests) {
+        if (philox4x32(t.seed)(t.counter) != t.expected) throw std::exception("philox known answer");
+    }
+}
+
+// the expected stochastic rounding of the exact value x into `out`
+template<fp_format out>
+floatbase_t<out> reference(double x, uint32_t random)
+{
+    using out_t = floatbase_t<out>;
+    using uint_t = typename fp_traits<out>::uint_t;
+    constexpr uint_t sign_mask = static_cast<uint_t>(uint_t(1) << (sizeof(uint_t) * 8 - 1));
+
+    const uint_t sign = std::signbit(x) ? sign_mask : 0;
+    const double magnitude = std::fabs(x);
+    auto value = [](uint_t bits) { return static_cast<double>(out_t::from_bitstring(bits)); };
+
+    // the neighbour towards zero and the one away from it
+    const out_t nearest = static_cast<out_t>(float64_t(magnitude));
+    uint_t lower = nearest.to_bitstring();
+    if (value(lower) > magnitude) {
+        --lower;
+    }
+    const uint_t upper = static_cast<uint_t>(lower + 1);
+    const double ulp = std::isinf(value(upper)) ? value(lower) - value(static_cast<uint_t>(lower - 1)) : value(upper) - value(lower);
+
+    const double fraction = (magnitude - value(lower)) / ulp;
+    const bool up = fraction >= 1 || std::floor(std::ldexp(fraction, 32)) + random >= 0x1p32;
+    return out_t::from_bitstring(static_cast<uint_t>((up ? upper : lower) | sign));
+}
+
+template<fp_format out, fp_format in>
+void check(size_t i, double exact, floatbase_t<in> x, floatbase_t<out> actual, uint32_t random, char const *what)
+{
+    floatbase_t<out> expected = exact != exact ? details::convert_format<out>(x) : reference<out>(exact, random);
+    if (expected.to_bitstring() != actual.to_bitstring()) fail(i, static_cast<double>(expected), actual, what);
+}
+
+template<fp_format out, fp_format in>
+void validate_conversion()
+{
+    using in_t = floatbase_t<in>;
+    using in_uint_t = typename fp_traits<in>::uint_t;
+
+    for (int i = 0; i < 300000; ++i) {
+        const auto x = in_t::from_bitstring(static_cast<in_uint_t>(next()));
+        const uint32_t random = static_cast<uint32_t>(next());
+        check(i, static_cast<double>(x), x, round_stochastic<out>(x, random), random, "conversion");
+
+        // ties and the extremes of the random bits
+        check(i, static_cast<double>(x), x, round_stochastic<out>(x, 0u), 0, "conversion random 0");
+        check(i, static_cast<double>(x), x, round_stochastic<out>(x, 0xffffffffu), 0xffffffff, "conversion random max");
+    }
+}
+
+// operands within a range where the double reference is exact
+float32_t random_operand(int exponent_range)
+{
+    const int e = static_cast<int>(next() % (2 * exponent_range + 1)) - exponent_range;
+    const uint32_t bits = static_cast<uint32_t>(((e + 127) << 23) | (next() & 0x807fffff));
+    return float32_t::from_bitstring(bits);
+}
+
+template<fp_format out>
+void validate_arithmetic()
+{
+    for (int i = 0; i < 300000; ++i) {
+        const float32_t a = random_operand(12), b = random_operand(12);
+        const double da = static_cast<double>(a), db = static_cast<double>(b);
+        const uint32_t random = static_cast<uint32_t>(next());
+
+        check(i, da + db, a, add_stochastic<out>(a, b, random), random, "add");
+        check(i, da - db, a, sub_stochastic<out>(a, b, random), random, "sub");
+        check(i, da * db, a, mul_stochastic<out>(a, b, random), random, "mul");
+
+        const float16_t x = static_cast<float16_t>(a), y = static_cast<float16_t>(b), z = static_cast<float16_t>(random_operand(12));
+        const double exact = static_cast<double>(x) * static_cast<double>(y) + static_cast<double>(z);
+        check(i, exact, x, fma_stochastic<out>(x, y, z, random), random, "fma");
+    }
+
+    // special values
+    const float32_t inf = float32_t::infinity(), one(1.0f);
+    if (!details::is_nan(add_stochastic<out>(inf, -inf, 0u))) throw std::exception("inf - inf");
+    if (!details::is_nan(mul_stochastic<out>(inf, float32_t::zero(), 0u))) throw std::exception("inf * 0");
+    if (add_stochastic<out>(one, -one, 0xffffffffu).to_bitstring() != 0) throw std::exception("x - x");
+    if (add_stochastic<out>(float32_t::zero(1), float32_t::zero(1), 0u).to_bitstring() != floatbase_t<out>::zero(1).to_bitstring()) throw std::exception("-0 + -0");
+}
+
+void validate_unbiased()
+{
+    // 1 + 1000 * 2^-10 in bfloat16: round-to-nearest never moves, stochastic
+    // rounding stays within a few standard deviations of the exact sum
+    const float32_t step(0x1p-10f);
+    bfloat16_t nearest(1.0f), stochastic(1.0f);
+    stochastic_rounding sr(42, 7);
+    for (int i = 0; i < 1000; ++i) {
+        nearest = static_cast<bfloat16_t>(static_cast<float32_t>(nearest) + step);
+        stochastic = sr.add<fp_format::bfloat16>(static_cast<float32_t>(stochastic), step);
+    }
+    if (static_cast<float>(nearest) != 1.0f) throw std::exception("round to nearest accumulation");
+    if (std::fabs(static_cast<float>(stochastic) - (1 + 1000 * 0x1p-10)) > 0.4) throw std::exception("stochastic accumulation");
+
+    // the same seed and stream give the same sequence
+    stochastic_rounding a(42, 7), b(42, 7), c(42, 8);
+    bool differ = false;
+    for (int i = 0; i < 100; ++i) {
+        const uint32_t x = a.next();
+        if (x != b.next()) throw std::exception("stochastic_rounding repeat");
+        differ |= x != c.next();
+    }
+    if (!differ) throw std::exception("stochastic_rounding streams");
+}
+
+template<fp_format from, fp_format to>
+void validate_batch(size_t count, thread_pool &pool1, thread_pool &pool4)
+{
+    using from_uint_t = typename fp_traits<from>::uint_t;
+
+    std::vector<floatbase_t<from>> src(count);
+    for (auto &x : src) {
+        x = floatbase_t<from>::from_bitstring(static_cast<from_uint_t>(next()));
+    }
+
+    std::vector<floatbase_t<to>> out1(count), out4(count), offset(count);
+    const auto flags1 = batch::round_stochastic(src.data(), out1.data(), count, 5, 3, pool1);
+    const auto flags4 = batch::round_stochastic(src.data(), out4.data(), count, 5, 3, pool4);
+    if (flags1 != flags4) throw std::exception("batch flags");
+
+    // element i uses the bits of element i whatever the chunk boundaries
+    batch::round_stochastic(src.data() + 1, offset.data() + 1, count - 1, 5, 3, pool4);
+
+    const philox4x32 generator(5);
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t random = generator.block(i / 4, 3)[i % 4];
+        const auto expected = round_stochastic<to>(src[i], random);
+        if (expected.to_bitstring() != out1[i].to_bitstring()) fail(i, static_cast<double>(expected), out1[i], "batch");
+        if (expected.to_bitstring() != out4[i].to_bitstring()) fail(i, static_cast<double>(expected), out4[i], "batch threads");
+
+        const uint32_t shifted = generator.block((i - 1) / 4, 3)[(i - 1) % 4];
+        if (i > 0 && round_stochastic<to>(src[i], shifted).to_bitstring() != offset[i].to_bitstring()) fail(i, 0, offset[i], "batch offset");
+    }
+}
+
+void validate_accumulate(thread_pool &pool1, thread_pool &pool4)
+{
+    const size_t count = 10001;
+    std::vector<bfloat16_t> acc1(count), acc4(count), expected(count);
+    std::vector<float32_t> x(count);
+    for (size_t i = 0; i < count; ++i) {
+        acc1[i] = acc4[i] = expected[i] = static_cast<bfloat16_t>(random_operand(4));
+        x[i] = random_operand(12);
+    }
+    x[0] = float32_t::indeterminate_nan();
+    x[1] = float32_t::infinity();
+
+    batch::accumulate_stochastic(acc1.data(), x.data(), count, 11, 0, pool1);
+    batch::accumulate_stochastic(acc4.data(), x.data(), count, 11, 0, pool4);
+
+    const philox4x32 generator(11);
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t random = generator.block(i / 4, 0)[i % 4];
+        const auto e = add_stochastic<fp_format::bfloat16>(static_cast<float32_t>(expected[i]), x[i], random);
+        if (e.to_bitstring() != acc1[i].to_bitstring()) fail(i, static_cast<double>(e), acc1[i], "accumulate");
+        if (e.to_bitstring() != acc4[i].to_bitstring()) fail(i, static_cast<double>(e), acc4[i], "accumulate threads");
+    }
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool1(1), pool4(4);
+
+        validate_philox();
+
+        validate_conversion<fp_format::bfloat16, fp_format::binary32>();
+        validate_conversion<fp_format::binary16, fp_format::binary32>();
+        validate_conversion<fp_format::float8_e5m2, fp_format::binary32>();
+        validate_conversion<fp_format::float8_e5m2, fp_format::binary16>();
+        validate_conversion<fp_format::binary32, fp_format::binary64>();
+
+        validate_arithmetic<fp_format::bfloat16>();
+        validate_arithmetic<fp_format::binary16>();
+        validate_arithmetic<fp_format::float8_e5m2>();
+
+        validate_unbiased();
+
+        validate_batch<fp_format::binary32, fp_format::bfloat16>(100003, pool1, pool4);
+        validate_batch<fp_format::binary32, fp_format::binary16>(20011, pool1, pool4);
+        validate_batch<fp_format::binary64, fp_format::binary32>(20011, pool1, pool4);
+
+        validate_accumulate(pool1, pool4);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,226 @@
+
+#include <stdint.h>
+#include <stdio.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <limits>
+
+#include "swtensor.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the .npy/raw tensor loader
+//  typed views read the values in place, converting views match the scalar conversions
+//  header parsing of dtype, shape and order, rejection of unsupported files
+//
+
+const char *test_path = "tensor_file_test.npy";
+
+template <typename fp_t>
+void fail(fp_t a, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+// write a version 1 .npy file, header padded so the data starts at a multiple of 64
+template<typename value_t>
+void write_npy(const std::string &descr, const std::string &shape, bool fortran_order, const std::vector<value_t> &values, uint8_t version = 1)
+{
+    std::string header = "{'descr': '" + descr + "', 'fortran_order': " + (fortran_order ? "True" : "False") + ", 'shape': " + shape + ", }";
+    const size_t prefix = (version == 1) ? 10 : 12;
+    header.append(63 - (prefix + header.size()) % 64, ' ');
+    header += '\n';
+
+    std::ofstream file(test_path, std::ios::binary);
+    file.write("\x93NUMPY", 6);
+    file.put(char(version));
+    file.put(0);
+    file.put(char(header.size() & 0xff));
+    file.put(char(header.size() >> 8));
+    if (version != 1) {
+        file.put(0);
+        file.put(0);
+    }
+    file.write(header.data(), header.size());
+    file.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(value_t));
+}
+
+template<fp_format format, typename fp_t>
+void validate_views(const tensor_file &tensor, const std::vector<fp_t> &values)
+{
+    if (tensor.format() != format || tensor.size() != values.size()) {
+        throw std::exception("bad tensor format or size");
+    }
+
+    auto view = tensor.view<format>();
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (view[i].to_bitstring() != values[i].to_bitstring()) fail(values[i], "bad typed view");
+    }
+
+    // lazy conversion matches the scalar and batch conversions
+    auto wide = tensor.view_as<fp_format::binary32>();
+    std::vector<float32_t> copied(values.size());
+    wide.copy_to(0, values.size(), copied.data());
+    size_t i = 0;
+    for (float32_t x : wide) {
+        float32_t expected;
+        if constexpr (format == fp_format::binary32) expected = values[i];
+        else expected = static_cast<float32_t>(values[i]);
+
+        if (x.to_bitstring() != expected.to_bitstring() || copied[i].to_bitstring() != expected.to_bitstring()) fail(values[i], "bad converting view");
+        ++i;
+    }
+
+    auto same = tensor.view_as<format>();
+    for (size_t j = 0; j < values.size(); ++j) {
+        if (same[j].to_bitstring() != values[j].to_bitstring()) fail(values[j], "bad same-format converting view");
+    }
+}
+
+template<typename fp_t, typename uint_t>
+std::vector<fp_t> make_values(size_t count)
+{
+    std::vector<fp_t> values(count);
+    xorshift64 rng(0x2468ace);
+    for (auto &v : values) {
+        v = fp_t::from_bitstring(static_cast<uint_t>(rng()));
+    }
+    return values;
+}
+
+bool rejects(const std::string &descr, const std::string &shape)
+{
+    write_npy(descr, shape, false, std::vector<uint16_t>(6));
+    try {
+        tensor_file::open(test_path);
+    }
+    catch (std::exception) {
+        return true;
+    }
+    return false;
+}
+
+void validate_npy()
+{
+    {
+        auto values = make_values<float16_t, uint16_t>(6);
+        write_npy("<f2", "(2, 3)", false, values);
+        auto tensor = tensor_file::open(test_path);
+        if (tensor.shape() != std::vector<size_t>{ 2, 3 } || tensor.fortran_order()) {
+            throw std::exception("bad shape");
+        }
+        validate_views<fp_format::binary16>(tensor, values);
+    }
+    {
+        auto values = make_values<float32_t, uint32_t>(1000);
+        write_npy("<f4", "(10, 10, 10)", true, values, 2);
+        auto tensor = tensor_file::open(test_path);
+        if (tensor.shape() != std::vector<size_t>{ 10, 10, 10 } || !tensor.fortran_order()) {
+            throw std::exception("bad shape");
+        }
+        validate_views<fp_format::binary32>(tensor, values);
+    }
+    {
+        auto values = make_values<float64_t, uint64_t>(7);
+        write_npy("<f8", "(7,)", false, values);
+        validate_views<fp_format::binary64>(tensor_file::open(test_path), values);
+    }
+    {
+        // bfloat16 stored with an opaque dtype
+        auto values = make_values<bfloat16_t, uint16_t>(33);
+        write_npy("<V2", "(33,)", false, values);
+        auto tensor = tensor_file::open(test_path, fp_format::bfloat16);
+        validate_views<fp_format::bfloat16>(tensor, values);
+
+        bool mismatch = false;
+        try {
+            tensor.view<fp_format::binary16>();
+        }
+        catch (std::exception) {
+            mismatch = true;
+        }
+        if (!mismatch) {
+            throw std::exception("format mismatch accepted");
+        }
+
+        // numpy writes plain void dtypes without a byte order
+        write_npy("|V2", "(33,)", false, values);
+        validate_views<fp_format::bfloat16>(tensor_file::open(test_path, fp_format::bfloat16), values);
+    }
+    {
+        // scalar
+        write_npy("<f4", "()", false, std::vector<float32_t>{ float32_t(2.5f) });
+        auto tensor = tensor_file::open(test_path);
+        if (!tensor.shape().empty() || tensor.size() != 1 || static_cast<float>(tensor.view<fp_format::binary32>()[0]) != 2.5f) {
+            throw std::exception("bad scalar tensor");
+        }
+    }
+
+    if (!rejects(">f2", "(6,)") || !rejects("<V2", "(6,)") || !rejects("<f2", "(7,)") || !rejects("<i4", "(3,)")) {
+        throw std::exception("unsupported file accepted");
+    }
+
+    // shapes whose element count wraps around to something the file can hold
+    if (!rejects("<f2", "(4294967296, 4294967296)") || !rejects("<f2", "(9223372036854775809, 2)")) {
+        throw std::exception("overflowing shape accepted");
+    }
+
+    remove(test_path);
+}
+
+void validate_raw()
+{
+    auto values = make_values<float8_e5m2_t, uint8_t>(30);
+    {
+        std::ofstream file(test_path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(values.data()), values.size());
+    }
+
+    validate_views<fp_format::float8_e5m2>(tensor_file::open_raw(test_path, fp_format::float8_e5m2), values);
+
+    auto tensor = tensor_file::open_raw(test_path, fp_format::float8_e5m2, { 2, 3, 5 });
+    if (tensor.shape() != std::vector<size_t>{ 2, 3, 5 }) {
+        throw std::exception("bad raw shape");
+    }
+
+    bool rejected = false;
+    try {
+        tensor_file::open_raw(test_path, fp_format::binary64);
+    }
+    catch (std::exception) {
+        rejected = true;
+    }
+    if (!rejected) {
+        throw std::exception("bad raw size accepted");
+    }
+
+    remove(test_path);
+}
+
+int main()
+{
+    try
+    {
+        validate_npy();
+        validate_raw();
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
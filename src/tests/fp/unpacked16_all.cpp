@@ -0,0 +1,131 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <limits>
+
+#include "swunpacked.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate unpacked arithmetic
+//  every value survives unpack/pack, single operations packed once are
+//  correctly rounded, chains rounded at every step match separately rounded
+//  operations, and fma rounds once
+//  the reference is computed in HW at 64-bit whenever that is exact
+//
+
+template <typename fp_t>
+void fail(fp_t a, fp_t b, fp_t expected, fp_t actual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+    cout << "b: " << b.to_hex_string() << " " << b.to_triplet_string() << endl;
+    cout << "expected: " << expected.to_hex_string() << " " << expected.to_triplet_string() << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+// a + b computed in double when that is exact: a single rounding from there
+// is the correctly rounded result in the narrow format
+bool exact_sum(double a, double b, double &sum)
+{
+    sum = a + b;
+    if (sum != sum || sum - sum != 0) {
+        return true;
+    }
+
+    // TwoSum error term
+    double bb = sum - a;
+    return (a - (sum - bb)) + (b - bb) == 0;
+}
+
+template<fp_format format>
+void check(floatbase_t<format> a, floatbase_t<format> b, double exact, floatbase_t<format> actual, char const *what)
+{
+    auto expected = static_cast<floatbase_t<format>>(float64_t(exact));
+    if (exact != exact) {
+        if (static_cast<double>(actual) == static_cast<double>(actual)) fail(a, b, expected, actual, what);
+    }
+    else if (expected.to_bitstring() != actual.to_bitstring()) {
+        fail(a, b, expected, actual, what);
+    }
+}
+
+template<fp_format format>
+void validate_ops(floatbase_t<format> a, floatbase_t<format> b, floatbase_t<format> c)
+{
+    using fp_t = floatbase_t<format>;
+    auto ua = unpack(a), ub = unpack(b), uc = unpack(c);
+    double x = static_cast<double>(a), y = static_cast<double>(b), z = static_cast<double>(c);
+
+    // products of narrow values are exact in double
+    double exact;
+    if (exact_sum(x, y, exact)) check(a, b, exact, (ua + ub).pack(), "add");
+    if (exact_sum(x, -y, exact)) check(a, b, exact, (ua - ub).pack(), "sub");
+    check(a, b, x * y, (ua * ub).pack(), "mul");
+    check(a, a, -x, (-ua).pack(), "neg");
+
+    // rounding at every step gives the result of separately rounded operations
+    fp_t product = static_cast<fp_t>(float64_t(x * y));
+    if (exact_sum(static_cast<double>(product), z, exact)) check(a, b, exact, ((ua * ub).round() + uc).pack(), "mul-add chain");
+
+    // fma rounds once
+    if (exact_sum(x * y, z, exact)) check(a, b, exact, fma(ua, ub, uc).pack(), "fma");
+}
+
+template<fp_format format, typename uint_t>
+void validate_format(uint64_t samples)
+{
+    using fp_t = floatbase_t<format>;
+
+    // unpack/pack is the identity, NaN payloads included
+    for (uint64_t i = 0; i <= std::numeric_limits<uint_t>::max(); ++i) {
+        auto x = fp_t::from_bitstring(static_cast<uint_t>(i));
+        if (unpack(x).pack().to_bitstring() != x.to_bitstring()) fail(x, x, x, unpack(x).pack(), "round trip");
+    }
+
+    xorshift64 rng;
+    auto next = [&]() { return static_cast<uint_t>(rng()); };
+
+    for (uint64_t i = 0; i < samples; ++i) {
+        auto a = fp_t::from_bitstring(next());
+        auto b = fp_t::from_bitstring(next());
+        auto c = fp_t::from_bitstring(next());
+        validate_ops(a, b, c);
+    }
+}
+
+int main()
+{
+    try
+    {
+        validate_format<fp_format::binary16, uint16_t>(4000000);
+        validate_format<fp_format::bfloat16, uint16_t>(4000000);
+
+        // all pairs of 8-bit values
+        using fp8_t = float8_e5m2_t;
+        for (int i = 0; i < 256; ++i) {
+            for (int j = 0; j < 256; ++j) {
+                auto a = fp8_t::from_bitstring(uint8_t(i)), b = fp8_t::from_bitstring(uint8_t(j));
+                validate_ops(a, b, fp8_t::from_bitstring(uint8_t(i ^ j)));
+            }
+        }
+        validate_format<fp_format::float8_e5m2, uint8_t>(1000000);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
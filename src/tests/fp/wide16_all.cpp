@@ -0,0 +1,183 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <execution>
+#include <atomic>
+
+#include <limits>
+
+#include "swunpacked.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate widening operations
+//  mul_wide and add_wide for all pairs of 8-bit and of binary16 values, and
+//  sampled pairs of bfloat16/32-bit values, fma_wide for sampled triples
+//  compute in HW at 64-bit and round to the wide format
+//
+
+template <typename narrow_t, typename wide_t>
+void fail(narrow_t a, narrow_t b, wide_t expected, wide_t actual, char const *what)
+{
+    cout << "failed!" << endl;
+    cout << "a: " << a.to_hex_string() << " " << a.to_triplet_string() << endl;
+    cout << "b: " << b.to_hex_string() << " " << b.to_triplet_string() << endl;
+    cout << "expected: " << expected.to_hex_string() << " " << expected.to_triplet_string() << endl;
+    cout << "actual:   " << actual.to_hex_string() << " " << actual.to_triplet_string() << endl;
+
+    auto err = std::string{ "Failure: '" } + what + "'";
+    throw std::exception(err.c_str());
+}
+
+// round a double that holds the exact result into the wide format
+template<fp_format wide>
+floatbase_t<wide> reference(double x)
+{
+    if constexpr (wide == fp_format::binary64) {
+        return floatbase_t<wide>(x);
+    }
+    else {
+        return static_cast<floatbase_t<wide>>(float64_t(x));
+    }
+}
+
+template<fp_format wide, fp_format narrow>
+void check(floatbase_t<narrow> a, floatbase_t<narrow> b, double exact, floatbase_t<wide> actual, char const *what)
+{
+    auto expected = reference<wide>(exact);
+    if (std::isnan(exact)) {
+        if (!std::isnan(static_cast<double>(actual))) fail(a, b, expected, actual, what);
+    }
+    else if (expected.to_bitstring() != actual.to_bitstring()) {
+        fail(a, b, expected, actual, what);
+    }
+}
+
+// a + b is exact in double
+bool exact_sum(double a, double b, double &sum)
+{
+    sum = a + b;
+    if (!std::isfinite(sum)) {
+        return true;
+    }
+
+    double bb = sum - a;
+    return (a - (sum - bb)) + (b - bb) == 0;
+}
+
+template<fp_format wide, fp_format narrow>
+void validate_pair(floatbase_t<narrow> a, floatbase_t<narrow> b)
+{
+    double x = static_cast<double>(a), y = static_cast<double>(b);
+
+    // the narrow products are exact in double
+    check(a, b, x * y, mul_wide<wide>(a, b), "mul_wide");
+
+    double sum;
+    if (exact_sum(x, y, sum)) {
+        check(a, b, sum, add_wide<wide>(a, b), "add_wide");
+    }
+}
+
+template<fp_format wide, fp_format narrow>
+void validate(floatbase_t<narrow> a, floatbase_t<narrow> b, floatbase_t<wide> c)
+{
+    validate_pair<wide>(a, b);
+
+    double x = static_cast<double>(a), y = static_cast<double>(b), z = static_cast<double>(c);
+    double sum;
+    if constexpr (wide == fp_format::binary64) {
+        check(a, b, std::fma(x, y, z), fma_wide<wide>(a, b, c), "fma_wide");
+    }
+    else if (exact_sum(x * y, z, sum)) {
+        check(a, b, sum, fma_wide<wide>(a, b, c), "fma_wide");
+    }
+}
+
+template<fp_format wide, fp_format narrow, typename narrow_uint_t, typename wide_uint_t>
+void validate_sampled(uint64_t samples)
+{
+    xorshift64 next(0x2545f4914f6cdd1d);
+
+    for (uint64_t i = 0; i < samples; ++i) {
+        auto a = floatbase_t<narrow>::from_bitstring(static_cast<narrow_uint_t>(next()));
+        auto b = floatbase_t<narrow>::from_bitstring(static_cast<narrow_uint_t>(next()));
+
+        // accumulators near the product make the fma interesting
+        auto c = floatbase_t<wide>::from_bitstring(static_cast<wide_uint_t>(next()));
+        if (i % 2) {
+            c = -mul_wide<wide>(a, b);
+            c = floatbase_t<wide>::from_bitstring(static_cast<wide_uint_t>(c.to_bitstring() ^ (next() & 0xff)));
+        }
+
+        validate<wide>(a, b, c);
+    }
+}
+
+std::atomic<int> count = 0;
+
+// every pair of binary16 values into binary32, parallelizing the outer loop
+void validate_all16()
+{
+    // fill array with values for std::for_each
+    static float16_t values[std::numeric_limits<uint16_t>::max() + 1];
+    for (int i = 0; i <= std::numeric_limits<uint16_t>::max(); ++i) {
+        values[i] = float16_t::from_bitstring(uint16_t(i));
+    }
+
+    std::for_each(std::execution::par_unseq, std::begin(values), std::end(values), [](float16_t a) {
+        for (int j = 0; j <= std::numeric_limits<uint16_t>::max(); ++j) {
+            validate_pair<fp_format::binary32>(a, float16_t::from_bitstring(uint16_t(j)));
+        }
+
+        // output progress
+        int old_value = count.fetch_add(1);
+        if (old_value % 10000 == 0) {
+            cout << "@";
+        }
+        else if (old_value % 1000 == 0) {
+            cout << "$";
+        }
+        else if (old_value % 100 == 0) {
+            cout << ".";
+        }
+    });
+
+    cout << "\n";
+}
+
+int main()
+{
+    try
+    {
+        // all pairs of 8-bit values into binary16
+        for (int i = 0; i < 256; ++i) {
+            for (int j = 0; j < 256; ++j) {
+                auto a = float8_e5m2_t::from_bitstring(uint8_t(i)), b = float8_e5m2_t::from_bitstring(uint8_t(j));
+                validate<fp_format::binary16>(a, b, float16_t::from_bitstring(uint16_t(i * 256 + j)));
+            }
+        }
+
+        validate_all16();
+
+        validate_sampled<fp_format::binary32, fp_format::binary16, uint16_t, uint32_t>(4000000);
+        validate_sampled<fp_format::binary32, fp_format::bfloat16, uint16_t, uint32_t>(4000000);
+        validate_sampled<fp_format::binary64, fp_format::binary32, uint32_t, uint64_t>(4000000);
+        validate_sampled<fp_format::binary64, fp_format::binary16, uint16_t, uint64_t>(1000000);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
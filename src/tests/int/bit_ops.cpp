@@ -0,0 +1,166 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cstring>
+
+#include <limits>
+
+#include "swint.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the bit manipulation API of intbase_t, for the halves and flat layouts
+//  popcount, countl_zero, countr_zero, bit_width and byteswap
+//  funnel shifts, rotates and << / >> for every amount
+// against a bit-by-bit model of the value as an array of bytes
+//
+
+// random bytes with runs of zero and all-ones bytes and sparse values
+template<typename int_t>
+int_t random_value()
+{
+    uint8_t bytes[sizeof(int_t)];
+    const uint64_t pattern = next();
+    for (size_t i = 0; i < sizeof(int_t); ++i) {
+        switch ((pattern >> (2 * (i % 32))) & 3) {
+        case 0: bytes[i] = 0; break;
+        case 1: bytes[i] = 0xff; break;
+        default: bytes[i] = static_cast<uint8_t>(next()); break;
+        }
+    }
+    if ((pattern >> 62) == 3) {
+        memset(bytes, 0, sizeof(bytes));
+        bytes[next() % sizeof(int_t)] = static_cast<uint8_t>(1 << (next() % 8));
+    }
+
+    int_t r;
+    memcpy(&r, bytes, sizeof(r));
+    return r;
+}
+
+template<typename int_t>
+struct bits_t
+{
+    static constexpr int size = sizeof(int_t) * 8;
+    uint8_t bytes[sizeof(int_t)] = {};
+
+    bits_t() = default;
+    explicit bits_t(int_t x) { memcpy(bytes, &x, sizeof(bytes)); }
+
+    int get(int i) const { return (i >= 0 && i < size) ? (bytes[i / 8] >> (i % 8)) & 1 : 0; }
+    void set(int i, int bit) { bytes[i / 8] = static_cast<uint8_t>((bytes[i / 8] & ~(1 << (i % 8))) | (bit << (i % 8))); }
+
+    int_t value() const
+    {
+        int_t r;
+        memcpy(&r, bytes, sizeof(r));
+        return r;
+    }
+};
+
+template<typename int_t>
+void fail(const char *what, int_t x, int amount)
+{
+    cout << "failed: " << what << " of " << int_t::to_string(x) << " by " << amount << ", " << sizeof(int_t) * 8 << " bits" << endl;
+    throw std::exception(what);
+}
+
+template<typename int_t>
+void validate(int count)
+{
+    using model_t = bits_t<int_t>;
+    constexpr int size = model_t::size;
+
+    for (int n = 0; n < count; ++n) {
+        const int_t x = random_value<int_t>(), y = random_value<int_t>();
+        const model_t bx(x), by(y);
+
+        int ones = 0, leading = size, trailing = size;
+        for (int i = 0; i < size; ++i) {
+            ones += bx.get(i);
+            if (bx.get(i) && trailing == size) {
+                trailing = i;
+            }
+            if (bx.get(i)) {
+                leading = size - 1 - i;
+            }
+        }
+        if (int_t::popcount(x) != ones) fail("popcount", x, 0);
+        if (int_t::countl_zero(x) != leading) fail("countl_zero", x, 0);
+        if (int_t::countr_zero(x) != trailing) fail("countr_zero", x, 0);
+        if (int_t::bit_width(x) != size - leading) fail("bit_width", x, 0);
+
+        model_t swapped;
+        for (size_t i = 0; i < sizeof(int_t); ++i) {
+            swapped.bytes[i] = bx.bytes[sizeof(int_t) - 1 - i];
+        }
+        if (int_t::byteswap(x) != swapped.value() || int_t::byteswap(int_t::byteswap(x)) != x) fail("byteswap", x, 0);
+
+        // every amount for the first values, a few random ones after that
+        for (int k = 0; k < (n < 4 ? size : 8); ++k) {
+            const int amount = n < 4 ? k : static_cast<int>(next() % size);
+
+            model_t left, right, rotate_left, rotate_right, shift_left, shift_right;
+            const int sign = int_t::is_signed ? bx.get(size - 1) : 0;
+            for (int i = 0; i < size; ++i) {
+                // (y:x) << amount, upper half, and (x:y) >> amount, lower half
+                left.set(i, i - amount >= 0 ? bx.get(i - amount) : by.get(size + i - amount));
+                right.set(i, i + amount < size ? by.get(i + amount) : bx.get(i + amount - size));
+                rotate_left.set(i, bx.get((i - amount + size) % size));
+                rotate_right.set(i, bx.get((i + amount) % size));
+                shift_left.set(i, bx.get(i - amount));
+                shift_right.set(i, i + amount < size ? bx.get(i + amount) : sign);
+            }
+
+            if (int_t::funnel_shift_left(x, y, amount) != left.value()) fail("funnel_shift_left", x, amount);
+            if (int_t::funnel_shift_right(x, y, amount) != right.value()) fail("funnel_shift_right", x, amount);
+            if (int_t::rotl(x, amount) != rotate_left.value() || int_t::rotr(x, -amount) != rotate_left.value()) fail("rotl", x, amount);
+            if (int_t::rotr(x, amount) != rotate_right.value() || int_t::rotl(x, -amount - 3 * size) != rotate_right.value()) fail("rotr", x, amount);
+            if ((x << amount) != shift_left.value()) fail("<<", x, amount);
+            if ((x >> amount) != shift_right.value()) fail(">>", x, amount);
+        }
+    }
+
+    if (int_t::popcount(int_t(0)) != 0 || int_t::countl_zero(int_t(0)) != size || int_t::countr_zero(int_t(0)) != size || int_t::bit_width(int_t(0)) != 0) {
+        throw std::exception("zero");
+    }
+    if (int_t::popcount(~int_t(0)) != size || int_t::countl_zero(~int_t(0)) != 0 || int_t::countr_zero(~int_t(0)) != 0) {
+        throw std::exception("all ones");
+    }
+}
+
+int main()
+{
+    try
+    {
+        validate<uint16sw_t>(20000);
+        validate<int16sw_t>(20000);
+        validate<uint32sw_t>(20000);
+        validate<int32sw_t>(20000);
+        validate<uint64sw_t>(20000);
+        validate<int64sw_t>(20000);
+        validate<uint128sw_t>(10000);
+        validate<int128sw_t>(10000);
+
+        // the halves layout above 128 bits as well as the default flat one
+        validate<intbase_t<32, false, details::int_halves>>(5000);
+        validate<intbase_t<32, true, details::int_halves>>(5000);
+        validate<uint256sw_t>(5000);
+        validate<int256sw_t>(5000);
+        validate<uint512sw_t>(2000);
+        validate<int512sw_t>(2000);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
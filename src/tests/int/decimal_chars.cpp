@@ -0,0 +1,251 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <charconv>
+
+#include <limits>
+
+#include "swint.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate decimal to_chars and from_chars
+//  every 16-bit value against std::to_chars and std::from_chars
+//  random values of 64 to 512 bits against digits found by division by 10,
+//  round trips and the to_string wrappers
+//  limits, chunk boundaries and leading zeros
+//  short buffers, empty input, signs, out of range values and the
+//  _i128sw literal
+//
+
+// digits by repeated division, the slow way
+template<typename int_t>
+std::string reference_string(int_t x)
+{
+    const bool negative = x < int_t(0);
+    std::string s;
+    do {
+        int_t digit = x % int_t(10);
+        x = x / int_t(10);
+        if (negative) {
+            digit = -digit;
+        }
+        uint8_t low = 0;
+        memcpy(&low, &digit, 1);
+        s += static_cast<char>('0' + low);
+    } while (!!x);
+    if (negative) {
+        s += '-';
+    }
+    return std::string(s.rbegin(), s.rend());
+}
+
+// a decimal string plus one
+std::string increment(std::string s)
+{
+    int i = static_cast<int>(s.size()) - 1;
+    for (; i >= 0 && s[i] == '9'; --i) {
+        s[i] = '0';
+    }
+    if (i < 0) {
+        return "1" + s;
+    }
+    ++s[i];
+    return s;
+}
+
+template<typename int_t>
+std::string chars(int_t x)
+{
+    char buffer[200];
+    const std::to_chars_result result = to_chars(buffer, buffer + sizeof(buffer), x);
+    if (result.ec != std::errc()) throw std::exception("to_chars failed");
+    return std::string(buffer, result.ptr);
+}
+
+template<typename int_t>
+int_t parse(const std::string &s)
+{
+    int_t x;
+    const std::from_chars_result result = from_chars(s.data(), s.data() + s.size(), x);
+    if (result.ec != std::errc() || result.ptr != s.data() + s.size()) {
+        cout << "failed: " << s << endl;
+        throw std::exception("from_chars failed");
+    }
+    return x;
+}
+
+void validate_all16()
+{
+    for (int i = 0; i <= std::numeric_limits<uint16_t>::max(); ++i) {
+        char expected[16], actual[16];
+
+        const uint16_t u = static_cast<uint16_t>(i);
+        char *end = std::to_chars(expected, expected + sizeof(expected), u).ptr;
+        if (chars(static_cast<uint16sw_t>(u)) != std::string(expected, end)) throw std::exception("uint16 to_chars");
+        if (static_cast<uint16_t>(parse<uint16sw_t>(std::string(expected, end))) != u) throw std::exception("uint16 from_chars");
+
+        const int16_t s = static_cast<int16_t>(u);
+        end = std::to_chars(expected, expected + sizeof(expected), s).ptr;
+        if (chars(static_cast<int16sw_t>(s)) != std::string(expected, end)) throw std::exception("int16 to_chars");
+        if (static_cast<int16_t>(parse<int16sw_t>(std::string(expected, end))) != s) throw std::exception("int16 from_chars");
+
+        // the exact length fits, one less does not
+        const ptrdiff_t length = end - expected;
+        if (to_chars(actual, actual + length - 1, static_cast<int16sw_t>(s)).ec != std::errc::value_too_large) throw std::exception("int16 short buffer");
+    }
+}
+
+template<typename int_t>
+void validate_random(int count)
+{
+    constexpr int bitsize = sizeof(int_t) * 8;
+
+    for (int i = 0; i < count; ++i) {
+        const int_t x = random_value<int_t>(1 + static_cast<int>(next() % bitsize));
+        const int_t y = int_t::is_signed && (next() & 1) ? -x : x;
+
+        const std::string s = chars(y);
+        if (s != reference_string(y)) {
+            cout << "to_chars: " << s << ", expected " << reference_string(y) << endl;
+            throw std::exception("to_chars digits");
+        }
+        if (parse<int_t>(s) != y) throw std::exception("round trip");
+        if (int_t::to_string(y) != s) throw std::exception("to_string");
+
+        // the exact length fits, one less does not
+        char buffer[200];
+        if (to_chars(buffer, buffer + s.size(), y).ptr != buffer + s.size()) throw std::exception("exact buffer");
+        if (to_chars(buffer, buffer + s.size() - 1, y).ec != std::errc::value_too_large) throw std::exception("short buffer");
+    }
+}
+
+template<typename int_t>
+void validate_limits()
+{
+    const std::string max = reference_string(int_t::max()), min = reference_string(int_t::min());
+    if (chars(int_t::max()) != max || chars(int_t::min()) != min || chars(int_t(0)) != "0") throw std::exception("limits to_chars");
+    if (parse<int_t>(max) != int_t::max() || parse<int_t>(min) != int_t::min()) throw std::exception("limits from_chars");
+    if (parse<int_t>(std::string(50, '0') + "17") != int_t(17)) throw std::exception("leading zeros");
+    if constexpr (int_t::is_signed) {
+        if (parse<int_t>("-0") != int_t(0) || parse<int_t>("-" + std::string(50, '0') + "17") != int_t(-17)) throw std::exception("negative leading zeros");
+    }
+
+    // one past either end, consumed to the end of the digits, value untouched
+    const std::string over = increment(max);
+    int_t x = int_t(5);
+    std::string text = over + "x";
+    std::from_chars_result result = from_chars(text.data(), text.data() + text.size(), x);
+    if (result.ec != std::errc::result_out_of_range || result.ptr != text.data() + over.size() || x != int_t(5)) throw std::exception("max + 1");
+
+    text = max + "1234567890123456789012345";
+    result = from_chars(text.data(), text.data() + text.size(), x);
+    if (result.ec != std::errc::result_out_of_range || result.ptr != text.data() + text.size() || x != int_t(5)) throw std::exception("max * 10^25");
+
+    if constexpr (int_t::is_signed) {
+        const std::string under = "-" + increment(min.substr(1));
+        result = from_chars(under.data(), under.data() + under.size(), x);
+        if (result.ec != std::errc::result_out_of_range || x != int_t(5)) throw std::exception("min - 1");
+    }
+
+    // no digits
+    for (const char *bad : { "", "-", "+1", " 1", "x" }) {
+        result = from_chars(bad, bad + strlen(bad), x);
+        if (result.ec != std::errc::invalid_argument || result.ptr != bad || x != int_t(5)) throw std::exception("invalid input");
+    }
+    if constexpr (!int_t::is_signed) {
+        const char *negative = "-1";
+        if (from_chars(negative, negative + 2, x).ec != std::errc::invalid_argument) throw std::exception("unsigned minus");
+    }
+
+    // stops at the first non-digit, including one inside an 8-digit word, and
+    // the characters either side of '0' to '9'
+    for (const char *mixed : { "12345a789", "12345/789", "12345:789", "12345\x80" "7890" }) {
+        result = from_chars(mixed, mixed + strlen(mixed), x);
+        if (result.ec != std::errc() || result.ptr != mixed + 5 || x != int_t(12345)) throw std::exception("stop at non-digit");
+    }
+}
+
+void validate_chunks()
+{
+    // values around 10^19 and 10^38, the limb chunk boundaries
+    const uint128sw_t p19 = uint128sw_t(10000000000000000000ull);
+    const uint128sw_t p38 = p19 * p19;
+    const uint128sw_t values[] = { p19 - uint128sw_t(1), p19, p19 + uint128sw_t(1), p38 - uint128sw_t(1), p38, p38 + uint128sw_t(1), uint128sw_t(~uint64_t(0)) };
+    for (const uint128sw_t &v : values) {
+        if (chars(v) != reference_string(v) || parse<uint128sw_t>(chars(v)) != v) throw std::exception("chunk boundary");
+    }
+
+    // multiples of 10^19 have all-zero chunks
+    for (int i = 0; i < 10000; ++i) {
+        const uint256sw_t v = random_value<uint256sw_t>(1 + static_cast<int>(next() % 190)) * uint256sw_t(10000000000000000000ull);
+        if (chars(v) != reference_string(v)) throw std::exception("multiple of 10^19");
+    }
+
+    if (chars(p38) != "100000000000000000000000000000000000000") throw std::exception("10^38");
+    if (to_string(uint128sw_t::max()) != "340282366920938463463374607431768211455") throw std::exception("to_string(uint128sw_t)");
+    if (to_string(int128sw_t::min()) != "-170141183460469231731687303715884105728") throw std::exception("to_string(int128sw_t)");
+    if (to_wstring(uint128sw_t(12345)) != L"12345") throw std::exception("to_wstring(uint128sw_t)");
+}
+
+void validate_literals()
+{
+    if (170141183460469231731687303715884105727_i128sw != int128sw_t::max()) throw std::exception("max literal");
+    if (10000000000000000000000_i128sw != int128sw_t(10000000000ll) * int128sw_t(1000000000000ll)) throw std::exception("decimal literal");
+
+    bool thrown = false;
+    try {
+        170141183460469231731687303715884105728_i128sw;
+    }
+    catch (std::exception) {
+        thrown = true;
+    }
+    if (!thrown) throw std::exception("literal out of range accepted");
+}
+
+int main()
+{
+    try
+    {
+        validate_all16();
+
+        validate_random<uint32sw_t>(20000);
+        validate_random<int32sw_t>(20000);
+        validate_random<uint64sw_t>(20000);
+        validate_random<int64sw_t>(20000);
+        validate_random<uint128sw_t>(5000);
+        validate_random<int128sw_t>(5000);
+        validate_random<uint256sw_t>(2000);
+        validate_random<int256sw_t>(2000);
+        validate_random<uint512sw_t>(500);
+        validate_random<int512sw_t>(500);
+
+        validate_limits<uint16sw_t>();
+        validate_limits<int16sw_t>();
+        validate_limits<uint64sw_t>();
+        validate_limits<int64sw_t>();
+        validate_limits<uint128sw_t>();
+        validate_limits<int128sw_t>();
+        validate_limits<uint256sw_t>();
+        validate_limits<int256sw_t>();
+        validate_limits<uint512sw_t>();
+        validate_limits<int512sw_t>();
+
+        validate_chunks();
+        validate_literals();
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,189 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <execution>
+#include <atomic>
+#include <vector>
+#include <cstring>
+
+#include <limits>
+
+#include "swdivider.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate division by invariant integers
+//  every 16-bit dividend and divisor, signed and unsigned, for the built-in
+//  and intbase_t dividers against intbase_t::div
+//  random 64- and 128-bit dividends and divisors of every length, and the
+//  divisors 1, -1, powers of 2, max and min
+//
+
+void validate_divisor16(uint16_t y)
+{
+    const divider<uint16_t> hw_unsigned(y);
+    const divider<uint16sw_t> sw_unsigned(static_cast<uint16sw_t>(y));
+    const divider<int16_t> hw_signed(static_cast<int16_t>(y));
+    const divider<int16sw_t> sw_signed(static_cast<int16sw_t>(static_cast<int16_t>(y)));
+
+    for (int i = 0; i <= std::numeric_limits<uint16_t>::max(); ++i) {
+        const uint16_t x = static_cast<uint16_t>(i);
+
+        {
+            const uint16sw_t a = static_cast<uint16sw_t>(x), b = static_cast<uint16sw_t>(y);
+            const uint16sw_t q = a / b, r = a % b;
+
+            const uint16sw_t sq = a / sw_unsigned, sr = a % sw_unsigned;
+            const uint16_t hq = x / hw_unsigned, hr = x % hw_unsigned;
+            if (memcmp(&q, &sq, sizeof(q)) || memcmp(&r, &sr, sizeof(r)) || memcmp(&q, &hq, sizeof(q)) || memcmp(&r, &hr, sizeof(r))) {
+                cout << std::hex << "x=0x" << x << ", y=0x" << y << ", q=0x" << (uint16_t)q << ", divider q=0x" << (uint16_t)sq << ", 0x" << hq << endl;
+                throw std::exception("bad unsigned divider");
+            }
+        }
+
+        // skip the overflowing min / -1
+        if (x == 0x8000 && y == 0xffff) {
+            continue;
+        }
+
+        {
+            const int16sw_t a = static_cast<int16sw_t>(static_cast<int16_t>(x)), b = static_cast<int16sw_t>(static_cast<int16_t>(y));
+            const int16sw_t q = a / b, r = a % b;
+
+            const int16sw_t sq = a / sw_signed, sr = a % sw_signed;
+            const int16_t hq = static_cast<int16_t>(x) / hw_signed, hr = static_cast<int16_t>(x) % hw_signed;
+            if (memcmp(&q, &sq, sizeof(q)) || memcmp(&r, &sr, sizeof(r)) || memcmp(&q, &hq, sizeof(q)) || memcmp(&r, &hr, sizeof(r))) {
+                cout << std::hex << "x=0x" << x << ", y=0x" << y << ", q=0x" << (uint16_t)q << ", divider q=0x" << (uint16_t)sq << ", 0x" << (uint16_t)hq << endl;
+                throw std::exception("bad signed divider");
+            }
+        }
+    }
+}
+
+std::atomic<int> count = 0;
+
+void validate_all16()
+{
+    // fill array with divisors for std::for_each
+    static uint16_t values[std::numeric_limits<uint16_t>::max()];
+    for (int i = 0; i < std::numeric_limits<uint16_t>::max(); ++i) {
+        values[i] = uint16_t(i + 1);
+    }
+
+    // run through all divisors in parallel
+    std::for_each(std::execution::par_unseq, std::begin(values), std::end(values), [](uint16_t y) {
+        try
+        {
+            validate_divisor16(y);
+
+            // output progress
+            int old_value = count.fetch_add(1);
+            if (old_value % 10000 == 0) {
+                cout << "@";
+            }
+            else if (old_value % 1000 == 0) {
+                cout << "$";
+            }
+        }
+        catch (std::exception e)
+        {
+            cout << "test failed: " << e.what() << endl;
+            std::terminate();
+        }
+    });
+    cout << "\n";
+}
+
+template<typename int_t>
+void check(const divider<int_t> &d, int_t n)
+{
+    const int_t q = n / d.divisor(), r = n % d.divisor();
+    if (n / d != q || n % d != r) {
+        cout << "n = " << int_t::to_string(n) << ", d = " << int_t::to_string(d.divisor()) << endl;
+        throw std::exception("bad wide divider");
+    }
+}
+
+// int_t is an intbase_t, native_t the built-in type of the same size or void
+template<typename int_t, typename native_t>
+void validate_random(int count)
+{
+    constexpr int bitsize = sizeof(int_t) * 8;
+
+    std::vector<int_t> divisors = { int_t(1), int_t(2), int_t(3), int_t(10), int_t::max(), int_t::max() - int_t(1), int_t(1) << (bitsize - 2) };
+    if constexpr (int_t::is_signed) {
+        divisors.push_back(int_t(-1));
+        divisors.push_back(int_t(-2));
+        divisors.push_back(int_t(-10));
+        divisors.push_back(int_t::min());
+        divisors.push_back(int_t::min() + int_t(1));
+    }
+    else {
+        divisors.push_back(int_t(1) << (bitsize - 1));
+        divisors.push_back((int_t(1) << (bitsize - 1)) + int_t(1));
+    }
+    for (int i = 0; i < count; ++i) {
+        divisors.push_back(random_value<int_t>(1 + static_cast<int>(next() % bitsize)));
+    }
+
+    for (const int_t &y : divisors) {
+        if (!y) {
+            continue;
+        }
+        const divider<int_t> d(y);
+
+        const int_t special[] = { int_t(0), int_t(1), y, y - int_t(1), y + int_t(1), int_t::max(), int_t::min() + int_t(1), int_t::max() - y };
+        for (const int_t &n : special) {
+            check(d, n);
+        }
+        for (int j = 0; j < 50; ++j) {
+            check(d, random_value<int_t>(1 + static_cast<int>(next() % bitsize)));
+        }
+
+        // the built-in divider of the same width
+        if constexpr (!std::is_void_v<native_t>) {
+            native_t hy;
+            memcpy(&hy, &y, sizeof(hy));
+            const divider<native_t> hd(hy);
+            for (int j = 0; j < 50; ++j) {
+                native_t n = random_value<native_t>(1 + static_cast<int>(next() % bitsize));
+                if (std::is_signed_v<native_t> && n == std::numeric_limits<native_t>::min() && hy == native_t(-1)) {
+                    continue;
+                }
+                if (n / hd != n / hy || n % hd != n % hy) {
+                    cout << "n = " << n << ", d = " << hy << endl;
+                    throw std::exception("bad built-in divider");
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    try
+    {
+        validate_random<uint64sw_t, uint64_t>(20000);
+        validate_random<int64sw_t, int64_t>(20000);
+        validate_random<uint128sw_t, void>(5000);
+        validate_random<int128sw_t, void>(5000);
+        validate_random<uint256sw_t, void>(1000);
+        validate_random<int256sw_t, void>(1000);
+
+        validate_all16();
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,185 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <limits>
+
+#include "swcolumn.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the int128 column kernels against intbase_t<16> element by element
+//  add, sub and mul with carries across the halves, both signs
+//  all six predicates column-column and column-scalar, including equal halves
+//  sum, min and max for lengths around the vector width and the mask words
+//  the same results for 1 and 4 threads
+//
+
+// halves drawn from edge values so carries, borrows and equal halves are common
+uint64_t random_half()
+{
+    switch (next() % 6) {
+    case 0: return 0;
+    case 1: return ~uint64_t(0);
+    case 2: return uint64_t(1) << 63;
+    case 3: return (uint64_t(1) << 63) - 1;
+    case 4: return next() % 4;
+    default: return next();
+    }
+}
+
+template<bool is_signed>
+std::vector<intbase_t<16, is_signed>> random_values(size_t count, bool edges = true)
+{
+    std::vector<intbase_t<16, is_signed>> values(count);
+    for (auto &x : values) {
+        uint64_t halves[2] = { edges ? random_half() : next(), edges ? random_half() : next() };
+        memcpy(&x, halves, sizeof(x));
+    }
+    return values;
+}
+
+template<bool is_signed>
+void validate(size_t count, thread_pool &pool1, thread_pool &pool4)
+{
+    using int_t = intbase_t<16, is_signed>;
+
+    const auto va = random_values<is_signed>(count);
+    auto vb = random_values<is_signed>(count);
+    for (size_t i = 0; i < count; i += 3) {
+        vb[i] = va[i];
+    }
+
+    const int128_column<is_signed> a(va.data(), count), b(vb.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        if (a[i] != va[i]) throw std::exception("column round trip");
+    }
+
+    thread_pool *pools[2] = { &pool1, &pool4 };
+    for (thread_pool *pool : pools) {
+        int128_column<is_signed> sum(count), difference, product;
+        batch::add(a, b, sum, *pool);
+        batch::sub(a, b, difference, *pool);
+        batch::mul(a, b, product, *pool);
+        for (size_t i = 0; i < count; ++i) {
+            if (sum[i] != va[i] + vb[i]) throw std::exception("add");
+            if (difference[i] != va[i] - vb[i]) throw std::exception("sub");
+            if (product[i] != va[i] * vb[i]) throw std::exception("mul");
+        }
+
+        // in place
+        int128_column<is_signed> c = a;
+        batch::add(c, b, c, *pool);
+        for (size_t i = 0; i < count; ++i) {
+            if (c[i] != sum[i]) throw std::exception("add in place");
+        }
+
+        const int_t scalar = count ? va[count / 2] : int_t(0);
+        std::vector<uint64_t> mask(batch::mask_words(count)), scalar_mask(batch::mask_words(count));
+
+#define VALIDATE_COMPARE(name, op)                                                                                  \
+        std::fill(mask.begin(), mask.end(), ~uint64_t(0));                                                          \
+        std::fill(scalar_mask.begin(), scalar_mask.end(), ~uint64_t(0));                                            \
+        batch::name(a, b, mask.data(), *pool);                                                                      \
+        batch::name(a, scalar, scalar_mask.data(), *pool);                                                          \
+        for (size_t i = 0; i < batch::mask_words(count) * 64; ++i) {                                                \
+            const bool bit = (mask[i / 64] >> (i % 64)) & 1, scalar_bit = (scalar_mask[i / 64] >> (i % 64)) & 1;   \
+            if (bit != (i < count && (va[i] op vb[i]))) throw std::exception(#name);                                \
+            if (scalar_bit != (i < count && (va[i] op scalar))) throw std::exception(#name " scalar");              \
+        }                                                                                                           \
+
+        VALIDATE_COMPARE(lt, <)
+        VALIDATE_COMPARE(le, <=)
+        VALIDATE_COMPARE(eq, ==)
+        VALIDATE_COMPARE(ne, !=)
+        VALIDATE_COMPARE(gt, >)
+        VALIDATE_COMPARE(ge, >=)
+
+#undef VALIDATE_COMPARE
+
+        int_t total(0);
+        for (size_t i = 0; i < count; ++i) {
+            total += va[i];
+        }
+        if (batch::sum(a, *pool) != total) throw std::exception("sum");
+
+        if (count == 0) {
+            bool thrown = false;
+            try {
+                batch::min(a, *pool);
+            }
+            catch (std::exception) {
+                thrown = true;
+            }
+            if (!thrown) throw std::exception("min of an empty column");
+            continue;
+        }
+
+        int_t smallest = va[0], largest = va[0];
+        for (size_t i = 1; i < count; ++i) {
+            smallest = va[i] < smallest ? va[i] : smallest;
+            largest = largest < va[i] ? va[i] : largest;
+        }
+        if (batch::min(a, *pool) != smallest) throw std::exception("min");
+        if (batch::max(a, *pool) != largest) throw std::exception("max");
+    }
+
+    bool thrown = false;
+    try {
+        int128_column<is_signed> out;
+        batch::add(a, int128_column<is_signed>(count + 1), out, pool1);
+    }
+    catch (std::exception) {
+        thrown = true;
+    }
+    if (!thrown) throw std::exception("column length mismatch accepted");
+}
+
+// sum of many rows across chunks and workers, with distinct extremes
+void validate_large(thread_pool &pool1, thread_pool &pool4)
+{
+    const size_t count = 1000003;
+    const auto values = random_values<true>(count, false);
+    const int128_column<true> a(values.data(), count);
+
+    int128sw_t total(0), smallest = values[0], largest = values[0];
+    for (auto &x : values) {
+        total += x;
+        smallest = x < smallest ? x : smallest;
+        largest = largest < x ? x : largest;
+    }
+
+    if (batch::sum(a, pool1) != total || batch::sum(a, pool4) != total) throw std::exception("large sum");
+    if (batch::min(a, pool4) != smallest || batch::max(a, pool4) != largest) throw std::exception("large min/max");
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool1(1), pool4(4);
+
+        const size_t counts[] = { 0, 1, 2, 3, 63, 64, 65, 127, 1000, 16384, 16385, 50001 };
+        for (size_t count : counts) {
+            validate<false>(count, pool1, pool4);
+            validate<true>(count, pool1, pool4);
+        }
+
+        validate_large(pool1, pool4);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
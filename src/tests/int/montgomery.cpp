@@ -0,0 +1,187 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <limits>
+
+#include "swmodular.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate Montgomery modular arithmetic for 128-, 256- and 512-bit moduli
+//  mul, sqr and mod_pow against double-width products reduced with %
+//  Fermat's little theorem for known primes
+//  the batch API against the scalar one for any thread count
+//  % and / of the 128-bit type
+//
+
+// x zero-extended to the double width
+template<typename wide_t, typename int_t>
+wide_t widen(int_t x)
+{
+    uint64_t limbs[sizeof(wide_t) / 8] = {};
+    memcpy(limbs, &x, sizeof(x));
+    wide_t r;
+    memcpy(&r, limbs, sizeof(r));
+    return r;
+}
+
+template<typename int_t, typename wide_t>
+int_t narrow(wide_t x)
+{
+    int_t r;
+    memcpy(&r, &x, sizeof(r));
+    return r;
+}
+
+// a * b mod m with double-width arithmetic
+template<typename int_t>
+int_t mod_mul(int_t a, int_t b, int_t m)
+{
+    using wide_t = intbase_t<2 * sizeof(int_t), false>;
+    return narrow<int_t>(widen<wide_t>(a) * widen<wide_t>(b) % widen<wide_t>(m));
+}
+
+template<typename int_t>
+int_t reference_pow(int_t base, int_t exponent, int_t m)
+{
+    int_t r = int_t(1) % m;
+    base = base % m;
+    for (int i = sizeof(int_t) * 8 - 1; i >= 0; --i) {
+        r = mod_mul(r, r, m);
+        if (!!((exponent >> i) & int_t(1))) {
+            r = mod_mul(r, base, m);
+        }
+    }
+    return r;
+}
+
+template<typename int_t>
+void validate(int count)
+{
+    constexpr int bitsize = sizeof(int_t) * 8;
+
+    for (int i = 0; i < count; ++i) {
+        // odd moduli of every length, including the full width
+        int_t m = random_value<int_t>(1 + static_cast<int>(next() % bitsize)) | int_t(1);
+        if (i % 8 == 0) {
+            m = int_t::max() - int_t(2 * (next() % 1000));
+        }
+        const montgomery_context<int_t> ctx(m);
+        if (ctx.modulus() != m) throw std::exception("modulus");
+
+        const int_t a = random_value<int_t>(bitsize), b = random_value<int_t>(bitsize) % m;
+        const int_t am = ctx.to_montgomery(a), bm = ctx.to_montgomery(b);
+        if (!(am < m) || ctx.from_montgomery(am) != a % m) throw std::exception("Montgomery form round trip");
+
+        if (ctx.from_montgomery(ctx.mul(am, bm)) != mod_mul(a % m, b, m)) throw std::exception("mul");
+        if (ctx.from_montgomery(ctx.sqr(am)) != mod_mul(a % m, a % m, m)) throw std::exception("sqr");
+        if (ctx.sqr(am) != ctx.mul(am, am)) throw std::exception("sqr != mul");
+
+        const int_t e = random_value<int_t>(1 + static_cast<int>(next() % bitsize));
+        const int_t p = ctx.mod_pow(a, e);
+        if (!(p < m) || p != reference_pow(a, e, m)) {
+            cout << "m = " << int_t::to_string(m) << endl;
+            cout << "a = " << int_t::to_string(a) << ", e = " << int_t::to_string(e) << endl;
+            cout << "mod_pow = " << int_t::to_string(p) << endl;
+            throw std::exception("mod_pow");
+        }
+        if (ctx.mod_pow(a, int_t(0)) != int_t(1) % m || ctx.mod_pow(a, int_t(1)) != a % m) throw std::exception("mod_pow 0 and 1");
+    }
+
+    bool thrown = false;
+    try {
+        montgomery_context<int_t> even(int_t(100));
+    }
+    catch (std::exception) {
+        thrown = true;
+    }
+    if (!thrown) throw std::exception("even modulus accepted");
+}
+
+// a^(p - 1) = 1 mod p for prime p
+template<typename int_t>
+void validate_prime(int_t p)
+{
+    const montgomery_context<int_t> ctx(p);
+    for (int i = 0; i < 20; ++i) {
+        const int_t a = random_value<int_t>(sizeof(int_t) * 8 - 2) + int_t(2);
+        if (ctx.mod_pow(a, p - int_t(1)) != int_t(1)) throw std::exception("Fermat's little theorem");
+    }
+}
+
+template<typename int_t>
+void validate_batch(thread_pool &pool1, thread_pool &pool4)
+{
+    const int_t m = random_value<int_t>(sizeof(int_t) * 8) | int_t(1);
+    const montgomery_context<int_t> ctx(m);
+
+    const size_t count = 301;
+    std::vector<int_t> base(count), exponent(count), out1(count), out4(count);
+    for (size_t i = 0; i < count; ++i) {
+        base[i] = random_value<int_t>(sizeof(int_t) * 8);
+        exponent[i] = random_value<int_t>(sizeof(int_t) * 8);
+    }
+
+    batch::mod_pow(ctx, base.data(), exponent.data(), out1.data(), count, pool1);
+    batch::mod_pow(ctx, base.data(), exponent.data(), out4.data(), count, pool4);
+    for (size_t i = 0; i < count; ++i) {
+        if (out1[i] != ctx.mod_pow(base[i], exponent[i]) || out4[i] != out1[i]) throw std::exception("batch mod_pow");
+    }
+}
+
+void validate_int128_div()
+{
+    for (int i = 0; i < 100000; ++i) {
+        const uint128sw_t n = random_value<uint128sw_t>(128), d = random_value<uint128sw_t>(1 + static_cast<int>(next() % 128));
+        if (!d) {
+            continue;
+        }
+        const uint128sw_t q = n / d, r = n % d;
+        if (q * d + r != n || !(r < d)) throw std::exception("uint128 q * d + r != n");
+
+        const int128sw_t sn = details::bit_cast<int128sw_t>(n), sd = details::bit_cast<int128sw_t>(d);
+        const int128sw_t sq = sn / sd, sr = sn % sd;
+        if (sq * sd + sr != sn) throw std::exception("int128 q * d + r != n");
+    }
+
+    if (int128sw_t(-7) % int128sw_t(2) != int128sw_t(-1) || int128sw_t(7) % int128sw_t(-2) != int128sw_t(1)) throw std::exception("int128 remainder sign");
+}
+
+int main()
+{
+    try
+    {
+        thread_pool pool1(1), pool4(4);
+
+        validate_int128_div();
+
+        validate<uint128sw_t>(2000);
+        validate<uint256sw_t>(1000);
+        validate<uint512sw_t>(300);
+
+        // 2^127 - 1, 2^255 - 19 and 2^512 - 569
+        validate_prime(uint128sw_t::max() >> 1);
+        validate_prime((uint256sw_t::max() >> 1) - uint256sw_t(18));
+        validate_prime(uint512sw_t::max() - uint512sw_t(568));
+
+        validate_batch<uint128sw_t>(pool1, pool4);
+        validate_batch<uint256sw_t>(pool1, pool4);
+        validate_batch<uint512sw_t>(pool1, pool4);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
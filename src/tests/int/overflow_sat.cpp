@@ -0,0 +1,168 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <limits>
+
+#include "swint.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate overflow-checked and saturating arithmetic
+//  16-bit operands from the edges of the range and random values against
+//  built-in 64-bit arithmetic
+//  64- to 512-bit operands against the exact result in a wider type
+//
+
+template<typename int_t>
+void fail(const char *what, int_t a, int_t b)
+{
+    cout << "failed: " << what << " of " << int_t::to_string(a) << " and " << int_t::to_string(b) << endl;
+    throw std::exception(what);
+}
+
+template<typename int_t, typename native_t>
+void validate16()
+{
+    // the edges of the signed and unsigned ranges, and random values
+    std::vector<int> values;
+    for (int i = 0; i < 64; ++i) {
+        for (int edge : { 0, 0x7fff, 0x8000, 0xffff, 0x00ff, 0x0100, 0x00b5, 0xff4b }) {
+            values.push_back((edge + i - 32) & 0xffff);
+        }
+    }
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(static_cast<int>(next() & 0xffff));
+    }
+
+    constexpr int64_t lo = std::numeric_limits<native_t>::min(), hi = std::numeric_limits<native_t>::max();
+    auto clamp = [](int64_t x) { return x < lo ? lo : x > hi ? hi : x; };
+
+    for (int x : values) {
+        for (int y : values) {
+            const native_t na = static_cast<native_t>(x), nb = static_cast<native_t>(y);
+            const int_t a = static_cast<int_t>(na), b = static_cast<int_t>(nb);
+
+            const int64_t exact[3] = { int64_t(na) + nb, int64_t(na) - nb, int64_t(na) * nb };
+            bool overflow[3] = {};
+            const int_t wrapped[3] = { int_t::add_overflow(a, b, overflow[0]), int_t::sub_overflow(a, b, overflow[1]), int_t::mul_overflow(a, b, overflow[2]) };
+            const int_t saturated[3] = { int_t::add_sat(a, b), int_t::sub_sat(a, b), int_t::mul_sat(a, b) };
+            const char *names[3] = { "add", "sub", "mul" };
+
+            for (int op = 0; op < 3; ++op) {
+                if (static_cast<native_t>(wrapped[op]) != static_cast<native_t>(exact[op])) fail(names[op], a, b);
+                if (overflow[op] != (exact[op] < lo || exact[op] > hi)) fail(names[op], a, b);
+                if (static_cast<native_t>(saturated[op]) != static_cast<native_t>(clamp(exact[op]))) fail(names[op], a, b);
+            }
+        }
+    }
+}
+
+// the exact result in a signed type of four times the width, which holds
+// unsigned products and negative unsigned differences
+template<typename int_t>
+struct wide_reference
+{
+    using wide_t = intbase_t<4 * sizeof(int_t), true>;
+
+    static wide_t widen(int_t x)
+    {
+        uint8_t bytes[sizeof(wide_t)];
+        memset(bytes, (int_t::is_signed && x < int_t(0)) ? 0xff : 0, sizeof(bytes));
+        memcpy(bytes, &x, sizeof(x));
+        wide_t r;
+        memcpy(&r, bytes, sizeof(r));
+        return r;
+    }
+
+    static int_t narrow(wide_t x)
+    {
+        int_t r;
+        memcpy(&r, &x, sizeof(r));
+        return r;
+    }
+
+    static void check(const char *what, int_t a, int_t b, wide_t exact, int_t wrapped, bool overflow, int_t saturated)
+    {
+        const bool out_of_range = exact < widen(int_t::min()) || exact > widen(int_t::max());
+        const int_t clamped = exact < widen(int_t::min()) ? int_t::min() : exact > widen(int_t::max()) ? int_t::max() : narrow(exact);
+        if (wrapped != narrow(exact) || overflow != out_of_range || saturated != clamped) fail(what, a, b);
+    }
+};
+
+template<typename int_t>
+void validate_wide(int count)
+{
+    using reference = wide_reference<int_t>;
+    constexpr int bitsize = sizeof(int_t) * 8;
+
+    for (int i = 0; i < count; ++i) {
+        // near the limits, near zero, and products of every size
+        int_t a = random_value<int_t>(1 + static_cast<int>(next() % bitsize));
+        int_t b = random_value<int_t>(1 + static_cast<int>(next() % bitsize));
+        switch (next() % 8) {
+        case 0: a = int_t::max() - a % int_t(1000); break;
+        case 1: a = int_t::min() + a % int_t(1000); break;
+        case 2: b = int_t::max() - b % int_t(1000); break;
+        case 3: b = int_t::min() + b % int_t(1000); break;
+        default: break;
+        }
+        if (int_t::is_signed && (next() & 1)) {
+            a = -a;
+        }
+        if (int_t::is_signed && (next() & 1)) {
+            b = -b;
+        }
+
+        const auto wa = reference::widen(a), wb = reference::widen(b);
+        bool overflow = false;
+        int_t r = int_t::add_overflow(a, b, overflow);
+        reference::check("add", a, b, wa + wb, r, overflow, int_t::add_sat(a, b));
+        r = int_t::sub_overflow(a, b, overflow);
+        reference::check("sub", a, b, wa - wb, r, overflow, int_t::sub_sat(a, b));
+        r = int_t::mul_overflow(a, b, overflow);
+        reference::check("mul", a, b, wa * wb, r, overflow, int_t::mul_sat(a, b));
+    }
+
+    // min * -1 and min - 1 overflow, max * 1 does not
+    bool overflow = false;
+    if constexpr (int_t::is_signed) {
+        if (int_t::mul_overflow(int_t::min(), int_t(-1), overflow) != int_t::min() || !overflow) throw std::exception("min * -1");
+        if (int_t::mul_sat(int_t::min(), int_t(-1)) != int_t::max()) throw std::exception("min * -1 saturated");
+    }
+    if (int_t::sub_sat(int_t::min(), int_t(1)) != int_t::min()) throw std::exception("min - 1 saturated");
+    if (int_t::mul_overflow(int_t::max(), int_t(1), overflow) != int_t::max() || overflow) throw std::exception("max * 1");
+}
+
+int main()
+{
+    try
+    {
+        validate16<uint16sw_t, uint16_t>();
+        validate16<int16sw_t, int16_t>();
+
+        validate_wide<uint64sw_t>(100000);
+        validate_wide<int64sw_t>(100000);
+        validate_wide<uint128sw_t>(50000);
+        validate_wide<int128sw_t>(50000);
+        validate_wide<uint256sw_t>(20000);
+        validate_wide<int256sw_t>(20000);
+        validate_wide<uint512sw_t>(5000);
+        validate_wide<int512sw_t>(5000);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -15,6 +15,7 @@ for %%x in (
   basic_init.cpp
 
   shift_misc.cpp
+  bit_ops.cpp
 
   neg16_all.cpp
   shift16_all.cpp
@@ -28,6 +29,14 @@ for %%x in (
   sub16_all.cpp
   mulext16_all.cpp
 
+  wide_limbs.cpp
+  wide_multiply.cpp
+  montgomery.cpp
+  divider.cpp
+  decimal_chars.cpp
+  overflow_sat.cpp
+  int128_columns.cpp
+
 ) do (
  call :run_test %%~fx
  if errorlevel 1 goto :fail
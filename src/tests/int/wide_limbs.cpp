@@ -0,0 +1,177 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cstring>
+
+#include <limits>
+
+#include "swint.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the flat limb layout of 256-bit and wider intbase_t against the
+// recursive halves layout
+//  +, -, *, shifts, bitwise operators, compares and multiply_extended for
+//  random values with runs of zero and all-ones limbs
+//  division and remainder from q * d + r == n with |r| < |d|
+//  to_string
+//
+
+template<typename int_t>
+int_t random_value()
+{
+    uint64_t limbs[sizeof(int_t) / 8];
+    const uint64_t pattern = next();
+    for (size_t i = 0; i < sizeof(int_t) / 8; ++i) {
+        switch ((pattern >> (2 * (i % 32))) & 3) {
+        case 0: limbs[i] = 0; break;
+        case 1: limbs[i] = ~uint64_t(0); break;
+        default: limbs[i] = next(); break;
+        }
+    }
+
+    // short values exercise the single-digit divisor and the leading zeros
+    const size_t used = 1 + next() % (sizeof(int_t) / 8);
+    for (size_t i = used; i < sizeof(int_t) / 8; ++i) {
+        limbs[i] = (pattern >> 63) ? ~uint64_t(0) : 0;
+    }
+
+    int_t r;
+    memcpy(&r, limbs, sizeof(r));
+    return r;
+}
+
+template<typename a_t, typename b_t>
+void same(const a_t &a, const b_t &b, char const *what)
+{
+    static_assert(sizeof(a_t) == sizeof(b_t), "same layout size");
+    if (memcmp(&a, &b, sizeof(a_t))) {
+        cout << "failed: " << what << " for " << sizeof(a_t) * 8 << "-bit " << (a_t::is_signed ? "signed" : "unsigned") << endl;
+        throw std::exception("limbs and halves layouts differ");
+    }
+}
+
+template<size_t byte_size, bool is_signed>
+void validate(int count)
+{
+    using flat_t = intbase_t<byte_size, is_signed>;
+    using halves_t = intbase_t<byte_size, is_signed, details::int_halves>;
+    constexpr int bitsize = byte_size * 8;
+
+    for (int i = 0; i < count; ++i) {
+        const flat_t a = random_value<flat_t>(), b = random_value<flat_t>();
+        halves_t ha, hb;
+        memcpy(&ha, &a, sizeof(a));
+        memcpy(&hb, &b, sizeof(b));
+
+        same(a + b, ha + hb, "+");
+        same(a - b, ha - hb, "-");
+        same(a * b, ha * hb, "*");
+        same(-a, -ha, "negate");
+        same(a & b, ha & hb, "&");
+        same(a | b, ha | hb, "|");
+        same(a ^ b, ha ^ hb, "^");
+        same(~a, ~ha, "~");
+        if ((a == b) != (ha == hb) || (a != a) || !(a == a)) throw std::exception("==");
+
+        // the halves compare signed values as unsigned
+        if constexpr (!is_signed) {
+            if ((a < b) != (ha < hb) || (a <= b) != (ha <= hb) || (a > b) != (ha > hb) || (a >= b) != (ha >= hb)) throw std::exception("compare");
+        }
+
+        const int amount = 1 + static_cast<int>(next() % (bitsize - 1));
+        same(a << amount, ha << amount, "<<");
+        same(a >> amount, ha >> amount, ">>");
+        if (a << 0 != a || a >> 0 != a) throw std::exception("shift by 0");
+
+        flat_t hi;
+        halves_t hhi;
+        const flat_t lo = flat_t::multiply_extended(a, b, hi);
+        const halves_t hlo = halves_t::multiply_extended(ha, hb, hhi);
+        same(lo, hlo, "multiply_extended low");
+        same(hi, hhi, "multiply_extended high");
+
+        uint8_t carry = static_cast<uint8_t>(next() & 1), hcarry = carry;
+        same(flat_t::add_carry(a, b, carry), halves_t::add_carry(ha, hb, hcarry), "add_carry");
+        if (carry != hcarry) throw std::exception("add_carry carry");
+        uint8_t borrow = static_cast<uint8_t>(next() & 1), hborrow = borrow;
+        same(flat_t::sub_borrow(a, b, borrow), halves_t::sub_borrow(ha, hb, hborrow), "sub_borrow");
+        if (borrow != hborrow) throw std::exception("sub_borrow borrow");
+
+        // division: n = q * d + r, |r| < |d|, r has the sign of n
+        if (!b) {
+            continue;
+        }
+        const flat_t q = a / b, r = a % b;
+        if (q * b + r != a) throw std::exception("q * d + r != n");
+
+        const flat_t zero(0);
+        const flat_t abs_r = r < zero ? -r : r, abs_b = b < zero ? -b : b;
+        if constexpr (is_signed) {
+            if (a == flat_t::min() && b == flat_t(-1)) {
+                continue;
+            }
+            if (!(r == zero || (r < zero) == (a < zero))) throw std::exception("remainder sign");
+            if (!(abs_r < abs_b)) throw std::exception("signed remainder too large");
+        }
+        else {
+            if (!(r < b)) throw std::exception("remainder too large");
+        }
+    }
+}
+
+void validate_misc()
+{
+    using uint256_t = intbase_t<32, false>;
+    using int256_t = intbase_t<32, true>;
+    using uint1024_t = intbase_t<128, false>;
+
+    if (uint256_t::to_string(uint256_t::max()) != "115792089237316195423570985008687907853269984665640564039457584007913129639935") throw std::exception("to_string max");
+    if (int256_t::to_string(int256_t::min()) != "-57896044618658097711785492504343953926634992332820282019728792003956564819968") throw std::exception("to_string min");
+    if (int256_t::to_string(int256_t(0)) != "0" || int256_t::to_string(int256_t(-1000000000)) != "-1000000000") throw std::exception("to_string small");
+
+    // 3 * 2^1022 + 12345
+    const uint1024_t x = (uint1024_t(3) << 1022) + uint1024_t(12345);
+    if (uint1024_t::to_string(x).substr(0, 20) != "13482698511467369307" || uint1024_t::to_string(x).size() != 309) throw std::exception("to_string 1024");
+
+    // signed compares and conversions
+    const int256_t minus_one(-1), one(1);
+    if (!(minus_one < one) || !(int256_t::min() < int256_t::max()) || static_cast<int64_t>(minus_one) != -1) throw std::exception("signed compare");
+    if ((int256_t::min() >> 255) != minus_one || (int256_t::max() >> 254) != one) throw std::exception("arithmetic shift");
+
+    unsigned long index = 0;
+    if (!uint256_t::reverse_bit_scan(&index, uint256_t(1) << 200) || index != 200) throw std::exception("reverse_bit_scan");
+    if (uint256_t::reverse_bit_scan(&index, uint256_t(0))) throw std::exception("reverse_bit_scan zero");
+
+    // increments
+    uint256_t i = uint256_t::max();
+    if (i++ != uint256_t::max() || i != uint256_t(0) || --i != uint256_t::max()) throw std::exception("increment");
+}
+
+int main()
+{
+    try
+    {
+        validate<32, false>(20000);
+        validate<32, true>(20000);
+        validate<64, false>(5000);
+        validate<64, true>(5000);
+        validate<128, false>(500);
+        validate<128, true>(500);
+
+        validate_misc();
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
@@ -0,0 +1,163 @@
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cstring>
+
+#include <limits>
+
+#include "swint.h"
+#include "../test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// Validate the Karatsuba and Toom-3 multiplies of the flat limb layout
+//  each method against the schoolbook product for odd and even limb counts,
+//  random limbs with runs of zero and all-ones limbs
+//  truncated products against the low limbs of the full product
+//  intbase_t products up to 8192 bits: a * b == b * a, (a + 1) * b == a * b + b,
+//  and the high limbs of multiply_extended against a product of the halves
+//
+
+void random_limbs(uint64_t *limbs, int n)
+{
+    const uint64_t pattern = next();
+    for (int i = 0; i < n; ++i) {
+        switch ((pattern >> (2 * (i % 32))) & 3) {
+        case 0: limbs[i] = 0; break;
+        case 1: limbs[i] = ~uint64_t(0); break;
+        default: limbs[i] = next(); break;
+        }
+    }
+
+    // all-ones operands give the largest intermediate values
+    if ((pattern >> 62) == 3) {
+        for (int i = 0; i < n; ++i) {
+            limbs[i] = ~uint64_t(0);
+        }
+    }
+}
+
+template<int n>
+void validate_methods(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        uint64_t a[n], b[n];
+        random_limbs(a, n);
+        random_limbs(b, n);
+
+        uint64_t expected[2 * n], actual[2 * n];
+        details::multiply_schoolbook<n>(a, b, expected);
+
+        if constexpr (n >= 2) {
+            memset(actual, 0xcc, sizeof(actual));
+            details::multiply_karatsuba<n>(a, b, actual);
+            if (memcmp(expected, actual, sizeof(actual))) {
+                cout << "failed: Karatsuba for " << n << " limbs" << endl;
+                throw std::exception("Karatsuba product");
+            }
+        }
+
+        if constexpr (n >= 5) {
+            memset(actual, 0xcc, sizeof(actual));
+            details::multiply_toom3<n>(a, b, actual);
+            if (memcmp(expected, actual, sizeof(actual))) {
+                cout << "failed: Toom-3 for " << n << " limbs" << endl;
+                throw std::exception("Toom-3 product");
+            }
+        }
+
+        memset(actual, 0xcc, sizeof(actual));
+        details::multiply_low_limbs<n>(a, b, actual);
+        if (memcmp(expected, actual, n * sizeof(uint64_t))) {
+            cout << "failed: low product for " << n << " limbs" << endl;
+            throw std::exception("low product");
+        }
+    }
+}
+
+template<size_t byte_size, bool is_signed>
+void validate_products(int count)
+{
+    using int_t = intbase_t<byte_size, is_signed>;
+    using unsigned_t = intbase_t<byte_size / 2, false>;
+    constexpr int limb_count = byte_size / 8;
+
+    for (int i = 0; i < count; ++i) {
+        uint64_t la[limb_count], lb[limb_count];
+        random_limbs(la, limb_count);
+        random_limbs(lb, limb_count);
+
+        int_t a, b;
+        memcpy(&a, la, sizeof(a));
+        memcpy(&b, lb, sizeof(b));
+
+        if (a * b != b * a) throw std::exception("a * b != b * a");
+        if ((a + int_t(1)) * b != a * b + b) throw std::exception("(a + 1) * b != a * b + b");
+
+        int_t hi, hi_swapped;
+        const int_t lo = int_t::multiply_extended(a, b, hi);
+        const int_t lo_swapped = int_t::multiply_extended(b, a, hi_swapped);
+        if (lo != a * b || lo != lo_swapped || hi != hi_swapped) throw std::exception("multiply_extended");
+
+        // the half-width operands multiply exactly in the full width
+        if constexpr (!is_signed) {
+            unsigned_t ha, hb;
+            memcpy(&ha, la, sizeof(ha));
+            memcpy(&hb, lb, sizeof(hb));
+            unsigned_t phi;
+            const unsigned_t plo = unsigned_t::multiply_extended(ha, hb, phi);
+
+            uint64_t wide_a[limb_count] = {}, wide_b[limb_count] = {};
+            memcpy(wide_a, la, sizeof(ha));
+            memcpy(wide_b, lb, sizeof(hb));
+            int_t fa, fb;
+            memcpy(&fa, wide_a, sizeof(fa));
+            memcpy(&fb, wide_b, sizeof(fb));
+
+            const int_t product = fa * fb;
+            if (memcmp(&product, &plo, sizeof(plo)) || memcmp(reinterpret_cast<char const *>(&product) + sizeof(plo), &phi, sizeof(phi))) {
+                throw std::exception("half-width product");
+            }
+        }
+    }
+}
+
+int main()
+{
+    try
+    {
+        validate_methods<2>(10000);
+        validate_methods<3>(10000);
+        validate_methods<5>(10000);
+        validate_methods<7>(10000);
+        validate_methods<8>(10000);
+        validate_methods<9>(10000);
+        validate_methods<16>(5000);
+        validate_methods<17>(5000);
+        validate_methods<31>(2000);
+        validate_methods<32>(2000);
+        validate_methods<33>(2000);
+        validate_methods<64>(1000);
+        validate_methods<97>(500);
+        validate_methods<128>(500);
+
+        validate_products<64, false>(2000);
+        validate_products<64, true>(2000);
+        validate_products<256, false>(500);
+        validate_products<256, true>(500);
+        validate_products<1024, false>(100);
+        validate_products<1024, true>(100);
+    }
+    catch (std::exception e)
+    {
+        cout << "test failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout << "success!" << endl;
+    return 0;
+}
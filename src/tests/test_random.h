@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <cmath>
+
+#include "swfp.h"
+
+//
+// Deterministic pseudo-random test inputs
+//
+// xorshift64 from a fixed seed: a sampled test checks the same values on
+// every run, so a failure can be reproduced.
+//
+
+class xorshift64
+{
+public:
+    static constexpr uint64_t default_seed = 0x9e3779b97f4a7c15;
+
+    explicit xorshift64(uint64_t seed = default_seed) : state(seed) { }
+
+    // a UniformRandomBitGenerator, for std::shuffle
+    using result_type = uint64_t;
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~uint64_t(0); }
+
+    uint64_t operator()()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+private:
+    uint64_t state;
+};
+
+// next value of the test program's generator
+inline uint64_t next()
+{
+    static xorshift64 generator;
+    return generator();
+}
+
+// random low `bits` bits, the rest zero, for intbase_t and built-in integers
+template<typename int_t>
+int_t random_value(int bits)
+{
+    uint64_t limbs[(sizeof(int_t) + 7) / 8] = {};
+    for (int i = 0; i < bits / 64; ++i) {
+        limbs[i] = next();
+    }
+    if (bits % 64) {
+        limbs[bits / 64] = next() >> (64 - bits % 64);
+    }
+
+    int_t r;
+    memcpy(&r, limbs, sizeof(r));
+    return r;
+}
+
+// floatbase_t value of a double, through float64_t for the narrower formats
+template<fp_format format>
+floatbase_t<format> from_double(double x)
+{
+    if constexpr (format == fp_format::binary64) {
+        return floatbase_t<format>(x);
+    }
+    else {
+        return static_cast<floatbase_t<format>>(float64_t(x));
+    }
+}
+
+// random finite value of either sign with an exponent in [emin, emax]
+template<fp_format format>
+floatbase_t<format> random_value(int emin, int emax)
+{
+    const double significand = 1.0 + static_cast<double>(next() >> 12) * 0x1p-52;
+    const int exponent = emin + static_cast<int>(next() % static_cast<uint64_t>(emax - emin + 1));
+    const double x = std::ldexp(significand, exponent);
+    return from_double<format>(next() % 2 ? -x : x);
+}
@@ -0,0 +1,17 @@
+@for %%x in (
+
+ fpconv.cpp
+ intbench.cpp
+
+) do @(
+ cl -nologo -EHsc -std:c++17 -W4 -diagnostics:caret -O2 -DNDEBUG -I%%~px\.. %%~fx
+ if not errorlevel 0 goto :fail
+ if errorlevel 1 goto :fail
+)
+echo BUILD SUCCEEDED
+goto :eof
+
+
+:fail
+echo !!!FAILURE!!!
+goto :eof
@@ -0,0 +1,63 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+
+#include "swconv.h"
+
+using std::cout;
+using std::endl;
+
+//
+// fpconv: convert a raw file of floating-point values between formats
+//
+//  fpconv <input> <from> <output> <to> [threads]
+//
+//  formats: fp8 (e5m2), bf16, fp16, fp32, fp64
+//
+
+int usage()
+{
+    cout << "usage: fpconv <input> <from> <output> <to> [threads]" << endl;
+    cout << "  formats: fp8 (e5m2), bf16, fp16, fp32, fp64" << endl;
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 5 && argc != 6) {
+        return usage();
+    }
+
+    fp_format from, to;
+    if (!parse_fp_format(argv[2], from) || !parse_fp_format(argv[4], to)) {
+        return usage();
+    }
+
+    unsigned threads = (argc == 6) ? static_cast<unsigned>(atoi(argv[5])) : 0;
+
+    try
+    {
+        thread_pool pool(threads, true);
+        convert_stats stats = convert_file(argv[1], from, argv[3], to, pool);
+
+        cout << "converted " << stats.count << " values (" << stats.bytes_read << " -> " << stats.bytes_written << " bytes)"
+             << " in " << stats.seconds << " s on " << pool.size() << " threads: "
+             << stats.gigabytes_per_second() << " GB/s" << endl;
+
+        if (has_flag(stats.flags, fp_flags::overflow)) {
+            cout << "  some values overflowed to infinity" << endl;
+        }
+        if (has_flag(stats.flags, fp_flags::underflow)) {
+            cout << "  some values became subnormal or zero" << endl;
+        }
+    }
+    catch (std::exception e)
+    {
+        cout << "conversion failed: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
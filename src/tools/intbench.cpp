@@ -0,0 +1,203 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+
+#include "swint.h"
+#include "tests/test_random.h"
+
+using std::cout;
+using std::endl;
+
+//
+// intbench: time the wide intbase_t layouts against each other
+//
+//  intbench [iterations]
+//  intbench multiply [iterations]
+//
+//  for 256- to 2048-bit integers, compares the flat limb layout used above
+//  128 bits with the recursive halves layout it replaced
+//
+//  `multiply` times the schoolbook, Karatsuba and Toom-3 products of the flat
+//  layout at each limb count, the crossovers are details::karatsuba_threshold
+//  and details::toom3_threshold
+//
+
+template<typename int_t>
+std::vector<int_t> random_values(size_t count, xorshift64 &rng)
+{
+    std::vector<int_t> values(count);
+    for (auto &v : values) {
+        uint64_t limbs[sizeof(int_t) / 8];
+        for (auto &l : limbs) {
+            l = rng();
+        }
+        memcpy(&v, limbs, sizeof(v));
+    }
+    return values;
+}
+
+// nanoseconds per call of op over pairs of values
+template<typename int_t, typename op_t>
+double time_op(const std::vector<int_t> &a, const std::vector<int_t> &b, size_t iterations, op_t op)
+{
+    int_t sink(0);
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        const size_t j = i % a.size();
+        sink = sink ^ op(a[j], b[j]);
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    // keep the results alive
+    static volatile uint64_t keep;
+    keep = static_cast<uint64_t>(sink);
+
+    return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+}
+
+template<typename int_t>
+struct bench
+{
+    template<typename op_t>
+    static double run(size_t iterations, op_t op)
+    {
+        const size_t count = 1024;
+        xorshift64 rng;
+        const auto a = random_values<int_t>(count, rng);
+        auto b = random_values<int_t>(count, rng);
+
+        // half-width divisors keep the quotients interesting
+        for (auto &d : b) {
+            d = (d >> static_cast<int>(sizeof(int_t) * 4)) | int_t(1);
+        }
+        return time_op(a, b, iterations, op);
+    }
+};
+
+template<size_t byte_size>
+void compare(size_t iterations)
+{
+    using flat_t = intbase_t<byte_size, false>;
+    using halves_t = intbase_t<byte_size, false, details::int_halves>;
+
+    auto report = [&](char const *name, auto flat_op, auto halves_op, size_t n) {
+        const double flat = bench<flat_t>::run(n, flat_op);
+        const double halves = bench<halves_t>::run(n, halves_op);
+        cout << std::setw(6) << byte_size * 8 << std::setw(20) << name
+             << std::setw(12) << flat << std::setw(12) << halves
+             << std::setw(10) << halves / flat << "x" << endl;
+    };
+
+    auto add = [](auto a, auto b) { return a + b; };
+    auto sub = [](auto a, auto b) { return a - b; };
+    auto mul = [](auto a, auto b) { return a * b; };
+    auto mul_ext = [](auto a, auto b) { decltype(a) hi; auto lo = decltype(a)::multiply_extended(a, b, hi); return lo ^ hi; };
+    auto shl = [](auto a, auto b) { return a << static_cast<int>(static_cast<uint64_t>(b) % (byte_size * 8)); };
+    auto shr = [](auto a, auto b) { return a >> static_cast<int>(static_cast<uint64_t>(b) % (byte_size * 8)); };
+    auto div = [](auto a, auto b) { return a / b; };
+    auto less = [](auto a, auto b) { return decltype(a)(a < b); };
+
+    report("add", add, add, iterations);
+    report("sub", sub, sub, iterations);
+    report("mul", mul, mul, iterations / 4);
+    report("multiply_extended", mul_ext, mul_ext, iterations / 4);
+    report("shift left", shl, shl, iterations);
+    report("shift right", shr, shr, iterations);
+    report("divide", div, div, iterations / 64);
+    report("compare", less, less, iterations);
+}
+
+// nanoseconds per full product of n-limb operands with one multiply method
+template<int n, typename method_t>
+double time_multiply(size_t iterations, method_t method)
+{
+    const size_t count = 64;
+    xorshift64 rng;
+    std::vector<uint64_t> a(count * n), b(count * n);
+    for (size_t i = 0; i < count * n; ++i) {
+        a[i] = rng();
+        b[i] = rng();
+    }
+
+    uint64_t product[2 * n];
+    uint64_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        const size_t j = (i % count) * n;
+        method(&a[j], &b[j], product);
+        sink ^= product[n];
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    static volatile uint64_t keep;
+    keep = sink;
+
+    return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+}
+
+template<int n>
+void compare_multiply(size_t iterations)
+{
+    const double schoolbook = time_multiply<n>(iterations, details::multiply_schoolbook<n>);
+    const double karatsuba = time_multiply<n>(iterations, details::multiply_karatsuba<n>);
+    const double toom3 = time_multiply<n>(iterations, details::multiply_toom3<n>);
+    const double selected = time_multiply<n>(iterations, details::multiply_limbs<n>);
+
+    char const *best = schoolbook <= karatsuba && schoolbook <= toom3 ? "schoolbook" : karatsuba <= toom3 ? "Karatsuba" : "Toom-3";
+    cout << std::setw(6) << n << std::setw(8) << n * 64
+         << std::setw(13) << schoolbook << std::setw(13) << karatsuba << std::setw(13) << toom3
+         << std::setw(13) << selected << std::setw(13) << best << endl;
+}
+
+void multiply(size_t iterations)
+{
+    cout << "thresholds: Karatsuba from " << details::karatsuba_threshold << " limbs, Toom-3 from " << details::toom3_threshold << " limbs" << endl;
+    cout << std::setw(6) << "limbs" << std::setw(8) << "bits"
+         << std::setw(13) << "schoolbook" << std::setw(13) << "Karatsuba" << std::setw(13) << "Toom-3"
+         << std::setw(13) << "selected" << std::setw(13) << "fastest" << endl;
+
+    compare_multiply<6>(iterations);
+    compare_multiply<8>(iterations);
+    compare_multiply<12>(iterations);
+    compare_multiply<16>(iterations / 2);
+    compare_multiply<24>(iterations / 4);
+    compare_multiply<32>(iterations / 8);
+    compare_multiply<48>(iterations / 16);
+    compare_multiply<64>(iterations / 32);
+    compare_multiply<96>(iterations / 64);
+    compare_multiply<128>(iterations / 64);
+}
+
+int main(int argc, char **argv)
+{
+    const bool multiply_only = argc >= 2 && std::string(argv[1]) == "multiply";
+    const int iterations_arg = multiply_only ? 2 : 1;
+    const size_t iterations = (argc == iterations_arg + 1) ? static_cast<size_t>(atoll(argv[iterations_arg])) : 1000000;
+    if (iterations < 64 || argc > iterations_arg + 1) {
+        cout << "usage: intbench [multiply] [iterations]" << endl;
+        return 2;
+    }
+
+    cout << std::fixed << std::setprecision(2);
+    if (multiply_only) {
+        multiply(iterations);
+        return 0;
+    }
+
+    cout << std::setw(6) << "bits" << std::setw(20) << "operation"
+         << std::setw(12) << "flat ns" << std::setw(12) << "halves ns"
+         << std::setw(11) << "speedup" << endl;
+
+    compare<32>(iterations);
+    compare<64>(iterations);
+    compare<128>(iterations / 4);
+    compare<256>(iterations / 16);
+
+    return 0;
+}